@@ -0,0 +1,430 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "burst_merge.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_BURST_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_BURST_SSE2 1
+#endif
+
+#include "image_kernels.h"
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// The pyramid gets levels until the search at the coarsest one is at most this many pixels
+// in every direction, or the next level would be smaller than kMinLevelSize.
+constexpr int kCoarseRadius = 4;
+constexpr int kMinLevelSize = 16;
+constexpr int kMaxLevels = 8;
+// Rows compared per candidate translation and level. More add time but barely change the
+// estimate.
+constexpr int kSadRows = 128;
+
+int64_t ElapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+// Sum of absolute differences of count samples.
+uint32_t SadRow(const uint8_t* a, const uint8_t* b, int count, bool simd) {
+    uint32_t sad = 0;
+    int x = 0;
+#if defined(CAMERAX_BURST_NEON)
+    uint32x4_t sums = vdupq_n_u32(0);
+    for (; simd && x + 16 <= count; x += 16) {
+        sums = vpadalq_u16(sums, vpaddlq_u8(vabdq_u8(vld1q_u8(a + x), vld1q_u8(b + x))));
+    }
+    sad = vgetq_lane_u32(sums, 0) + vgetq_lane_u32(sums, 1) + vgetq_lane_u32(sums, 2)
+            + vgetq_lane_u32(sums, 3);
+#elif defined(CAMERAX_BURST_SSE2)
+    __m128i sums = _mm_setzero_si128();
+    for (; simd && x + 16 <= count; x += 16) {
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x))));
+    }
+    sad = static_cast<uint32_t>(_mm_cvtsi128_si32(sums))
+            + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums)));
+#endif
+    for (; x < count; ++x) {
+        sad += static_cast<uint32_t>(std::abs(a[x] - b[x]));
+    }
+    return sad;
+}
+
+// Adds every sample of src that is within threshold of the same sample of reference to sums
+// and counts it.
+void AccumulateRow(const uint8_t* src, const uint8_t* reference, int count, uint8_t threshold,
+                   bool simd, uint16_t* sums, uint8_t* counts) {
+    int x = 0;
+#if defined(CAMERAX_BURST_NEON)
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    for (; simd && x + 16 <= count; x += 16) {
+        const uint8x16_t samples = vld1q_u8(src + x);
+        // All ones where the sample is kept.
+        const uint8x16_t keep = vcleq_u8(vabdq_u8(samples, vld1q_u8(reference + x)), limit);
+        const uint8x16_t kept = vandq_u8(samples, keep);
+        vst1q_u16(sums + x, vaddw_u8(vld1q_u16(sums + x), vget_low_u8(kept)));
+        vst1q_u16(sums + x + 8, vaddw_u8(vld1q_u16(sums + x + 8), vget_high_u8(kept)));
+        vst1q_u8(counts + x, vsubq_u8(vld1q_u8(counts + x), keep));
+    }
+#elif defined(CAMERAX_BURST_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    for (; simd && x + 16 <= count; x += 16) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i reference_samples =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(reference + x));
+        const __m128i difference = _mm_or_si128(_mm_subs_epu8(samples, reference_samples),
+                                                _mm_subs_epu8(reference_samples, samples));
+        // All ones where the sample is kept, i.e. the difference does not exceed the limit.
+        const __m128i keep = _mm_cmpeq_epi8(_mm_subs_epu8(difference, limit), zero);
+        const __m128i kept = _mm_and_si128(samples, keep);
+        __m128i* low = reinterpret_cast<__m128i*>(sums + x);
+        __m128i* high = reinterpret_cast<__m128i*>(sums + x + 8);
+        _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(kept, zero)));
+        _mm_storeu_si128(high,
+                         _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(kept, zero)));
+        __m128i* count_lanes = reinterpret_cast<__m128i*>(counts + x);
+        _mm_storeu_si128(count_lanes, _mm_sub_epi8(_mm_loadu_si128(count_lanes), keep));
+    }
+#endif
+    for (; x < count; ++x) {
+        if (std::abs(src[x] - reference[x]) <= threshold) {
+            sums[x] = static_cast<uint16_t>(sums[x] + src[x]);
+            ++counts[x];
+        }
+    }
+}
+
+// Returns row y of plane with adjacent samples, gathered into buffer if needed.
+const uint8_t* LumaRow(const Plane& plane, int y, int width, uint8_t* buffer) {
+    const uint8_t* row = plane.RowAt(y);
+    if (plane.pixel_stride == 1) {
+        return row;
+    }
+    for (int x = 0; x < width; ++x) {
+        buffer[x] = row[x * plane.pixel_stride];
+    }
+    return buffer;
+}
+
+// Returns chroma row y of image as interleaved UV, gathered into buffer if needed.
+const uint8_t* ChromaRow(const PlanarImage& image, int y, uint8_t* buffer) {
+    if (image.chroma_layout() == ChromaLayout::kSemiPlanarUV) {
+        return image.u.RowAt(y);
+    }
+    const uint8_t* u = image.u.RowAt(y);
+    const uint8_t* v = image.v.RowAt(y);
+    const int width = image.chroma_width();
+    for (int x = 0; x < width; ++x) {
+        buffer[2 * x] = u[x * image.u.pixel_stride];
+        buffer[2 * x + 1] = v[x * image.v.pixel_stride];
+    }
+    return buffer;
+}
+
+// Adds the samples [0, count) of a row shifted by shift to the sums, leaving out those that
+// fall outside of the row.
+void AccumulateShifted(const uint8_t* src, const uint8_t* reference, int count, int shift,
+                       uint8_t threshold, bool simd, uint16_t* sums, uint8_t* counts) {
+    const int begin = std::max(0, -shift);
+    const int end = std::min(count, count - shift);
+    if (begin < end) {
+        AccumulateRow(src + begin + shift, reference + begin, end - begin, threshold, simd,
+                      sums + begin, counts + begin);
+    }
+}
+
+// round(sum / count) for a sum of at most count samples, by a 33-bit fixed point reciprocal.
+inline uint8_t Mean(uint32_t sum, uint32_t count, const uint64_t* reciprocals) {
+    return static_cast<uint8_t>(((2 * sum + count) * reciprocals[count]) >> 33);
+}
+
+}  // namespace
+
+BurstMerger::BurstMerger(const BurstMergeOptions& options) : options_(options) {
+    if (options.width <= 0 || options.height <= 0 || options.max_shift < 0
+        || options.motion_threshold < 0 || options.motion_threshold > 255) {
+        return;
+    }
+    const size_t pixels = static_cast<size_t>(options.width) * options.height;
+    chroma_row_ = 2 * ((options.width + 1) / 2);
+    chroma_height_ = (options.height + 1) / 2;
+    const size_t chroma = static_cast<size_t>(chroma_row_) * chroma_height_;
+    const size_t merged_size = static_cast<size_t>(chroma_row_) * options.height + chroma;
+    const size_t total = 2 * pixels + pixels + 2 * chroma + chroma + pixels + chroma
+            + merged_size;
+    if (arena_.Reset(FrameArena::CapacityFor(total, 7)) != 0) {
+        return;
+    }
+    uint16_t* luma_sums = reinterpret_cast<uint16_t*>(arena_.Allocate(2 * pixels));
+    luma_counts_ = arena_.Allocate(pixels);
+    chroma_sums_ = reinterpret_cast<uint16_t*>(arena_.Allocate(2 * chroma));
+    chroma_counts_ = arena_.Allocate(chroma);
+    reference_y_ = arena_.Allocate(pixels);
+    reference_uv_ = arena_.Allocate(chroma);
+    merged_ = arena_.Allocate(merged_size);
+    if (merged_ == nullptr) {
+        return;
+    }
+
+    int level_count = 1;
+    while (level_count < kMaxLevels && (options.max_shift >> (level_count - 1)) > kCoarseRadius
+           && (std::min(options.width, options.height) >> level_count) >= kMinLevelSize) {
+        ++level_count;
+    }
+    pyramid_options_.level_count = level_count;
+    pyramid_options_.ratio = 2.0f;
+    pyramid_options_.format = PyramidFormat::kY8;
+    luma_sums_ = luma_sums;
+}
+
+void BurstMerger::Reset() {
+    stats_ = BurstMergeStats();
+}
+
+int BurstMerger::AddFrame(const PlanarImage& frame, StripePool* pool, int* shift_x,
+                          int* shift_y) {
+    if (!IsValid() || !frame.IsValid() || frame.subsampling != ChromaSubsampling::k420
+        || frame.width != options_.width || frame.height != options_.height
+        || stats_.frame_count >= kMaxFrames) {
+        return -1;
+    }
+    const bool first = stats_.frame_count == 0;
+    int dx = 0;
+    int dy = 0;
+    if (options_.align && options_.max_shift > 0) {
+        auto start = std::chrono::steady_clock::now();
+        if (BuildPyramid(frame, pyramid_options_,
+                         first ? &reference_pyramid_arena_ : &frame_pyramid_arena_, pool,
+                         first ? &reference_levels_ : &frame_levels_) != 0) {
+            return -1;
+        }
+        stats_.pyramid_ns += ElapsedNs(start);
+        if (!first) {
+            start = std::chrono::steady_clock::now();
+            EstimateShift(pool, &dx, &dy);
+            stats_.align_ns += ElapsedNs(start);
+        }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    Accumulate(frame, dx, dy, pool);
+    stats_.accumulate_ns += ElapsedNs(start);
+    ++stats_.frame_count;
+    if (shift_x != nullptr) {
+        *shift_x = dx;
+    }
+    if (shift_y != nullptr) {
+        *shift_y = dy;
+    }
+    return 0;
+}
+
+void BurstMerger::EstimateShift(StripePool* pool, int* shift_x, int* shift_y) const {
+    const bool simd = GetKernelImpl(Kernel::kBurstMerge) != KernelImpl::kScalar;
+    const int top_level = static_cast<int>(reference_levels_.size()) - 1;
+    int sx = 0;
+    int sy = 0;
+    for (int level = top_level; level >= 0; --level) {
+        const PyramidLevel& reference = reference_levels_[level];
+        const PyramidLevel& frame = frame_levels_[level];
+        // The coarsest level covers the whole range, every finer one refines the doubled
+        // estimate of the level above by a pixel.
+        int radius = 1;
+        if (level == top_level) {
+            radius = std::max(1, (options_.max_shift + (1 << level) - 1) >> level);
+        } else {
+            sx *= 2;
+            sy *= 2;
+        }
+        // Every candidate is compared over the same window of the reference, so that their
+        // sums are comparable, and the window stays inside the frame for all of them.
+        const int margin_x = std::abs(sx) + radius;
+        const int margin_y = std::abs(sy) + radius;
+        const int window_width = reference.width - 2 * margin_x;
+        const int window_height = reference.height - 2 * margin_y;
+        if (window_width <= 0 || window_height <= 0) {
+            continue;
+        }
+        const int row_step = std::max(1, window_height / kSadRows);
+        const int side = 2 * radius + 1;
+        std::vector<uint64_t> sads(static_cast<size_t>(side) * side);
+        RunStripes(pool, side * side, [&](int candidate) {
+            const int cx = sx + candidate % side - radius;
+            const int cy = sy + candidate / side - radius;
+            uint64_t sad = 0;
+            for (int y = margin_y; y < margin_y + window_height; y += row_step) {
+                sad += SadRow(reference.data + static_cast<ptrdiff_t>(y) * reference.stride
+                                      + margin_x,
+                              frame.data + static_cast<ptrdiff_t>(y + cy) * frame.stride
+                                      + margin_x + cx,
+                              window_width, simd);
+            }
+            sads[candidate] = sad;
+        });
+        // Ties go to the candidate closest to the current estimate.
+        int best = (side * side) / 2;
+        for (int candidate = 0; candidate < side * side; ++candidate) {
+            const int distance = std::abs(candidate % side - radius)
+                    + std::abs(candidate / side - radius);
+            const int best_distance = std::abs(best % side - radius)
+                    + std::abs(best / side - radius);
+            if (sads[candidate] < sads[best]
+                || (sads[candidate] == sads[best] && distance < best_distance)) {
+                best = candidate;
+            }
+        }
+        sx += best % side - radius;
+        sy += best / side - radius;
+    }
+    *shift_x = std::min(std::max(sx, -options_.max_shift), options_.max_shift);
+    *shift_y = std::min(std::max(sy, -options_.max_shift), options_.max_shift);
+}
+
+void BurstMerger::Accumulate(const PlanarImage& frame, int shift_x, int shift_y,
+                             StripePool* pool) {
+    const bool simd = GetKernelImpl(Kernel::kBurstMerge) != KernelImpl::kScalar;
+    const bool first = stats_.frame_count == 0;
+    const int width = options_.width;
+    const int height = options_.height;
+    const uint8_t threshold = static_cast<uint8_t>(options_.motion_threshold);
+    // Chroma moves by half the luma shift, rounded down.
+    const int chroma_shift_x = shift_x >> 1;
+    const int chroma_shift_y = shift_y >> 1;
+
+    // Stripes start on even rows, so that they hold whole chroma rows.
+    RunRowStripes(pool, height, 2, [&](int top, int bottom) {
+        std::vector<uint8_t> buffer(std::max(width, chroma_row_));
+        for (int y = top; y < bottom; ++y) {
+            const size_t offset = static_cast<size_t>(y) * width;
+            if (first) {
+                memcpy(reference_y_ + offset, LumaRow(frame.y, y, width, buffer.data()), width);
+                memset(luma_sums_ + offset, 0, width * sizeof(uint16_t));
+                memset(luma_counts_ + offset, 0, width);
+            }
+            const int src_y = y + shift_y;
+            if (src_y < 0 || src_y >= height) {
+                continue;
+            }
+            AccumulateShifted(LumaRow(frame.y, src_y, width, buffer.data()),
+                              reference_y_ + offset, width, shift_x, threshold, simd,
+                              luma_sums_ + offset, luma_counts_ + offset);
+        }
+        for (int y = top / 2; y < (bottom + 1) / 2; ++y) {
+            const size_t offset = static_cast<size_t>(y) * chroma_row_;
+            if (first) {
+                memcpy(reference_uv_ + offset, ChromaRow(frame, y, buffer.data()), chroma_row_);
+                memset(chroma_sums_ + offset, 0, chroma_row_ * sizeof(uint16_t));
+                memset(chroma_counts_ + offset, 0, chroma_row_);
+            }
+            const int src_y = y + chroma_shift_y;
+            if (src_y < 0 || src_y >= chroma_height_) {
+                continue;
+            }
+            AccumulateShifted(ChromaRow(frame, src_y, buffer.data()), reference_uv_ + offset,
+                              chroma_row_, 2 * chroma_shift_x, threshold, simd,
+                              chroma_sums_ + offset, chroma_counts_ + offset);
+        }
+    });
+}
+
+int BurstMerger::MergeToYuv(const PlanarImage& dst, StripePool* pool) {
+    if (!IsValid() || stats_.frame_count == 0 || !dst.IsValid()
+        || dst.subsampling != ChromaSubsampling::k420 || dst.width != options_.width
+        || dst.height != options_.height) {
+        return -1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t reciprocals[kMaxFrames + 1] = {0};
+    for (int count = 1; count <= kMaxFrames; ++count) {
+        reciprocals[count] = ((uint64_t{1} << 32) + count - 1) / count;
+    }
+    const int width = options_.width;
+    std::atomic<int64_t> merged_samples(0);
+    RunRowStripes(pool, options_.height, 2, [&](int top, int bottom) {
+        int64_t merged = 0;
+        for (int y = top; y < bottom; ++y) {
+            const size_t offset = static_cast<size_t>(y) * width;
+            const uint16_t* sums = luma_sums_ + offset;
+            const uint8_t* counts = luma_counts_ + offset;
+            uint8_t* out = dst.y.RowAt(y);
+            for (int x = 0; x < width; ++x) {
+                // The reference always counts, so no sample is left without one.
+                out[x * dst.y.pixel_stride] = Mean(sums[x], counts[x], reciprocals);
+                merged += counts[x];
+            }
+        }
+        for (int y = top / 2; y < (bottom + 1) / 2; ++y) {
+            const size_t offset = static_cast<size_t>(y) * chroma_row_;
+            const uint16_t* sums = chroma_sums_ + offset;
+            const uint8_t* counts = chroma_counts_ + offset;
+            uint8_t* u = dst.u.RowAt(y);
+            uint8_t* v = dst.v.RowAt(y);
+            for (int x = 0; x < chroma_row_ / 2; ++x) {
+                u[x * dst.u.pixel_stride] = Mean(sums[2 * x], counts[2 * x], reciprocals);
+                v[x * dst.v.pixel_stride] = Mean(sums[2 * x + 1], counts[2 * x + 1],
+                                                 reciprocals);
+            }
+        }
+        merged_samples += merged;
+    });
+    stats_.merged_samples = merged_samples;
+    stats_.output_ns = ElapsedNs(start);
+    return 0;
+}
+
+int BurstMerger::MergeToABGR(uint8_t* dst, int dst_stride, bool is_full_swing,
+                             StripePool* pool) {
+    if (dst == nullptr || dst_stride < 4 * options_.width) {
+        return -1;
+    }
+    const PlanarImage merged = WrapNV12(merged_, options_.width, options_.height, chroma_row_,
+                                        options_.height, /* vu_order= */ false);
+    if (MergeToYuv(merged, pool) != 0) {
+        return -1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<int> result(0);
+    RunRowStripes(pool, options_.height, 2, [&](int top, int bottom) {
+        PlanarImage band = merged;
+        band.height = bottom - top;
+        band.y.data = merged.y.RowAt(top);
+        band.u.data = merged.u.RowAt(top / 2);
+        band.v.data = merged.v.RowAt(top / 2);
+        if (Android420ToABGR(band, dst + static_cast<ptrdiff_t>(top) * dst_stride, dst_stride,
+                             is_full_swing) != 0) {
+            result = -1;
+        }
+    });
+    stats_.output_ns += ElapsedNs(start);
+    return result;
+}
+
+}  // namespace camerax
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_BURST_MERGE_H_
+#define CAMERA_CORE_BURST_MERGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame_arena.h"
+#include "image_planes.h"
+#include "image_pyramid.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * Configuration of a {@link BurstMerger}.
+ */
+struct BurstMergeOptions {
+    int width = 0;
+    int height = 0;
+    // Aligns every frame to the first one by a global translation, found on luma pyramids.
+    bool align = true;
+    // Largest translation searched, in pixels.
+    int max_shift = 64;
+    // Samples that differ from the first frame by more than this are taken to have moved and
+    // are left out of the mean. 255 keeps every sample.
+    int motion_threshold = 24;
+};
+
+/**
+ * What a {@link BurstMerger} did, with the time spent per stage summed over all frames.
+ */
+struct BurstMergeStats {
+    int frame_count = 0;
+    int64_t pyramid_ns = 0;
+    int64_t align_ns = 0;
+    int64_t accumulate_ns = 0;
+    int64_t output_ns = 0;
+    // Luma samples that went into the last output, at most frame_count per pixel. The rest were
+    // rejected as motion or fell outside of a shifted frame.
+    int64_t merged_samples = 0;
+};
+
+/**
+ * Averages a burst of YUV frames into one with less noise, e.g. for low light capture.
+ *
+ * <p>The first frame is the reference. Every later frame is shifted onto it by the translation
+ * that matches their luma pyramids best, searched coarse to fine. Its samples are then added to
+ * 16-bit sums with per-sample counts, except for those that differ too much from the reference,
+ * so that moving objects do not ghost. The output is the mean of every sample.
+ *
+ * <p>All memory is allocated from {@link FrameArena}s: the sums and the reference when the
+ * merger is created, the pyramids with the first burst. Later bursts do not allocate. Rows are
+ * split into stripes that run on a {@link StripePool}. The merger is not thread safe.
+ */
+class BurstMerger {
+public:
+    /** At most this many frames fit the 8-bit counts. */
+    static constexpr int kMaxFrames = 255;
+
+    explicit BurstMerger(const BurstMergeOptions& options);
+
+    BurstMerger(const BurstMerger&) = delete;
+    BurstMerger& operator=(const BurstMerger&) = delete;
+
+    /** False if the options were invalid. */
+    bool IsValid() const { return luma_sums_ != nullptr; }
+
+    /** Drops the frames added so far and the stats, to start the next burst. */
+    void Reset();
+
+    /**
+     * Adds a 4:2:0 frame of the configured size in any chroma layout. The translation it was
+     * shifted by is written to {@code shift_x} and {@code shift_y} unless they are null; it is
+     * 0 for the first frame and without alignment.
+     *
+     * @return 0 on success or -1 if the frame does not fit or {@link #kMaxFrames} were added.
+     */
+    int AddFrame(const PlanarImage& frame, StripePool* pool, int* shift_x, int* shift_y);
+
+    /**
+     * Writes the mean of the frames added so far into the 4:2:0 image {@code dst}, which has
+     * the configured size and any chroma layout, e.g. NV12.
+     *
+     * @return 0 on success or -1 if no frame was added or {@code dst} does not fit.
+     */
+    int MergeToYuv(const PlanarImage& dst, StripePool* pool);
+
+    /**
+     * Like {@link #MergeToYuv}, converted to RGBA with the full or studio swing BT.601 matrix.
+     */
+    int MergeToABGR(uint8_t* dst, int dst_stride, bool is_full_swing, StripePool* pool);
+
+    int width() const { return options_.width; }
+    int height() const { return options_.height; }
+
+    const BurstMergeStats& stats() const { return stats_; }
+
+    /** Bytes of memory held by the merger. */
+    size_t memory_size() const {
+        return arena_.capacity() + reference_pyramid_arena_.capacity()
+                + frame_pyramid_arena_.capacity();
+    }
+
+private:
+    // Finds the translation of the frame whose pyramid is frame_levels_.
+    void EstimateShift(StripePool* pool, int* shift_x, int* shift_y) const;
+    // Adds the frame shifted by (shift_x, shift_y) to the sums.
+    void Accumulate(const PlanarImage& frame, int shift_x, int shift_y, StripePool* pool);
+
+    const BurstMergeOptions options_;
+    PyramidOptions pyramid_options_;
+    FrameArena arena_;
+    FrameArena reference_pyramid_arena_;
+    FrameArena frame_pyramid_arena_;
+    std::vector<PyramidLevel> reference_levels_;
+    std::vector<PyramidLevel> frame_levels_;
+    // Luma and interleaved UV chroma of the reference and of the sums, tightly packed.
+    int chroma_row_ = 0;
+    int chroma_height_ = 0;
+    uint16_t* luma_sums_ = nullptr;
+    uint8_t* luma_counts_ = nullptr;
+    uint16_t* chroma_sums_ = nullptr;
+    uint8_t* chroma_counts_ = nullptr;
+    uint8_t* reference_y_ = nullptr;
+    uint8_t* reference_uv_ = nullptr;
+    // NV12 output that is converted to RGBA.
+    uint8_t* merged_ = nullptr;
+    BurstMergeStats stats_;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_BURST_MERGE_H_
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chroma_subsampling.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_CHROMA_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_CHROMA_SSE2 1
+#endif
+
+#include "libyuv/planar_functions.h"
+
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// Averages two rows of count bytes, rounding halves up. If swap is set the two bytes of every
+// pair trade places, which turns interleaved UV into VU.
+void AverageRows(const uint8_t* row0, const uint8_t* row1, int count, int swap, bool simd,
+                 uint8_t* out) {
+    int i = 0;
+#if defined(CAMERAX_CHROMA_NEON)
+    for (; simd && i + 16 <= count; i += 16) {
+        uint8x16_t average = vrhaddq_u8(vld1q_u8(row0 + i), vld1q_u8(row1 + i));
+        vst1q_u8(out + i, swap != 0 ? vrev16q_u8(average) : average);
+    }
+#elif defined(CAMERAX_CHROMA_SSE2)
+    for (; simd && i + 16 <= count; i += 16) {
+        __m128i average = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i)));
+        if (swap != 0) {
+            average = _mm_or_si128(_mm_slli_epi16(average, 8), _mm_srli_epi16(average, 8));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), average);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i ^ swap] = static_cast<uint8_t>((row0[i] + row1[i] + 1) >> 1);
+    }
+}
+
+// Averages the 2x2 blocks of two rows of width samples of kChannels interleaved channels into
+// (width + 1) / 2 samples, rounding halves up. Channel c is written to out[c ^ swap].
+template <int kChannels>
+void AverageBlocks(const uint8_t* row0, const uint8_t* row1, int width, int swap, bool simd,
+                   uint8_t* out) {
+    // Source bytes of the blocks that have two columns.
+    const int count = (width & ~1) * kChannels;
+    int i = 0;
+#if defined(CAMERAX_CHROMA_NEON)
+    if (kChannels == 1) {
+        for (; simd && i + 16 <= count; i += 16) {
+            uint16x8_t sum = vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + i)),
+                                       vpaddlq_u8(vld1q_u8(row1 + i)));
+            vst1_u8(out + i / 2, vrshrn_n_u16(sum, 2));
+        }
+    } else {
+        for (; simd && i + 32 <= count; i += 32) {
+            uint8x16x2_t a = vld2q_u8(row0 + i);
+            uint8x16x2_t b = vld2q_u8(row1 + i);
+            uint8x8_t u = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[0]), vpaddlq_u8(b.val[0])), 2);
+            uint8x8_t v = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[1]), vpaddlq_u8(b.val[1])), 2);
+            uint8x8x2_t pairs;
+            pairs.val[0] = swap != 0 ? v : u;
+            pairs.val[1] = swap != 0 ? u : v;
+            vst2_u8(out + i / 2, pairs);
+        }
+    }
+#elif defined(CAMERAX_CHROMA_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    for (; simd && i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+        __m128i sum;
+        if (kChannels == 1) {
+            // Even and odd bytes as 16-bit lanes, so that adding them sums horizontal pairs.
+            const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+            sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, low_bytes), _mm_srli_epi16(a, 8)),
+                                _mm_add_epi16(_mm_and_si128(b, low_bytes), _mm_srli_epi16(b, 8)));
+        } else {
+            // Every 32-bit lane holds one UV pair; the even and odd lanes are shuffled apart
+            // and added, which sums horizontal pairs of pairs.
+            __m128 low = _mm_castsi128_ps(_mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                                                        _mm_unpacklo_epi8(b, zero)));
+            __m128 high = _mm_castsi128_ps(_mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                                                         _mm_unpackhi_epi8(b, zero)));
+            sum = _mm_add_epi16(
+                    _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))),
+                    _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1))));
+            if (swap != 0) {
+                sum = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sum, _MM_SHUFFLE(2, 3, 0, 1)),
+                                          _MM_SHUFFLE(2, 3, 0, 1));
+            }
+        }
+        sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(sum, sum));
+    }
+#endif
+    const int out_width = (width + 1) / 2;
+    for (int x = i / (2 * kChannels); x < out_width; ++x) {
+        const int x0 = 2 * x * kChannels;
+        const int x1 = std::min(2 * x + 1, width - 1) * kChannels;
+        for (int c = 0; c < kChannels; ++c) {
+            out[x * kChannels + (c ^ swap)] = static_cast<uint8_t>(
+                    (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+        }
+    }
+}
+
+// Downsamples two source rows of kChannels interleaved channels into one output row, along
+// both axes if horizontal is set, else vertically only.
+template <int kChannels>
+void DownsampleRow(const uint8_t* row0, const uint8_t* row1, int width, bool horizontal,
+                   int swap, bool simd, uint8_t* out) {
+    if (horizontal) {
+        AverageBlocks<kChannels>(row0, row1, width, swap, simd, out);
+    } else {
+        AverageRows(row0, row1, width * kChannels, swap, simd, out);
+    }
+}
+
+// DownsampleRow for a single channel with any pixel strides, for flexible chroma layouts.
+void DownsampleStridedRow(const uint8_t* row0, const uint8_t* row1, int pixel_stride,
+                          int width, bool horizontal, uint8_t* out, int out_pixel_stride) {
+    if (!horizontal) {
+        for (int x = 0; x < width; ++x) {
+            const int offset = x * pixel_stride;
+            out[x * out_pixel_stride] =
+                    static_cast<uint8_t>((row0[offset] + row1[offset] + 1) >> 1);
+        }
+        return;
+    }
+    for (int x = 0; x < (width + 1) / 2; ++x) {
+        const int x0 = 2 * x * pixel_stride;
+        const int x1 = std::min(2 * x + 1, width - 1) * pixel_stride;
+        out[x * out_pixel_stride] = static_cast<uint8_t>(
+                (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2);
+    }
+}
+
+bool IsSemiPlanar(ChromaLayout layout) {
+    return layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU;
+}
+
+}  // namespace
+
+int DownsampleChromaTo420(const PlanarImage& src, const PlanarImage& dst) {
+    if (!src.IsValid() || !dst.IsValid() || src.subsampling == ChromaSubsampling::k420
+        || dst.subsampling != ChromaSubsampling::k420 || src.width != dst.width
+        || src.height != dst.height) {
+        return -1;
+    }
+    const bool horizontal = src.subsampling == ChromaSubsampling::k444;
+    const bool simd = GetKernelImpl(Kernel::kChromaDownsample) != KernelImpl::kScalar;
+    const int src_width = src.chroma_width();
+    const int src_height = src.chroma_height();
+    const int dst_width = dst.chroma_width();
+    const ChromaLayout src_layout = src.chroma_layout();
+    const ChromaLayout dst_layout = dst.chroma_layout();
+    // Interleaved planes start at their first sample, whichever channel it belongs to.
+    const Plane src_uv = {std::min(src.u.data, src.v.data), src.u.row_stride, 2};
+    const Plane dst_uv = {std::min(dst.u.data, dst.v.data), dst.u.row_stride, 2};
+    // Rows of pairs or of both planes for layouts that differ, converted with libyuv afterwards.
+    std::vector<uint8_t> row;
+    if (src_layout != dst_layout && src_layout != ChromaLayout::kFlexible
+        && dst_layout != ChromaLayout::kFlexible) {
+        row.resize(static_cast<size_t>(dst_width) * 2);
+    }
+
+    for (int y = 0; y < dst.chroma_height(); ++y) {
+        const int y0 = 2 * y;
+        const int y1 = std::min(y0 + 1, src_height - 1);
+        if (IsSemiPlanar(src_layout) && IsSemiPlanar(dst_layout)) {
+            const int swap = src_layout != dst_layout ? 1 : 0;
+            DownsampleRow<2>(src_uv.RowAt(y0), src_uv.RowAt(y1), src_width, horizontal, swap,
+                             simd, dst_uv.RowAt(y));
+        } else if (IsSemiPlanar(src_layout) && dst_layout == ChromaLayout::kPlanar) {
+            // Averaged as pairs in UV order, then split.
+            const int swap = src_layout == ChromaLayout::kSemiPlanarVU ? 1 : 0;
+            DownsampleRow<2>(src_uv.RowAt(y0), src_uv.RowAt(y1), src_width, horizontal, swap,
+                             simd, row.data());
+            libyuv::SplitUVPlane(row.data(), 0, dst.u.RowAt(y), 0, dst.v.RowAt(y), 0, dst_width,
+                                 1);
+        } else if (src_layout == ChromaLayout::kPlanar && IsSemiPlanar(dst_layout)) {
+            // Averaged plane by plane, then merged in the order of the destination.
+            uint8_t* first = row.data();
+            uint8_t* second = first + dst_width;
+            const bool vu_order = dst_layout == ChromaLayout::kSemiPlanarVU;
+            DownsampleRow<1>(src.u.RowAt(y0), src.u.RowAt(y1), src_width, horizontal, 0, simd,
+                             vu_order ? second : first);
+            DownsampleRow<1>(src.v.RowAt(y0), src.v.RowAt(y1), src_width, horizontal, 0, simd,
+                             vu_order ? first : second);
+            libyuv::MergeUVPlane(first, 0, second, 0, dst_uv.RowAt(y), 0, dst_width, 1);
+        } else if (src_layout == ChromaLayout::kPlanar && dst_layout == ChromaLayout::kPlanar) {
+            DownsampleRow<1>(src.u.RowAt(y0), src.u.RowAt(y1), src_width, horizontal, 0, simd,
+                             dst.u.RowAt(y));
+            DownsampleRow<1>(src.v.RowAt(y0), src.v.RowAt(y1), src_width, horizontal, 0, simd,
+                             dst.v.RowAt(y));
+        } else {
+            DownsampleStridedRow(src.u.RowAt(y0), src.u.RowAt(y1), src.u.pixel_stride,
+                                 src_width, horizontal, dst.u.RowAt(y), dst.u.pixel_stride);
+            DownsampleStridedRow(src.v.RowAt(y0), src.v.RowAt(y1), src.v.pixel_stride,
+                                 src_width, horizontal, dst.v.RowAt(y), dst.v.pixel_stride);
+        }
+    }
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_CHROMA_SUBSAMPLING_H_
+#define CAMERA_CORE_CHROMA_SUBSAMPLING_H_
+
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Downsamples the chroma of the 4:2:2 or 4:4:4 image {@code src} into the 4:2:0 image
+ * {@code dst} of the same size. Every output sample is the rounded average of the 1x2 (4:2:2) or
+ * 2x2 (4:4:4) source samples it covers; the last row and column are repeated for odd sizes.
+ *
+ * <p>Either image may have any chroma layout. Planar and interleaved chroma is averaged with
+ * SIMD, also when the layouts differ; only flexible layouts go sample by sample. Luma is not
+ * touched.
+ *
+ * @return 0 on success or -1 if {@code src} is 4:2:0, {@code dst} is not or the sizes differ.
+ */
+int DownsampleChromaTo420(const PlanarImage& src, const PlanarImage& dst);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_CHROMA_SUBSAMPLING_H_
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "conversion_cache.h"
+
+#include <cstring>
+#include <utility>
+
+namespace camerax {
+
+bool ConversionCache::Lookup(const ConversionKey& key, uint8_t* dst, int dst_stride,
+                             int row_bytes, int rows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry& entry : entries_) {
+        if (!(entry.key == key)) {
+            continue;
+        }
+        if (entry.row_bytes != row_bytes || entry.rows != rows) {
+            return false;
+        }
+        for (int y = 0; y < rows; ++y) {
+            std::memcpy(dst + static_cast<ptrdiff_t>(y) * dst_stride,
+                        entry.data.data() + static_cast<size_t>(y) * row_bytes, row_bytes);
+        }
+        entry.last_use = ++use_counter_;
+        return true;
+    }
+    return false;
+}
+
+void ConversionCache::Insert(const ConversionKey& key, const uint8_t* src, int src_stride,
+                             int row_bytes, int rows) {
+    const size_t bytes = static_cast<size_t>(row_bytes) * rows;
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The old result goes even when the new one is not stored, so lookups never see it again.
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].key == key) {
+            size_bytes_ -= entries_[i].data.size();
+            entries_.erase(entries_.begin() + i);
+            break;
+        }
+    }
+    if (bytes == 0 || bytes > max_bytes_) {
+        return;
+    }
+    EvictFor(bytes);
+
+    Entry entry;
+    entry.key = key;
+    entry.data.resize(bytes);
+    entry.row_bytes = row_bytes;
+    entry.rows = rows;
+    entry.last_use = ++use_counter_;
+    for (int y = 0; y < rows; ++y) {
+        std::memcpy(entry.data.data() + static_cast<size_t>(y) * row_bytes,
+                    src + static_cast<ptrdiff_t>(y) * src_stride, row_bytes);
+    }
+    size_bytes_ += bytes;
+    entries_.push_back(std::move(entry));
+}
+
+void ConversionCache::SetMaxBytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    EvictFor(0);
+}
+
+void ConversionCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    size_bytes_ = 0;
+}
+
+size_t ConversionCache::size_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_bytes_;
+}
+
+void ConversionCache::EvictFor(size_t bytes) {
+    while (!entries_.empty() && size_bytes_ + bytes > max_bytes_) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < entries_.size(); ++i) {
+            if (entries_[i].last_use < entries_[oldest].last_use) {
+                oldest = i;
+            }
+        }
+        size_bytes_ -= entries_[oldest].data.size();
+        entries_.erase(entries_.begin() + oldest);
+    }
+}
+
+}  // namespace camerax
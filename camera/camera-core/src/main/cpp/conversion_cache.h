@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_CONVERSION_CACHE_H_
+#define CAMERA_CORE_CONVERSION_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace camerax {
+
+/**
+ * Identifies the result of converting a frame: the frame itself plus everything that changes
+ * the output.
+ */
+struct ConversionKey {
+    // Content hash of the source, or its timestamp if by_timestamp is set.
+    uint64_t source_id = 0;
+    bool by_timestamp = false;
+    int width = 0;
+    int height = 0;
+    // Output format and any other parameter of the conversion, packed by the caller.
+    uint32_t params = 0;
+
+    bool operator==(const ConversionKey& other) const {
+        return source_id == other.source_id && by_timestamp == other.by_timestamp
+                && width == other.width && height == other.height && params == other.params;
+    }
+};
+
+/**
+ * A small least recently used cache of conversion results, so that consumers asking for the
+ * same frame in the same form get a copy of the first result instead of converting again.
+ *
+ * <p>Results are stored tightly packed and copied out row by row into the caller's buffer. The
+ * cache is thread safe.
+ */
+class ConversionCache {
+public:
+    /** Two 1080p RGBA frames. */
+    static constexpr size_t kDefaultMaxBytes = 2 * 1920 * 1080 * 4;
+
+    explicit ConversionCache(size_t max_bytes = kDefaultMaxBytes) : max_bytes_(max_bytes) {}
+
+    ConversionCache(const ConversionCache&) = delete;
+    ConversionCache& operator=(const ConversionCache&) = delete;
+
+    /**
+     * Copies the result cached for {@code key} into {@code rows} rows of {@code row_bytes}
+     * bytes at {@code dst}.
+     *
+     * @return false if there is no result for the key or it has a different size.
+     */
+    bool Lookup(const ConversionKey& key, uint8_t* dst, int dst_stride, int row_bytes, int rows);
+
+    /**
+     * Stores a copy of the result of converting {@code key}, evicting the least recently used
+     * results until it fits. Results larger than the whole cache are not stored, but still
+     * replace an earlier result for the key.
+     */
+    void Insert(const ConversionKey& key, const uint8_t* src, int src_stride, int row_bytes,
+                int rows);
+
+    /** Changes the size limit, 0 disables the cache. Evicts results that no longer fit. */
+    void SetMaxBytes(size_t max_bytes);
+
+    void Clear();
+
+    size_t size_bytes() const;
+
+private:
+    struct Entry {
+        ConversionKey key;
+        std::vector<uint8_t> data;
+        int row_bytes = 0;
+        int rows = 0;
+        uint64_t last_use = 0;
+    };
+
+    // Evicts least recently used entries until {@code bytes} more fit. Requires mutex_.
+    void EvictFor(size_t bytes);
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+    size_t max_bytes_;
+    size_t size_bytes_ = 0;
+    uint64_t use_counter_ = 0;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_CONVERSION_CACHE_H_
@@ -0,0 +1,394 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "depth_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_DEPTH_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_DEPTH_SSE2 1
+#endif
+
+#include "image_transpose.h"
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+constexpr uint16_t kRangeMask = 0x1FFF;
+constexpr int kConfidenceShift = 13;
+constexpr float kMetersPerMillimeter = 0.001f;
+constexpr float kConfidenceStep = 1.0f / 7;
+// Entries of the colormap, spread evenly between the near and the far range.
+constexpr int kColormapSize = 256;
+
+// The crop rectangle of a request, with an empty one standing for the whole image.
+struct DepthCrop {
+    int left;
+    int top;
+    int width;
+    int height;
+};
+
+bool ResolveCrop(int width, int height, const DepthRequest& request, DepthCrop* crop) {
+    if (request.crop_width <= 0 || request.crop_height <= 0) {
+        *crop = {0, 0, width, height};
+        return width > 0 && height > 0;
+    }
+    *crop = {request.crop_left, request.crop_top, request.crop_width, request.crop_height};
+    return crop->left >= 0 && crop->top >= 0 && crop->left + crop->width <= width
+            && crop->top + crop->height <= height;
+}
+
+bool IsValidRotation(int rotation) {
+    return rotation == 0 || rotation == 90 || rotation == 180 || rotation == 270;
+}
+
+// Row y of the crop after the vertical flip of the orientation.
+const uint16_t* CropRow(const uint16_t* src, int src_stride, const DepthCrop& crop,
+                        bool flip_vertical, int y) {
+    const int row = crop.top + (flip_vertical ? crop.height - 1 - y : y);
+    return src + static_cast<ptrdiff_t>(row) * src_stride + crop.left;
+}
+
+// Destination of 32-bit values that are produced row by row in source orientation. Without
+// rotation the rows go straight to dst, otherwise to a scratch plane that Finish() rotates into
+// dst with the tiled transpose.
+class OrientedRows {
+public:
+    OrientedRows(uint8_t* dst, int dst_stride, int width, int height, int rotation)
+            : dst_(dst), dst_stride_(dst_stride), width_(width), height_(height),
+              rotation_(rotation) {
+        if (rotation_ != 0) {
+            scratch_.resize(static_cast<size_t>(width_) * height_ * 4);
+        }
+    }
+
+    uint8_t* Row(int y) {
+        return rotation_ == 0 ? dst_ + static_cast<ptrdiff_t>(y) * dst_stride_
+                              : scratch_.data() + static_cast<size_t>(y) * width_ * 4;
+    }
+
+    int Finish() {
+        return rotation_ == 0 ? 0 : RotateABGR(scratch_.data(), width_ * 4, dst_, dst_stride_,
+                                               width_, height_, rotation_);
+    }
+
+private:
+    uint8_t* dst_;
+    int dst_stride_;
+    int width_;
+    int height_;
+    int rotation_;
+    std::vector<uint8_t> scratch_;
+};
+
+// Decodes a row of DEPTH16 samples, see Depth16ToFloat. confidence may be null.
+void DecodeRow(const uint16_t* src, int width, bool simd, float* depth, float* confidence) {
+    int x = 0;
+#if defined(CAMERAX_DEPTH_NEON)
+    const uint16x8_t range_mask = vdupq_n_u16(kRangeMask);
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const int32x4_t one = vdupq_n_s32(1);
+    const float32x4_t certain = vdupq_n_f32(1.0f);
+    for (; simd && x + 8 <= width; x += 8) {
+        const uint16x8_t samples = vld1q_u16(src + x);
+        const uint16x8_t range = vandq_u16(samples, range_mask);
+        vst1q_f32(depth + x, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(range))),
+                                         kMetersPerMillimeter));
+        vst1q_f32(depth + x + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(range))),
+                                             kMetersPerMillimeter));
+        if (confidence == nullptr) {
+            continue;
+        }
+        const uint16x8_t codes = vshrq_n_u16(samples, kConfidenceShift);
+        const uint32x4_t halves[2] = {vmovl_u16(vget_low_u16(codes)),
+                                      vmovl_u16(vget_high_u16(codes))};
+        for (int h = 0; h < 2; ++h) {
+            const float32x4_t value = vmulq_n_f32(
+                    vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(halves[h]), one)),
+                    kConfidenceStep);
+            vst1q_f32(confidence + x + 4 * h,
+                      vbslq_f32(vceqq_u32(halves[h], zero), certain, value));
+        }
+    }
+#elif defined(CAMERAX_DEPTH_SSE2)
+    const __m128i range_mask = _mm_set1_epi16(static_cast<int16_t>(kRangeMask));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 scale = _mm_set1_ps(kMetersPerMillimeter);
+    const __m128 step = _mm_set1_ps(kConfidenceStep);
+    const __m128 certain = _mm_set1_ps(1.0f);
+    for (; simd && x + 8 <= width; x += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i range = _mm_and_si128(samples, range_mask);
+        _mm_storeu_ps(depth + x,
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(range, zero)), scale));
+        _mm_storeu_ps(depth + x + 4,
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(range, zero)), scale));
+        if (confidence == nullptr) {
+            continue;
+        }
+        const __m128i codes = _mm_srli_epi16(samples, kConfidenceShift);
+        const __m128i halves[2] = {_mm_unpacklo_epi16(codes, zero),
+                                   _mm_unpackhi_epi16(codes, zero)};
+        for (int h = 0; h < 2; ++h) {
+            const __m128 value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(halves[h], one)),
+                                            step);
+            const __m128 is_certain = _mm_castsi128_ps(_mm_cmpeq_epi32(halves[h], zero));
+            _mm_storeu_ps(confidence + x + 4 * h,
+                          _mm_or_ps(_mm_and_ps(is_certain, certain),
+                                    _mm_andnot_ps(is_certain, value)));
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        depth[x] = static_cast<float>(src[x] & kRangeMask) * kMetersPerMillimeter;
+        if (confidence != nullptr) {
+            const int code = src[x] >> kConfidenceShift;
+            confidence[x] = code == 0 ? 1.0f : static_cast<float>(code - 1) * kConfidenceStep;
+        }
+    }
+}
+
+// The Turbo colormap from blue to red, as packed ABGR pixels.
+const uint32_t* Colormap() {
+    static const std::vector<uint32_t> colormap = [] {
+        // Polynomial fit of Turbo by its authors, accurate to about one 8-bit step.
+        auto channel = [](const double c[6], double t) {
+            const double value = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4]
+                    + t * c[5]))));
+            return static_cast<uint8_t>(std::lround(std::min(std::max(value, 0.0), 1.0) * 255));
+        };
+        static const double kRed[6] = {0.13572138, 4.61539260, -42.66032258, 132.13108234,
+                                       -152.94239396, 59.28637943};
+        static const double kGreen[6] = {0.09140261, 2.19418839, 4.84296658, -14.18503333,
+                                         4.27729857, 2.82956604};
+        static const double kBlue[6] = {0.10667330, 12.64194608, -60.58204836, 110.36276771,
+                                        -89.90310912, 27.34824973};
+        std::vector<uint32_t> table(kColormapSize);
+        for (int i = 0; i < kColormapSize; ++i) {
+            const double t = static_cast<double>(i) / (kColormapSize - 1);
+            const uint8_t pixel[4] = {channel(kRed, t), channel(kGreen, t), channel(kBlue, t),
+                                      255};
+            memcpy(&table[i], pixel, sizeof(pixel));
+        }
+        return table;
+    }();
+    return colormap.data();
+}
+
+// What an orientation does to x and y of a point: x' = sign_x * (swap ? y : x) and
+// y' = sign_y * (swap ? x : y). The orientation's flip comes first, then its clockwise rotation.
+struct PointTransform {
+    bool swap;
+    float sign_x;
+    float sign_y;
+};
+
+PointTransform PointTransformFromOrientation(const Orientation& orientation) {
+    const float flip = orientation.flip_vertical ? -1.0f : 1.0f;
+    switch (orientation.rotation) {
+        case 90:
+            return {true, -flip, 1.0f};
+        case 180:
+            return {false, -1.0f, -flip};
+        case 270:
+            return {true, flip, -1.0f};
+        default:
+            return {false, 1.0f, flip};
+    }
+}
+
+// Packs points [begin, count) with a plain loop and returns the number written in total.
+int PackPointsScalar(const float* points, int begin, int count, const PointTransform& transform,
+                     float min_confidence, float* xyz, int written) {
+    for (int i = begin; i < count; ++i) {
+        const float* p = points + 4 * i;
+        if (!(p[3] >= min_confidence)) {
+            continue;
+        }
+        float* out = xyz + 3 * written++;
+        out[0] = transform.sign_x * (transform.swap ? p[1] : p[0]);
+        out[1] = transform.sign_y * (transform.swap ? p[0] : p[1]);
+        out[2] = p[2];
+    }
+    return written;
+}
+
+#if defined(CAMERAX_DEPTH_NEON) || defined(CAMERAX_DEPTH_SSE2)
+// Packs all but the last point with one vector per point. Every point is stored whole at the
+// end of the output, which the next point overwrites unless this one was dropped, so that
+// dropping points needs no branch. The fourth float lands on the next triple, which is why the
+// last point is left to the scalar loop. Returns the number of points written.
+template <bool kSwap>
+int PackPointsSimd(const float* points, int count, const PointTransform& transform,
+                   float min_confidence, float* xyz) {
+    int written = 0;
+#if defined(CAMERAX_DEPTH_NEON)
+    const uint32_t sign_bits[4] = {transform.sign_x < 0 ? 0x80000000u : 0u,
+                                   transform.sign_y < 0 ? 0x80000000u : 0u, 0u, 0u};
+    const uint32x4_t sign = vld1q_u32(sign_bits);
+    for (int i = 0; i + 1 < count; ++i) {
+        float32x4_t p = vld1q_f32(points + 4 * i);
+        if (kSwap) {
+            p = vcombine_f32(vrev64_f32(vget_low_f32(p)), vget_high_f32(p));
+        }
+        p = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(p), sign));
+        vst1q_f32(xyz + 3 * written, p);
+        written += vgetq_lane_f32(p, 3) >= min_confidence ? 1 : 0;
+    }
+#else
+    const __m128 sign = _mm_castsi128_ps(
+            _mm_setr_epi32(transform.sign_x < 0 ? static_cast<int>(0x80000000u) : 0,
+                           transform.sign_y < 0 ? static_cast<int>(0x80000000u) : 0, 0, 0));
+    const __m128 min = _mm_set1_ps(min_confidence);
+    for (int i = 0; i + 1 < count; ++i) {
+        __m128 p = _mm_loadu_ps(points + 4 * i);
+        if (kSwap) {
+            p = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 2, 0, 1));
+        }
+        p = _mm_xor_ps(p, sign);
+        _mm_storeu_ps(xyz + 3 * written, p);
+        written += (_mm_movemask_ps(_mm_cmpge_ps(p, min)) >> 3) & 1;
+    }
+#endif
+    return written;
+}
+#endif
+
+}  // namespace
+
+int GetDepthOutputSize(int width, int height, const DepthRequest& request,
+                       int* output_width, int* output_height) {
+    DepthCrop crop;
+    if (!ResolveCrop(width, height, request, &crop)) {
+        return -1;
+    }
+    const bool swap = request.orientation.SwapsDimensions();
+    *output_width = swap ? crop.height : crop.width;
+    *output_height = swap ? crop.width : crop.height;
+    return 0;
+}
+
+int Depth16ToFloat(const uint16_t* src, int src_stride, int width, int height,
+                   const DepthRequest& request, float* depth, int depth_stride,
+                   float* confidence, int confidence_stride) {
+    DepthCrop crop;
+    int output_width = 0;
+    int output_height = 0;
+    const int rotation = request.orientation.rotation;
+    if (src == nullptr || depth == nullptr || src_stride < width
+        || !ResolveCrop(width, height, request, &crop) || !IsValidRotation(rotation)
+        || GetDepthOutputSize(width, height, request, &output_width, &output_height) != 0
+        || depth_stride < output_width
+        || (confidence != nullptr && confidence_stride < output_width)) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kDepth) != KernelImpl::kScalar;
+    OrientedRows depth_rows(reinterpret_cast<uint8_t*>(depth), depth_stride * 4, crop.width,
+                            crop.height, rotation);
+    OrientedRows confidence_rows(reinterpret_cast<uint8_t*>(confidence),
+                                 confidence_stride * 4, crop.width,
+                                 confidence != nullptr ? crop.height : 0, rotation);
+    for (int y = 0; y < crop.height; ++y) {
+        DecodeRow(CropRow(src, src_stride, crop, request.orientation.flip_vertical, y),
+                  crop.width, simd, reinterpret_cast<float*>(depth_rows.Row(y)),
+                  confidence != nullptr ? reinterpret_cast<float*>(confidence_rows.Row(y))
+                                        : nullptr);
+    }
+    if (depth_rows.Finish() != 0) {
+        return -1;
+    }
+    return confidence != nullptr ? confidence_rows.Finish() : 0;
+}
+
+int Depth16ToABGR(const uint16_t* src, int src_stride, int width, int height,
+                  const DepthRequest& request, const DepthColorOptions& options,
+                  uint8_t* dst_abgr, int dst_stride_abgr) {
+    DepthCrop crop;
+    int output_width = 0;
+    int output_height = 0;
+    const int rotation = request.orientation.rotation;
+    if (src == nullptr || dst_abgr == nullptr || src_stride < width
+        || options.far_range <= options.near_range
+        || !ResolveCrop(width, height, request, &crop) || !IsValidRotation(rotation)
+        || GetDepthOutputSize(width, height, request, &output_width, &output_height) != 0
+        || dst_stride_abgr < output_width * 4) {
+        return -1;
+    }
+
+    // A color for every possible range and a mask for every confidence, so that a pixel costs
+    // two lookups. The colors fit the L1 cache.
+    const uint32_t* colormap = Colormap();
+    std::vector<uint32_t> colors(kRangeMask + 1);
+    colors[0] = 0;
+    const float range_scale = static_cast<float>(kColormapSize - 1)
+            / static_cast<float>(options.far_range - options.near_range);
+    for (int range = 1; range <= kRangeMask; ++range) {
+        const float t = static_cast<float>(range - options.near_range) * range_scale;
+        const int index = static_cast<int>(std::min(std::max(t, 0.0f),
+                                                    static_cast<float>(kColormapSize - 1)) + 0.5f);
+        colors[range] = colormap[kColormapSize - 1 - index];
+    }
+    uint32_t confident[8];
+    for (int code = 0; code < 8; ++code) {
+        const float value = code == 0 ? 1.0f : static_cast<float>(code - 1) * kConfidenceStep;
+        confident[code] = value >= options.min_confidence ? 0xFFFFFFFFu : 0u;
+    }
+
+    OrientedRows rows(dst_abgr, dst_stride_abgr, crop.width, crop.height, rotation);
+    for (int y = 0; y < crop.height; ++y) {
+        const uint16_t* in = CropRow(src, src_stride, crop, request.orientation.flip_vertical, y);
+        uint8_t* out = rows.Row(y);
+        for (int x = 0; x < crop.width; ++x) {
+            const uint32_t pixel =
+                    colors[in[x] & kRangeMask] & confident[in[x] >> kConfidenceShift];
+            memcpy(out + 4 * x, &pixel, sizeof(pixel));
+        }
+    }
+    return rows.Finish();
+}
+
+int PointCloudToXyz(const float* points, int count, const Orientation& orientation,
+                    float min_confidence, float* xyz) {
+    if (count < 0 || (count > 0 && (points == nullptr || xyz == nullptr))
+        || !IsValidRotation(orientation.rotation)) {
+        return -1;
+    }
+    const PointTransform transform = PointTransformFromOrientation(orientation);
+    int begin = 0;
+    int written = 0;
+#if defined(CAMERAX_DEPTH_NEON) || defined(CAMERAX_DEPTH_SSE2)
+    if (GetKernelImpl(Kernel::kDepth) != KernelImpl::kScalar && count > 1) {
+        written = transform.swap
+                ? PackPointsSimd<true>(points, count, transform, min_confidence, xyz)
+                : PackPointsSimd<false>(points, count, transform, min_confidence, xyz);
+        begin = count - 1;
+    }
+#endif
+    return PackPointsScalar(points, begin, count, transform, min_confidence, xyz, written);
+}
+
+}  // namespace camerax
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_DEPTH_KERNELS_H_
+#define CAMERA_CORE_DEPTH_KERNELS_H_
+
+#include <cstdint>
+
+#include "image_orientation.h"
+
+namespace camerax {
+
+/**
+ * Crop and orientation of a DEPTH16 image. Depth is never resampled, since interpolating
+ * across an object's edge invents points floating between it and the background.
+ */
+struct DepthRequest {
+    // Region of the source to keep, in source coordinates. An empty region keeps the whole
+    // image.
+    int crop_left = 0;
+    int crop_top = 0;
+    int crop_width = 0;
+    int crop_height = 0;
+    Orientation orientation;
+};
+
+/**
+ * How {@link Depth16ToABGR} colors ranges.
+ */
+struct DepthColorOptions {
+    // Ranges mapped to the ends of the colormap, in millimeters. Near ranges are red and far
+    // ones blue, following the Turbo colormap; ranges outside are clamped.
+    int near_range = 200;
+    int far_range = 5000;
+    // Samples less confident than this are transparent, as are those without a range.
+    float min_confidence = 0.0f;
+};
+
+/**
+ * Computes the size of the outputs of the DEPTH16 kernels for a {@code width} x {@code height}
+ * source, i.e. the size of the oriented crop.
+ *
+ * @return 0 on success or -1 if the crop does not fit the source.
+ */
+int GetDepthOutputSize(int width, int height, const DepthRequest& request,
+                       int* output_width, int* output_height);
+
+/**
+ * Decodes DEPTH16 samples into ranges in meters and, if {@code confidence} is not null, their
+ * confidence between 0 and 1. The low 13 bits of a sample are its range in millimeters, 0 for
+ * no measurement, and the top 3 bits its confidence, where 0 stands for 1 and other values c
+ * for (c - 1) / 7. Strides are in samples for {@code src} and in floats for the outputs.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+int Depth16ToFloat(const uint16_t* src, int src_stride, int width, int height,
+                   const DepthRequest& request, float* depth, int depth_stride,
+                   float* confidence, int confidence_stride);
+
+/**
+ * Colors the ranges of DEPTH16 samples for preview, see {@link DepthColorOptions}.
+ * {@code src_stride} is in samples, {@code dst_stride_abgr} in bytes.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+int Depth16ToABGR(const uint16_t* src, int src_stride, int width, int height,
+                  const DepthRequest& request, const DepthColorOptions& options,
+                  uint8_t* dst_abgr, int dst_stride_abgr);
+
+/**
+ * Packs the {x, y, z, confidence} points of a DEPTH_POINT_CLOUD buffer into {x, y, z} triples,
+ * dropping points less confident than {@code min_confidence}. The points are turned about the
+ * optical axis by {@code orientation}, like the pixels of an image of the same camera, so that
+ * they line up with an oriented preview. {@code xyz} needs room for {@code count} triples.
+ *
+ * @return the number of points written, or -1 on invalid arguments.
+ */
+int PointCloudToXyz(const float* points, int count, const Orientation& orientation,
+                    float min_confidence, float* xyz);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_DEPTH_KERNELS_H_
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_arena.h"
+
+namespace camerax {
+
+FrameArena::FrameArena(uint8_t* data, size_t capacity)
+        : data_(data), capacity_(data != nullptr ? capacity : 0), wraps_(true) {}
+
+int FrameArena::Reset(size_t capacity) {
+    used_ = 0;
+    if (capacity <= capacity_) {
+        return 0;
+    }
+    if (wraps_) {
+        return -1;
+    }
+    owned_.reset(new uint8_t[capacity]);
+    data_ = owned_.get();
+    capacity_ = capacity;
+    return 0;
+}
+
+uint8_t* FrameArena::Allocate(size_t bytes) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(data_);
+    const uintptr_t start = (base + used_ + kAlignment - 1) & ~(kAlignment - 1);
+    const size_t offset = start - base;
+    if (data_ == nullptr || offset > capacity_ || bytes > capacity_ - offset) {
+        return nullptr;
+    }
+    used_ = offset + bytes;
+    return data_ + offset;
+}
+
+size_t FrameArena::CapacityFor(size_t bytes, size_t allocation_count) {
+    // Aligning the start of an allocation skips less than one alignment unit, also for the
+    // first one in a block of unknown alignment.
+    return bytes + allocation_count * kAlignment;
+}
+
+}  // namespace camerax
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_FRAME_ARENA_H_
+#define CAMERA_CORE_FRAME_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace camerax {
+
+/**
+ * A bump allocator over one contiguous block of memory, for the buffers that make up the result
+ * of processing one frame. Allocations are never freed one by one; {@link #Reset} drops all of
+ * them at once, so the block can be reused frame after frame without touching the heap.
+ *
+ * <p>The block is either owned by the arena or wraps caller memory, e.g. a direct ByteBuffer.
+ * The arena is not thread safe.
+ */
+class FrameArena {
+public:
+    /** Alignment of every allocation, a cache line on current mobile CPUs. */
+    static constexpr size_t kAlignment = 64;
+
+    FrameArena() = default;
+
+    /** Wraps {@code capacity} bytes of caller memory, which have to outlive the arena. */
+    FrameArena(uint8_t* data, size_t capacity);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Drops all allocations and makes sure at least {@code capacity} bytes can be allocated.
+     * An owned block grows if needed; a wrapped one cannot, and -1 is returned if it is too
+     * small.
+     */
+    int Reset(size_t capacity);
+
+    /**
+     * Returns {@code bytes} of memory aligned to {@link #kAlignment}, or null if the block is
+     * exhausted.
+     */
+    uint8_t* Allocate(size_t bytes);
+
+    /** Start of the block; allocations are reported as offsets from it to Java. */
+    uint8_t* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+
+    /**
+     * Capacity that fits {@code allocation_count} allocations of {@code bytes} in total,
+     * including their alignment padding.
+     */
+    static size_t CapacityFor(size_t bytes, size_t allocation_count);
+
+private:
+    std::unique_ptr<uint8_t[]> owned_;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    bool wraps_ = false;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_FRAME_ARENA_H_
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_ring.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "libyuv/planar_functions.h"
+
+#include "image_kernels.h"
+
+namespace camerax {
+
+namespace {
+
+// Lossless chroma codec. Each U and V sample is predicted by the previous sample of the same
+// channel in its row, and the zigzag coded residuals are packed in blocks of 16 with the fewest
+// bits that fit all of them, after a header byte holding that width. Camera chroma is smooth,
+// so most blocks take 2 or 3 bits per sample.
+constexpr int kCodecBlock = 16;
+// Codes packed into one 64-bit word, at most 8 bits each.
+constexpr int kCodecHalf = kCodecBlock / 2;
+// Prediction of the first sample of a row.
+constexpr int kCodecSeed = 128;
+
+uint8_t ZigZag(int residual) {
+    const int wrapped = static_cast<int8_t>(residual);
+    return static_cast<uint8_t>((wrapped << 1) ^ (wrapped >> 7));
+}
+
+int UnZigZag(uint8_t code) {
+    return (code >> 1) ^ -(code & 1);
+}
+
+size_t MaxEncodedChromaSize(int chroma_width, int chroma_height) {
+    const size_t blocks = (static_cast<size_t>(chroma_width) * 2 + kCodecBlock - 1) / kCodecBlock;
+    return blocks * (kCodecBlock + 1) * chroma_height;
+}
+
+// Encodes one row of U and V samples in NV12 order to out. Returns the bytes written, at most
+// MaxEncodedChromaSize(chroma_width, 1).
+size_t EncodeChromaRow(const uint8_t* u_row, int u_pixel_stride, const uint8_t* v_row,
+                       int v_pixel_stride, int chroma_width, uint8_t* out) {
+    uint8_t* const start = out;
+    uint8_t codes[kCodecBlock];
+    int prev_u = kCodecSeed;
+    int prev_v = kCodecSeed;
+    for (int x = 0; x < chroma_width; x += kCodecBlock / 2) {
+        const int pairs = std::min(kCodecBlock / 2, chroma_width - x);
+        int any_bits = 0;
+        for (int i = 0; i < pairs; ++i) {
+            const int sample_u = u_row[(x + i) * u_pixel_stride];
+            const int sample_v = v_row[(x + i) * v_pixel_stride];
+            codes[2 * i] = ZigZag(sample_u - prev_u);
+            codes[2 * i + 1] = ZigZag(sample_v - prev_v);
+            any_bits |= codes[2 * i] | codes[2 * i + 1];
+            prev_u = sample_u;
+            prev_v = sample_v;
+        }
+        std::fill(codes + 2 * pairs, codes + kCodecBlock, 0);
+        int bits = 0;
+        while ((any_bits >> bits) != 0) {
+            ++bits;
+        }
+        *out++ = static_cast<uint8_t>(bits);
+        for (int half = 0; half < kCodecBlock; half += kCodecHalf) {
+            uint64_t packed = 0;
+            for (int i = 0; i < kCodecHalf; ++i) {
+                packed |= static_cast<uint64_t>(codes[half + i]) << (i * bits);
+            }
+            for (int i = 0; i < bits; ++i) {
+                *out++ = static_cast<uint8_t>(packed >> (8 * i));
+            }
+        }
+    }
+    return static_cast<size_t>(out - start);
+}
+
+// Decodes chroma_height rows written by EncodeChromaRow into an NV12 chroma plane.
+void DecodeChroma(const uint8_t* in, int chroma_width, int chroma_height, uint8_t* dst_uv,
+                  int dst_stride) {
+    uint8_t codes[kCodecBlock];
+    for (int y = 0; y < chroma_height; ++y) {
+        uint8_t* row = dst_uv + static_cast<ptrdiff_t>(y) * dst_stride;
+        int prev_u = kCodecSeed;
+        int prev_v = kCodecSeed;
+        for (int x = 0; x < chroma_width; x += kCodecBlock / 2) {
+            const int pairs = std::min(kCodecBlock / 2, chroma_width - x);
+            const int bits = *in++;
+            const int mask = (1 << bits) - 1;
+            for (int half = 0; half < kCodecBlock; half += kCodecHalf) {
+                uint64_t packed = 0;
+                for (int i = 0; i < bits; ++i) {
+                    packed |= static_cast<uint64_t>(*in++) << (8 * i);
+                }
+                for (int i = 0; i < kCodecHalf; ++i) {
+                    codes[half + i] = static_cast<uint8_t>((packed >> (i * bits)) & mask);
+                }
+            }
+            uint8_t* out = row + 2 * x;
+            for (int i = 0; i < pairs; ++i) {
+                prev_u = (prev_u + UnZigZag(codes[2 * i])) & 0xff;
+                prev_v = (prev_v + UnZigZag(codes[2 * i + 1])) & 0xff;
+                out[2 * i] = static_cast<uint8_t>(prev_u);
+                out[2 * i + 1] = static_cast<uint8_t>(prev_v);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+FrameRing::FrameRing(const FrameRingOptions& options) : options_(options) {
+    if (options.width <= 0 || options.height <= 0 || options.capacity <= 0
+        || options.max_retained < 0) {
+        return;
+    }
+    // Rows are padded to an even width so that every chroma row fits the shared stride.
+    const int stride = (options.width + 1) & ~1;
+    const size_t luma_size = static_cast<size_t>(stride) * options.height;
+    const size_t chroma_size = static_cast<size_t>(stride) * ((options.height + 1) >> 1);
+
+    size_t total = 0;
+    size_t allocation_count = options.capacity;
+    if (options.compress_chroma) {
+        const size_t max_encoded = MaxEncodedChromaSize(stride >> 1, (options.height + 1) >> 1);
+        // The default leaves room for a worst case frame on top, which is skipped when the log
+        // wraps around.
+        chroma_log_size_ = options.chroma_budget_bytes != 0
+                ? std::max(options.chroma_budget_bytes, max_encoded)
+                : chroma_size * options.capacity / 2 + max_encoded;
+        total = luma_size * options.capacity + chroma_log_size_
+                + chroma_size * options.max_retained;
+        allocation_count += 1 + options.max_retained;
+    } else {
+        total = (luma_size + chroma_size) * options.capacity;
+    }
+    if (arena_.Reset(FrameArena::CapacityFor(total, allocation_count)) != 0) {
+        return;
+    }
+
+    slots_.resize(options.capacity);
+    for (Slot& slot : slots_) {
+        if (options.compress_chroma) {
+            slot.y = arena_.Allocate(luma_size);
+        } else {
+            slot.y = arena_.Allocate(luma_size + chroma_size);
+            slot.uv = slot.y + luma_size;
+        }
+    }
+    if (options.compress_chroma) {
+        chroma_log_ = arena_.Allocate(chroma_log_size_);
+        for (int i = 0; i < options.max_retained; ++i) {
+            free_chroma_.push_back(arena_.Allocate(chroma_size));
+        }
+    }
+}
+
+int FrameRing::Push(const PlanarImage& src, int64_t timestamp_ns) {
+    if (!IsValid() || !src.IsValid() || src.subsampling != ChromaSubsampling::k420
+        || src.width != options_.width || src.height != options_.height) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // An empty slot, else the oldest frame that is not retained.
+    int target = -1;
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        if (IsRetained(i)) {
+            continue;
+        }
+        if (!slots_[i].valid) {
+            target = i;
+            break;
+        }
+        if (target < 0 || slots_[i].sequence < slots_[target].sequence) {
+            target = i;
+        }
+    }
+    if (target < 0) {
+        return -1;
+    }
+    Slot& slot = slots_[target];
+    slot.valid = false;
+    slot.chroma_size = 0;
+
+    const int width = options_.width;
+    const int height = options_.height;
+    const int stride = (width + 1) & ~1;
+    if (!options_.compress_chroma) {
+        if (CopyAndroid420(src, WrapNV12(slot.y, width, height, stride, height, false)) != 0) {
+            return -1;
+        }
+    } else {
+        const int chroma_width = src.chroma_width();
+        const int chroma_height = src.chroma_height();
+        if (src.y.pixel_stride == 1) {
+            libyuv::CopyPlane(src.y.data, src.y.row_stride, slot.y, stride, width, height);
+        } else {
+            for (int y = 0; y < height; ++y) {
+                const uint8_t* in = src.y.RowAt(y);
+                uint8_t* out = slot.y + static_cast<size_t>(y) * stride;
+                for (int x = 0; x < width; ++x) {
+                    out[x] = in[x * src.y.pixel_stride];
+                }
+            }
+        }
+        // Written at the head of the log, wrapping around when the worst case does not fit.
+        // Frames are only evicted for the rows actually written, so that well compressed
+        // chroma keeps more of them around.
+        if (chroma_log_head_ + MaxEncodedChromaSize(chroma_width, chroma_height)
+            > chroma_log_size_) {
+            chroma_log_head_ = 0;
+        }
+        const size_t max_row = MaxEncodedChromaSize(chroma_width, 1);
+        slot.chroma_offset = chroma_log_head_;
+        for (int y = 0; y < chroma_height; ++y) {
+            EvictChroma(chroma_log_head_, chroma_log_head_ + max_row);
+            chroma_log_head_ += EncodeChromaRow(src.u.RowAt(y), src.u.pixel_stride,
+                                                src.v.RowAt(y), src.v.pixel_stride,
+                                                chroma_width, chroma_log_ + chroma_log_head_);
+        }
+        slot.chroma_size = chroma_log_head_ - slot.chroma_offset;
+    }
+    slot.timestamp_ns = timestamp_ns;
+    slot.sequence = next_sequence_++;
+    slot.valid = true;
+    return target;
+}
+
+int FrameRing::Acquire(int64_t timestamp_ns, int64_t tolerance_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int best = -1;
+    int64_t best_distance = 0;
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        if (!slots_[i].valid) {
+            continue;
+        }
+        const int64_t distance = std::llabs(slots_[i].timestamp_ns - timestamp_ns);
+        if (distance <= tolerance_ns && (best < 0 || distance < best_distance)) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    if (best < 0) {
+        return -1;
+    }
+    Slot& slot = slots_[best];
+    if (options_.compress_chroma && slot.retain_count == 0) {
+        if (free_chroma_.empty()) {
+            return -1;
+        }
+        slot.uv = free_chroma_.back();
+        free_chroma_.pop_back();
+        DecodeChroma(chroma_log_ + slot.chroma_offset, (options_.width + 1) >> 1,
+                     (options_.height + 1) >> 1, slot.uv, (options_.width + 1) & ~1);
+    } else if (!options_.compress_chroma && slot.retain_count == 0) {
+        int retained = 0;
+        for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+            retained += IsRetained(i) ? 1 : 0;
+        }
+        if (retained >= options_.max_retained) {
+            return -1;
+        }
+    }
+    ++slot.retain_count;
+    return best;
+}
+
+int FrameRing::Release(int slot_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!IsRetained(slot_index)) {
+        return -1;
+    }
+    Slot& slot = slots_[slot_index];
+    if (--slot.retain_count == 0 && options_.compress_chroma) {
+        free_chroma_.push_back(slot.uv);
+        slot.uv = nullptr;
+        // The decoded chroma was the only copy left once the log moved past the frame.
+        slot.valid = slot.chroma_size != 0;
+    }
+    return 0;
+}
+
+PlanarImage FrameRing::GetFrame(int slot_index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!IsRetained(slot_index)) {
+        return PlanarImage();
+    }
+    const Slot& slot = slots_[slot_index];
+    const int stride = (options_.width + 1) & ~1;
+    return WrapAndroid420(slot.y, stride, 1, slot.uv, stride, slot.uv + 1, 2, options_.width,
+                          options_.height);
+}
+
+int64_t FrameRing::GetTimestamp(int slot_index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return IsRetained(slot_index) ? slots_[slot_index].timestamp_ns : -1;
+}
+
+int FrameRing::frame_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int count = 0;
+    for (const Slot& slot : slots_) {
+        count += slot.valid ? 1 : 0;
+    }
+    return count;
+}
+
+bool FrameRing::IsRetained(int slot) const {
+    return slot >= 0 && slot < static_cast<int>(slots_.size()) && slots_[slot].retain_count > 0;
+}
+
+void FrameRing::EvictChroma(size_t begin, size_t end) {
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        Slot& slot = slots_[i];
+        if (slot.chroma_size == 0 || slot.chroma_offset >= end
+            || slot.chroma_offset + slot.chroma_size <= begin) {
+            continue;
+        }
+        slot.chroma_size = 0;
+        // A retained frame lives on in its decoded chroma until it is released.
+        if (!IsRetained(i)) {
+            slot.valid = false;
+        }
+    }
+}
+
+}  // namespace camerax
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_FRAME_RING_H_
+#define CAMERA_CORE_FRAME_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "frame_arena.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Configuration of a {@link FrameRing}.
+ */
+struct FrameRingOptions {
+    int width = 0;
+    int height = 0;
+    // Number of frames the ring holds.
+    int capacity = 8;
+    // Number of frames that can be retained at the same time.
+    int max_retained = 2;
+    // Stores the chroma losslessly compressed in a shared log instead of once per frame.
+    bool compress_chroma = false;
+    // Size of the compressed chroma log, 0 picks half the raw chroma of all frames plus one
+    // frame of slack. When the log fills up faster than frames are pushed out, the oldest
+    // frames are dropped early.
+    size_t chroma_budget_bytes = 0;
+};
+
+/**
+ * Keeps the last frames of a stream in packed NV12 for zero-shutter-lag capture on devices
+ * without HAL ZSL. All memory is allocated once from a {@link FrameArena}, so pushing a frame
+ * only copies it and never allocates.
+ *
+ * <p>A frame looked up by timestamp is retained: it is not overwritten until released and can be
+ * handed to the rotate, convert and JPEG kernels in place. With compressed chroma, retaining a
+ * frame decodes its chroma into one of {@code max_retained} spare planes.
+ *
+ * <p>The ring is thread safe. Push holds the lock while copying, which takes well under a
+ * millisecond for a preview frame.
+ */
+class FrameRing {
+public:
+    explicit FrameRing(const FrameRingOptions& options);
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /** False if the options were invalid. */
+    bool IsValid() const { return !slots_.empty(); }
+
+    /**
+     * Copies {@code src}, which must have the size of the ring, in place of the oldest frame
+     * that is not retained.
+     *
+     * @return the slot of the frame, or -1 if the size does not match, the image is not 4:2:0 or
+     * every slot is retained.
+     */
+    int Push(const PlanarImage& src, int64_t timestamp_ns);
+
+    /**
+     * Retains the frame closest to {@code timestamp_ns} that is at most {@code tolerance_ns}
+     * away, so that it stays readable until {@link #Release}. A frame can be retained more than
+     * once.
+     *
+     * @return the slot of the frame, or -1 if there is none or no more frames can be retained.
+     */
+    int Acquire(int64_t timestamp_ns, int64_t tolerance_ns);
+
+    /** Drops one retain of the frame in {@code slot}. Returns -1 if it was not retained. */
+    int Release(int slot);
+
+    /**
+     * Returns the NV12 image of a retained frame, or an invalid image if {@code slot} is not
+     * retained. The planes are tightly packed.
+     */
+    PlanarImage GetFrame(int slot) const;
+
+    /** Timestamp of a retained frame, or -1. */
+    int64_t GetTimestamp(int slot) const;
+
+    /** Number of frames that can currently be looked up. */
+    int frame_count() const;
+
+    /** Bytes of memory held by the ring. */
+    size_t memory_size() const { return arena_.capacity(); }
+
+private:
+    struct Slot {
+        uint8_t* y = nullptr;
+        // Raw chroma, or the decoded chroma while a compressed frame is retained.
+        uint8_t* uv = nullptr;
+        int64_t timestamp_ns = 0;
+        uint64_t sequence = 0;
+        bool valid = false;
+        int retain_count = 0;
+        // Compressed chroma in the log, empty once it was overwritten.
+        size_t chroma_offset = 0;
+        size_t chroma_size = 0;
+    };
+
+    bool IsRetained(int slot) const;
+    // Drops the compressed chroma of the frames overlapping [begin, end) of the log.
+    void EvictChroma(size_t begin, size_t end);
+
+    const FrameRingOptions options_;
+    mutable std::mutex mutex_;
+    FrameArena arena_;
+    std::vector<Slot> slots_;
+    // Spare chroma planes that retained compressed frames are decoded into.
+    std::vector<uint8_t*> free_chroma_;
+    uint8_t* chroma_log_ = nullptr;
+    size_t chroma_log_size_ = 0;
+    size_t chroma_log_head_ = 0;
+    uint64_t next_sequence_ = 0;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_FRAME_RING_H_
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hardware_buffer_planes.h"
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+
+namespace camerax {
+
+#ifdef __ANDROID__
+namespace {
+
+typedef int (*LockPlanesFn)(AHardwareBuffer*, uint64_t, int32_t, const ARect*,
+                            AHardwareBuffer_Planes*);
+typedef int (*UnlockFn)(AHardwareBuffer*, int32_t*);
+typedef void (*DescribeFn)(const AHardwareBuffer*, AHardwareBuffer_Desc*);
+
+struct HardwareBufferApi {
+    LockPlanesFn lock_planes = nullptr;
+    UnlockFn unlock = nullptr;
+    DescribeFn describe = nullptr;
+};
+
+const HardwareBufferApi& GetHardwareBufferApi() {
+    static const HardwareBufferApi api = [] {
+        HardwareBufferApi result;
+        void* lib = dlopen("libandroid.so", RTLD_NOW);
+        if (lib != nullptr) {
+            result.lock_planes = reinterpret_cast<LockPlanesFn>(
+                    dlsym(lib, "AHardwareBuffer_lockPlanes"));
+            result.unlock = reinterpret_cast<UnlockFn>(dlsym(lib, "AHardwareBuffer_unlock"));
+            result.describe = reinterpret_cast<DescribeFn>(
+                    dlsym(lib, "AHardwareBuffer_describe"));
+        }
+        return result;
+    }();
+    return api;
+}
+
+}  // namespace
+
+bool HardwareBufferPlaneProvider::IsSupported() {
+    const HardwareBufferApi& api = GetHardwareBufferApi();
+    return api.lock_planes != nullptr && api.unlock != nullptr && api.describe != nullptr;
+}
+
+int HardwareBufferPlaneProvider::Lock(bool write, PlanarImage* image) {
+    if (buffer_ == nullptr || !IsSupported()) {
+        return -1;
+    }
+    const HardwareBufferApi& api = GetHardwareBufferApi();
+
+    AHardwareBuffer_Desc desc;
+    api.describe(buffer_, &desc);
+    if (desc.format != AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420) {
+        return -1;
+    }
+
+    uint64_t usage = write ? AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN
+                           : AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN;
+    AHardwareBuffer_Planes planes;
+    if (api.lock_planes(buffer_, usage, /* fence= */ -1, /* rect= */ nullptr, &planes) != 0) {
+        return -1;
+    }
+    if (planes.planeCount < 3) {
+        api.unlock(buffer_, nullptr);
+        return -1;
+    }
+
+    // All chroma planes of a YUV_420_888 buffer share the row and pixel strides.
+    *image = WrapAndroid420(static_cast<uint8_t*>(planes.planes[0].data),
+                            static_cast<int>(planes.planes[0].rowStride),
+                            static_cast<int>(planes.planes[0].pixelStride),
+                            static_cast<uint8_t*>(planes.planes[1].data),
+                            static_cast<int>(planes.planes[1].rowStride),
+                            static_cast<uint8_t*>(planes.planes[2].data),
+                            static_cast<int>(planes.planes[1].pixelStride),
+                            static_cast<int>(desc.width),
+                            static_cast<int>(desc.height));
+    return 0;
+}
+
+void HardwareBufferPlaneProvider::Unlock() {
+    GetHardwareBufferApi().unlock(buffer_, nullptr);
+}
+#endif  // __ANDROID__
+
+}  // namespace camerax
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_HARDWARE_BUFFER_PLANES_H_
+#define CAMERA_CORE_HARDWARE_BUFFER_PLANES_H_
+
+#include <cstdint>
+
+#include "image_planes.h"
+
+#ifdef __ANDROID__
+#include <android/hardware_buffer.h>
+#endif
+
+namespace camerax {
+
+/**
+ * A source of YUV_420_888 planes that has to be locked before its memory can be accessed by the
+ * CPU, such as an AHardwareBuffer.
+ */
+class PlaneProvider {
+public:
+    virtual ~PlaneProvider() = default;
+
+    /**
+     * Locks the underlying memory and fills {@code image} with its plane layout. Returns 0 on
+     * success or a negative value otherwise.
+     */
+    virtual int Lock(bool write, PlanarImage* image) = 0;
+
+    virtual void Unlock() = 0;
+};
+
+/**
+ * Locks a {@link PlaneProvider} for the lifetime of the object.
+ */
+class ScopedPlaneLock {
+public:
+    ScopedPlaneLock(PlaneProvider* provider, bool write)
+            : provider_(provider), result_(provider->Lock(write, &image_)) {}
+
+    ~ScopedPlaneLock() {
+        if (result_ == 0) {
+            provider_->Unlock();
+        }
+    }
+
+    ScopedPlaneLock(const ScopedPlaneLock&) = delete;
+    ScopedPlaneLock& operator=(const ScopedPlaneLock&) = delete;
+
+    bool ok() const { return result_ == 0; }
+    const PlanarImage& image() const { return image_; }
+
+private:
+    PlaneProvider* provider_;
+    PlanarImage image_;
+    int result_;
+};
+
+#ifdef __ANDROID__
+/**
+ * Provides the planes of an AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420 hardware buffer through
+ * AHardwareBuffer_lockPlanes. The entry points are resolved at runtime since they are only
+ * available from API level 29.
+ */
+class HardwareBufferPlaneProvider : public PlaneProvider {
+public:
+    explicit HardwareBufferPlaneProvider(AHardwareBuffer* buffer) : buffer_(buffer) {}
+
+    /** Returns whether AHardwareBuffer_lockPlanes is available on this device. */
+    static bool IsSupported();
+
+    int Lock(bool write, PlanarImage* image) override;
+    void Unlock() override;
+
+private:
+    AHardwareBuffer* buffer_;
+};
+#endif  // __ANDROID__
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_HARDWARE_BUFFER_PLANES_H_
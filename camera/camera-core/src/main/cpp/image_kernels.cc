@@ -0,0 +1,621 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/rotate_argb.h"
+#include "libyuv/convert.h"
+#include "libyuv/planar_functions.h"
+
+#include "chroma_subsampling.h"
+#include "image_transpose.h"
+
+namespace camerax {
+
+static libyuv::RotationMode get_rotation_mode(int rotation) {
+    libyuv::RotationMode mode = libyuv::kRotate0;
+    switch (rotation) {
+        case 0:
+            mode = libyuv::kRotate0;
+            break;
+        case 90:
+            mode = libyuv::kRotate90;
+            break;
+        case 180:
+            mode = libyuv::kRotate180;
+            break;
+        case 270:
+            mode = libyuv::kRotate270;
+            break;
+        default:
+            break;
+    }
+    return mode;
+}
+
+static int Android420ToABGR(const uint8_t* src_y,
+                            int src_stride_y,
+                            const uint8_t* src_u,
+                            int src_stride_u,
+                            const uint8_t* src_v,
+                            int src_stride_v,
+                            int src_pixel_stride_uv,
+                            uint8_t* dst_abgr,
+                            int dst_stride_abgr,
+                            bool is_full_swing,
+                            int width,
+                            int height) {
+    // ABGR is ARGB with U and V swapped, hence the YVU constants.
+    return libyuv::Android420ToARGBMatrix(src_y,
+                                          src_stride_y,
+                                          src_v,
+                                          src_stride_v,
+                                          src_u,
+                                          src_stride_u,
+                                          src_pixel_stride_uv,
+                                          dst_abgr,
+                                          dst_stride_abgr,
+                                          is_full_swing ? &libyuv::kYvuJPEGConstants
+                                                        : &libyuv::kYvuI601Constants,
+                                          width,
+                                          height);
+}
+
+// Copies width x height samples one by one, for pixel strides libyuv has no kernel for.
+static void CopySamples(const Plane& src, const Plane& dst, int width, int height) {
+    for (int i = 0; i < height; i++) {
+        const uint8_t* src_row = src.RowAt(i);
+        uint8_t* dst_row = dst.RowAt(i);
+        for (int j = 0; j < width; j++) {
+            dst_row[j * dst.pixel_stride] = src_row[j * src.pixel_stride];
+        }
+    }
+}
+
+// Converts a 4:2:2 or 4:4:4 image to ABGR. Planar chroma is converted in one call, other layouts
+// are split into planar bands of kChromaBandRows rows first.
+static int AndroidYuvToABGR(const PlanarImage& src, uint8_t* dst_abgr, int dst_stride_abgr,
+                            bool is_full_swing) {
+    constexpr int kChromaBandRows = 16;
+    const auto convert = src.subsampling == ChromaSubsampling::k444 ? libyuv::I444ToARGBMatrix
+                                                                    : libyuv::I422ToARGBMatrix;
+    // ABGR is ARGB with U and V swapped, hence the YVU constants.
+    const libyuv::YuvConstants* constants = is_full_swing ? &libyuv::kYvuJPEGConstants
+                                                          : &libyuv::kYvuI601Constants;
+    const ChromaLayout layout = src.chroma_layout();
+    if (layout == ChromaLayout::kPlanar) {
+        return convert(src.y.data, src.y.row_stride, src.v.data, src.v.row_stride,
+                       src.u.data, src.u.row_stride, dst_abgr, dst_stride_abgr, constants,
+                       src.width, src.height);
+    }
+
+    // The chroma has as many rows as luma, so a band of luma rows is a band of chroma rows.
+    const int chroma_width = src.chroma_width();
+    std::vector<uint8_t> band(static_cast<size_t>(chroma_width) * kChromaBandRows * 2);
+    const Plane band_u = {band.data(), chroma_width, 1};
+    const Plane band_v = {band.data() + static_cast<size_t>(chroma_width) * kChromaBandRows,
+                          chroma_width, 1};
+    for (int top = 0; top < src.height; top += kChromaBandRows) {
+        const int rows = std::min(kChromaBandRows, src.height - top);
+        const PlanarImage band_src = CropPlanarImage(src, 0, top, src.width, rows);
+        if (layout == ChromaLayout::kSemiPlanarUV) {
+            libyuv::SplitUVPlane(band_src.u.data, band_src.u.row_stride, band_u.data,
+                                 band_u.row_stride, band_v.data, band_v.row_stride,
+                                 chroma_width, rows);
+        } else if (layout == ChromaLayout::kSemiPlanarVU) {
+            libyuv::SplitUVPlane(band_src.v.data, band_src.v.row_stride, band_v.data,
+                                 band_v.row_stride, band_u.data, band_u.row_stride,
+                                 chroma_width, rows);
+        } else {
+            CopySamples(band_src.u, band_u, chroma_width, rows);
+            CopySamples(band_src.v, band_v, chroma_width, rows);
+        }
+        int result = convert(band_src.y.data, band_src.y.row_stride,
+                             band_v.data, band_v.row_stride, band_u.data, band_u.row_stride,
+                             dst_abgr + static_cast<ptrdiff_t>(top) * dst_stride_abgr,
+                             dst_stride_abgr, constants, src.width, rows);
+        if (result != 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+int Android420ToABGR(const PlanarImage& src, uint8_t* dst_abgr, int dst_stride_abgr,
+                     bool is_full_swing) {
+    if (src.subsampling != ChromaSubsampling::k420) {
+        return AndroidYuvToABGR(src, dst_abgr, dst_stride_abgr, is_full_swing);
+    }
+    return Android420ToABGR(src.y.data, src.y.row_stride,
+                            src.u.data, src.u.row_stride,
+                            src.v.data, src.v.row_stride,
+                            src.u.pixel_stride,
+                            dst_abgr, dst_stride_abgr,
+                            is_full_swing,
+                            src.width, src.height);
+}
+
+// Converts an image whose samples are shifted by one pixel, see PixelShift.
+static int Android420ToABGRShifted(const PlanarImage& src,
+                                   const PixelShift& shift,
+                                   uint8_t* dst_ptr,
+                                   int dst_stride_y) {
+    // TODO(b/195990691): extend the pixel shift to handle multiple corrupted pixels.
+    // We don't support multiple pixel shift now.
+    if (src.subsampling != ChromaSubsampling::k420
+        || shift.start_offset_y != src.y.pixel_stride
+        || shift.start_offset_u != src.u.pixel_stride
+        || shift.start_offset_v != src.v.pixel_stride) {
+        return -1;
+    }
+
+    const int width = src.width;
+    const int height = src.height;
+    uint8_t* src_y_ptr = src.y.data + shift.start_offset_y;
+    uint8_t* src_u_ptr = src.u.data + shift.start_offset_u;
+    uint8_t* src_v_ptr = src.v.data + shift.start_offset_v;
+
+    // Convert yuv to rgb except the last line.
+    int result = Android420ToABGR(src_y_ptr,
+                                  src.y.row_stride,
+                                  src_u_ptr,
+                                  src.u.row_stride,
+                                  src_v_ptr,
+                                  src.v.row_stride,
+                                  src.u.pixel_stride,
+                                  dst_ptr,
+                                  dst_stride_y,
+                                  /* is_full_swing = */true,
+                                  width,
+                                  height - 1);
+    if (result == 0) {
+        // Convert the last row with (width - 1) pixels
+        // since the last pixel's yuv data is missing.
+        result = Android420ToABGR(
+                src_y_ptr + src.y.row_stride * (height - 1),
+                src.y.row_stride - 1,
+                src_u_ptr + src.u.row_stride * (height - 2) / 2,
+                src.u.row_stride - 1,
+                src_v_ptr + src.v.row_stride * (height - 2) / 2,
+                src.v.row_stride - 1,
+                src.u.pixel_stride,
+                dst_ptr + dst_stride_y * (height - 1),
+                dst_stride_y,
+                /* is_full_swing = */true,
+                width - 1,
+                1);
+    }
+
+    if (result == 0) {
+        // Set the 2x2 pixels on the right bottom by duplicating the 3rd pixel
+        // from the right to left in each row.
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) {
+                int r_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 1);
+                int g_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 2);
+                int b_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 3);
+                int a_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 4);
+                dst_ptr[r_ind] = dst_ptr[r_ind - 8];
+                dst_ptr[g_ind] = dst_ptr[g_ind - 8];
+                dst_ptr[b_ind] = dst_ptr[b_ind - 8];
+                dst_ptr[a_ind] = dst_ptr[a_ind - 8];
+            }
+        }
+    }
+    return result;
+}
+
+int Android420ToRotatedABGR(const PlanarImage& src,
+                            const PixelShift& shift,
+                            uint8_t* scratch,
+                            uint8_t* dst_abgr,
+                            int dst_stride_abgr,
+                            const Orientation& orientation) {
+    bool has_rotation = orientation.rotation != 0;
+    if (has_rotation && scratch == nullptr) {
+        return -1;
+    }
+
+    uint8_t* dst_ptr = has_rotation ? scratch : dst_abgr;
+    int dst_stride_y = has_rotation ? (src.width * 4) : dst_stride_abgr;
+    if (orientation.flip_vertical) {
+        // Writes the converted rows bottom up.
+        dst_ptr += static_cast<ptrdiff_t>(src.height - 1) * dst_stride_y;
+        dst_stride_y = -dst_stride_y;
+    }
+
+    int result;
+    // Apply workaround for one pixel shift issue by checking offset.
+    if (shift.IsShifted()) {
+        result = Android420ToABGRShifted(src, shift, dst_ptr, dst_stride_y);
+    } else {
+        result = Android420ToABGR(src, dst_ptr, dst_stride_y, /* is_full_swing = */true);
+    }
+
+    // TODO(b/203141655): avoid unnecessary memory copy by merging libyuv API for rotation.
+    if (result == 0 && has_rotation) {
+        result = RotateABGR(scratch,
+                            src.width * 4,
+                            dst_abgr,
+                            dst_stride_abgr,
+                            src.width,
+                            src.height,
+                            orientation.rotation);
+    }
+    return result;
+}
+
+int Android420ToRotatedABGRInBands(const PlanarImage& src,
+                                   uint8_t* dst_abgr,
+                                   int dst_stride_abgr,
+                                   const Orientation& orientation,
+                                   size_t budget_bytes) {
+    if (!src.IsValid() || dst_abgr == nullptr) {
+        return -1;
+    }
+    const int width = src.width;
+    const int height = src.height;
+    const int rotation = orientation.rotation;
+    const bool flip = orientation.flip_vertical;
+    if (rotation == 0) {
+        // Nothing to reorder, the rows are converted in place.
+        if (flip) {
+            dst_abgr += static_cast<ptrdiff_t>(height - 1) * dst_stride_abgr;
+            dst_stride_abgr = -dst_stride_abgr;
+        }
+        return Android420ToABGR(src, dst_abgr, dst_stride_abgr, /* is_full_swing = */true);
+    }
+
+    // Bands start on even source rows so that they share chroma rows with nobody else, and
+    // multiples of 16 rows keep the transposes on their SIMD blocks. The flip is applied while
+    // converting a band, which keeps odd heights exact.
+    const size_t row_bytes = static_cast<size_t>(width) * 4;
+    int band_rows = static_cast<int>(std::min<size_t>(budget_bytes / row_bytes, height));
+    band_rows = band_rows >= 16 ? band_rows & ~15 : std::max(2, band_rows & ~1);
+    std::vector<uint8_t> band(row_bytes * band_rows);
+
+    for (int top = 0; top < height; top += band_rows) {
+        const int rows = std::min(band_rows, height - top);
+        const PlanarImage band_src = CropPlanarImage(src, 0, top, width, rows);
+        uint8_t* band_ptr = band.data();
+        int band_stride = static_cast<int>(row_bytes);
+        if (flip) {
+            band_ptr += (rows - 1) * row_bytes;
+            band_stride = -band_stride;
+        }
+        int result = Android420ToABGR(band_src, band_ptr, band_stride, /* is_full_swing = */true);
+        if (result != 0) {
+            return result;
+        }
+        // Where the band lands: a column strip for 90 and 270 degrees, a row strip for 180.
+        const int flipped_top = flip ? height - top - rows : top;
+        uint8_t* dst;
+        switch (rotation) {
+            case 90:
+                dst = dst_abgr + static_cast<ptrdiff_t>(height - flipped_top - rows) * 4;
+                break;
+            case 270:
+                dst = dst_abgr + static_cast<ptrdiff_t>(flipped_top) * 4;
+                break;
+            case 180:
+                dst = dst_abgr
+                        + static_cast<ptrdiff_t>(height - flipped_top - rows) * dst_stride_abgr;
+                break;
+            default:
+                return -1;
+        }
+        result = RotateABGR(band.data(), static_cast<int>(row_bytes), dst, dst_stride_abgr,
+                            width, rows, rotation);
+        if (result != 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+int RotateAndroid420ToI420(const PlanarImage& image, const PlanarImage& dst,
+                           const Orientation& orientation) {
+    if (dst.chroma_layout() != ChromaLayout::kPlanar
+        || dst.subsampling != ChromaSubsampling::k420) {
+        return -1;
+    }
+    if (image.subsampling != ChromaSubsampling::k420) {
+        // The chroma is downsampled first, into planes of the same layout so that interleaved
+        // chroma keeps its fast paths, and the 4:2:0 result is oriented as usual. Luma is read
+        // straight from the source.
+        PlanarImage downsampled = image;
+        downsampled.subsampling = ChromaSubsampling::k420;
+        const int chroma_width = downsampled.chroma_width();
+        const int chroma_height = downsampled.chroma_height();
+        std::vector<uint8_t> chroma(static_cast<size_t>(chroma_width) * chroma_height * 2);
+        const ChromaLayout layout = image.chroma_layout();
+        if (layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU) {
+            const bool vu_order = layout == ChromaLayout::kSemiPlanarVU;
+            downsampled.u = {chroma.data() + (vu_order ? 1 : 0), chroma_width * 2, 2};
+            downsampled.v = {chroma.data() + (vu_order ? 0 : 1), chroma_width * 2, 2};
+        } else {
+            downsampled.u = {chroma.data(), chroma_width, 1};
+            downsampled.v = {chroma.data() + static_cast<size_t>(chroma_width) * chroma_height,
+                             chroma_width, 1};
+        }
+        if (DownsampleChromaTo420(image, downsampled) != 0) {
+            return -1;
+        }
+        return RotateAndroid420ToI420(downsampled, dst, orientation);
+    }
+    if (image.chroma_layout() == ChromaLayout::kFlexible && orientation.rotation != 0) {
+        // libyuv only rotates planar or interleaved chroma, so other layouts, e.g. padded
+        // samples in separate planes, are repacked into planar chroma first.
+        PlanarImage repacked = image;
+        const int chroma_width = image.chroma_width();
+        const int chroma_height = image.chroma_height();
+        std::vector<uint8_t> chroma(static_cast<size_t>(chroma_width) * chroma_height * 2);
+        repacked.u = {chroma.data(), chroma_width, 1};
+        repacked.v = {chroma.data() + static_cast<size_t>(chroma_width) * chroma_height,
+                      chroma_width, 1};
+        CopySamples(image.u, repacked.u, chroma_width, chroma_height);
+        CopySamples(image.v, repacked.v, chroma_width, chroma_height);
+        return RotateAndroid420ToI420(repacked, dst, orientation);
+    }
+    const PlanarImage src = orientation.flip_vertical ? FlipPlanarImage(image) : image;
+    if (orientation.SwapsDimensions() && src.y.pixel_stride == 1) {
+        // The cache-blocked transposes outperform libyuv on large frames, whose rotation
+        // otherwise writes every sample to a different cache line.
+        const ChromaLayout layout = src.chroma_layout();
+        const int rotation = orientation.rotation;
+        if (layout == ChromaLayout::kPlanar) {
+            RotatePlaneTiled(src.y.data, src.y.row_stride, dst.y.data, dst.y.row_stride,
+                             src.width, src.height, rotation);
+            RotatePlaneTiled(src.u.data, src.u.row_stride, dst.u.data, dst.u.row_stride,
+                             src.chroma_width(), src.chroma_height(), rotation);
+            RotatePlaneTiled(src.v.data, src.v.row_stride, dst.v.data, dst.v.row_stride,
+                             src.chroma_width(), src.chroma_height(), rotation);
+            return 0;
+        }
+        if (layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU) {
+            const bool vu_order = layout == ChromaLayout::kSemiPlanarVU;
+            RotatePlaneTiled(src.y.data, src.y.row_stride, dst.y.data, dst.y.row_stride,
+                             src.width, src.height, rotation);
+            RotateUVPlaneTiled(vu_order ? src.v.data : src.u.data, src.u.row_stride,
+                               vu_order ? dst.v.data : dst.u.data,
+                               vu_order ? dst.v.row_stride : dst.u.row_stride,
+                               vu_order ? dst.u.data : dst.v.data,
+                               vu_order ? dst.u.row_stride : dst.v.row_stride,
+                               src.chroma_width(), src.chroma_height(), rotation);
+            return 0;
+        }
+    }
+    return libyuv::Android420ToI420Rotate(src.y.data,
+                                          src.y.row_stride,
+                                          src.u.data,
+                                          src.u.row_stride,
+                                          src.v.data,
+                                          src.v.row_stride,
+                                          src.u.pixel_stride,
+                                          dst.y.data,
+                                          dst.y.row_stride,
+                                          dst.u.data,
+                                          dst.u.row_stride,
+                                          dst.v.data,
+                                          dst.v.row_stride,
+                                          src.width,
+                                          src.height,
+                                          get_rotation_mode(orientation.rotation));
+}
+
+int RotateAndroid420(const PlanarImage& image,
+                     const PlanarImage& dst,
+                     uint8_t* rotated_y_ptr,
+                     uint8_t* rotated_u_ptr,
+                     uint8_t* rotated_v_ptr,
+                     const Orientation& orientation) {
+    const int width = image.width;
+    const int height = image.height;
+    int halfwidth = (width + 1) >> 1;
+    int halfheight = (height + 1) >> 1;
+
+    bool flip_wh = orientation.SwapsDimensions();
+
+    int rotated_stride_y = flip_wh ? height : width;
+    int rotated_stride_u = flip_wh ? halfheight : halfwidth;
+    int rotated_stride_v = flip_wh ? halfheight : halfwidth;
+
+    // Converts Android420 to I420 format with the orientation applied
+    PlanarImage rotated;
+    rotated.y = {rotated_y_ptr, rotated_stride_y, 1};
+    rotated.u = {rotated_u_ptr, rotated_stride_u, 1};
+    rotated.v = {rotated_v_ptr, rotated_stride_v, 1};
+    rotated.width = flip_wh ? height : width;
+    rotated.height = flip_wh ? width : height;
+    int result = RotateAndroid420ToI420(image, rotated, orientation);
+
+    if (result != 0) {
+        return result;
+    }
+
+    // Convert to the required output format
+    int rotated_width = flip_wh ? height : width;
+    int rotated_height = flip_wh ? width : height;
+    int rotated_halfwidth = flip_wh ? halfheight : halfwidth;
+    int rotated_halfheight = flip_wh ? halfwidth : halfheight;
+
+    uint8_t* dst_y_ptr = dst.y.data;
+    uint8_t* dst_u_ptr = dst.u.data;
+    uint8_t* dst_v_ptr = dst.v.data;
+    int dst_stride_y = dst.y.row_stride;
+    int dst_stride_u = dst.u.row_stride;
+    int dst_stride_v = dst.v.row_stride;
+
+    switch (dst.chroma_layout()) {
+        case ChromaLayout::kSemiPlanarVU:
+            // NV21
+            result = libyuv::I420ToNV21(
+                    /* src_y= */ rotated_y_ptr,
+                    /* src_stride_y= */ rotated_width,
+                    /* src_u= */ rotated_u_ptr,
+                    /* src_stride_u= */ rotated_halfwidth,
+                    /* src_v= */ rotated_v_ptr,
+                    /* src_stride_v= */ rotated_halfwidth,
+                    /* dst_y= */ dst_y_ptr,
+                    /* dst_stride_y= */ dst_stride_y,
+                    /* dst_uv= */ dst_v_ptr,
+                    /* dst_stride_uv= */ dst_stride_v,
+                    /* width= */ rotated_width,
+                    /* height= */ rotated_height
+            );
+            break;
+        case ChromaLayout::kSemiPlanarUV:
+            // NV12
+            result = libyuv::I420ToNV12(
+                    /* src_y= */ rotated_y_ptr,
+                    /* src_stride_y= */ rotated_width,
+                    /* src_u= */ rotated_u_ptr,
+                    /* src_stride_u= */ rotated_halfwidth,
+                    /* src_v= */ rotated_v_ptr,
+                    /* src_stride_v= */ rotated_halfwidth,
+                    /* dst_y= */ dst_y_ptr,
+                    /* dst_stride_y= */ dst_stride_y,
+                    /* dst_uv= */ dst_u_ptr,
+                    /* dst_stride_uv= */ dst_stride_u,
+                    /* width= */ rotated_width,
+                    /* height= */ rotated_height
+            );
+            break;
+        case ChromaLayout::kPlanar:
+            // I420
+            // Copies Y plane
+            libyuv::CopyPlane(
+                    /* src_y= */ rotated_y_ptr,
+                    /* src_stride_y= */ rotated_width,
+                    /* dst_y= */ dst_y_ptr,
+                    /* dst_stride_y= */ dst_stride_y,
+                    /* width= */ rotated_width,
+                    /* height= */ rotated_height);
+            // Copies U plane
+            libyuv::CopyPlane(
+                    /* src_y= */ rotated_u_ptr,
+                    /* src_stride_y= */ rotated_halfwidth,
+                    /* dst_y= */ dst_u_ptr,
+                    /* dst_stride_y= */ dst_stride_u,
+                    /* width= */ rotated_halfwidth,
+                    /* height= */ rotated_halfheight);
+            // Copies V plane
+            libyuv::CopyPlane(
+                    /* src_y= */ rotated_v_ptr,
+                    /* src_stride_y= */ rotated_halfwidth,
+                    /* dst_y= */ dst_v_ptr,
+                    /* dst_stride_y= */ dst_stride_v,
+                    /* width= */ rotated_halfwidth,
+                    /* height= */ rotated_halfheight);
+            break;
+        case ChromaLayout::kFlexible: {
+            // Fall backs to directly copy according to the dst stride and pixel_stride values if
+            // it is none of the above cases.
+
+            // Y
+            for (int i = 0; i < rotated_height; i++) {
+                for (int j = 0; j < rotated_width; j++) {
+                    dst_y_ptr[i * dst_stride_y + j * dst.y.pixel_stride] =
+                            rotated_y_ptr[i * rotated_stride_y + j];
+                }
+            }
+            // U
+            for (int i = 0; i < rotated_halfheight; i++) {
+                for (int j = 0; j < rotated_halfwidth; j++) {
+                    dst_u_ptr[i * dst_stride_u + j * dst.u.pixel_stride] =
+                            rotated_u_ptr[i * rotated_stride_u + j];
+                }
+            }
+            // V
+            for (int i = 0; i < rotated_halfheight; i++) {
+                for (int j = 0; j < rotated_halfwidth; j++) {
+                    dst_v_ptr[i * dst_stride_v + j * dst.v.pixel_stride] =
+                            rotated_v_ptr[i * rotated_stride_v + j];
+                }
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+// Copies the luma plane of src into dst of the same size.
+static void CopyLuma(const PlanarImage& src, const PlanarImage& dst) {
+    if (src.y.pixel_stride == 1 && dst.y.pixel_stride == 1) {
+        libyuv::CopyPlane(src.y.data, src.y.row_stride, dst.y.data, dst.y.row_stride,
+                          src.width, src.height);
+    } else {
+        CopySamples(src.y, dst.y, src.width, src.height);
+    }
+}
+
+int CopyAndroid420(const PlanarImage& src, const PlanarImage& dst) {
+    if (src.width != dst.width || src.height != dst.height
+        || src.subsampling != dst.subsampling) {
+        return -1;
+    }
+    CopyLuma(src, dst);
+
+    const int chroma_width = src.chroma_width();
+    const int chroma_height = src.chroma_height();
+    const ChromaLayout src_layout = src.chroma_layout();
+    const ChromaLayout dst_layout = dst.chroma_layout();
+    if (src_layout == ChromaLayout::kPlanar && dst_layout == ChromaLayout::kPlanar) {
+        libyuv::CopyPlane(src.u.data, src.u.row_stride, dst.u.data, dst.u.row_stride,
+                          chroma_width, chroma_height);
+        libyuv::CopyPlane(src.v.data, src.v.row_stride, dst.v.data, dst.v.row_stride,
+                          chroma_width, chroma_height);
+    } else if (src_layout == ChromaLayout::kPlanar && dst_layout == ChromaLayout::kSemiPlanarUV) {
+        libyuv::MergeUVPlane(src.u.data, src.u.row_stride, src.v.data, src.v.row_stride,
+                             dst.u.data, dst.u.row_stride, chroma_width, chroma_height);
+    } else if (src_layout == ChromaLayout::kPlanar && dst_layout == ChromaLayout::kSemiPlanarVU) {
+        libyuv::MergeUVPlane(src.v.data, src.v.row_stride, src.u.data, src.u.row_stride,
+                             dst.v.data, dst.v.row_stride, chroma_width, chroma_height);
+    } else if (src_layout == ChromaLayout::kSemiPlanarUV && dst_layout == ChromaLayout::kPlanar) {
+        libyuv::SplitUVPlane(src.u.data, src.u.row_stride, dst.u.data, dst.u.row_stride,
+                             dst.v.data, dst.v.row_stride, chroma_width, chroma_height);
+    } else if (src_layout == ChromaLayout::kSemiPlanarVU && dst_layout == ChromaLayout::kPlanar) {
+        libyuv::SplitUVPlane(src.v.data, src.v.row_stride, dst.v.data, dst.v.row_stride,
+                             dst.u.data, dst.u.row_stride, chroma_width, chroma_height);
+    } else if (src_layout == dst_layout && src_layout != ChromaLayout::kFlexible) {
+        // Same interleaved order, the chroma plane is copied as a whole.
+        libyuv::CopyPlane(std::min(src.u.data, src.v.data), src.u.row_stride,
+                          std::min(dst.u.data, dst.v.data), dst.u.row_stride,
+                          chroma_width * 2, chroma_height);
+    } else {
+        CopySamples(src.u, dst.u, chroma_width, chroma_height);
+        CopySamples(src.v, dst.v, chroma_width, chroma_height);
+    }
+    return 0;
+}
+
+int ConvertAndroidYuvTo420(const PlanarImage& src, const PlanarImage& dst) {
+    if (src.subsampling == ChromaSubsampling::k420) {
+        return dst.subsampling == ChromaSubsampling::k420 ? CopyAndroid420(src, dst) : -1;
+    }
+    if (DownsampleChromaTo420(src, dst) != 0) {
+        return -1;
+    }
+    CopyLuma(src, dst);
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_KERNELS_H_
+#define CAMERA_CORE_IMAGE_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Offsets of the first valid sample of each plane, used to work around devices that deliver
+ * YUV data shifted by one pixel (b/195990691). All zero when no workaround is needed.
+ */
+struct PixelShift {
+    int start_offset_y = 0;
+    int start_offset_u = 0;
+    int start_offset_v = 0;
+
+    bool IsShifted() const {
+        return start_offset_y > 0 || start_offset_u > 0 || start_offset_v > 0;
+    }
+};
+
+/**
+ * Converts Android420 to ABGR with options to choose full swing or studio swing. 4:2:2 and 4:4:4
+ * images are converted as well, with their chroma at full resolution.
+ */
+int Android420ToABGR(const PlanarImage& src, uint8_t* dst_abgr, int dst_stride_abgr,
+                     bool is_full_swing);
+
+/**
+ * Converts Android420 to full swing ABGR and orients the result into {@code dst_abgr}.
+ *
+ * <p>A vertical flip is applied while converting. When the orientation also rotates, the
+ * unrotated result is first written to {@code scratch}, which must hold
+ * {@code width * height * 4} bytes.
+ */
+int Android420ToRotatedABGR(const PlanarImage& src,
+                            const PixelShift& shift,
+                            uint8_t* scratch,
+                            uint8_t* dst_abgr,
+                            int dst_stride_abgr,
+                            const Orientation& orientation);
+
+/**
+ * Like {@link Android420ToRotatedABGR} without the pixel shift workaround, but with a working set
+ * bounded by {@code budget_bytes} instead of a full frame scratch buffer.
+ *
+ * <p>The source is converted in bands of rows that fit the budget, at least two rows. Each band
+ * is oriented straight into its place in {@code dst_abgr}: rows for 0 and 180 degrees, columns
+ * for 90 and 270 degrees. Peak memory is one band, independent of the frame size.
+ */
+int Android420ToRotatedABGRInBands(const PlanarImage& src,
+                                   uint8_t* dst_abgr,
+                                   int dst_stride_abgr,
+                                   const Orientation& orientation,
+                                   size_t budget_bytes);
+
+/**
+ * Orients an Android420 image into the planar I420 image {@code dst}, which must already have
+ * the oriented dimensions. 4:2:2 and 4:4:4 images are downsampled to 4:2:0 on the way, see
+ * {@link DownsampleChromaTo420}, and so is the input of {@link RotateAndroid420}.
+ */
+int RotateAndroid420ToI420(const PlanarImage& src, const PlanarImage& dst,
+                           const Orientation& orientation);
+
+/**
+ * Orients an Android420 image into the {@code dst} planes, which may be laid out as I420, NV12,
+ * NV21 or any other flexible YUV layout. The rotation goes through the tightly packed I420
+ * scratch planes {@code rotated_y}, {@code rotated_u} and {@code rotated_v}.
+ */
+int RotateAndroid420(const PlanarImage& src,
+                     const PlanarImage& dst,
+                     uint8_t* rotated_y,
+                     uint8_t* rotated_u,
+                     uint8_t* rotated_v,
+                     const Orientation& orientation);
+
+/**
+ * Copies an Android420 image into {@code dst} of the same size, converting between I420, NV12,
+ * NV21 and flexible chroma layouts on the way. Either image may have negative row strides. Both
+ * images must have the same chroma subsampling.
+ */
+int CopyAndroid420(const PlanarImage& src, const PlanarImage& dst);
+
+/**
+ * Converts a 4:2:0, 4:2:2 or 4:4:4 image into the 4:2:0 image {@code dst} of the same size, in
+ * any chroma layout, e.g. NV12 for a video encoder. 4:2:0 sources are copied.
+ */
+int ConvertAndroidYuvTo420(const PlanarImage& src, const PlanarImage& dst);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_KERNELS_H_
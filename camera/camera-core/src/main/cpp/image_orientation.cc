@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_orientation.h"
+
+namespace camerax {
+
+Orientation Orientation::FromRotation(int rotation, bool mirror) {
+    rotation = ((rotation % 360) + 360) % 360;
+    if (!mirror) {
+        return {rotation, false};
+    }
+    // A horizontal mirror is a vertical flip followed by a half turn, and moving the flip in
+    // front of the rotation reverses the rotation's direction.
+    return {(540 - rotation) % 360, true};
+}
+
+Orientation Orientation::FromExif(int exif_orientation) {
+    switch (exif_orientation) {
+        case 2:  // Flip horizontal.
+            return {180, true};
+        case 3:  // Rotate 180.
+            return {180, false};
+        case 4:  // Flip vertical.
+            return {0, true};
+        case 5:  // Transpose.
+            return {90, true};
+        case 6:  // Rotate 90.
+            return {90, false};
+        case 7:  // Transverse.
+            return {270, true};
+        case 8:  // Rotate 270.
+            return {270, false};
+        default:  // Normal or undefined.
+            return {0, false};
+    }
+}
+
+}  // namespace camerax
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_ORIENTATION_H_
+#define CAMERA_CORE_IMAGE_ORIENTATION_H_
+
+namespace camerax {
+
+/**
+ * One of the eight orientation transforms of a frame: the four rotations, each optionally
+ * mirrored. It is stored as an optional vertical flip of the source followed by a clockwise
+ * rotation, which is how the kernels apply it: the flip costs nothing since the source rows are
+ * simply walked bottom up while converting or rotating.
+ */
+struct Orientation {
+    // Clockwise rotation in degrees, one of 0, 90, 180 or 270, applied after the flip.
+    int rotation = 0;
+    bool flip_vertical = false;
+
+    /**
+     * Rotates clockwise by {@code rotation} degrees and then, if {@code mirror} is set, mirrors
+     * the rotated frame horizontally, as needed for front camera outputs.
+     */
+    static Orientation FromRotation(int rotation, bool mirror);
+
+    /**
+     * Returns the transform that displays a frame tagged with the given EXIF orientation (1-8)
+     * upright. Undefined values map to the identity.
+     */
+    static Orientation FromExif(int exif_orientation);
+
+    bool IsIdentity() const { return rotation == 0 && !flip_vertical; }
+
+    bool SwapsDimensions() const { return rotation == 90 || rotation == 270; }
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_ORIENTATION_H_
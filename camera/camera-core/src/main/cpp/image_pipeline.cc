@@ -0,0 +1,389 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+#include "libyuv/scale.h"
+#include "libyuv/scale_argb.h"
+
+#include "image_kernels.h"
+#include "image_transpose.h"
+#include "image_warp.h"
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// The steps of a request that the planner is free to reorder.
+enum class Step {
+    kRotate,
+    kScale,
+    kConvert,
+};
+
+size_t ABGRBytes(int width, int height) {
+    return static_cast<size_t>(width) * height * 4;
+}
+
+bool IsABGROp(PipelineOp op) {
+    return op == PipelineOp::kConvertToABGR || op == PipelineOp::kRotateABGR
+            || op == PipelineOp::kScaleABGR;
+}
+
+// Size of the intermediate result a stage writes when it is not the last one.
+size_t IntermediateBytes(const PipelineStage& stage) {
+    return IsABGROp(stage.op) ? ABGRBytes(stage.dst_width, stage.dst_height)
+                              : I420BufferSize(stage.dst_width, stage.dst_height);
+}
+
+bool IsRotateScalePair(Step first, Step second) {
+    return (first == Step::kRotate && second == Step::kScale)
+            || (first == Step::kScale && second == Step::kRotate);
+}
+
+// Whether the crop can be rotated and scaled to the output in one bilinear pass, which holds up
+// to a 2x downscale. The fused kernel reads the source once and writes the output once.
+//
+// Fewer bytes do not make it faster yet: on the host it is slower than the libyuv rotate and
+// scale it replaces, and it has not been measured on devices. So it is only used once an
+// implementation of Kernel::kWarp is forced with SetKernelImpl.
+bool CanFuseRotateScale(const PipelinePlan& plan) {
+    if (GetKernelImplOverride(Kernel::kWarp) == KernelImpl::kAuto) {
+        return false;
+    }
+    const bool swap = plan.orientation.SwapsDimensions();
+    const int oriented_width = swap ? plan.crop_height : plan.crop_width;
+    const int oriented_height = swap ? plan.crop_width : plan.crop_height;
+    return plan.orientation.rotation != 0 && 2 * plan.output_width >= oriented_width
+            && 2 * plan.output_height >= oriented_height;
+}
+
+// Appends the stages that run the steps in the given order to stages. Returns the estimated
+// number of bytes they move.
+size_t BuildCandidate(const PipelinePlan& plan, bool source_planar, const std::vector<Step>& steps,
+                      std::vector<PipelineStage>* stages) {
+    enum class Domain { kSource, kYUV, kABGR };
+    Domain domain = Domain::kSource;
+    int width = plan.crop_width;
+    int height = plan.crop_height;
+    bool rotated = false;
+    // Whether the last stage can write any chroma layout rather than I420 only.
+    bool any_layout = false;
+    size_t total = 0;
+    auto add = [&](PipelineOp op, int rotation, int dst_width, int dst_height, size_t bytes) {
+        stages->push_back({op, rotation, width, height, dst_width, dst_height, bytes});
+        width = dst_width;
+        height = dst_height;
+        total += bytes;
+        any_layout = op == PipelineOp::kRotateScaleYUV;
+    };
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const Step step = steps[i];
+        if (domain != Domain::kABGR && i + 1 < steps.size()
+            && IsRotateScalePair(step, steps[i + 1]) && CanFuseRotateScale(plan)) {
+            add(PipelineOp::kRotateScaleYUV, plan.orientation.rotation, plan.output_width,
+                plan.output_height,
+                I420BufferSize(width, height)
+                        + I420BufferSize(plan.output_width, plan.output_height));
+            domain = Domain::kYUV;
+            rotated = true;
+            ++i;
+            continue;
+        }
+        switch (step) {
+            case Step::kRotate: {
+                const int rotation = plan.orientation.rotation;
+                const bool swap = plan.orientation.SwapsDimensions();
+                const int dst_width = swap ? height : width;
+                const int dst_height = swap ? width : height;
+                if (domain == Domain::kABGR) {
+                    add(PipelineOp::kRotateABGR, rotation, dst_width, dst_height,
+                        2 * ABGRBytes(width, height));
+                } else {
+                    add(PipelineOp::kRotateYUV, rotation, dst_width, dst_height,
+                        2 * I420BufferSize(width, height));
+                    domain = Domain::kYUV;
+                }
+                rotated = true;
+                break;
+            }
+            case Step::kScale: {
+                // The output size is given in output orientation.
+                const bool swap = !rotated && plan.orientation.SwapsDimensions();
+                const int dst_width = swap ? plan.output_height : plan.output_width;
+                const int dst_height = swap ? plan.output_width : plan.output_height;
+                if (domain == Domain::kABGR) {
+                    add(PipelineOp::kScaleABGR, 0, dst_width, dst_height,
+                        ABGRBytes(width, height) + ABGRBytes(dst_width, dst_height));
+                    break;
+                }
+                if (domain == Domain::kSource && !source_planar) {
+                    // The YUV scaler needs separate chroma planes.
+                    add(PipelineOp::kRotateYUV, 0, width, height,
+                        2 * I420BufferSize(width, height));
+                }
+                add(PipelineOp::kScaleYUV, 0, dst_width, dst_height,
+                    I420BufferSize(width, height) + I420BufferSize(dst_width, dst_height));
+                domain = Domain::kYUV;
+                break;
+            }
+            case Step::kConvert:
+                add(PipelineOp::kConvertToABGR, 0, width, height,
+                    I420BufferSize(width, height) + ABGRBytes(width, height));
+                domain = Domain::kABGR;
+                break;
+        }
+    }
+
+    // YUV stages other than the fused one produce I420, which only a planar destination can
+    // take directly.
+    if (plan.output_format != PipelineFormat::kABGR
+        && (domain == Domain::kSource
+            || (plan.output_format != PipelineFormat::kI420 && !any_layout))) {
+        add(PipelineOp::kCopyYUV, 0, width, height, 2 * I420BufferSize(width, height));
+    }
+    return total;
+}
+
+bool MatchesFormat(const PlanarImage& image, PipelineFormat format) {
+    switch (image.chroma_layout()) {
+        case ChromaLayout::kPlanar:
+            return format == PipelineFormat::kI420;
+        case ChromaLayout::kSemiPlanarUV:
+            return format == PipelineFormat::kNV12;
+        case ChromaLayout::kSemiPlanarVU:
+            return format == PipelineFormat::kNV21;
+        default:
+            return false;
+    }
+}
+
+// Bytes between the first and the last sample of a plane, i.e. the memory a kernel sweeps.
+size_t PlaneSpan(const Plane& plane, int width, int height) {
+    return static_cast<size_t>(height - 1) * std::abs(plane.row_stride)
+            + static_cast<size_t>(width - 1) * plane.pixel_stride + 1;
+}
+
+size_t PlanarImageSpan(const PlanarImage& image) {
+    size_t span = PlaneSpan(image.y, image.width, image.height);
+    const int chroma_width = image.chroma_width();
+    const int chroma_height = image.chroma_height();
+    switch (image.chroma_layout()) {
+        case ChromaLayout::kSemiPlanarUV:
+        case ChromaLayout::kSemiPlanarVU:
+            // U and V share one interleaved plane.
+            return span + PlaneSpan(image.u, chroma_width, chroma_height) + 1;
+        default:
+            return span + PlaneSpan(image.u, chroma_width, chroma_height)
+                    + PlaneSpan(image.v, chroma_width, chroma_height);
+    }
+}
+
+size_t ABGRSpan(int stride, int width, int height) {
+    return static_cast<size_t>(height - 1) * std::abs(stride) + static_cast<size_t>(width) * 4;
+}
+
+}  // namespace
+
+int PlanPipeline(const PlanarImage& src, const PipelineRequest& request, PipelinePlan* plan) {
+    const int src_width = src.width;
+    const int src_height = src.height;
+    PipelinePlan result;
+    bool full_frame = request.crop_width <= 0 || request.crop_height <= 0;
+    result.crop_left = full_frame ? 0 : request.crop_left & ~1;
+    result.crop_top = full_frame ? 0 : request.crop_top & ~1;
+    result.crop_width = full_frame ? src_width : request.crop_width;
+    result.crop_height = full_frame ? src_height : request.crop_height;
+    if (src.subsampling != ChromaSubsampling::k420
+        || result.crop_left < 0 || result.crop_top < 0 || result.crop_width <= 0
+        || result.crop_height <= 0 || result.crop_left + result.crop_width > src_width
+        || result.crop_top + result.crop_height > src_height) {
+        return -1;
+    }
+
+    result.orientation = request.orientation;
+    result.output_format = request.output_format;
+    const bool swap = request.orientation.SwapsDimensions();
+    const int oriented_width = swap ? result.crop_height : result.crop_width;
+    const int oriented_height = swap ? result.crop_width : result.crop_height;
+    result.output_width = request.output_width > 0 ? request.output_width : oriented_width;
+    result.output_height = request.output_height > 0 ? request.output_height : oriented_height;
+
+    std::vector<Step> steps;
+    if (request.orientation.rotation != 0) {
+        steps.push_back(Step::kRotate);
+    }
+    if (result.output_width != oriented_width || result.output_height != oriented_height) {
+        steps.push_back(Step::kScale);
+    }
+    if (request.output_format == PipelineFormat::kABGR) {
+        steps.push_back(Step::kConvert);
+    }
+
+    // At most three steps, so every order is costed. The first order is rotate, scale, convert,
+    // which wins ties.
+    const bool source_planar = src.y.pixel_stride == 1
+            && src.chroma_layout() == ChromaLayout::kPlanar;
+    size_t best_bytes = 0;
+    do {
+        std::vector<PipelineStage> stages;
+        size_t bytes = BuildCandidate(result, source_planar, steps, &stages);
+        if (result.stages.empty() || bytes < best_bytes) {
+            result.stages = std::move(stages);
+            best_bytes = bytes;
+        }
+    } while (std::next_permutation(steps.begin(), steps.end()));
+    result.estimated_bytes = best_bytes;
+
+    // Intermediate results alternate between two regions of the scratch memory.
+    size_t region_bytes[2] = {0, 0};
+    for (size_t i = 0; i + 1 < result.stages.size(); ++i) {
+        region_bytes[i % 2] = std::max(region_bytes[i % 2], IntermediateBytes(result.stages[i]));
+    }
+    result.scratch_bytes = region_bytes[0] + region_bytes[1];
+
+    *plan = std::move(result);
+    return 0;
+}
+
+int RunPipeline(const PlanarImage& src,
+                const PipelinePlan& plan,
+                const PipelineDestination& dst,
+                uint8_t* scratch,
+                size_t scratch_size,
+                PipelineStats* stats) {
+    const auto start = std::chrono::steady_clock::now();
+    if (plan.stages.empty() || !src.IsValid()
+        || plan.crop_left + plan.crop_width > src.width
+        || plan.crop_top + plan.crop_height > src.height) {
+        return -1;
+    }
+    if (plan.output_format == PipelineFormat::kABGR) {
+        if (dst.abgr == nullptr) {
+            return -1;
+        }
+    } else if (!dst.yuv.IsValid() || dst.yuv.width != plan.output_width
+               || dst.yuv.height != plan.output_height
+               || !MatchesFormat(dst.yuv, plan.output_format)) {
+        return -1;
+    }
+
+    std::vector<uint8_t> owned_scratch;
+    if (scratch == nullptr || scratch_size < plan.scratch_bytes) {
+        owned_scratch.resize(plan.scratch_bytes);
+        scratch = owned_scratch.data();
+    }
+    size_t region_bytes = 0;
+    for (size_t i = 0; i + 1 < plan.stages.size(); i += 2) {
+        region_bytes = std::max(region_bytes, IntermediateBytes(plan.stages[i]));
+    }
+    uint8_t* regions[2] = {scratch, scratch + region_bytes};
+
+    // Crop and flip only change how the source is addressed.
+    PlanarImage yuv = CropPlanarImage(src, plan.crop_left, plan.crop_top, plan.crop_width,
+                                      plan.crop_height);
+    if (plan.orientation.flip_vertical) {
+        yuv = FlipPlanarImage(yuv);
+    }
+    uint8_t* abgr = nullptr;
+    int abgr_stride = 0;
+
+    size_t measured_bytes = 0;
+    int result = 0;
+    for (size_t i = 0; i < plan.stages.size() && result == 0; ++i) {
+        const PipelineStage& stage = plan.stages[i];
+        const bool last = i + 1 == plan.stages.size();
+        uint8_t* region = regions[i % 2];
+        PlanarImage yuv_out = last ? dst.yuv
+                                   : WrapI420(region, stage.dst_width, stage.dst_height,
+                                              stage.dst_width);
+        uint8_t* abgr_out = last ? dst.abgr : region;
+        int abgr_out_stride = last ? dst.abgr_stride : stage.dst_width * 4;
+
+        switch (stage.op) {
+            case PipelineOp::kRotateYUV:
+                result = RotateAndroid420ToI420(yuv, yuv_out,
+                                                Orientation::FromRotation(stage.rotation, false));
+                break;
+            case PipelineOp::kScaleYUV:
+                if (yuv.y.pixel_stride != 1 || yuv.chroma_layout() != ChromaLayout::kPlanar) {
+                    // Planned for a source with a different layout.
+                    result = -1;
+                    break;
+                }
+                result = libyuv::I420Scale(yuv.y.data, yuv.y.row_stride,
+                                           yuv.u.data, yuv.u.row_stride,
+                                           yuv.v.data, yuv.v.row_stride,
+                                           yuv.width, yuv.height,
+                                           yuv_out.y.data, yuv_out.y.row_stride,
+                                           yuv_out.u.data, yuv_out.u.row_stride,
+                                           yuv_out.v.data, yuv_out.v.row_stride,
+                                           yuv_out.width, yuv_out.height,
+                                           libyuv::kFilterBox);
+                break;
+            case PipelineOp::kCopyYUV:
+                result = CopyAndroid420(yuv, yuv_out);
+                break;
+            case PipelineOp::kRotateScaleYUV:
+                result = RotateScaleAndroid420(yuv, stage.rotation, yuv_out);
+                break;
+            case PipelineOp::kConvertToABGR:
+                result = Android420ToABGR(yuv, abgr_out, abgr_out_stride,
+                                          /* is_full_swing = */true);
+                break;
+            case PipelineOp::kRotateABGR:
+                result = RotateABGR(abgr, abgr_stride, abgr_out, abgr_out_stride,
+                                    stage.src_width, stage.src_height, stage.rotation);
+                break;
+            case PipelineOp::kScaleABGR:
+                result = libyuv::ARGBScale(abgr, abgr_stride, stage.src_width, stage.src_height,
+                                           abgr_out, abgr_out_stride,
+                                           stage.dst_width, stage.dst_height,
+                                           libyuv::kFilterBox);
+                break;
+        }
+
+        measured_bytes += abgr != nullptr
+                ? ABGRSpan(abgr_stride, stage.src_width, stage.src_height)
+                : PlanarImageSpan(yuv);
+        if (IsABGROp(stage.op)) {
+            abgr = abgr_out;
+            abgr_stride = abgr_out_stride;
+            measured_bytes += ABGRSpan(abgr_stride, stage.dst_width, stage.dst_height);
+        } else {
+            yuv = yuv_out;
+            measured_bytes += PlanarImageSpan(yuv);
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->estimated_bytes = plan.estimated_bytes;
+        stats->measured_bytes = measured_bytes;
+        stats->elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        stats->stage_count = static_cast<int>(plan.stages.size());
+    }
+    return result;
+}
+
+}  // namespace camerax
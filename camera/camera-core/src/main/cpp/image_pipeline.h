@@ -0,0 +1,158 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_PIPELINE_H_
+#define CAMERA_CORE_IMAGE_PIPELINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Output formats of a pipeline. The YUV formats describe the layout of the destination planes.
+ */
+enum class PipelineFormat {
+    kABGR,
+    kI420,
+    kNV12,
+    kNV21,
+};
+
+/**
+ * A chain of crop, orientation, scale and format conversion to apply to an Android420 frame.
+ * The request only says what the output looks like; the order in which the steps run is up to
+ * the planner.
+ */
+struct PipelineRequest {
+    // Region of the source to keep, in source coordinates. An empty region keeps the whole
+    // frame. The left and top edges are rounded down to even values.
+    int crop_left = 0;
+    int crop_top = 0;
+    int crop_width = 0;
+    int crop_height = 0;
+    Orientation orientation;
+    // Size of the output, in output orientation. 0 keeps the size of the oriented crop.
+    int output_width = 0;
+    int output_height = 0;
+    PipelineFormat output_format = PipelineFormat::kABGR;
+};
+
+/**
+ * The kernels a pipeline is built from. YUV stages produce tightly packed I420.
+ */
+enum class PipelineOp {
+    // Android420 to I420, rotating and repacking in a single pass.
+    kRotateYUV,
+    kScaleYUV,
+    kConvertToABGR,
+    kRotateABGR,
+    kScaleABGR,
+    // Android420 into the destination planes, converting the chroma layout.
+    kCopyYUV,
+    // Android420 rotated and resampled bilinearly in a single pass, into any chroma layout.
+    kRotateScaleYUV,
+};
+
+struct PipelineStage {
+    PipelineOp op;
+    // Clockwise rotation of kRotateYUV, kRotateScaleYUV and kRotateABGR. A kRotateYUV stage
+    // without rotation only repacks.
+    int rotation;
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+    // Estimated bytes read plus bytes written by the stage, assuming tightly packed planes.
+    size_t bytes;
+};
+
+/**
+ * The cheapest sequence of stages found for a request. The last stage writes straight into the
+ * destination, every other stage into scratch memory.
+ */
+struct PipelinePlan {
+    std::vector<PipelineStage> stages;
+    // Sum of the estimated bytes of all stages.
+    size_t estimated_bytes = 0;
+    // Scratch memory needed for the intermediate results.
+    size_t scratch_bytes = 0;
+    int crop_left = 0;
+    int crop_top = 0;
+    int crop_width = 0;
+    int crop_height = 0;
+    Orientation orientation;
+    PipelineFormat output_format = PipelineFormat::kABGR;
+    int output_width = 0;
+    int output_height = 0;
+};
+
+/**
+ * Where the output of a pipeline goes: {@code abgr} for PipelineFormat::kABGR, {@code yuv}
+ * otherwise.
+ */
+struct PipelineDestination {
+    uint8_t* abgr = nullptr;
+    int abgr_stride = 0;
+    PlanarImage yuv;
+};
+
+/**
+ * Bytes moved by a pipeline run. The measured bytes count the memory the kernels actually swept,
+ * including row padding, so they exceed the estimate for strided planes.
+ */
+struct PipelineStats {
+    size_t estimated_bytes = 0;
+    size_t measured_bytes = 0;
+    int64_t elapsed_ns = 0;
+    int stage_count = 0;
+};
+
+/**
+ * Orders the steps of {@code request} for frames shaped like {@code src} so that the fewest
+ * bytes are moved. Only the size and plane layout of {@code src} are looked at.
+ *
+ * <p>Crop and vertical flips are free since they only change how the source is addressed.
+ * Rotation and scaling are placed in the YUV domain, before the expansion to 4 bytes per pixel,
+ * unless scaling up makes the RGB domain cheaper. A rotation next to a scale by at most 2x in
+ * the YUV domain is fused into one pass if an implementation of Kernel::kWarp is forced, see
+ * {@link SetKernelImpl}; otherwise they run as separate libyuv stages.
+ *
+ * @return 0 on success or -1 if the request does not fit the frame or the frame is not 4:2:0.
+ */
+int PlanPipeline(const PlanarImage& src, const PipelineRequest& request, PipelinePlan* plan);
+
+/**
+ * Runs a plan on {@code src}, which must be shaped like the frame the plan was made for.
+ * Intermediate results go to {@code scratch} if it holds at least {@code plan.scratch_bytes},
+ * otherwise to memory allocated for the run. {@code stats} may be null.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+int RunPipeline(const PlanarImage& src,
+                const PipelinePlan& plan,
+                const PipelineDestination& dst,
+                uint8_t* scratch,
+                size_t scratch_size,
+                PipelineStats* stats);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_PIPELINE_H_
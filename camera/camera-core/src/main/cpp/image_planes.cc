@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_planes.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace camerax {
+
+bool PlanarImage::IsValid() const {
+    return y.data != nullptr && u.data != nullptr && v.data != nullptr
+            && width > 0 && height > 0
+            && std::abs(y.row_stride) >= width * y.pixel_stride
+            && u.pixel_stride > 0 && v.pixel_stride > 0;
+}
+
+ChromaLayout PlanarImage::chroma_layout() const {
+    const ptrdiff_t vu_off = v.data - u.data;
+    if (u.pixel_stride == 1 && v.pixel_stride == 1) {
+        return ChromaLayout::kPlanar;
+    }
+    if (u.pixel_stride == 2 && v.pixel_stride == 2 && u.row_stride == v.row_stride) {
+        if (vu_off == 1) {
+            return ChromaLayout::kSemiPlanarUV;
+        }
+        if (vu_off == -1) {
+            return ChromaLayout::kSemiPlanarVU;
+        }
+    }
+    return ChromaLayout::kFlexible;
+}
+
+PlanarImage WrapAndroid420(uint8_t* y, int y_row_stride, int y_pixel_stride,
+                           uint8_t* u, int uv_row_stride, uint8_t* v, int uv_pixel_stride,
+                           int width, int height) {
+    PlanarImage image;
+    image.y = {y, y_row_stride, y_pixel_stride};
+    image.u = {u, uv_row_stride, uv_pixel_stride};
+    image.v = {v, uv_row_stride, uv_pixel_stride};
+    image.width = width;
+    image.height = height;
+    return image;
+}
+
+PlanarImage WrapI420(uint8_t* data, int width, int height, int stride_y) {
+    int halfwidth = (width + 1) >> 1;
+    int halfheight = (height + 1) >> 1;
+    uint8_t* u = data + static_cast<size_t>(stride_y) * height;
+    uint8_t* v = u + static_cast<size_t>(halfwidth) * halfheight;
+    PlanarImage image = WrapAndroid420(data, stride_y, 1, u, halfwidth, v, 1, width, height);
+    return image;
+}
+
+PlanarImage WrapNV12(uint8_t* data, int width, int height, int stride, int slice_height,
+                     bool vu_order) {
+    uint8_t* uv = data + static_cast<size_t>(stride) * slice_height;
+    uint8_t* u = vu_order ? uv + 1 : uv;
+    uint8_t* v = vu_order ? uv : uv + 1;
+    return WrapAndroid420(data, stride, 1, u, stride, v, 2, width, height);
+}
+
+CodecBufferLayout GetCodecBufferLayout(int width, int height, ChromaLayout chroma_layout,
+                                       int stride_alignment, int slice_alignment) {
+    stride_alignment = std::max(stride_alignment, 1);
+    slice_alignment = std::max(slice_alignment, 1);
+    CodecBufferLayout layout;
+    layout.stride = (width + stride_alignment - 1) / stride_alignment * stride_alignment;
+    layout.slice_height = (height + slice_alignment - 1) / slice_alignment * slice_alignment;
+    const size_t luma_size = static_cast<size_t>(layout.stride) * layout.slice_height;
+    const size_t chroma_rows = (layout.slice_height + 1) / 2;
+    layout.size = chroma_layout == ChromaLayout::kPlanar
+            ? luma_size + 2 * static_cast<size_t>((layout.stride + 1) / 2) * chroma_rows
+            : luma_size + static_cast<size_t>(layout.stride) * chroma_rows;
+    return layout;
+}
+
+PlanarImage WrapCodecBuffer(uint8_t* data, int width, int height, ChromaLayout chroma_layout,
+                            const CodecBufferLayout& layout) {
+    if (chroma_layout != ChromaLayout::kPlanar) {
+        return WrapNV12(data, width, height, layout.stride, layout.slice_height,
+                        chroma_layout == ChromaLayout::kSemiPlanarVU);
+    }
+    const int chroma_stride = (layout.stride + 1) / 2;
+    uint8_t* u = data + static_cast<size_t>(layout.stride) * layout.slice_height;
+    uint8_t* v = u + static_cast<size_t>(chroma_stride) * ((layout.slice_height + 1) / 2);
+    return WrapAndroid420(data, layout.stride, 1, u, chroma_stride, v, 1, width, height);
+}
+
+size_t I420BufferSize(int width, int height) {
+    size_t halfwidth = (width + 1) >> 1;
+    size_t halfheight = (height + 1) >> 1;
+    return static_cast<size_t>(width) * height + 2 * halfwidth * halfheight;
+}
+
+PlanarImage CropPlanarImage(const PlanarImage& image, int left, int top, int width, int height) {
+    left &= ~1;
+    top &= ~1;
+    PlanarImage cropped = image;
+    cropped.y.data = image.y.RowAt(top) + left * image.y.pixel_stride;
+    const int chroma_left = image.subsampling == ChromaSubsampling::k444 ? left : left / 2;
+    const int chroma_top = image.subsampling == ChromaSubsampling::k420 ? top / 2 : top;
+    cropped.u.data = image.u.RowAt(chroma_top) + chroma_left * image.u.pixel_stride;
+    cropped.v.data = image.v.RowAt(chroma_top) + chroma_left * image.v.pixel_stride;
+    cropped.width = width;
+    cropped.height = height;
+    return cropped;
+}
+
+PlanarImage FlipPlanarImage(const PlanarImage& image) {
+    PlanarImage flipped = image;
+    flipped.y.data = image.y.RowAt(image.height - 1);
+    flipped.u.data = image.u.RowAt(image.chroma_height() - 1);
+    flipped.v.data = image.v.RowAt(image.chroma_height() - 1);
+    flipped.y.row_stride = -image.y.row_stride;
+    flipped.u.row_stride = -image.u.row_stride;
+    flipped.v.row_stride = -image.v.row_stride;
+    return flipped;
+}
+
+}  // namespace camerax
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_PLANES_H_
+#define CAMERA_CORE_IMAGE_PLANES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camerax {
+
+/**
+ * A single image plane: the address of its first sample plus the distance in bytes between
+ * vertically and horizontally adjacent samples.
+ */
+struct Plane {
+    uint8_t* data = nullptr;
+    int row_stride = 0;
+    int pixel_stride = 1;
+
+    uint8_t* RowAt(int row) const {
+        return data + static_cast<ptrdiff_t>(row) * row_stride;
+    }
+};
+
+/**
+ * How the chroma samples of an Android420 image are laid out in memory.
+ */
+enum class ChromaLayout {
+    // U and V are two separate tightly packed planes (I420 / YV12).
+    kPlanar,
+    // U and V are interleaved in a single plane starting with U (NV12).
+    kSemiPlanarUV,
+    // U and V are interleaved in a single plane starting with V (NV21).
+    kSemiPlanarVU,
+    // Any other combination of pixel strides, e.g. padded or non-adjacent chroma samples.
+    kFlexible,
+};
+
+/**
+ * The size of the chroma planes relative to luma, as in the flexible YUV formats of
+ * ImageFormat.
+ */
+enum class ChromaSubsampling {
+    // Half the width and half the height (YUV_420_888).
+    k420,
+    // Half the width and the full height (YUV_422_888).
+    k422,
+    // The full width and height (YUV_444_888).
+    k444,
+};
+
+/**
+ * Describes a YUV_420_888 (Android420) image plane by plane, independent of where the memory
+ * comes from: direct ByteBuffers of a media.Image, a locked AHardwareBuffer or plain memory.
+ * YUV_422_888 and YUV_444_888 images are described the same way with a different
+ * {@code subsampling}; the chroma layout is detected from the strides for all three.
+ *
+ * <p>The descriptor does not own the memory it points to.
+ */
+struct PlanarImage {
+    Plane y;
+    Plane u;
+    Plane v;
+    int width = 0;
+    int height = 0;
+    ChromaSubsampling subsampling = ChromaSubsampling::k420;
+
+    int chroma_width() const {
+        return subsampling == ChromaSubsampling::k444 ? width : (width + 1) >> 1;
+    }
+    int chroma_height() const {
+        return subsampling == ChromaSubsampling::k420 ? (height + 1) >> 1 : height;
+    }
+
+    bool IsValid() const;
+    ChromaLayout chroma_layout() const;
+};
+
+/**
+ * Wraps separately allocated planes. The U and V planes share the same row and pixel strides as
+ * it is guaranteed for YUV_420_888 images.
+ */
+PlanarImage WrapAndroid420(uint8_t* y, int y_row_stride, int y_pixel_stride,
+                           uint8_t* u, int uv_row_stride, uint8_t* v, int uv_pixel_stride,
+                           int width, int height);
+
+/**
+ * Wraps a contiguous I420 buffer with tightly packed planes of the given luma stride.
+ */
+PlanarImage WrapI420(uint8_t* data, int width, int height, int stride_y);
+
+/**
+ * Wraps a contiguous NV12 (or NV21 if {@code vu_order} is set) buffer whose chroma plane starts
+ * right after {@code slice_height} rows of luma.
+ */
+PlanarImage WrapNV12(uint8_t* data, int width, int height, int stride, int slice_height,
+                     bool vu_order);
+
+/**
+ * The layout of a video encoder input buffer: {@code slice_height} rows of {@code stride} luma
+ * bytes followed by the chroma, planar with half the stride and slice height or interleaved with
+ * the full stride.
+ */
+struct CodecBufferLayout {
+    int stride = 0;
+    int slice_height = 0;
+    size_t size = 0;
+};
+
+/**
+ * Computes the layout of a codec buffer for an image of the given size, with the stride and the
+ * slice height rounded up to the alignments the codec requires, e.g. 16 for macroblocks.
+ */
+CodecBufferLayout GetCodecBufferLayout(int width, int height, ChromaLayout chroma_layout,
+                                       int stride_alignment, int slice_alignment);
+
+/**
+ * Wraps a codec buffer of the given layout, see {@link GetCodecBufferLayout}.
+ */
+PlanarImage WrapCodecBuffer(uint8_t* data, int width, int height, ChromaLayout chroma_layout,
+                            const CodecBufferLayout& layout);
+
+/**
+ * Returns the number of bytes needed for a tightly packed I420 image of the given size.
+ */
+size_t I420BufferSize(int width, int height);
+
+/**
+ * Returns a descriptor pointing at the given sub-rectangle of {@code image}. The left and top
+ * offsets are rounded down to even values so that chroma stays aligned with luma.
+ */
+PlanarImage CropPlanarImage(const PlanarImage& image, int left, int top, int width, int height);
+
+/**
+ * Returns a descriptor that walks {@code image} bottom up, i.e. an upside down view of it with
+ * negative row strides. Nothing is copied.
+ */
+PlanarImage FlipPlanarImage(const PlanarImage& image);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_PLANES_H_
@@ -16,10 +16,12 @@
 
 #include <jni.h>
 #include <string>
+#include <dlfcn.h>
 #include <android/log.h>
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdlib>
 
@@ -30,6 +32,30 @@
 #include "libyuv/convert.h"
 #include "libyuv/planar_functions.h"
 
+#include "burst_merge.h"
+#include "conversion_cache.h"
+#include "depth_kernels.h"
+#include "frame_ring.h"
+#include "hardware_buffer_planes.h"
+#include "image_kernels.h"
+#include "image_pipeline.h"
+#include "image_planes.h"
+#include "image_pyramid.h"
+#include "image_transpose.h"
+#include "jpeg_blob.h"
+#include "jpeg_decoder.h"
+#include "jpeg_encoder.h"
+#include "jpeg_transform.h"
+#include "kernel_dispatch.h"
+#include "letterbox.h"
+#include "luma_pipeline.h"
+#include "plane_hash.h"
+#include "privacy_mask.h"
+#include "raw_kernels.h"
+#include "rgb_to_yuv.h"
+#include "stripe_pool.h"
+#include "yuv_overlay.h"
+
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "YuvToRgbJni", __VA_ARGS__)
 
 #define align_buffer_64(var, size)                                           \
@@ -55,55 +81,619 @@ static void weave_pixels(const uint8_t* src_u,
     }
 }
 
-static libyuv::RotationMode get_rotation_mode(int rotation) {
-    libyuv::RotationMode mode = libyuv::kRotate0;
-    switch (rotation) {
-        case 0:
-            mode = libyuv::kRotate0;
-            break;
-        case 90:
-            mode = libyuv::kRotate90;
+// Wraps the direct ByteBuffers of a YUV_420_888 image without copying.
+static camerax::PlanarImage PlanarImageFromByteBuffers(JNIEnv* env,
+                                                       jobject y,
+                                                       jint stride_y,
+                                                       jint pixel_stride_y,
+                                                       jobject u,
+                                                       jint stride_u,
+                                                       jobject v,
+                                                       jint stride_v,
+                                                       jint pixel_stride_uv,
+                                                       jint width,
+                                                       jint height) {
+    camerax::PlanarImage image;
+    image.y = {static_cast<uint8_t*>(env->GetDirectBufferAddress(y)), stride_y, pixel_stride_y};
+    image.u = {static_cast<uint8_t*>(env->GetDirectBufferAddress(u)), stride_u, pixel_stride_uv};
+    image.v = {static_cast<uint8_t*>(env->GetDirectBufferAddress(v)), stride_v, pixel_stride_uv};
+    image.width = width;
+    image.height = height;
+    return image;
+}
+
+// Returns whether every plane of the image fits the capacity of the direct buffer it was wrapped
+// from, so that strides passed from Java cannot reach past the end of a buffer.
+static bool PlanesFitByteBuffers(JNIEnv* env,
+                                 const camerax::PlanarImage& image,
+                                 jobject y,
+                                 jobject u,
+                                 jobject v) {
+    auto fits = [env](jobject buffer, const camerax::Plane& plane, int cols, int rows) {
+        const jlong row_bytes = static_cast<jlong>(plane.pixel_stride) * (cols - 1) + 1;
+        return plane.row_stride >= row_bytes
+                && env->GetDirectBufferCapacity(buffer)
+                        >= static_cast<jlong>(plane.row_stride) * (rows - 1) + row_bytes;
+    };
+    return image.IsValid()
+            && fits(y, image.y, image.width, image.height)
+            && fits(u, image.u, image.chroma_width(), image.chroma_height())
+            && fits(v, image.v, image.chroma_width(), image.chroma_height());
+}
+
+// The ImageFormat constants of the flexible YUV formats.
+static constexpr jint kImageFormatYuv420 = 0x23;
+static constexpr jint kImageFormatYuv422 = 0x27;
+static constexpr jint kImageFormatYuv444 = 0x28;
+
+// Maps YUV_420_888, YUV_422_888 or YUV_444_888 to the chroma subsampling of the planes.
+static bool ChromaSubsamplingFromImageFormat(jint format,
+                                             camerax::ChromaSubsampling* subsampling) {
+    switch (format) {
+        case kImageFormatYuv420:
+            *subsampling = camerax::ChromaSubsampling::k420;
+            return true;
+        case kImageFormatYuv422:
+            *subsampling = camerax::ChromaSubsampling::k422;
+            return true;
+        case kImageFormatYuv444:
+            *subsampling = camerax::ChromaSubsampling::k444;
+            return true;
+        default:
+            LOGE("Unsupported YUV format %d.", format);
+            return false;
+    }
+}
+
+// Converts the planes to ABGR and writes the oriented result into the RGBA_8888 surface.
+static int ConvertToSurface(JNIEnv* env,
+                            const camerax::PlanarImage& src,
+                            const camerax::PixelShift& shift,
+                            jobject surface,
+                            jobject converted_buffer,
+                            const camerax::Orientation& orientation,
+                            size_t band_budget_bytes = 0) {
+    ANativeWindow* window = ANativeWindow_fromSurface(env, surface);
+    if (window == nullptr) {
+        return -1;
+    }
+    ANativeWindow_Buffer buffer;
+    int lockResult = ANativeWindow_lock(window, &buffer, NULL);
+    if(lockResult != 0 || buffer.format != WINDOW_FORMAT_RGBA_8888) {
+        ANativeWindow_release(window);
+        return -1;
+    }
+
+    uint8_t* buffer_ptr = reinterpret_cast<uint8_t*>(buffer.bits);
+    uint8_t* converted_buffer_ptr = converted_buffer != NULL
+            ? static_cast<uint8_t*>(env->GetDirectBufferAddress(converted_buffer)) : nullptr;
+
+    int result;
+    if (band_budget_bytes > 0 && !shift.IsShifted()) {
+        // Streams row bands straight into the window, the working set is bounded by the budget.
+        result = camerax::Android420ToRotatedABGRInBands(src,
+                                                         buffer_ptr,
+                                                         buffer.stride * 4,
+                                                         orientation,
+                                                         band_budget_bytes);
+    } else if (shift.IsShifted() || src.subsampling != camerax::ChromaSubsampling::k420
+               || (orientation.rotation != 0 && ((src.width | src.height) & 1) != 0)) {
+        // The planner only handles 4:2:0, 4:2:2 and 4:4:4 frames are converted at full chroma
+        // resolution and rotated through the converted buffer. Rotating 4:2:0 with an odd
+        // dimension in YUV pairs the last row or column with other chroma samples than
+        // converting first, so those frames keep the convert then rotate order as well.
+        result = camerax::Android420ToRotatedABGR(src,
+                                                  shift,
+                                                  orientation.rotation != 0
+                                                          ? converted_buffer_ptr : nullptr,
+                                                  buffer_ptr,
+                                                  buffer.stride * 4,
+                                                  orientation);
+    } else {
+        // Lets the planner rotate in YUV before the expansion to RGBA. The converted buffer is
+        // large enough to hold the planner's YUV intermediates.
+        camerax::PipelineRequest request;
+        request.orientation = orientation;
+        camerax::PipelinePlan plan;
+        camerax::PipelineDestination dst;
+        dst.abgr = buffer_ptr;
+        dst.abgr_stride = buffer.stride * 4;
+        size_t scratch_size = converted_buffer_ptr != nullptr
+                ? static_cast<size_t>(env->GetDirectBufferCapacity(converted_buffer)) : 0;
+        result = camerax::PlanPipeline(src, request, &plan) == 0
+                ? camerax::RunPipeline(src, plan, dst, converted_buffer_ptr, scratch_size, nullptr)
+                : -1;
+    }
+
+    ANativeWindow_unlockAndPost(window);
+    ANativeWindow_release(window);
+    return result;
+}
+
+// Converts the planes to ABGR directly into the locked pixels of the bitmap.
+static int ConvertToBitmap(JNIEnv* env,
+                           const camerax::PlanarImage& src,
+                           jobject bitmap,
+                           jint bitmap_stride) {
+    void* bitmapAddress = nullptr;
+
+    // get bitmap address
+    int lockResult =  AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress);
+    if (lockResult != 0) {
+        return -1;
+    }
+
+    int result = camerax::Android420ToABGR(src,
+                                           reinterpret_cast<uint8_t *> (bitmapAddress),
+                                           bitmap_stride,
+                                           /* is_full_swing = */true);
+
+    if (result != 0) {
+        AndroidBitmap_unlockPixels(env,bitmap);
+        return -1;
+    }
+
+    // balance call to AndroidBitmap_lockPixels
+    int unlockResult = AndroidBitmap_unlockPixels(env,bitmap);
+    if (unlockResult != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Locks a BLOB buffer of the surface that can hold max_jpeg_size bytes of JPEG data and lets
+// encode(buffer, capacity) fill it in place. encode returns the number of bytes written or a
+// negative value on failure. The tail of the buffer is finished with a camera3_jpeg_blob
+// trailer since the final size is only known after writing.
+//
+// The geometry request is only a hint when the consumer fixed its buffer size, so the locked
+// buffer is checked before anything is encoded. A buffer that was locked but could not be
+// filled is posted cleared, see camerax::ClearFailedJpegBlob, and -1 is returned so that the
+// caller can drop the image it produces.
+template <typename EncodeFn>
+static jint EncodeToBlobSurface(JNIEnv* env, jobject surface, size_t max_jpeg_size,
+                                EncodeFn encode) {
+    size_t buffer_size = camerax::JpegBlobBufferSize(max_jpeg_size);
+    if (buffer_size > static_cast<size_t>(INT32_MAX)) {
+        LOGE("JPEG too large for a BLOB buffer.");
+        return -1;
+    }
+    ANativeWindow *window = ANativeWindow_fromSurface(env, surface);
+    if (window == nullptr) {
+        LOGE("Failed to get ANativeWindow");
+        return -1;
+    }
+
+    if (ANativeWindow_setBuffersGeometry(window, static_cast<int32_t>(buffer_size), 1,
+                                         AHARDWAREBUFFER_FORMAT_BLOB) != 0) {
+        ANativeWindow_release(window);
+        LOGE("Failed to set the BLOB buffer geometry.");
+        return -1;
+    }
+
+    ANativeWindow_Buffer buffer;
+    int lockResult = ANativeWindow_lock(window, &buffer, NULL);
+    if (lockResult != 0) {
+        ANativeWindow_release(window);
+        LOGE("Failed to lock window.");
+        return -1;
+    }
+
+    uint8_t *buffer_ptr = reinterpret_cast<uint8_t *>(buffer.bits);
+    // BLOB buffers are one row of bytes and consumers look for the trailer at the end of the
+    // width. Any other format has at least one byte per pixel.
+    const size_t blob_size = buffer.width > 0 ? static_cast<size_t>(buffer.width) : 0;
+    const size_t capacity = buffer.stride > 0 && buffer.height > 0
+            ? static_cast<size_t>(buffer.stride) * static_cast<size_t>(buffer.height) : 0;
+    long jpeg_size = -1;
+    if (buffer.format != AHARDWAREBUFFER_FORMAT_BLOB || buffer.height != 1
+        || blob_size < buffer_size || capacity < blob_size) {
+        LOGE("The surface does not provide a BLOB buffer of %zu bytes.", buffer_size);
+    } else {
+        jpeg_size = encode(buffer_ptr, max_jpeg_size);
+        if (jpeg_size <= 0) {
+            LOGE("Failed to write JPEG.");
+            jpeg_size = -1;
+        }
+    }
+    if (jpeg_size > 0) {
+        camerax::FinishJpegBlob(buffer_ptr, blob_size, static_cast<size_t>(jpeg_size));
+    } else {
+        camerax::ClearFailedJpegBlob(buffer_ptr, std::min(capacity, blob_size));
+    }
+
+    ANativeWindow_unlockAndPost(window);
+    ANativeWindow_release(window);
+    return jpeg_size > 0 ? static_cast<jint>(jpeg_size) : -1;
+}
+
+// Returns the JPEG in the first jpeg_size bytes of the direct buffer, or null if the buffer is
+// not direct or holds fewer bytes.
+static const uint8_t* JpegFromByteBuffer(JNIEnv* env, jobject jpeg_buffer, jint jpeg_size) {
+    const uint8_t* data = static_cast<const uint8_t*>(env->GetDirectBufferAddress(jpeg_buffer));
+    if (data == nullptr || jpeg_size <= 0
+        || env->GetDirectBufferCapacity(jpeg_buffer) < jpeg_size) {
+        LOGE("Invalid JPEG buffer.");
+        return nullptr;
+    }
+    return data;
+}
+
+// Builds the options of a reduced size JPEG decode from the JNI arguments.
+static camerax::ScaledDecodeOptions ScaledDecodeOptionsFromArgs(jint scale_denom,
+                                                                jint roi_left,
+                                                                jint roi_top,
+                                                                jint roi_width,
+                                                                jint roi_height) {
+    camerax::ScaledDecodeOptions options;
+    options.scale_denom = scale_denom;
+    options.region.left = roi_left;
+    options.region.top = roi_top;
+    options.region.width = roi_width;
+    options.region.height = roi_height;
+    return options;
+}
+
+// Builds the options of a lossless JPEG transformation from the JNI arguments.
+static camerax::JpegTransformOptions JpegTransformOptionsFromArgs(jint op,
+                                                                 jint edge_mode,
+                                                                 jboolean copy_markers) {
+    camerax::JpegTransformOptions options;
+    options.op = static_cast<camerax::JpegTransformOp>(op);
+    options.edge_mode = static_cast<camerax::JpegEdgeMode>(edge_mode);
+    options.copy_markers = copy_markers;
+    return options;
+}
+
+// Builds the crop and orientation part of a pipeline request from the JNI arguments.
+static camerax::PipelineRequest PipelineRequestFromArgs(jint crop_left,
+                                                        jint crop_top,
+                                                        jint crop_width,
+                                                        jint crop_height,
+                                                        jint rotation,
+                                                        jboolean mirror) {
+    camerax::PipelineRequest request;
+    request.crop_left = crop_left;
+    request.crop_top = crop_top;
+    request.crop_width = crop_width;
+    request.crop_height = crop_height;
+    request.orientation = camerax::Orientation::FromRotation(rotation, mirror);
+    return request;
+}
+
+// Builds a luma request from the JNI arguments.
+static camerax::LumaRequest LumaRequestFromArgs(jint crop_left,
+                                                jint crop_top,
+                                                jint crop_width,
+                                                jint crop_height,
+                                                jint rotation,
+                                                jboolean mirror,
+                                                jint output_width,
+                                                jint output_height) {
+    camerax::LumaRequest request;
+    request.crop_left = crop_left;
+    request.crop_top = crop_top;
+    request.crop_width = crop_width;
+    request.crop_height = crop_height;
+    request.orientation = camerax::Orientation::FromRotation(rotation, mirror);
+    request.output_width = output_width;
+    request.output_height = output_height;
+    return request;
+}
+
+// Builds a depth request from the JNI arguments.
+static camerax::DepthRequest DepthRequestFromArgs(jint crop_left,
+                                                  jint crop_top,
+                                                  jint crop_width,
+                                                  jint crop_height,
+                                                  jint rotation,
+                                                  jboolean mirror) {
+    camerax::DepthRequest request;
+    request.crop_left = crop_left;
+    request.crop_top = crop_top;
+    request.crop_width = crop_width;
+    request.crop_height = crop_height;
+    request.orientation = camerax::Orientation::FromRotation(rotation, mirror);
+    return request;
+}
+
+// Wraps the video encoder input buffer dst as a width x height image in I420 (format 1), NV12
+// (2) or NV21 (3), see camerax::GetCodecBufferLayout. Returns the size of the layout, or 0 if
+// the format is unknown or the buffer too small.
+static size_t WrapCodecDestination(JNIEnv* env,
+                                   jobject dst,
+                                   jint width,
+                                   jint height,
+                                   jint format,
+                                   jint stride_alignment,
+                                   jint slice_alignment,
+                                   camerax::PlanarImage* image) {
+    camerax::ChromaLayout chroma_layout;
+    switch (static_cast<camerax::PipelineFormat>(format)) {
+        case camerax::PipelineFormat::kI420:
+            chroma_layout = camerax::ChromaLayout::kPlanar;
             break;
-        case 180:
-            mode = libyuv::kRotate180;
+        case camerax::PipelineFormat::kNV12:
+            chroma_layout = camerax::ChromaLayout::kSemiPlanarUV;
             break;
-        case 270:
-            mode = libyuv::kRotate270;
+        case camerax::PipelineFormat::kNV21:
+            chroma_layout = camerax::ChromaLayout::kSemiPlanarVU;
             break;
         default:
+            LOGE("Unsupported codec format %d.", format);
+            return 0;
+    }
+    camerax::CodecBufferLayout layout = camerax::GetCodecBufferLayout(
+            width, height, chroma_layout, stride_alignment, slice_alignment);
+    uint8_t* data = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    if (data == nullptr || width <= 0 || height <= 0
+        || env->GetDirectBufferCapacity(dst) < static_cast<jlong>(layout.size)) {
+        LOGE("Codec buffer too small.");
+        return 0;
+    }
+    *image = camerax::WrapCodecBuffer(data, width, height, chroma_layout, layout);
+    return layout.size;
+}
+
+// Returns the DEPTH16 samples of the direct buffer src, or null if they do not fit it.
+static const uint16_t* Depth16FromByteBuffer(JNIEnv* env,
+                                             jobject src,
+                                             jint row_stride,
+                                             jint width,
+                                             jint height) {
+    const uint16_t* data = static_cast<const uint16_t*>(env->GetDirectBufferAddress(src));
+    if (data == nullptr || width <= 0 || height <= 0 || row_stride % 2 != 0
+        || row_stride < 2 * width
+        || env->GetDirectBufferCapacity(src)
+                < static_cast<jlong>(row_stride) * (height - 1) + 2 * width) {
+        LOGE("Invalid DEPTH16 image.");
+        return nullptr;
+    }
+    return data;
+}
+
+// Threads shared by all stripe parallel kernels. Never destroyed, so that no worker is joined
+// while the library is unloaded.
+static camerax::StripePool* GetStripePool() {
+    static camerax::StripePool* pool = new camerax::StripePool();
+    return pool;
+}
+
+// Conversion parameters of cached results, see camerax::ConversionKey::params.
+static constexpr uint32_t kCachedBitmapABGR = 1;
+
+// Conversion results shared by all consumers of the library.
+static camerax::ConversionCache* GetConversionCache() {
+    static camerax::ConversionCache* cache = new camerax::ConversionCache();
+    return cache;
+}
+
+// Builds the options of a pyramid from the JNI arguments.
+static camerax::PyramidOptions PyramidOptionsFromArgs(jint level_count,
+                                                      jfloat ratio,
+                                                      jint format) {
+    camerax::PyramidOptions options;
+    options.level_count = level_count;
+    options.ratio = ratio;
+    options.format = static_cast<camerax::PyramidFormat>(format);
+    return options;
+}
+
+// The ImageFormat constants of the RAW formats.
+static constexpr jint kImageFormatRawSensor = 0x20;
+static constexpr jint kImageFormatRaw10 = 0x25;
+static constexpr jint kImageFormatRaw12 = 0x26;
+
+// Describes the RAW_SENSOR, RAW10 or RAW12 image in the direct buffer src. Returns an invalid
+// image if the format is unknown or the buffer is too small.
+static camerax::RawImage RawImageFromByteBuffer(JNIEnv* env,
+                                                jobject src,
+                                                jint row_stride,
+                                                jint width,
+                                                jint height,
+                                                jint format) {
+    camerax::RawImage image;
+    switch (format) {
+        case kImageFormatRawSensor:
+            image.format = camerax::RawFormat::kRaw16;
+            break;
+        case kImageFormatRaw10:
+            image.format = camerax::RawFormat::kRaw10;
             break;
+        case kImageFormatRaw12:
+            image.format = camerax::RawFormat::kRaw12;
+            break;
+        default:
+            LOGE("Unsupported RAW format %d.", format);
+            return image;
+    }
+    image.row_stride = row_stride;
+    image.width = width;
+    image.height = height;
+    uint8_t* data = static_cast<uint8_t*>(env->GetDirectBufferAddress(src));
+    if (data == nullptr || !image.IsValid()
+        || env->GetDirectBufferCapacity(src)
+                < static_cast<jlong>(row_stride) * (height - 1) + image.row_bytes()) {
+        LOGE("Invalid RAW image.");
+        return image;
+    }
+    image.data = data;
+    return image;
+}
+
+// Builds the develop options of a RAW image from the JNI arguments. black_level holds the four
+// values of BlackLevelPattern and gains the four of RggbChannelVector.
+static bool RawDevelopOptionsFromArgs(JNIEnv* env,
+                                      jint cfa_pattern,
+                                      jintArray black_level,
+                                      jint white_level,
+                                      jfloatArray gains,
+                                      jint method,
+                                      jboolean apply_gamma,
+                                      camerax::RawDevelopOptions* options) {
+    if (black_level == nullptr || env->GetArrayLength(black_level) < 4 || gains == nullptr
+        || env->GetArrayLength(gains) < 4) {
+        LOGE("Invalid RAW develop options.");
+        return false;
+    }
+    options->pattern = static_cast<camerax::CfaPattern>(cfa_pattern);
+    jint black[4];
+    env->GetIntArrayRegion(black_level, 0, 4, black);
+    std::copy(black, black + 4, options->black_level);
+    options->white_level = white_level;
+    env->GetFloatArrayRegion(gains, 0, 4, options->gains);
+    options->method = static_cast<camerax::DemosaicMethod>(method);
+    options->apply_gamma = apply_gamma;
+    return true;
+}
+
+// Reports the statistics of a pipeline run as {estimated bytes, measured bytes, elapsed
+// nanoseconds, stage count} if the caller passed an array for them.
+static void WritePipelineStats(JNIEnv* env, jlongArray stats_out,
+                               const camerax::PipelineStats& stats) {
+    if (stats_out == nullptr || env->GetArrayLength(stats_out) < 4) {
+        return;
+    }
+    jlong values[4] = {static_cast<jlong>(stats.estimated_bytes),
+                       static_cast<jlong>(stats.measured_bytes),
+                       static_cast<jlong>(stats.elapsed_ns),
+                       static_cast<jlong>(stats.stage_count)};
+    env->SetLongArrayRegion(stats_out, 0, 4, values);
+}
+
+// Reports the statistics of a burst merge as {frame count, pyramid, alignment, accumulation and
+// output nanoseconds, merged luma samples} if the caller passed an array for them.
+static void WriteBurstMergeStats(JNIEnv* env, jlongArray stats_out,
+                                 const camerax::BurstMergeStats& stats) {
+    if (stats_out == nullptr || env->GetArrayLength(stats_out) < 6) {
+        return;
+    }
+    jlong values[6] = {static_cast<jlong>(stats.frame_count),
+                       static_cast<jlong>(stats.pyramid_ns),
+                       static_cast<jlong>(stats.align_ns),
+                       static_cast<jlong>(stats.accumulate_ns),
+                       static_cast<jlong>(stats.output_ns),
+                       static_cast<jlong>(stats.merged_samples)};
+    env->SetLongArrayRegion(stats_out, 0, 6, values);
+}
+
+typedef AHardwareBuffer* (*FromHardwareBufferFn)(JNIEnv*, jobject);
+
+// AHardwareBuffer_fromHardwareBuffer is only available from API level 26.
+static AHardwareBuffer* HardwareBufferFromJava(JNIEnv* env, jobject hardware_buffer) {
+    static const FromHardwareBufferFn from_hardware_buffer = [] {
+        void* lib = dlopen("libandroid.so", RTLD_NOW);
+        return lib == nullptr ? nullptr : reinterpret_cast<FromHardwareBufferFn>(
+                dlsym(lib, "AHardwareBuffer_fromHardwareBuffer"));
+    }();
+    if (from_hardware_buffer == nullptr || hardware_buffer == nullptr) {
+        return nullptr;
+    }
+    return from_hardware_buffer(env, hardware_buffer);
+}
+
+// Builds the options of an RGB to YUV conversion from the JNI arguments.
+static camerax::RgbToYuvOptions RgbToYuvOptionsFromArgs(jint matrix,
+                                                        jboolean full_range,
+                                                        jint order,
+                                                        jint rotation) {
+    camerax::RgbToYuvOptions options;
+    options.matrix = static_cast<camerax::YuvMatrix>(matrix);
+    options.full_range = full_range;
+    options.order = static_cast<camerax::RgbOrder>(order);
+    options.rotation = rotation;
+    return options;
+}
+
+// Converts the pixels of the RGBA_8888 bitmap described by info into dst.
+static int ConvertBitmapToYuv(JNIEnv* env,
+                              jobject bitmap,
+                              const AndroidBitmapInfo& info,
+                              const camerax::RgbToYuvOptions& options,
+                              const camerax::PlanarImage& dst) {
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
     }
-    return mode;
-}
-
-// Helper function to convert Android420 to ABGR with options to choose full swing or studio swing.
-static int Android420ToABGR(const uint8_t* src_y,
-                            int src_stride_y,
-                            const uint8_t* src_u,
-                            int src_stride_u,
-                            const uint8_t* src_v,
-                            int src_stride_v,
-                            int src_pixel_stride_uv,
-                            uint8_t* dst_abgr,
-                            int dst_stride_abgr,
-                            bool is_full_swing,
-                            int width,
-                            int height) {
-    return Android420ToARGBMatrix(src_y,
-                                  src_stride_y,
-                                  src_v,
-                                  src_stride_v,
-                                  src_u,
-                                  src_stride_u,
-                                  src_pixel_stride_uv,
-                                  dst_abgr,
-                                  dst_stride_abgr,
-                                  is_full_swing
-                                      ? &libyuv::kYvuJPEGConstants : &libyuv::kYvuI601Constants,
-                                  width,
-                                  height);
+    int result = camerax::RgbToYuv420(static_cast<const uint8_t*>(bitmapAddress),
+                                      static_cast<int>(info.stride),
+                                      static_cast<int>(info.width),
+                                      static_cast<int>(info.height), options, dst,
+                                      GetStripePool());
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+// Reads the {left, top, width, height} groups of regions and builds the options of a privacy
+// mask. Returns false if the array is null or not a whole number of groups.
+static bool MaskArgsFromJava(JNIEnv* env,
+                             jintArray regions,
+                             jint mode,
+                             jint size,
+                             std::vector<camerax::MaskRegion>* mask_regions,
+                             camerax::MaskOptions* options) {
+    const jsize length = regions != nullptr ? env->GetArrayLength(regions) : -1;
+    if (length < 0 || length % 4 != 0) {
+        LOGE("Invalid mask regions.");
+        return false;
+    }
+    std::vector<jint> values(length);
+    env->GetIntArrayRegion(regions, 0, length, values.data());
+    mask_regions->resize(length / 4);
+    for (size_t i = 0; i < mask_regions->size(); ++i) {
+        (*mask_regions)[i] = {values[4 * i], values[4 * i + 1], values[4 * i + 2],
+                              values[4 * i + 3]};
+    }
+    options->mode = static_cast<camerax::MaskMode>(mode);
+    options->size = size;
+    return true;
+}
+
+// Builds a letterbox request from the JNI arguments. {@code pad_color} is an ARGB color int
+// whose alpha is ignored.
+static camerax::LetterboxRequest LetterboxRequestFromArgs(jint crop_left,
+                                                          jint crop_top,
+                                                          jint crop_width,
+                                                          jint crop_height,
+                                                          jint rotation,
+                                                          jboolean mirror,
+                                                          jint box_width,
+                                                          jint box_height,
+                                                          jint pad_color,
+                                                          jboolean center) {
+    camerax::LetterboxRequest request;
+    request.crop_left = crop_left;
+    request.crop_top = crop_top;
+    request.crop_width = crop_width;
+    request.crop_height = crop_height;
+    request.orientation = camerax::Orientation::FromRotation(rotation, mirror);
+    request.box_width = box_width;
+    request.box_height = box_height;
+    request.pad_color[0] = static_cast<uint8_t>(pad_color >> 16);
+    request.pad_color[1] = static_cast<uint8_t>(pad_color >> 8);
+    request.pad_color[2] = static_cast<uint8_t>(pad_color);
+    request.center = center;
+    return request;
 }
 
+// Writes the image's rectangle of the box to {@code placement_out} as {left, top, width,
+// height} and the source to box transform to {@code transform_out} as the 9 values of an
+// android.graphics.Matrix. Either array may be null.
+static void WriteLetterboxPlacement(JNIEnv* env,
+                                    const camerax::LetterboxPlacement& placement,
+                                    jintArray placement_out,
+                                    jfloatArray transform_out) {
+    if (placement_out != nullptr && env->GetArrayLength(placement_out) >= 4) {
+        const jint rect[4] = {placement.left, placement.top, placement.width, placement.height};
+        env->SetIntArrayRegion(placement_out, 0, 4, rect);
+    }
+    if (transform_out != nullptr && env->GetArrayLength(transform_out) >= 9) {
+        env->SetFloatArrayRegion(transform_out, 0, 9, placement.transform);
+    }
+}
 
 extern "C" {
 JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeCopyBetweenByteBufferAndBitmap (
@@ -299,7 +889,16 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeWriteJpegToSu
     return 0;
 }
 
-JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToABGR(
+/**
+ * Encodes the YUV_420_888 planes as JPEG directly into a BLOB buffer of the Surface.
+ *
+ * <p>This replaces compressing with YuvImage and copying the resulting byte array with
+ * nativeWriteJpegToSurface. The buffer is sized for the largest JPEG the frame can produce and a
+ * camera3_jpeg_blob trailer reports the actual JPEG size, so the encoder can write in place.
+ *
+ * @return the size of the JPEG in bytes, or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeEncodeAndroid420ToJpegSurface(
         JNIEnv* env,
         jclass,
         jobject src_y,
@@ -310,198 +909,601 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroi
         jint src_stride_v,
         jint src_pixel_stride_y,
         jint src_pixel_stride_uv,
-        jobject surface,
-        jobject converted_buffer,
         jint width,
         jint height,
-        jint start_offset_y,
-        jint start_offset_u,
-        jint start_offset_v,
-        int rotation) {
+        jint quality,
+        jint rotation,
+        jboolean mirror,
+        jobject surface) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!src.IsValid()) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
 
-    uint8_t* src_y_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_y));
-    uint8_t* src_u_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_u));
-    uint8_t* src_v_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_v));
+    return EncodeToBlobSurface(env, surface, camerax::MaxJpegSize(width, height),
+                               [&](uint8_t* buffer, size_t capacity) {
+                                   return camerax::EncodeAndroid420ToJpeg(
+                                           src, quality,
+                                           camerax::Orientation::FromRotation(rotation, mirror),
+                                           buffer, capacity);
+                               });
+}
 
-    ANativeWindow* window = ANativeWindow_fromSurface(env, surface);
-    if (window == nullptr) {
+/**
+ * Computes the size of the image a reduced size JPEG decode will produce, so that the caller can
+ * allocate the destination. The width and height are stored at position 0 and 1 of
+ * {@code size_out}.
+ *
+ * <p>The region (roi) is given in full resolution coordinates, a zero sized region selects the
+ * whole image.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeGetScaledJpegSize(
+        JNIEnv* env,
+        jclass,
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint scale_denom,
+        jint roi_left,
+        jint roi_top,
+        jint roi_width,
+        jint roi_height,
+        jintArray size_out) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    if (jpeg_ptr == nullptr || size_out == nullptr || env->GetArrayLength(size_out) < 2) {
         return -1;
     }
-    ANativeWindow_Buffer buffer;
-    int lockResult = ANativeWindow_lock(window, &buffer, NULL);
-    if(lockResult != 0 || buffer.format != WINDOW_FORMAT_RGBA_8888) {
-        ANativeWindow_release(window);
+    camerax::ScaledDecodeOptions options = ScaledDecodeOptionsFromArgs(
+            scale_denom, roi_left, roi_top, roi_width, roi_height);
+    int width = 0;
+    int height = 0;
+    if (camerax::GetScaledJpegSize(jpeg_ptr, jpeg_size, options, &width, &height) != 0) {
         return -1;
     }
-
-    libyuv::RotationMode mode = get_rotation_mode(rotation);
-    bool has_rotation = rotation != 0;
-
-    uint8_t* buffer_ptr = reinterpret_cast<uint8_t*>(buffer.bits);
-    uint8_t* converted_buffer_ptr = (has_rotation && converted_buffer != NULL)
-            ? static_cast<uint8_t*>(env->GetDirectBufferAddress(converted_buffer)) : nullptr;
-
-    uint8_t* dst_ptr = has_rotation ? converted_buffer_ptr : buffer_ptr;
-    int dst_stride_y = has_rotation ? (width * 4) : (buffer.stride * 4);
-
-    int result = 0;
-    // Apply workaround for one pixel shift issue by checking offset.
-    if (start_offset_y > 0 || start_offset_u > 0 || start_offset_v > 0) {
-
-        // TODO(b/195990691): extend the pixel shift to handle multiple corrupted pixels.
-        // We don't support multiple pixel shift now.
-        if (start_offset_y != src_pixel_stride_y
-            || start_offset_u != src_pixel_stride_uv
-            || start_offset_v != src_pixel_stride_uv) {
-            ANativeWindow_unlockAndPost(window);
-            ANativeWindow_release(window);
-            return -1;
-        }
-
-        // Convert yuv to rgb except the last line.
-        result = Android420ToABGR(src_y_ptr + start_offset_y,
-                                  src_stride_y,
-                                  src_u_ptr + start_offset_u,
-                                  src_stride_u,
-                                  src_v_ptr + start_offset_v,
-                                  src_stride_v,
-                                  src_pixel_stride_uv,
-                                  dst_ptr,
-                                  dst_stride_y,
-                                  /* is_full_swing = */true,
-                                  width,
-                                  height - 1);
-        if (result == 0) {
-            // Convert the last row with (width - 1) pixels
-            // since the last pixel's yuv data is missing.
-            result = Android420ToABGR(
-                    src_y_ptr + start_offset_y + src_stride_y * (height - 1),
-                    src_stride_y - 1,
-                    src_u_ptr + start_offset_u + src_stride_u * (height - 2) / 2,
-                    src_stride_u - 1,
-                    src_v_ptr + start_offset_v + src_stride_v * (height - 2) / 2,
-                    src_stride_v - 1,
-                    src_pixel_stride_uv,
-                    dst_ptr + dst_stride_y * (height - 1),
-                    dst_stride_y,
-                    /* is_full_swing = */true,
-                    width - 1,
-                    1);
-        }
-
-        if (result == 0) {
-            // Set the 2x2 pixels on the right bottom by duplicating the 3rd pixel
-            // from the right to left in each row.
-            for (int i = 0; i < 2; i++) {
-                for (int j = 0; j < 2; j++) {
-                    int r_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 1);
-                    int g_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 2);
-                    int b_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 3);
-                    int a_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 4);
-                    dst_ptr[r_ind] = dst_ptr[r_ind - 8];
-                    dst_ptr[g_ind] = dst_ptr[g_ind - 8];
-                    dst_ptr[b_ind] = dst_ptr[b_ind - 8];
-                    dst_ptr[a_ind] = dst_ptr[a_ind - 8];
-                }
-            }
-        }
-    } else {
-        result = Android420ToABGR(src_y_ptr + start_offset_y,
-                                          src_stride_y,
-                                          src_u_ptr + start_offset_u,
-                                          src_stride_u,
-                                          src_v_ptr + start_offset_v,
-                                          src_stride_v,
-                                          src_pixel_stride_uv,
-                                          dst_ptr,
-                                          dst_stride_y,
-                                          /* is_full_swing = */true,
-                                          width,
-                                          height);
-    }
-
-    // TODO(b/203141655): avoid unnecessary memory copy by merging libyuv API for rotation.
-    if (result == 0 && has_rotation) {
-        result = libyuv::ARGBRotate(dst_ptr,
-                                    dst_stride_y,
-                                    buffer_ptr,
-                                    buffer.stride * 4,
-                                    width,
-                                    height,
-                                    mode);
-    }
-
-    ANativeWindow_unlockAndPost(window);
-    ANativeWindow_release(window);
-    return result;
+    jint size[2] = {width, height};
+    env->SetIntArrayRegion(size_out, 0, 2, size);
+    return 0;
 }
 
-JNIEXPORT jint
-Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmap(
+/**
+ * Decodes the JPEG in the direct ByteBuffer at 1/scale_denom of its size straight into the
+ * pixels of an RGBA_8888 bitmap, for post-view thumbnails and previews.
+ *
+ * <p>The downscaling happens in the DCT domain and only the selected region is decoded, so the
+ * full resolution image is never materialized.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeDecodeJpegToBitmap(
         JNIEnv* env,
         jclass,
-        jobject src_y,
-        jint src_stride_y,
-        jobject src_u,
-        jint src_stride_u,
-        jobject src_v,
-        jint src_stride_v,
-        jint src_pixel_stride_y,
-        jint src_pixel_stride_uv,
-        jobject bitmap,
-        jint bitmap_stride,
-        jint width,
-        jint height) {
-
-    void* bitmapAddress = nullptr;
-
-    // get bitmap address
-    int lockResult =  AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress);
-    if (lockResult != 0) {
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint scale_denom,
+        jint roi_left,
+        jint roi_top,
+        jint roi_width,
+        jint roi_height,
+        jobject bitmap) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    if (jpeg_ptr == nullptr) {
+        return -1;
+    }
+    camerax::ScaledDecodeOptions options = ScaledDecodeOptionsFromArgs(
+            scale_denom, roi_left, roi_top, roi_width, roi_height);
+    int width = 0;
+    int height = 0;
+    if (camerax::GetScaledJpegSize(jpeg_ptr, jpeg_size, options, &width, &height) != 0) {
+        LOGE("Failed to read JPEG header.");
         return -1;
     }
 
-    uint8_t* src_y_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_y));
-    uint8_t* src_u_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_u));
-    uint8_t* src_v_ptr =
-            static_cast<uint8_t*>(env->GetDirectBufferAddress(src_v));
-
-    int dst_stride_y = bitmap_stride;
-
-    int result = Android420ToABGR(
-            src_y_ptr ,
-            src_stride_y,
-            src_u_ptr,
-            src_stride_u,
-            src_v_ptr,
-            src_stride_v,
-            src_pixel_stride_uv,
-            reinterpret_cast<uint8_t *> (bitmapAddress),
-            dst_stride_y,
-            /* is_full_swing = */true,
-            width,
-            height);
-
-    if (result != 0) {
-        AndroidBitmap_unlockPixels(env,bitmap);
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888
+        || static_cast<int>(info.width) < width || static_cast<int>(info.height) < height) {
+        LOGE("Bitmap does not fit the decoded image.");
         return -1;
     }
 
-    // balance call to AndroidBitmap_lockPixels
-    int unlockResult = AndroidBitmap_unlockPixels(env,bitmap);
-    if (unlockResult != 0) {
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    int result = camerax::DecodeJpegToRGBA(jpeg_ptr, jpeg_size, options,
+                                           static_cast<uint8_t*>(bitmapAddress),
+                                           static_cast<int>(info.stride));
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
         return -1;
     }
+    return result;
+}
 
-    return 0;
+/**
+ * Like nativeDecodeJpegToBitmap, but writes RGBA_8888 rows of {@code dst_stride} bytes into a
+ * direct ByteBuffer.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeDecodeJpegToRGBABuffer(
+        JNIEnv* env,
+        jclass,
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint scale_denom,
+        jint roi_left,
+        jint roi_top,
+        jint roi_width,
+        jint roi_height,
+        jobject dst_buffer,
+        jint dst_stride) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_buffer));
+    camerax::ScaledDecodeOptions options = ScaledDecodeOptionsFromArgs(
+            scale_denom, roi_left, roi_top, roi_width, roi_height);
+    int width = 0;
+    int height = 0;
+    if (jpeg_ptr == nullptr || dst_ptr == nullptr
+        || camerax::GetScaledJpegSize(jpeg_ptr, jpeg_size, options, &width, &height) != 0
+        || dst_stride < width * 4
+        || env->GetDirectBufferCapacity(dst_buffer)
+                < static_cast<jlong>(dst_stride) * (height - 1) + width * 4) {
+        return -1;
+    }
+    return camerax::DecodeJpegToRGBA(jpeg_ptr, jpeg_size, options, dst_ptr, dst_stride);
 }
 
-JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
+/**
+ * Like nativeDecodeJpegToBitmap, but writes full range YUV 4:2:0 into the given planes, which may
+ * be laid out as I420, NV12 or NV21.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeDecodeJpegToAndroid420(
+        JNIEnv* env,
+        jclass,
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint scale_denom,
+        jint roi_left,
+        jint roi_top,
+        jint roi_width,
+        jint roi_height,
+        jobject dst_y,
+        jint dst_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_uv) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    if (jpeg_ptr == nullptr) {
+        return -1;
+    }
+    camerax::ScaledDecodeOptions options = ScaledDecodeOptionsFromArgs(
+            scale_denom, roi_left, roi_top, roi_width, roi_height);
+    int width = 0;
+    int height = 0;
+    if (camerax::GetScaledJpegSize(jpeg_ptr, jpeg_size, options, &width, &height) != 0) {
+        return -1;
+    }
+    camerax::PlanarImage dst = PlanarImageFromByteBuffers(env,
+                                                          dst_y, dst_stride_y, 1,
+                                                          dst_u, dst_stride_u,
+                                                          dst_v, dst_stride_v,
+                                                          dst_pixel_stride_uv,
+                                                          width, height);
+    if (!PlanesFitByteBuffers(env, dst, dst_y, dst_u, dst_v)) {
+        LOGE("YUV planes do not fit the decoded image.");
+        return -1;
+    }
+    return camerax::DecodeJpegToAndroid420(jpeg_ptr, jpeg_size, options, dst);
+}
+
+/**
+ * Losslessly rotates, flips or transposes the JPEG in the direct ByteBuffer into
+ * {@code dst_buffer} by rearranging its DCT blocks, without decoding and re-encoding.
+ *
+ * <p>{@code op} follows jpegtran: 0 none, 1 flip horizontal, 2 flip vertical, 3 transpose,
+ * 4 transverse, 5 rotate 90, 6 rotate 180, 7 rotate 270. {@code edge_mode} 0 trims partial edge
+ * MCUs, 1 fails instead.
+ *
+ * @return the size of the transformed JPEG in bytes, or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeTransformJpeg(
+        JNIEnv* env,
+        jclass,
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint op,
+        jint edge_mode,
+        jboolean copy_markers,
+        jobject dst_buffer) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_buffer));
+    if (jpeg_ptr == nullptr || dst_ptr == nullptr) {
+        return -1;
+    }
+    size_t dst_capacity = static_cast<size_t>(env->GetDirectBufferCapacity(dst_buffer));
+    long size = camerax::TransformJpeg(jpeg_ptr, jpeg_size,
+                                       JpegTransformOptionsFromArgs(op, edge_mode, copy_markers),
+                                       dst_ptr, dst_capacity);
+    return size >= 0 ? static_cast<jint>(size) : -1;
+}
+
+/**
+ * Like nativeTransformJpeg, but writes the transformed JPEG directly into a BLOB buffer of the
+ * Surface, replacing a separate nativeWriteJpegToSurface copy.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeTransformJpegToSurface(
+        JNIEnv* env,
+        jclass,
+        jobject jpeg_buffer,
+        jint jpeg_size,
+        jint op,
+        jint edge_mode,
+        jboolean copy_markers,
+        jobject surface) {
+    const uint8_t* jpeg_ptr = JpegFromByteBuffer(env, jpeg_buffer, jpeg_size);
+    if (jpeg_ptr == nullptr) {
+        return -1;
+    }
+    camerax::JpegTransformOptions options =
+            JpegTransformOptionsFromArgs(op, edge_mode, copy_markers);
+    return EncodeToBlobSurface(env, surface, camerax::MaxTransformedJpegSize(jpeg_size),
+                               [&](uint8_t* buffer, size_t capacity) {
+                                   return camerax::TransformJpeg(jpeg_ptr, jpeg_size, options,
+                                                                 buffer, capacity);
+                               });
+}
+
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToABGR(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject surface,
+        jobject converted_buffer,
+        jint width,
+        jint height,
+        jint start_offset_y,
+        jint start_offset_u,
+        jint start_offset_v,
+        int rotation) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PixelShift shift;
+    shift.start_offset_y = start_offset_y;
+    shift.start_offset_u = start_offset_u;
+    shift.start_offset_v = start_offset_v;
+    return ConvertToSurface(env, src, shift, surface, converted_buffer,
+                            camerax::Orientation::FromRotation(rotation, /* mirror= */ false));
+}
+
+/**
+ * Like nativeConvertAndroid420ToABGR, but also mirrors the rotated frame horizontally if
+ * {@code mirror} is set, e.g. for front cameras. The mirroring happens while converting and
+ * rotating, so no extra pass over the RGBA frame is needed.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToABGRWithOrientation(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject surface,
+        jobject converted_buffer,
+        jint width,
+        jint height,
+        jint start_offset_y,
+        jint start_offset_u,
+        jint start_offset_v,
+        jint rotation,
+        jboolean mirror) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PixelShift shift;
+    shift.start_offset_y = start_offset_y;
+    shift.start_offset_u = start_offset_u;
+    shift.start_offset_v = start_offset_v;
+    return ConvertToSurface(env, src, shift, surface, converted_buffer,
+                            camerax::Orientation::FromRotation(rotation, mirror));
+}
+
+/**
+ * Like nativeConvertAndroid420ToABGRWithOrientation, for frames too large for a full size
+ * converted buffer. The frame is converted in row bands of at most {@code memory_budget_bytes}
+ * of RGBA that are oriented straight into the surface, so the native memory used does not grow
+ * with the resolution. The pixel shift workaround is not applied.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToABGRInBands(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject surface,
+        jint width,
+        jint height,
+        jint rotation,
+        jboolean mirror,
+        jlong memory_budget_bytes) {
+    if (memory_budget_bytes <= 0) {
+        LOGE("Invalid memory budget: %lld", static_cast<long long>(memory_budget_bytes));
+        return -1;
+    }
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    return ConvertToSurface(env, src, camerax::PixelShift(), surface, /* converted_buffer= */ NULL,
+                            camerax::Orientation::FromRotation(rotation, mirror),
+                            static_cast<size_t>(memory_budget_bytes));
+}
+
+/**
+ * Like nativeConvertAndroid420ToABGRWithOrientation for planes of the YUV {@code format}:
+ * ImageFormat#YUV_420_888, YUV_422_888 or YUV_444_888. 4:2:2 and 4:4:4 chroma is converted at
+ * its full resolution; rotated frames need a {@code converted_buffer} of
+ * {@code width * height * 4} bytes. The pixel shift workaround is not applied.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroidYuvToABGR(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint format,
+        jobject surface,
+        jobject converted_buffer,
+        jint width,
+        jint height,
+        jint rotation,
+        jboolean mirror) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!ChromaSubsamplingFromImageFormat(format, &src.subsampling)) {
+        return -1;
+    }
+    return ConvertToSurface(env, src, camerax::PixelShift(), surface, converted_buffer,
+                            camerax::Orientation::FromRotation(rotation, mirror));
+}
+
+JNIEXPORT jint
+Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject bitmap,
+        jint bitmap_stride,
+        jint width,
+        jint height) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    return ConvertToBitmap(env, src, bitmap, bitmap_stride);
+}
+
+/**
+ * Like nativeConvertAndroid420ToBitmap, with the crop, rotation and mirroring options of
+ * nativeConvertAndroid420ToABGRWithOrientation. The RGBA_8888 bitmap must have the size of the
+ * oriented crop. An empty crop selects the whole frame; its left and top are rounded down to
+ * even values.
+ *
+ * <p>The result is written straight into the locked bitmap: rows convert in place when nothing
+ * is rotated, rotated frames go through bands of 16 rows that stay in the cache.
+ */
+JNIEXPORT jint
+Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmapWithOrientation(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject bitmap,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!src.IsValid()) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
+    if (crop_width > 0 && crop_height > 0) {
+        if (crop_left < 0 || crop_top < 0 || crop_left + crop_width > width
+            || crop_top + crop_height > height) {
+            LOGE("Crop rect out of bounds.");
+            return -1;
+        }
+        src = camerax::CropPlanarImage(src, crop_left, crop_top, crop_width, crop_height);
+    }
+    const camerax::Orientation orientation = camerax::Orientation::FromRotation(rotation, mirror);
+    const int dst_width = orientation.SwapsDimensions() ? src.height : src.width;
+    const int dst_height = orientation.SwapsDimensions() ? src.width : src.height;
+
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888
+        || static_cast<int>(info.width) != dst_width
+        || static_cast<int>(info.height) != dst_height) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    void* pixels = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != 0) {
+        return -1;
+    }
+    int result = camerax::Android420ToRotatedABGRInBands(
+            src, static_cast<uint8_t*>(pixels), static_cast<int>(info.stride), orientation,
+            /* budget_bytes= */ static_cast<size_t>(src.width) * 4 * 16);
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+/**
+ * Like nativeConvertAndroid420ToBitmap, but serves repeated requests for the same frame from a
+ * native cache of converted results. The frame is identified by {@code timestamp_ns} if it is not
+ * negative, else by a hash of its planes that reads every {@code hash_row_step}-th row.
+ *
+ * @return 1 if the result came from the cache, 0 if the frame was converted, -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmapCached(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jobject bitmap,
+        jint bitmap_stride,
+        jint width,
+        jint height,
+        jlong timestamp_ns,
+        jint hash_row_step) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!src.IsValid()) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
+    camerax::ConversionKey key;
+    key.by_timestamp = timestamp_ns >= 0;
+    key.source_id = key.by_timestamp ? static_cast<uint64_t>(timestamp_ns)
+                                     : camerax::HashAndroid420(src, hash_row_step);
+    key.width = width;
+    key.height = height;
+    key.params = kCachedBitmapABGR;
+
+    void* pixels = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != 0) {
+        return -1;
+    }
+    uint8_t* dst = static_cast<uint8_t*>(pixels);
+    camerax::ConversionCache* cache = GetConversionCache();
+    int result = 1;
+    if (!cache->Lookup(key, dst, bitmap_stride, width * 4, height)) {
+        result = camerax::Android420ToABGR(src, dst, bitmap_stride, /* is_full_swing = */true);
+        if (result == 0) {
+            cache->Insert(key, dst, bitmap_stride, width * 4, height);
+        }
+    }
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+/**
+ * Returns a hash of the YUV_420_888 planes that reads every {@code row_step}-th row, e.g. to key
+ * caches of derived results on the Java side.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeHashAndroid420(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint row_step) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!src.IsValid()) {
+        LOGE("Invalid YUV planes.");
+        return 0;
+    }
+    return static_cast<jlong>(camerax::HashAndroid420(src, row_step));
+}
+
+/**
+ * Limits the memory of the conversion cache to {@code max_bytes}, 0 disables and empties it.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeSetConversionCacheSize(
+        JNIEnv*,
+        jclass,
+        jlong max_bytes) {
+    GetConversionCache()->SetMaxBytes(static_cast<size_t>(std::max<jlong>(max_bytes, 0)));
+}
+
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
         JNIEnv* env,
         jclass,
         jobject src_y,
@@ -526,23 +1528,19 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
         jint width,
         jint height,
         jint rotation) {
-
-    uint8_t *src_y_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(src_y));
-    uint8_t *src_u_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(src_u));
-    uint8_t *src_v_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(src_v));
-
-    uint8_t *dst_y_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(dst_y));
-    uint8_t *dst_u_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(dst_u));
-    uint8_t *dst_v_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(dst_v));
-
-    int halfwidth = (width + 1) >> 1;
-    int halfheight = (height + 1) >> 1;
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, 1,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PlanarImage dst;
+    dst.y = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_y)),
+             dst_stride_y, dst_pixel_stride_y};
+    dst.u = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_u)),
+             dst_stride_u, dst_pixel_stride_u};
+    dst.v = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_v)),
+             dst_stride_v, dst_pixel_stride_v};
 
     uint8_t *rotated_y_ptr =
             static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_y));
@@ -551,167 +1549,1864 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
     uint8_t *rotated_v_ptr =
             static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_v));
 
-    libyuv::RotationMode mode = get_rotation_mode(rotation);
-    bool flip_wh = (mode == libyuv::kRotate90 || mode == libyuv::kRotate270);
-
-    int rotated_stride_y = flip_wh ? height : width;
-    int rotated_stride_u = flip_wh ? halfheight : halfwidth;
-    int rotated_stride_v = flip_wh ? halfheight : halfwidth;
-
-    int result = 0;
-
-    // Converts Android420 to I420 format with rotation applied
-    result = libyuv::Android420ToI420Rotate(
-            src_y_ptr,
-            src_stride_y,
-            src_u_ptr,
-            src_stride_u,
-            src_v_ptr,
-            src_stride_v,
-            src_pixel_stride_uv,
-            rotated_y_ptr,
-            rotated_stride_y,
-            rotated_u_ptr,
-            rotated_stride_u,
-            rotated_v_ptr,
-            rotated_stride_v,
-            width,
-            height,
-            mode);
-
-    if (result != 0) {
-        return result;
-    }
-
-    // Convert to the required output format
-    int rotated_width = flip_wh ? height : width;
-    int rotated_height = flip_wh ? width : height;
-    int rotated_halfwidth = flip_wh ? halfheight : halfwidth;
-    int rotated_halfheight = flip_wh ? halfwidth : halfheight;
-    const ptrdiff_t vu_off = dst_v_ptr - dst_u_ptr;
-
-    if (dst_pixel_stride_u == 2 && vu_off == -1) {
-        // NV21
-        result = libyuv::I420ToNV21(
-                /* src_y= */ rotated_y_ptr,
-                /* src_stride_y= */ rotated_width,
-                /* src_u= */ rotated_u_ptr,
-                /* src_stride_u= */ rotated_halfwidth,
-                /* src_v= */ rotated_v_ptr,
-                /* src_stride_v= */ rotated_halfwidth,
-                /* dst_y= */ dst_y_ptr,
-                /* dst_stride_y= */ dst_stride_y,
-                /* dst_uv= */ dst_v_ptr,
-                /* dst_stride_uv= */ dst_stride_v,
-                /* width= */ rotated_width,
-                /* height= */ rotated_height
-        );
-    } else if (dst_pixel_stride_u == 2 && vu_off == 1) {
-        // NV12
-        result = libyuv::I420ToNV12(
-                /* src_y= */ rotated_y_ptr,
-                /* src_stride_y= */ rotated_width,
-                /* src_u= */ rotated_u_ptr,
-                /* src_stride_u= */ rotated_halfwidth,
-                /* src_v= */ rotated_v_ptr,
-                /* src_stride_v= */ rotated_halfwidth,
-                /* dst_y= */ dst_y_ptr,
-                /* dst_stride_y= */ dst_stride_y,
-                /* dst_uv= */ dst_u_ptr,
-                /* dst_stride_uv= */ dst_stride_u,
-                /* width= */ rotated_width,
-                /* height= */ rotated_height
-        );
-    } else if (dst_pixel_stride_u == 1 && dst_pixel_stride_v == 1) {
-        // I420
-        // Copies Y plane
-        libyuv::CopyPlane(
-                /* src_y= */ rotated_y_ptr,
-                /* src_stride_y= */ rotated_width,
-                /* dst_y= */ dst_y_ptr,
-                /* dst_stride_y= */ dst_stride_y,
-                /* width= */ rotated_width,
-                /* height= */ rotated_height);
-        // Copies U plane
-        libyuv::CopyPlane(
-                /* src_y= */ rotated_u_ptr,
-                /* src_stride_y= */ rotated_halfwidth,
-                /* dst_y= */ dst_u_ptr,
-                /* dst_stride_y= */ dst_stride_u,
-                /* width= */ rotated_halfwidth,
-                /* height= */ rotated_halfheight);
-        // Copies V plane
-        libyuv::CopyPlane(
-                /* src_y= */ rotated_v_ptr,
-                /* src_stride_y= */ rotated_halfwidth,
-                /* dst_y= */ dst_v_ptr,
-                /* dst_stride_y= */ dst_stride_v,
-                /* width= */ rotated_halfwidth,
-                /* height= */ rotated_halfheight);
-    } else {
-        // Fall backs to directly copy according to the dst stride and pixel_stride values if
-        // it is none of the above cases.
-
-        // Y
-        uint8_t *dst_y = rotated_y_ptr;
-        int rotated_pixel_stride_y = 1;
-        for (int i = 0; i < rotated_height; i++) {
-            for (int j = 0; j < rotated_width; j++) {
-                dst_y_ptr[i * dst_stride_y + j * dst_pixel_stride_y] =
-                        dst_y[i * rotated_stride_y + j * rotated_pixel_stride_y];
-            }
-        }
-        // U
-        uint8_t *dst_u = rotated_u_ptr;
-        int rotated_pixel_stride_u = 1;
-        for (int i = 0; i < rotated_halfheight; i++) {
-            for (int j = 0; j < rotated_halfwidth; j++) {
-                dst_u_ptr[i * dst_stride_u + j * dst_pixel_stride_u] =
-                        dst_u[i * rotated_stride_u + j * rotated_pixel_stride_u];
-            }
-        }
-        // V
-        uint8_t *dst_v = rotated_v_ptr;
-        int rotated_pixel_stride_v = 1;
-        for (int i = 0; i < rotated_halfheight; i++) {
-            for (int j = 0; j < rotated_halfwidth; j++) {
-                dst_v_ptr[i * dst_stride_v + j * dst_pixel_stride_v] =
-                        dst_v[i * rotated_stride_v + j * rotated_pixel_stride_v];
-            }
-        }
-    }
-
-    return result;
-}
-
-JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeGetYUVImageVUOff(
-        JNIEnv* env,
-        jclass,
-        jobject byte_buffer_v,
-        jobject byte_buffer_u) {
-    uint8_t *byte_buffer_v_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(byte_buffer_v));
-    uint8_t *byte_buffer_u_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(byte_buffer_u));
-    return byte_buffer_v_ptr - byte_buffer_u_ptr;
+    return camerax::RotateAndroid420(src, dst, rotated_y_ptr, rotated_u_ptr, rotated_v_ptr,
+                                     camerax::Orientation::FromRotation(rotation,
+                                                                        /* mirror= */ false));
 }
 
 /**
- * Creates ByteBuffer from the offset of the input byte buffer.
+ * Like nativeRotateYUV, but also mirrors the rotated frame horizontally if {@code mirror} is set.
+ * The mirroring is folded into the rotation pass.
  */
-JNIEXPORT jobject
-Java_androidx_camera_core_ImageProcessingUtil_nativeNewDirectByteBuffer(
-        JNIEnv *env,
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUVWithOrientation(
+        JNIEnv* env,
         jclass,
-        jobject byte_buffer,
-        jint offset,
-        jint capacity) {
-
-    uint8_t *byte_buffer_ptr =
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_uv,
+        jobject dst_y,
+        jint dst_stride_y,
+        jint dst_pixel_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jint dst_pixel_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_v,
+        jobject rotated_buffer_y,
+        jobject rotated_buffer_u,
+        jobject rotated_buffer_v,
+        jint width,
+        jint height,
+        jint rotation,
+        jboolean mirror) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, 1,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PlanarImage dst;
+    dst.y = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_y)),
+             dst_stride_y, dst_pixel_stride_y};
+    dst.u = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_u)),
+             dst_stride_u, dst_pixel_stride_u};
+    dst.v = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_v)),
+             dst_stride_v, dst_pixel_stride_v};
+
+    uint8_t *rotated_y_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_y));
+    uint8_t *rotated_u_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_u));
+    uint8_t *rotated_v_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_v));
+
+    return camerax::RotateAndroid420(src, dst, rotated_y_ptr, rotated_u_ptr, rotated_v_ptr,
+                                     camerax::Orientation::FromRotation(rotation, mirror));
+}
+
+/**
+ * Like nativeRotateYUVWithOrientation for planes of the YUV {@code format}:
+ * ImageFormat#YUV_420_888, YUV_422_888 or YUV_444_888. The output is 4:2:0 in any case, so the
+ * destination and rotated buffers have the sizes they have for YUV_420_888; 4:2:2 and 4:4:4
+ * chroma is averaged down before it is rotated.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUVWithFormat(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_uv,
+        jint format,
+        jobject dst_y,
+        jint dst_stride_y,
+        jint dst_pixel_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jint dst_pixel_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_v,
+        jobject rotated_buffer_y,
+        jobject rotated_buffer_u,
+        jobject rotated_buffer_v,
+        jint width,
+        jint height,
+        jint rotation,
+        jboolean mirror) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, 1,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!ChromaSubsamplingFromImageFormat(format, &src.subsampling)) {
+        return -1;
+    }
+    camerax::PlanarImage dst;
+    dst.y = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_y)),
+             dst_stride_y, dst_pixel_stride_y};
+    dst.u = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_u)),
+             dst_stride_u, dst_pixel_stride_u};
+    dst.v = {static_cast<uint8_t*>(env->GetDirectBufferAddress(dst_v)),
+             dst_stride_v, dst_pixel_stride_v};
+
+    uint8_t *rotated_y_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_y));
+    uint8_t *rotated_u_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_u));
+    uint8_t *rotated_v_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_v));
+
+    return camerax::RotateAndroid420(src, dst, rotated_y_ptr, rotated_u_ptr, rotated_v_ptr,
+                                     camerax::Orientation::FromRotation(rotation, mirror));
+}
+
+/**
+ * Converts planes of the YUV {@code format}, ImageFormat#YUV_420_888, YUV_422_888 or
+ * YUV_444_888, into the NV12 (NV21 if {@code vu_order} is set) buffer {@code dst}, whose chroma
+ * starts after {@code dst_slice_height} rows of {@code dst_stride} bytes. 4:2:2 and 4:4:4 chroma
+ * is averaged down to 4:2:0.
+ *
+ * @return 0 on success or -1 on failure, e.g. if {@code dst} is too small.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroidYuvToNV12(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint format,
+        jint width,
+        jint height,
+        jobject dst,
+        jint dst_stride,
+        jint dst_slice_height,
+        jboolean vu_order) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    if (!ChromaSubsamplingFromImageFormat(format, &src.subsampling)) {
+        return -1;
+    }
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    const jlong dst_size = static_cast<jlong>(dst_stride)
+            * (dst_slice_height + (static_cast<jlong>(height) + 1) / 2);
+    if (dst_ptr == nullptr || dst_stride < width || dst_slice_height < height
+        || env->GetDirectBufferCapacity(dst) < dst_size) {
+        LOGE("NV12 buffer too small.");
+        return -1;
+    }
+    return camerax::ConvertAndroidYuvTo420(
+            src, camerax::WrapNV12(dst_ptr, width, height, dst_stride, dst_slice_height,
+                                   vu_order));
+}
+
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeGetYUVImageVUOff(
+        JNIEnv* env,
+        jclass,
+        jobject byte_buffer_v,
+        jobject byte_buffer_u) {
+    uint8_t *byte_buffer_v_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(byte_buffer_v));
+    uint8_t *byte_buffer_u_ptr =
+            static_cast<uint8_t *>(env->GetDirectBufferAddress(byte_buffer_u));
+    return byte_buffer_v_ptr - byte_buffer_u_ptr;
+}
+
+/**
+ * Creates ByteBuffer from the offset of the input byte buffer.
+ */
+JNIEXPORT jobject
+Java_androidx_camera_core_ImageProcessingUtil_nativeNewDirectByteBuffer(
+        JNIEnv *env,
+        jclass,
+        jobject byte_buffer,
+        jint offset,
+        jint capacity) {
+
+    uint8_t *byte_buffer_ptr =
             static_cast<uint8_t *>(env->GetDirectBufferAddress(byte_buffer));
 
     // Create the ByteBuffers
     return env->NewDirectByteBuffer(byte_buffer_ptr + offset, capacity);
 }
 
+/**
+ * Converts a YUV_420_888 HardwareBuffer to ABGR and writes it into the RGBA_8888 surface.
+ *
+ * <p>The planes are read straight from the locked buffer, so no plane extraction is needed on the
+ * Java side.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertHardwareBufferToABGR(
+        JNIEnv* env,
+        jclass,
+        jobject hardware_buffer,
+        jobject surface,
+        jobject converted_buffer,
+        jint rotation,
+        jboolean mirror) {
+    camerax::HardwareBufferPlaneProvider provider(HardwareBufferFromJava(env, hardware_buffer));
+    camerax::ScopedPlaneLock lock(&provider, /* write= */ false);
+    if (!lock.ok()) {
+        LOGE("Failed to lock hardware buffer planes.");
+        return -1;
+    }
+    return ConvertToSurface(env, lock.image(), camerax::PixelShift(), surface, converted_buffer,
+                            camerax::Orientation::FromRotation(rotation, mirror));
+}
+
+/**
+ * Converts a YUV_420_888 HardwareBuffer to ABGR directly into the pixels of the bitmap.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertHardwareBufferToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject hardware_buffer,
+        jobject bitmap,
+        jint bitmap_stride) {
+    camerax::HardwareBufferPlaneProvider provider(HardwareBufferFromJava(env, hardware_buffer));
+    camerax::ScopedPlaneLock lock(&provider, /* write= */ false);
+    if (!lock.ok()) {
+        LOGE("Failed to lock hardware buffer planes.");
+        return -1;
+    }
+    return ConvertToBitmap(env, lock.image(), bitmap, bitmap_stride);
+}
+
+/**
+ * Crops, orients and scales the YUV_420_888 planes to the size of the RGBA_8888 bitmap and
+ * converts them straight into its pixels.
+ *
+ * <p>The steps are ordered to move the fewest bytes, e.g. rotating in YUV before expanding to
+ * 4 bytes per pixel. If {@code stats} is not null it receives the estimated and measured bytes
+ * moved, the elapsed nanoseconds and the number of passes.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeProcessAndroid420ToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject bitmap,
+        jlongArray stats) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+
+    camerax::PipelineRequest request = PipelineRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror);
+    request.output_width = static_cast<int>(info.width);
+    request.output_height = static_cast<int>(info.height);
+    request.output_format = camerax::PipelineFormat::kABGR;
+    camerax::PipelinePlan plan;
+    if (camerax::PlanPipeline(src, request, &plan) != 0) {
+        LOGE("Invalid crop rectangle.");
+        return -1;
+    }
+
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    camerax::PipelineDestination dst;
+    dst.abgr = static_cast<uint8_t*>(bitmapAddress);
+    dst.abgr_stride = static_cast<int>(info.stride);
+    camerax::PipelineStats pipeline_stats;
+    int result = camerax::RunPipeline(src, plan, dst, nullptr, 0, &pipeline_stats);
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    WritePipelineStats(env, stats, pipeline_stats);
+    return result;
+}
+
+/**
+ * Crops, orients and scales the YUV_420_888 planes into I420, NV12 or NV21 destination planes of
+ * {@code dst_width} x {@code dst_height}. {@code dst_format} is 1 for I420, 2 for NV12 and 3 for
+ * NV21 and has to match the destination planes.
+ *
+ * @see #nativeProcessAndroid420ToBitmap
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeProcessAndroid420ToYUV(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject dst_y,
+        jint dst_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_uv,
+        jint dst_width,
+        jint dst_height,
+        jint dst_format,
+        jlongArray stats) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PipelineDestination dst;
+    dst.yuv = PlanarImageFromByteBuffers(env,
+                                         dst_y, dst_stride_y, 1,
+                                         dst_u, dst_stride_u,
+                                         dst_v, dst_stride_v,
+                                         dst_pixel_stride_uv,
+                                         dst_width, dst_height);
+    if (!PlanesFitByteBuffers(env, src, src_y, src_u, src_v)) {
+        LOGE("Invalid source YUV planes.");
+        return -1;
+    }
+    if (!PlanesFitByteBuffers(env, dst.yuv, dst_y, dst_u, dst_v)) {
+        LOGE("Invalid destination YUV planes.");
+        return -1;
+    }
+
+    camerax::PipelineRequest request = PipelineRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror);
+    request.output_width = dst_width;
+    request.output_height = dst_height;
+    request.output_format = static_cast<camerax::PipelineFormat>(dst_format);
+    camerax::PipelinePlan plan;
+    if (request.output_format == camerax::PipelineFormat::kABGR
+        || camerax::PlanPipeline(src, request, &plan) != 0) {
+        LOGE("Invalid pipeline request.");
+        return -1;
+    }
+
+    camerax::PipelineStats pipeline_stats;
+    int result = camerax::RunPipeline(src, plan, dst, nullptr, 0, &pipeline_stats);
+    WritePipelineStats(env, stats, pipeline_stats);
+    return result;
+}
+
+/**
+ * Crops, orients and scales the YUV_420_888 planes into the video encoder input buffer
+ * {@code dst}, e.g. one from MediaCodec#getInputBuffer. The buffer holds a {@code dst_width} x
+ * {@code dst_height} image in I420 ({@code dst_format} 1), NV12 (2) or NV21 (3) with the stride
+ * and slice height rounded up to {@code stride_alignment} and {@code slice_alignment}. A
+ * rotation combined with a scale by at most 2x runs as a single pass into the buffer once an
+ * implementation of the warp kernel is forced with nativeSetKernelImpl.
+ *
+ * @return the number of bytes of the buffer layout, to be queued to the codec, or -1 on failure.
+ * @see #nativeProcessAndroid420ToYUV
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeProcessAndroid420ToCodecBuffer(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject dst,
+        jint dst_width,
+        jint dst_height,
+        jint dst_format,
+        jint stride_alignment,
+        jint slice_alignment,
+        jlongArray stats) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::PlanarImage codec_image;
+    const size_t codec_size = WrapCodecDestination(env, dst, dst_width, dst_height, dst_format,
+                                                   stride_alignment, slice_alignment,
+                                                   &codec_image);
+    if (codec_size == 0) {
+        return -1;
+    }
+
+    camerax::PipelineRequest request = PipelineRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror);
+    request.output_width = dst_width;
+    request.output_height = dst_height;
+    request.output_format = static_cast<camerax::PipelineFormat>(dst_format);
+    camerax::PipelinePlan plan;
+    if (camerax::PlanPipeline(src, request, &plan) != 0) {
+        LOGE("Invalid pipeline request.");
+        return -1;
+    }
+    camerax::PipelineDestination pipeline_dst;
+    pipeline_dst.yuv = codec_image;
+    camerax::PipelineStats pipeline_stats;
+    int result = camerax::RunPipeline(src, plan, pipeline_dst, nullptr, 0, &pipeline_stats);
+    WritePipelineStats(env, stats, pipeline_stats);
+    return result == 0 ? static_cast<jint>(codec_size) : -1;
+}
+
+/**
+ * Crops, orients and scales the Y plane of a YUV_420_888 image into the packed 8-bit buffer
+ * {@code dst} of {@code dst_width} x {@code dst_height}, e.g. for barcode scanning or text
+ * recognition. The chroma planes are not read.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeProcessAndroid420ToY8(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jint src_pixel_stride_y,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject dst,
+        jint dst_stride,
+        jint dst_width,
+        jint dst_height) {
+    uint8_t* src_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(src_y));
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    if (src_ptr == nullptr || dst_ptr == nullptr || dst_width <= 0 || dst_height <= 0
+        || dst_stride < dst_width
+        || env->GetDirectBufferCapacity(dst)
+                < static_cast<jlong>(dst_stride) * (dst_height - 1) + dst_width) {
+        LOGE("Invalid Y8 destination.");
+        return -1;
+    }
+    camerax::Plane plane = {src_ptr, src_stride_y, src_pixel_stride_y};
+    camerax::LumaRequest request = LumaRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror, dst_width,
+            dst_height);
+    return camerax::ProcessLuma(plane, width, height, request, dst_ptr, dst_stride);
+}
+
+/**
+ * Like nativeProcessAndroid420ToY8, but writes into an ALPHA_8 bitmap whose size is the output
+ * size.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeProcessAndroid420ToAlpha8Bitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jint src_pixel_stride_y,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject bitmap) {
+    uint8_t* src_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(src_y));
+    AndroidBitmapInfo info;
+    if (src_ptr == nullptr || AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_A_8) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    camerax::Plane plane = {src_ptr, src_stride_y, src_pixel_stride_y};
+    camerax::LumaRequest request = LumaRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror,
+            static_cast<jint>(info.width), static_cast<jint>(info.height));
+
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    int result = camerax::ProcessLuma(plane, width, height, request,
+                                      static_cast<uint8_t*>(bitmapAddress),
+                                      static_cast<int>(info.stride));
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+/**
+ * Returns the size of the direct buffer {@link #nativeBuildPyramid} needs for the given frame
+ * size and options, or 0 if the options are invalid.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeGetPyramidBufferSize(
+        JNIEnv*,
+        jclass,
+        jint width,
+        jint height,
+        jint level_count,
+        jfloat ratio,
+        jint format) {
+    std::vector<camerax::PyramidLevel> levels;
+    return static_cast<jlong>(camerax::GetPyramidLayout(
+            width, height, PyramidOptionsFromArgs(level_count, ratio, format), &levels));
+}
+
+/**
+ * Builds {@code level_count} successively smaller Y8 ({@code format} 0) or RGBA ({@code format}
+ * 1) copies of a YUV_420_888 image into the direct buffer {@code dst}, level 0 being the full
+ * resolution. {@code level_info} receives {offset, width, height, row stride} of every level,
+ * the offsets being relative to the start of {@code dst}.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeBuildPyramid(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint level_count,
+        jfloat ratio,
+        jint format,
+        jobject dst,
+        jintArray level_info) {
+    if (level_info == nullptr || env->GetArrayLength(level_info) < 4 * level_count) {
+        LOGE("Level info array too small.");
+        return -1;
+    }
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::FrameArena arena(static_cast<uint8_t*>(env->GetDirectBufferAddress(dst)),
+                              static_cast<size_t>(std::max<jlong>(
+                                      env->GetDirectBufferCapacity(dst), 0)));
+    std::vector<camerax::PyramidLevel> levels;
+    if (camerax::BuildPyramid(src, PyramidOptionsFromArgs(level_count, ratio, format), &arena,
+                              GetStripePool(), &levels) != 0) {
+        LOGE("Failed to build pyramid.");
+        return -1;
+    }
+
+    std::vector<jint> info;
+    for (const camerax::PyramidLevel& level : levels) {
+        info.push_back(static_cast<jint>(level.data - arena.data()));
+        info.push_back(level.width);
+        info.push_back(level.height);
+        info.push_back(level.stride);
+    }
+    env->SetIntArrayRegion(level_info, 0, static_cast<jsize>(info.size()), info.data());
+    return 0;
+}
+
+/**
+ * Sets the number of source bytes per tile of the cache-blocked 90 and 270 degree rotations.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeSetRotationTileBytes(
+        JNIEnv*,
+        jclass,
+        jint tile_bytes) {
+    camerax::SetTransposeTileBytes(static_cast<size_t>(std::max(tile_bytes, 0)));
+}
+
+/**
+ * Picks the fastest rotation tile size for this CPU and returns it. Meant to run once on a
+ * background thread.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeAutoTuneRotationTileBytes(
+        JNIEnv*,
+        jclass) {
+    return static_cast<jint>(camerax::AutoTuneTransposeTileBytes());
+}
+
+/**
+ * Creates a native zero-shutter-lag ring of {@code capacity} frames of the given size, see
+ * camerax::FrameRing. All memory is allocated here, pushing frames never allocates.
+ *
+ * @return a handle for the other frame ring calls, or 0 on failure. The other calls fail for a
+ * handle of 0 instead of dereferencing it.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeCreateFrameRing(
+        JNIEnv*,
+        jclass,
+        jint width,
+        jint height,
+        jint capacity,
+        jint max_retained,
+        jboolean compress_chroma,
+        jlong chroma_budget_bytes) {
+    camerax::FrameRingOptions options;
+    options.width = width;
+    options.height = height;
+    options.capacity = capacity;
+    options.max_retained = max_retained;
+    options.compress_chroma = compress_chroma;
+    options.chroma_budget_bytes = static_cast<size_t>(std::max<jlong>(chroma_budget_bytes, 0));
+    camerax::FrameRing* ring = new camerax::FrameRing(options);
+    if (!ring->IsValid()) {
+        LOGE("Invalid frame ring options.");
+        delete ring;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(ring);
+}
+
+/**
+ * Frees a frame ring. Retained frames must not be used afterwards.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeDestroyFrameRing(
+        JNIEnv*,
+        jclass,
+        jlong ring) {
+    delete reinterpret_cast<camerax::FrameRing*>(ring);
+}
+
+/**
+ * Copies the YUV_420_888 planes into the ring as packed NV12, replacing the oldest frame that is
+ * not retained.
+ *
+ * @return the slot of the frame, or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativePushFrameRingFrame(
+        JNIEnv* env,
+        jclass,
+        jlong ring,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jlong timestamp_ns) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return -1;
+    }
+    return frame_ring->Push(src, timestamp_ns);
+}
+
+/**
+ * Retains the frame closest to {@code timestamp_ns} within {@code tolerance_ns}, so that it is not
+ * overwritten until nativeReleaseFrameRingFrame.
+ *
+ * @return the slot of the frame, or -1 if there is none or too many frames are retained.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeAcquireFrameRingFrame(
+        JNIEnv*,
+        jclass,
+        jlong ring,
+        jlong timestamp_ns,
+        jlong tolerance_ns) {
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return -1;
+    }
+    return frame_ring->Acquire(timestamp_ns, tolerance_ns);
+}
+
+/**
+ * Drops one retain of the frame in {@code slot}. Returns -1 if it was not retained.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeReleaseFrameRingFrame(
+        JNIEnv*,
+        jclass,
+        jlong ring,
+        jint slot) {
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return -1;
+    }
+    return frame_ring->Release(slot);
+}
+
+/**
+ * Wraps a plane of a retained frame in a direct ByteBuffer without copying, so that it can be
+ * passed to the other conversions. Plane 0 is the luma, plane 1 the interleaved UV chroma; both
+ * have a row stride of the width rounded up to even. The buffer is valid until the frame is
+ * released.
+ *
+ * @return the buffer, or null if the frame is not retained.
+ */
+JNIEXPORT jobject Java_androidx_camera_core_ImageProcessingUtil_nativeGetFrameRingPlane(
+        JNIEnv* env,
+        jclass,
+        jlong ring,
+        jint slot,
+        jint plane) {
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return nullptr;
+    }
+    camerax::PlanarImage frame = frame_ring->GetFrame(slot);
+    if (!frame.IsValid() || plane < 0 || plane > 1) {
+        return nullptr;
+    }
+    if (plane == 0) {
+        return env->NewDirectByteBuffer(frame.y.data,
+                                        static_cast<jlong>(frame.y.row_stride) * frame.height);
+    }
+    return env->NewDirectByteBuffer(frame.u.data,
+                                    static_cast<jlong>(frame.u.row_stride) * frame.chroma_height());
+}
+
+/**
+ * Returns the timestamp of a retained frame in nanoseconds, or -1.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeGetFrameRingTimestamp(
+        JNIEnv*,
+        jclass,
+        jlong ring,
+        jint slot) {
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return -1;
+    }
+    return frame_ring->GetTimestamp(slot);
+}
+
+/**
+ * Encodes a retained frame as JPEG directly into a BLOB buffer of the Surface, reading the ring
+ * in place. See nativeEncodeAndroid420ToJpegSurface.
+ *
+ * @return the size of the JPEG in bytes, or -1 on failure.
+ */
+JNIEXPORT jint
+Java_androidx_camera_core_ImageProcessingUtil_nativeEncodeFrameRingFrameToJpegSurface(
+        JNIEnv* env,
+        jclass,
+        jlong ring,
+        jint slot,
+        jint quality,
+        jint rotation,
+        jboolean mirror,
+        jobject surface) {
+    camerax::FrameRing* frame_ring = reinterpret_cast<camerax::FrameRing*>(ring);
+    if (frame_ring == nullptr) {
+        LOGE("Invalid frame ring.");
+        return -1;
+    }
+    camerax::PlanarImage frame = frame_ring->GetFrame(slot);
+    if (!frame.IsValid()) {
+        LOGE("Frame %d is not retained.", slot);
+        return -1;
+    }
+    return EncodeToBlobSurface(env, surface, camerax::MaxJpegSize(frame.width, frame.height),
+                               [&](uint8_t* buffer, size_t capacity) {
+                                   return camerax::EncodeAndroid420ToJpeg(
+                                           frame, quality,
+                                           camerax::Orientation::FromRotation(rotation, mirror),
+                                           buffer, capacity);
+                               });
+}
+
+/**
+ * Returns the CPU features detected at runtime as camerax::CpuFeature bits.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeGetCpuFeatures(
+        JNIEnv*,
+        jclass) {
+    return static_cast<jint>(camerax::GetCpuFeatures());
+}
+
+/**
+ * Returns the camerax::KernelImpl that runs for the camerax::Kernel {@code kernel}, or -1 for an
+ * unknown kernel.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeGetKernelImpl(
+        JNIEnv*,
+        jclass,
+        jint kernel) {
+    if (kernel < 0 || kernel >= camerax::kKernelCount) {
+        return -1;
+    }
+    return static_cast<jint>(camerax::GetKernelImpl(static_cast<camerax::Kernel>(kernel)));
+}
+
+/**
+ * Forces the camerax::KernelImpl {@code impl} for the camerax::Kernel {@code kernel}, 0 (auto)
+ * restores the default. Meant for A/B benchmarks and for switching off a broken implementation.
+ *
+ * @return 0 on success or -1 if the kernel or implementation is unknown or the implementation
+ * is unavailable.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeSetKernelImpl(
+        JNIEnv*,
+        jclass,
+        jint kernel,
+        jint impl) {
+    if (kernel < 0 || kernel >= camerax::kKernelCount
+        || impl < 0 || impl >= camerax::kKernelImplCount) {
+        return -1;
+    }
+    return camerax::SetKernelImpl(static_cast<camerax::Kernel>(kernel),
+                                  static_cast<camerax::KernelImpl>(impl));
+}
+
+/**
+ * Describes the implementation of every kernel, e.g. "transpose=neon warp=neon ...", for logs
+ * and benchmark reports.
+ */
+JNIEXPORT jstring Java_androidx_camera_core_ImageProcessingUtil_nativeDescribeKernelImpls(
+        JNIEnv* env,
+        jclass) {
+    std::string description;
+    for (int i = 0; i < camerax::kKernelCount; ++i) {
+        const auto kernel = static_cast<camerax::Kernel>(i);
+        description += std::string(i > 0 ? " " : "") + camerax::GetKernelName(kernel) + "="
+                + camerax::GetKernelImplName(camerax::GetKernelImpl(kernel));
+    }
+    return env->NewStringUTF(description.c_str());
+}
+
+/**
+ * Unpacks a RAW10 or RAW12 image to 16-bit samples in the sensor's value range; RAW_SENSOR is
+ * copied. {@code dst_row_stride} is in bytes.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeUnpackRaw(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_row_stride,
+        jint width,
+        jint height,
+        jint format,
+        jobject dst,
+        jint dst_row_stride) {
+    camerax::RawImage image = RawImageFromByteBuffer(env, src, src_row_stride, width, height,
+                                                     format);
+    uint16_t* dst_ptr = static_cast<uint16_t*>(env->GetDirectBufferAddress(dst));
+    if (image.data == nullptr || dst_ptr == nullptr || dst_row_stride % 2 != 0
+        || env->GetDirectBufferCapacity(dst)
+                < static_cast<jlong>(dst_row_stride) * (height - 1) + 2 * width) {
+        return -1;
+    }
+    return camerax::UnpackRaw(image, dst_ptr, dst_row_stride / 2, GetStripePool());
+}
+
+/**
+ * Applies the black level and white balance to a RAW image, see camerax::LinearizeRaw. The
+ * result is a linear 16-bit Bayer mosaic where the white level maps to 65535.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeLinearizeRaw(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_row_stride,
+        jint width,
+        jint height,
+        jint format,
+        jint cfa_pattern,
+        jintArray black_level,
+        jint white_level,
+        jfloatArray gains,
+        jobject dst,
+        jint dst_row_stride) {
+    camerax::RawImage image = RawImageFromByteBuffer(env, src, src_row_stride, width, height,
+                                                     format);
+    camerax::RawDevelopOptions options;
+    uint16_t* dst_ptr = static_cast<uint16_t*>(env->GetDirectBufferAddress(dst));
+    if (image.data == nullptr || dst_ptr == nullptr || dst_row_stride % 2 != 0
+        || env->GetDirectBufferCapacity(dst)
+                < static_cast<jlong>(dst_row_stride) * (height - 1) + 2 * width
+        || !RawDevelopOptionsFromArgs(env, cfa_pattern, black_level, white_level, gains, 0,
+                                      false, &options)) {
+        return -1;
+    }
+    return camerax::LinearizeRaw(image, options, dst_ptr, dst_row_stride / 2, GetStripePool());
+}
+
+/**
+ * Develops a RAW image into an RGBA_8888 bitmap. With {@code bin} set, every 2x2 block becomes
+ * one pixel and the bitmap is half the width and height of the image, which is the cheapest
+ * live preview. Otherwise the image is demosaiced with {@code method}, 0 for bilinear and 1 for
+ * edge-aware, into a bitmap of the image's size.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeDevelopRawToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_row_stride,
+        jint width,
+        jint height,
+        jint format,
+        jint cfa_pattern,
+        jintArray black_level,
+        jint white_level,
+        jfloatArray gains,
+        jboolean bin,
+        jint method,
+        jboolean apply_gamma,
+        jobject bitmap) {
+    camerax::RawImage image = RawImageFromByteBuffer(env, src, src_row_stride, width, height,
+                                                     format);
+    camerax::RawDevelopOptions options;
+    if (image.data == nullptr
+        || !RawDevelopOptionsFromArgs(env, cfa_pattern, black_level, white_level, gains, method,
+                                      apply_gamma, &options)) {
+        return -1;
+    }
+    const uint32_t output_width = static_cast<uint32_t>(bin ? width / 2 : width);
+    const uint32_t output_height = static_cast<uint32_t>(bin ? height / 2 : height);
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 || info.width != output_width
+        || info.height != output_height) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    uint8_t* dst = static_cast<uint8_t*>(bitmapAddress);
+    const int dst_stride = static_cast<int>(info.stride);
+    int result = bin ? camerax::BinRawToABGR(image, options, dst, dst_stride, GetStripePool())
+            : camerax::DemosaicRawToABGR(image, options, dst, dst_stride, GetStripePool());
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+/**
+ * Crops and orients a DEPTH16 image into ranges in meters and, if {@code confidence} is not
+ * null, confidences between 0 and 1, see camerax::Depth16ToFloat. The outputs are direct
+ * buffers of floats with row strides in bytes, sized for the oriented crop.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertDepth16ToFloat(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_row_stride,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jobject depth,
+        jint depth_row_stride,
+        jobject confidence,
+        jint confidence_row_stride) {
+    const uint16_t* src_ptr = Depth16FromByteBuffer(env, src, src_row_stride, width, height);
+    camerax::DepthRequest request = DepthRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror);
+    int output_width = 0;
+    int output_height = 0;
+    if (src_ptr == nullptr
+        || camerax::GetDepthOutputSize(width, height, request, &output_width,
+                                       &output_height) != 0) {
+        return -1;
+    }
+    auto float_buffer = [&](jobject buffer, jint row_stride) -> float* {
+        float* data = static_cast<float*>(env->GetDirectBufferAddress(buffer));
+        if (data == nullptr || row_stride % 4 != 0
+            || env->GetDirectBufferCapacity(buffer)
+                    < static_cast<jlong>(row_stride) * (output_height - 1) + 4 * output_width) {
+            return nullptr;
+        }
+        return data;
+    };
+    float* depth_ptr = float_buffer(depth, depth_row_stride);
+    float* confidence_ptr = confidence != nullptr
+            ? float_buffer(confidence, confidence_row_stride) : nullptr;
+    if (depth_ptr == nullptr || (confidence != nullptr && confidence_ptr == nullptr)) {
+        LOGE("Invalid depth destination.");
+        return -1;
+    }
+    return camerax::Depth16ToFloat(src_ptr, src_row_stride / 2, width, height, request,
+                                   depth_ptr, depth_row_stride / 4, confidence_ptr,
+                                   confidence_row_stride / 4);
+}
+
+/**
+ * Crops, orients and colors a DEPTH16 image into an RGBA_8888 bitmap of the oriented crop's
+ * size for preview. Ranges from {@code near_range} to {@code far_range} millimeters run from
+ * red to blue; samples without a range or below {@code min_confidence} are transparent.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertDepth16ToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_row_stride,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jint near_range,
+        jint far_range,
+        jfloat min_confidence,
+        jobject bitmap) {
+    const uint16_t* src_ptr = Depth16FromByteBuffer(env, src, src_row_stride, width, height);
+    camerax::DepthRequest request = DepthRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror);
+    int output_width = 0;
+    int output_height = 0;
+    AndroidBitmapInfo info;
+    if (src_ptr == nullptr
+        || camerax::GetDepthOutputSize(width, height, request, &output_width,
+                                       &output_height) != 0
+        || AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888
+        || info.width != static_cast<uint32_t>(output_width)
+        || info.height != static_cast<uint32_t>(output_height)) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    camerax::DepthColorOptions options;
+    options.near_range = near_range;
+    options.far_range = far_range;
+    options.min_confidence = min_confidence;
+
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    int result = camerax::Depth16ToABGR(src_ptr, src_row_stride / 2, width, height, request,
+                                        options, static_cast<uint8_t*>(bitmapAddress),
+                                        static_cast<int>(info.stride));
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    return result;
+}
+
+/**
+ * Packs the {x, y, z, confidence} floats of a DEPTH_POINT_CLOUD buffer into {x, y, z} triples
+ * in the direct buffer {@code dst}, dropping points below {@code min_confidence} and turning
+ * the rest like an image rotated by {@code rotation} and mirrored if {@code mirror} is set.
+ *
+ * @return the number of points written, or -1 on invalid arguments.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertPointCloudToXyz(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint point_count,
+        jint rotation,
+        jboolean mirror,
+        jfloat min_confidence,
+        jobject dst) {
+    const float* src_ptr = static_cast<const float*>(env->GetDirectBufferAddress(src));
+    float* dst_ptr = static_cast<float*>(env->GetDirectBufferAddress(dst));
+    if (src_ptr == nullptr || dst_ptr == nullptr || point_count < 0
+        || env->GetDirectBufferCapacity(src) < 16 * static_cast<jlong>(point_count)
+        || env->GetDirectBufferCapacity(dst) < 12 * static_cast<jlong>(point_count)) {
+        LOGE("Invalid point cloud buffers.");
+        return -1;
+    }
+    return camerax::PointCloudToXyz(src_ptr, point_count,
+                                    camerax::Orientation::FromRotation(rotation, mirror),
+                                    min_confidence, dst_ptr);
+}
+
+/**
+ * Converts the pixels of an RGBA_8888 bitmap to YUV and writes them into the video encoder input
+ * buffer {@code dst}, e.g. to record composited frames. The buffer layout is that of
+ * nativeProcessAndroid420ToCodecBuffer, for the bitmap's size rotated by {@code rotation}.
+ * {@code matrix} is 0 for BT.601 and 1 for BT.709.
+ *
+ * @return the number of bytes of the buffer layout, to be queued to the codec, or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertBitmapToCodecBuffer(
+        JNIEnv* env,
+        jclass,
+        jobject bitmap,
+        jint matrix,
+        jboolean full_range,
+        jint rotation,
+        jobject dst,
+        jint dst_format,
+        jint stride_alignment,
+        jint slice_alignment) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    const bool transpose = rotation == 90 || rotation == 270;
+    const jint dst_width = static_cast<jint>(transpose ? info.height : info.width);
+    const jint dst_height = static_cast<jint>(transpose ? info.width : info.height);
+    camerax::PlanarImage codec_image;
+    const size_t codec_size = WrapCodecDestination(env, dst, dst_width, dst_height, dst_format,
+                                                   stride_alignment, slice_alignment,
+                                                   &codec_image);
+    if (codec_size == 0) {
+        return -1;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(
+            matrix, full_range, static_cast<jint>(camerax::RgbOrder::kABGR), rotation);
+    return ConvertBitmapToYuv(env, bitmap, info, options, codec_image) == 0
+            ? static_cast<jint>(codec_size) : -1;
+}
+
+/**
+ * Like nativeConvertBitmapToCodecBuffer for 32-bit pixels in a direct buffer, in R, G, B, A
+ * ({@code order} 0) or B, G, R, A (1) byte order.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertRgbaToCodecBuffer(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_stride,
+        jint width,
+        jint height,
+        jint order,
+        jint matrix,
+        jboolean full_range,
+        jint rotation,
+        jobject dst,
+        jint dst_format,
+        jint stride_alignment,
+        jint slice_alignment) {
+    const uint8_t* src_ptr = static_cast<const uint8_t*>(env->GetDirectBufferAddress(src));
+    if (src_ptr == nullptr || width <= 0 || height <= 0
+        || env->GetDirectBufferCapacity(src)
+                < static_cast<jlong>(src_stride) * (height - 1) + 4 * width) {
+        LOGE("Invalid RGBA source.");
+        return -1;
+    }
+    const bool transpose = rotation == 90 || rotation == 270;
+    camerax::PlanarImage codec_image;
+    const size_t codec_size = WrapCodecDestination(
+            env, dst, transpose ? height : width, transpose ? width : height, dst_format,
+            stride_alignment, slice_alignment, &codec_image);
+    if (codec_size == 0) {
+        return -1;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(matrix, full_range, order,
+                                                               rotation);
+    return camerax::RgbToYuv420(src_ptr, src_stride, width, height, options, codec_image,
+                                GetStripePool()) == 0 ? static_cast<jint>(codec_size) : -1;
+}
+
+/**
+ * Converts the pixels of an RGBA_8888 bitmap to YUV and writes them into YUV_420_888 planes of
+ * any layout, e.g. those of an Image dequeued from an ImageWriter, which is then queued to the
+ * writer's Surface. The planes are the bitmap's size rotated by {@code rotation}.
+ *
+ * @return 0 on success or -1 on failure.
+ * @see #nativeConvertBitmapToCodecBuffer
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertBitmapToAndroid420(
+        JNIEnv* env,
+        jclass,
+        jobject bitmap,
+        jint matrix,
+        jboolean full_range,
+        jint rotation,
+        jobject dst_y,
+        jint dst_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_y,
+        jint dst_pixel_stride_uv) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+        LOGE("Invalid rotation %d.", rotation);
+        return -1;
+    }
+    const bool transpose = rotation == 90 || rotation == 270;
+    camerax::PlanarImage dst = PlanarImageFromByteBuffers(
+            env, dst_y, dst_stride_y, dst_pixel_stride_y, dst_u, dst_stride_u, dst_v,
+            dst_stride_v, dst_pixel_stride_uv,
+            static_cast<jint>(transpose ? info.height : info.width),
+            static_cast<jint>(transpose ? info.width : info.height));
+    if (!PlanesFitByteBuffers(env, dst, dst_y, dst_u, dst_v)) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(
+            matrix, full_range, static_cast<jint>(camerax::RgbOrder::kABGR), rotation);
+    return ConvertBitmapToYuv(env, bitmap, info, options, dst);
+}
+
+/**
+ * Like nativeConvertBitmapToAndroid420 for a YUV_420_888 HardwareBuffer, e.g. that of an Image
+ * dequeued from an ImageWriter, which is locked for writing.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertBitmapToHardwareBuffer(
+        JNIEnv* env,
+        jclass,
+        jobject bitmap,
+        jint matrix,
+        jboolean full_range,
+        jint rotation,
+        jobject hardware_buffer) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    camerax::HardwareBufferPlaneProvider provider(HardwareBufferFromJava(env, hardware_buffer));
+    camerax::ScopedPlaneLock lock(&provider, /* write= */ true);
+    if (!lock.ok()) {
+        LOGE("Failed to lock hardware buffer planes.");
+        return -1;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(
+            matrix, full_range, static_cast<jint>(camerax::RgbOrder::kABGR), rotation);
+    return ConvertBitmapToYuv(env, bitmap, info, options, lock.image());
+}
+
+/**
+ * Converts an RGBA_8888 bitmap, e.g. a watermark or a rendered timestamp, into an overlay that
+ * can be blended into any number of YUV frames without converting them to RGBA, see
+ * camerax::YuvOverlay. {@code premultiplied} is Bitmap#isPremultiplied. The overlay is rotated
+ * by {@code rotation}, so that it appears upright once the frame is rotated for display.
+ *
+ * @return a handle for the other overlay calls, or 0 on failure. The other calls fail for a
+ * handle of 0 instead of dereferencing it.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeCreateYuvOverlay(
+        JNIEnv* env,
+        jclass,
+        jobject bitmap,
+        jboolean premultiplied,
+        jint matrix,
+        jboolean full_range,
+        jint rotation) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return 0;
+    }
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return 0;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(
+            matrix, full_range, static_cast<jint>(camerax::RgbOrder::kABGR), rotation);
+    camerax::YuvOverlay* overlay = new camerax::YuvOverlay(
+            static_cast<const uint8_t*>(bitmapAddress), static_cast<int>(info.stride),
+            static_cast<int>(info.width), static_cast<int>(info.height), premultiplied, options);
+    AndroidBitmap_unlockPixels(env, bitmap);
+    if (!overlay->IsValid()) {
+        LOGE("Invalid overlay options.");
+        delete overlay;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(overlay);
+}
+
+/**
+ * Like nativeCreateYuvOverlay for 32-bit pixels in a direct buffer, in R, G, B, A
+ * ({@code order} 0) or B, G, R, A (1) byte order.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeCreateYuvOverlayFromRgba(
+        JNIEnv* env,
+        jclass,
+        jobject src,
+        jint src_stride,
+        jint width,
+        jint height,
+        jint order,
+        jboolean premultiplied,
+        jint matrix,
+        jboolean full_range,
+        jint rotation) {
+    const uint8_t* src_ptr = static_cast<const uint8_t*>(env->GetDirectBufferAddress(src));
+    if (src_ptr == nullptr || width <= 0 || height <= 0
+        || env->GetDirectBufferCapacity(src)
+                < static_cast<jlong>(src_stride) * (height - 1) + 4 * width) {
+        LOGE("Invalid RGBA source.");
+        return 0;
+    }
+    camerax::RgbToYuvOptions options = RgbToYuvOptionsFromArgs(matrix, full_range, order,
+                                                               rotation);
+    camerax::YuvOverlay* overlay = new camerax::YuvOverlay(src_ptr, src_stride, width, height,
+                                                           premultiplied, options);
+    if (!overlay->IsValid()) {
+        LOGE("Invalid overlay options.");
+        delete overlay;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(overlay);
+}
+
+/**
+ * Frees an overlay. It must not be blended anymore.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeDestroyYuvOverlay(
+        JNIEnv*,
+        jclass,
+        jlong overlay) {
+    delete reinterpret_cast<camerax::YuvOverlay*>(overlay);
+}
+
+/**
+ * Blends an overlay in place into YUV_420_888 planes, with its top left corner at
+ * ({@code x}, {@code y}) rounded down to even. Only the covered part of the planes is touched,
+ * the rest of the overlay is clipped.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeBlendYuvOverlay(
+        JNIEnv* env,
+        jclass,
+        jlong overlay,
+        jobject dst_y,
+        jint dst_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_y,
+        jint dst_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint x,
+        jint y) {
+    camerax::PlanarImage dst = PlanarImageFromByteBuffers(env,
+                                                          dst_y, dst_stride_y, dst_pixel_stride_y,
+                                                          dst_u, dst_stride_u,
+                                                          dst_v, dst_stride_v,
+                                                          dst_pixel_stride_uv,
+                                                          width, height);
+    camerax::YuvOverlay* yuv_overlay = reinterpret_cast<camerax::YuvOverlay*>(overlay);
+    if (yuv_overlay == nullptr) {
+        LOGE("Invalid overlay.");
+        return -1;
+    }
+    if (!PlanesFitByteBuffers(env, dst, dst_y, dst_u, dst_v)) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
+    return yuv_overlay->BlendInto(dst, x, y, GetStripePool());
+}
+
+/**
+ * Like nativeBlendYuvOverlay for the NV12 (NV21 if {@code vu_order} is set) buffer {@code dst},
+ * whose chroma starts after {@code dst_slice_height} rows of {@code dst_stride} bytes, e.g. a
+ * frame ring plane or a codec buffer.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeBlendYuvOverlayIntoNV12(
+        JNIEnv* env,
+        jclass,
+        jlong overlay,
+        jobject dst,
+        jint width,
+        jint height,
+        jint dst_stride,
+        jint dst_slice_height,
+        jboolean vu_order,
+        jint x,
+        jint y) {
+    camerax::YuvOverlay* yuv_overlay = reinterpret_cast<camerax::YuvOverlay*>(overlay);
+    if (yuv_overlay == nullptr) {
+        LOGE("Invalid overlay.");
+        return -1;
+    }
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    const jlong dst_size = static_cast<jlong>(dst_stride)
+            * (dst_slice_height + (static_cast<jlong>(height) + 1) / 2);
+    if (dst_ptr == nullptr || dst_stride < width || dst_slice_height < height
+        || env->GetDirectBufferCapacity(dst) < dst_size) {
+        LOGE("NV12 buffer too small.");
+        return -1;
+    }
+    return yuv_overlay->BlendInto(
+            camerax::WrapNV12(dst_ptr, width, height, dst_stride, dst_slice_height, vu_order),
+            x, y, GetStripePool());
+}
+
+/**
+ * Blurs or pixelates regions of YUV_420_888 planes in place, e.g. faces and license plates
+ * before a frame leaves the device. {@code regions} holds {left, top, width, height} groups.
+ * {@code mode} is 0 for a box blur of radius {@code size}, 1 for a Gaussian blur of standard
+ * deviation {@code size} and 2 for blocks of {@code size} pixels, see camerax::MaskRegions.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeMaskRegions(
+        JNIEnv* env,
+        jclass,
+        jobject dst_y,
+        jint dst_stride_y,
+        jobject dst_u,
+        jint dst_stride_u,
+        jobject dst_v,
+        jint dst_stride_v,
+        jint dst_pixel_stride_y,
+        jint dst_pixel_stride_uv,
+        jint width,
+        jint height,
+        jintArray regions,
+        jint mode,
+        jint size) {
+    std::vector<camerax::MaskRegion> mask_regions;
+    camerax::MaskOptions options;
+    if (!MaskArgsFromJava(env, regions, mode, size, &mask_regions, &options)) {
+        return -1;
+    }
+    camerax::PlanarImage dst = PlanarImageFromByteBuffers(env,
+                                                          dst_y, dst_stride_y, dst_pixel_stride_y,
+                                                          dst_u, dst_stride_u,
+                                                          dst_v, dst_stride_v,
+                                                          dst_pixel_stride_uv,
+                                                          width, height);
+    if (!PlanesFitByteBuffers(env, dst, dst_y, dst_u, dst_v)) {
+        LOGE("Invalid YUV planes.");
+        return -1;
+    }
+    return camerax::MaskRegions(dst, mask_regions.data(), static_cast<int>(mask_regions.size()),
+                                options, GetStripePool());
+}
+
+/**
+ * Like nativeMaskRegions for the NV12 (NV21 if {@code vu_order} is set) buffer {@code dst},
+ * whose chroma starts after {@code dst_slice_height} rows of {@code dst_stride} bytes.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeMaskRegionsInNV12(
+        JNIEnv* env,
+        jclass,
+        jobject dst,
+        jint width,
+        jint height,
+        jint dst_stride,
+        jint dst_slice_height,
+        jboolean vu_order,
+        jintArray regions,
+        jint mode,
+        jint size) {
+    std::vector<camerax::MaskRegion> mask_regions;
+    camerax::MaskOptions options;
+    if (!MaskArgsFromJava(env, regions, mode, size, &mask_regions, &options)) {
+        return -1;
+    }
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    const jlong dst_size = static_cast<jlong>(dst_stride)
+            * (dst_slice_height + (static_cast<jlong>(height) + 1) / 2);
+    if (dst_ptr == nullptr || dst_stride < width || dst_slice_height < height
+        || env->GetDirectBufferCapacity(dst) < dst_size) {
+        LOGE("NV12 buffer too small.");
+        return -1;
+    }
+    return camerax::MaskRegions(
+            camerax::WrapNV12(dst_ptr, width, height, dst_stride, dst_slice_height, vu_order),
+            mask_regions.data(), static_cast<int>(mask_regions.size()), options,
+            GetStripePool());
+}
+
+/**
+ * Creates a native burst merger for frames of the given size, see camerax::BurstMerger. Frames
+ * are aligned by a global translation of up to {@code max_shift} pixels if {@code align} is
+ * set, and samples differing from the first frame by more than {@code motion_threshold} are
+ * left out. The sums are allocated here.
+ *
+ * @return a handle for the other burst merge calls, or 0 on failure. The other calls fail for
+ * a handle of 0 instead of dereferencing it.
+ */
+JNIEXPORT jlong Java_androidx_camera_core_ImageProcessingUtil_nativeCreateBurstMerger(
+        JNIEnv*,
+        jclass,
+        jint width,
+        jint height,
+        jboolean align,
+        jint max_shift,
+        jint motion_threshold) {
+    camerax::BurstMergeOptions options;
+    options.width = width;
+    options.height = height;
+    options.align = align;
+    options.max_shift = max_shift;
+    options.motion_threshold = motion_threshold;
+    camerax::BurstMerger* merger = new camerax::BurstMerger(options);
+    if (!merger->IsValid()) {
+        LOGE("Invalid burst merge options.");
+        delete merger;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(merger);
+}
+
+/**
+ * Frees a burst merger.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeDestroyBurstMerger(
+        JNIEnv*,
+        jclass,
+        jlong merger) {
+    delete reinterpret_cast<camerax::BurstMerger*>(merger);
+}
+
+/**
+ * Drops the frames added to a burst merger, to start the next burst without allocating.
+ */
+JNIEXPORT void Java_androidx_camera_core_ImageProcessingUtil_nativeResetBurstMerger(
+        JNIEnv*,
+        jclass,
+        jlong merger) {
+    camerax::BurstMerger* burst_merger = reinterpret_cast<camerax::BurstMerger*>(merger);
+    if (burst_merger == nullptr) {
+        LOGE("Invalid burst merger.");
+        return;
+    }
+    burst_merger->Reset();
+}
+
+/**
+ * Adds YUV_420_888 planes to a burst. The first frame after a reset is the reference the
+ * others are aligned to. The translation of the frame is written to {@code shift_out} as
+ * {x, y} if it is not null.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeAddBurstFrame(
+        JNIEnv* env,
+        jclass,
+        jlong merger,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jintArray shift_out) {
+    camerax::BurstMerger* burst_merger = reinterpret_cast<camerax::BurstMerger*>(merger);
+    if (burst_merger == nullptr) {
+        LOGE("Invalid burst merger.");
+        return -1;
+    }
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    jint shift[2] = {0, 0};
+    if (burst_merger->AddFrame(src, GetStripePool(), &shift[0], &shift[1]) != 0) {
+        return -1;
+    }
+    if (shift_out != nullptr && env->GetArrayLength(shift_out) >= 2) {
+        env->SetIntArrayRegion(shift_out, 0, 2, shift);
+    }
+    return 0;
+}
+
+/**
+ * Writes the merged burst into the NV12 (NV21 if {@code vu_order} is set) buffer {@code dst},
+ * whose chroma starts after {@code dst_slice_height} rows of {@code dst_stride} bytes. The stats
+ * are written to {@code stats_out} if it is not null, see WriteBurstMergeStats.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeMergeBurstToNV12(
+        JNIEnv* env,
+        jclass,
+        jlong merger,
+        jobject dst,
+        jint width,
+        jint height,
+        jint dst_stride,
+        jint dst_slice_height,
+        jboolean vu_order,
+        jlongArray stats_out) {
+    camerax::BurstMerger* burst_merger = reinterpret_cast<camerax::BurstMerger*>(merger);
+    if (burst_merger == nullptr) {
+        LOGE("Invalid burst merger.");
+        return -1;
+    }
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    const jlong dst_size = static_cast<jlong>(dst_stride)
+            * (dst_slice_height + (static_cast<jlong>(height) + 1) / 2);
+    if (dst_ptr == nullptr || dst_stride < width || dst_slice_height < height
+        || env->GetDirectBufferCapacity(dst) < dst_size) {
+        LOGE("NV12 buffer too small.");
+        return -1;
+    }
+    const int result = burst_merger->MergeToYuv(
+            camerax::WrapNV12(dst_ptr, width, height, dst_stride, dst_slice_height, vu_order),
+            GetStripePool());
+    WriteBurstMergeStats(env, stats_out, burst_merger->stats());
+    return result;
+}
+
+/**
+ * Writes the merged burst into an RGBA_8888 bitmap of the frame size, with the full or studio
+ * swing BT.601 matrix. The stats are written like for nativeMergeBurstToNV12.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeMergeBurstToBitmap(
+        JNIEnv* env,
+        jclass,
+        jlong merger,
+        jobject bitmap,
+        jboolean is_full_swing,
+        jlongArray stats_out) {
+    camerax::BurstMerger* burst_merger = reinterpret_cast<camerax::BurstMerger*>(merger);
+    if (burst_merger == nullptr) {
+        LOGE("Invalid burst merger.");
+        return -1;
+    }
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888
+        || static_cast<int>(info.width) != burst_merger->width()
+        || static_cast<int>(info.height) != burst_merger->height()) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    int result = burst_merger->MergeToABGR(static_cast<uint8_t*>(bitmapAddress),
+                                           static_cast<int>(info.stride), is_full_swing,
+                                           GetStripePool());
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        result = -1;
+    }
+    WriteBurstMergeStats(env, stats_out, burst_merger->stats());
+    return result;
+}
+
+/**
+ * Crops and orients the YUV_420_888 planes and scales them, keeping the aspect ratio, to fit an
+ * RGBA_8888 bitmap, filling the rest of the bitmap with {@code pad_color}. See
+ * WriteLetterboxPlacement for {@code placement_out} and {@code transform_out}.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeLetterboxAndroid420ToBitmap(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jint pad_color,
+        jboolean center,
+        jobject bitmap,
+        jintArray placement_out,
+        jfloatArray transform_out) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != 0
+        || info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Unsupported bitmap.");
+        return -1;
+    }
+    camerax::LetterboxRequest request = LetterboxRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror,
+            static_cast<int>(info.width), static_cast<int>(info.height), pad_color, center);
+
+    void* bitmapAddress = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &bitmapAddress) != 0) {
+        return -1;
+    }
+    camerax::LetterboxPlacement placement;
+    int result = camerax::Letterbox(src, request, static_cast<uint8_t*>(bitmapAddress),
+                                    static_cast<int>(info.stride), GetStripePool(), &placement);
+    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+        return -1;
+    }
+    if (result == 0) {
+        WriteLetterboxPlacement(env, placement, placement_out, transform_out);
+    }
+    return result;
+}
+
+/**
+ * Like nativeLetterboxAndroid420ToBitmap, but into a {@code box_width} x {@code box_height}
+ * model input tensor in the direct buffer {@code dst}. {@code format} is 1 for RGB bytes, 2 for
+ * NHWC floats and 3 for NCHW floats, see camerax::LetterboxFormat. Floats hold (c - mean) *
+ * scale for channel values c in [0, 255]; {@code mean} and {@code scale} hold a value per
+ * channel and may be null for 0 and 1.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeLetterboxAndroid420ToTensor(
+        JNIEnv* env,
+        jclass,
+        jobject src_y,
+        jint src_stride_y,
+        jobject src_u,
+        jint src_stride_u,
+        jobject src_v,
+        jint src_stride_v,
+        jint src_pixel_stride_y,
+        jint src_pixel_stride_uv,
+        jint width,
+        jint height,
+        jint crop_left,
+        jint crop_top,
+        jint crop_width,
+        jint crop_height,
+        jint rotation,
+        jboolean mirror,
+        jint box_width,
+        jint box_height,
+        jint pad_color,
+        jboolean center,
+        jint format,
+        jfloatArray mean,
+        jfloatArray scale,
+        jobject dst,
+        jintArray placement_out,
+        jfloatArray transform_out) {
+    camerax::PlanarImage src = PlanarImageFromByteBuffers(env,
+                                                          src_y, src_stride_y, src_pixel_stride_y,
+                                                          src_u, src_stride_u,
+                                                          src_v, src_stride_v,
+                                                          src_pixel_stride_uv,
+                                                          width, height);
+    camerax::LetterboxRequest request = LetterboxRequestFromArgs(
+            crop_left, crop_top, crop_width, crop_height, rotation, mirror, box_width,
+            box_height, pad_color, center);
+    request.output_format = static_cast<camerax::LetterboxFormat>(format);
+    if (request.output_format == camerax::LetterboxFormat::kABGR
+        || (mean != nullptr && env->GetArrayLength(mean) < 3)
+        || (scale != nullptr && env->GetArrayLength(scale) < 3)) {
+        LOGE("Invalid tensor format.");
+        return -1;
+    }
+    if (mean != nullptr) {
+        env->GetFloatArrayRegion(mean, 0, 3, request.mean);
+    }
+    if (scale != nullptr) {
+        env->GetFloatArrayRegion(scale, 0, 3, request.scale);
+    }
+
+    const jlong sample_size = request.output_format == camerax::LetterboxFormat::kRGB ? 1 : 4;
+    uint8_t* dst_ptr = static_cast<uint8_t*>(env->GetDirectBufferAddress(dst));
+    if (dst_ptr == nullptr || box_width <= 0 || box_height <= 0
+        || env->GetDirectBufferCapacity(dst)
+                < static_cast<jlong>(box_width) * box_height * 3 * sample_size) {
+        LOGE("Invalid tensor buffer.");
+        return -1;
+    }
+    camerax::LetterboxPlacement placement;
+    if (camerax::Letterbox(src, request, dst_ptr, 0, GetStripePool(), &placement) != 0) {
+        return -1;
+    }
+    WriteLetterboxPlacement(env, placement, placement_out, transform_out);
+    return 0;
+}
+
 }  // extern "C"
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_pyramid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "libyuv/planar_functions.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_argb.h"
+
+#include "image_kernels.h"
+#include "image_warp.h"
+
+namespace camerax {
+
+namespace {
+
+// A few stripes per thread even out stripes that take longer than others.
+constexpr int kStripesPerThread = 3;
+constexpr int kMaxLevels = 16;
+
+int BytesPerPixel(PyramidFormat format) {
+    return format == PyramidFormat::kABGR ? 4 : 1;
+}
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Bytes taken by a level inside the pyramid block, so that every level starts aligned.
+size_t LevelBytes(const PyramidLevel& level) {
+    return AlignUp(static_cast<size_t>(level.stride) * level.height, FrameArena::kAlignment);
+}
+
+// Splits rows into at most stripe_count stripes whose height is a multiple of alignment.
+int StripeRows(int rows, int stripe_count, int alignment) {
+    int stripe_rows = (rows + stripe_count - 1) / stripe_count;
+    return std::max(alignment, (stripe_rows + alignment - 1) / alignment * alignment);
+}
+
+// Writes the rows [top, bottom) of the full resolution level.
+int ConvertRows(const PlanarImage& src, PyramidFormat format, const PyramidLevel& dst, int top,
+                int bottom) {
+    uint8_t* dst_row = dst.data + static_cast<ptrdiff_t>(top) * dst.stride;
+    const int rows = bottom - top;
+    if (format == PyramidFormat::kABGR) {
+        // Stripes start on even rows, so their chroma rows are their own.
+        return Android420ToABGR(CropPlanarImage(src, 0, top, src.width, rows), dst_row,
+                                dst.stride, /* is_full_swing = */true);
+    }
+    if (src.y.pixel_stride == 1) {
+        libyuv::CopyPlane(src.y.RowAt(top), src.y.row_stride, dst_row, dst.stride, src.width,
+                          rows);
+        return 0;
+    }
+    for (int y = top; y < bottom; ++y, dst_row += dst.stride) {
+        const uint8_t* src_row = src.y.RowAt(y);
+        for (int x = 0; x < src.width; ++x) {
+            dst_row[x] = src_row[x * src.y.pixel_stride];
+        }
+    }
+    return 0;
+}
+
+// Writes the rows [top, bottom) of dst as 2x2 box averages of src, which is twice as large up
+// to an odd last row or column that is dropped.
+void HalveRows(const PyramidLevel& src, const PyramidLevel& dst, PyramidFormat format, int top,
+               int bottom) {
+    if (bottom <= top) {
+        return;
+    }
+    const uint8_t* src_rows = src.data + static_cast<ptrdiff_t>(2 * top) * src.stride;
+    uint8_t* dst_rows = dst.data + static_cast<ptrdiff_t>(top) * dst.stride;
+    const int rows = bottom - top;
+    // Exact halving makes libyuv take its SIMD 2x2 box kernels.
+    if (format == PyramidFormat::kABGR) {
+        libyuv::ARGBScale(src_rows, src.stride, 2 * dst.width, 2 * rows,
+                          dst_rows, dst.stride, dst.width, rows, libyuv::kFilterBox);
+    } else {
+        libyuv::ScalePlane(src_rows, src.stride, 2 * dst.width, 2 * rows,
+                           dst_rows, dst.stride, dst.width, rows, libyuv::kFilterBox);
+    }
+}
+
+// Writes the rows [top, bottom) of dst by resampling src bilinearly.
+void ResampleRows(const PyramidLevel& src, const PyramidLevel& dst, int bytes_per_pixel,
+                  const BilinearTaps& columns, const BilinearTaps& rows, int top, int bottom) {
+    for (int y = top; y < bottom; ++y) {
+        const uint8_t* row0 = src.data + static_cast<ptrdiff_t>(rows.index[y]) * src.stride;
+        const uint8_t* row1 = rows.weight[y] != 0 ? row0 + src.stride : row0;
+        const int fy = rows.weight[y];
+        uint8_t* dst_row = dst.data + static_cast<ptrdiff_t>(y) * dst.stride;
+        for (int x = 0; x < dst.width; ++x) {
+            const int x0 = columns.index[x] * bytes_per_pixel;
+            const int x1 = columns.weight[x] != 0 ? x0 + bytes_per_pixel : x0;
+            const int fx = columns.weight[x];
+            for (int c = 0; c < bytes_per_pixel; ++c) {
+                int top_value = row0[x0 + c] * (256 - fx) + row0[x1 + c] * fx;
+                int bottom_value = row1[x0 + c] * (256 - fx) + row1[x1 + c] * fx;
+                dst_row[x * bytes_per_pixel + c] = static_cast<uint8_t>(
+                        (top_value * (256 - fy) + bottom_value * fy + 32768) >> 16);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+size_t GetPyramidLayout(int width, int height, const PyramidOptions& options,
+                        std::vector<PyramidLevel>* levels) {
+    if (width <= 0 || height <= 0 || options.level_count < 1 || options.level_count > kMaxLevels
+        || !(options.ratio > 1.0f)) {
+        return 0;
+    }
+    const int bytes_per_pixel = BytesPerPixel(options.format);
+    const bool halving = options.ratio == 2.0f;
+    levels->clear();
+    size_t bytes = 0;
+    for (int i = 0; i < options.level_count; ++i) {
+        if (i > 0) {
+            width = halving ? width / 2 : static_cast<int>(width / options.ratio);
+            height = halving ? height / 2 : static_cast<int>(height / options.ratio);
+            if (width <= 0 || height <= 0) {
+                return 0;
+            }
+        }
+        // 16 byte aligned rows keep SIMD loads of consumers aligned.
+        const int stride = static_cast<int>(AlignUp(static_cast<size_t>(width) * bytes_per_pixel,
+                                                    16));
+        levels->push_back({nullptr, width, height, stride});
+        bytes += LevelBytes(levels->back());
+    }
+    return FrameArena::CapacityFor(bytes, 1);
+}
+
+int BuildPyramid(const PlanarImage& src, const PyramidOptions& options, FrameArena* arena,
+                 StripePool* pool, std::vector<PyramidLevel>* levels) {
+    if (!src.IsValid() || arena == nullptr || levels == nullptr) {
+        return -1;
+    }
+    std::vector<PyramidLevel> layout;
+    const size_t capacity = GetPyramidLayout(src.width, src.height, options, &layout);
+    if (capacity == 0 || arena->Reset(capacity) != 0) {
+        return -1;
+    }
+    size_t bytes = 0;
+    for (const PyramidLevel& level : layout) {
+        bytes += LevelBytes(level);
+    }
+    uint8_t* block = arena->Allocate(bytes);
+    if (block == nullptr) {
+        return -1;
+    }
+    for (PyramidLevel& level : layout) {
+        level.data = block;
+        block += LevelBytes(level);
+    }
+
+    const PyramidFormat format = options.format;
+    const int level_count = static_cast<int>(layout.size());
+    const bool halving = options.ratio == 2.0f;
+    const int stripe_target = pool != nullptr ? pool->thread_count() * kStripesPerThread : 1;
+    // Halving stripes are aligned so that every level splits at whole rows. Level 0 stripes
+    // start on even rows for the chroma.
+    const int alignment = halving ? std::max(2, 1 << (level_count - 1)) : 2;
+    const int stripe_rows = StripeRows(src.height, stripe_target, alignment);
+    const int stripe_count = (src.height + stripe_rows - 1) / stripe_rows;
+
+    std::atomic<int> failures(0);
+    RunStripes(pool, stripe_count, [&](int stripe) {
+        const int top = stripe * stripe_rows;
+        const int bottom = std::min(src.height, top + stripe_rows);
+        if (ConvertRows(src, format, layout[0], top, bottom) != 0) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (halving) {
+            for (int i = 1; i < level_count; ++i) {
+                HalveRows(layout[i - 1], layout[i], format, top >> i,
+                          std::min(bottom >> i, layout[i].height));
+            }
+        }
+    });
+    if (failures.load() != 0) {
+        return -1;
+    }
+
+    if (!halving) {
+        // Every level depends on all rows of the previous one, so levels run one after the
+        // other, each split into stripes of its own.
+        const int bytes_per_pixel = BytesPerPixel(format);
+        for (int i = 1; i < level_count; ++i) {
+            const PyramidLevel& src_level = layout[i - 1];
+            const PyramidLevel& dst_level = layout[i];
+            const BilinearTaps columns = ComputeBilinearTaps(src_level.width, dst_level.width,
+                                                             /* reverse= */ false);
+            const BilinearTaps rows = ComputeBilinearTaps(src_level.height, dst_level.height,
+                                                          /* reverse= */ false);
+            const int level_stripe_rows = StripeRows(dst_level.height, stripe_target, 1);
+            const int level_stripe_count =
+                    (dst_level.height + level_stripe_rows - 1) / level_stripe_rows;
+            RunStripes(pool, level_stripe_count, [&](int stripe) {
+                const int top = stripe * level_stripe_rows;
+                ResampleRows(src_level, dst_level, bytes_per_pixel, columns, rows, top,
+                             std::min(dst_level.height, top + level_stripe_rows));
+            });
+        }
+    }
+
+    *levels = std::move(layout);
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_PYRAMID_H_
+#define CAMERA_CORE_IMAGE_PYRAMID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame_arena.h"
+#include "image_planes.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+enum class PyramidFormat {
+    // The luma plane only, one byte per pixel.
+    kY8 = 0,
+    // Full range RGBA, four bytes per pixel.
+    kABGR = 1,
+};
+
+struct PyramidOptions {
+    // Number of levels including the full resolution one.
+    int level_count = 4;
+    // Size ratio between successive levels, greater than 1. A ratio of exactly 2 takes a 2x2
+    // box filter and is computed in a single pass over the source; other ratios resample the
+    // previous level bilinearly.
+    float ratio = 2.0f;
+    PyramidFormat format = PyramidFormat::kY8;
+};
+
+struct PyramidLevel {
+    uint8_t* data;
+    int width;
+    int height;
+    // Bytes between rows.
+    int stride;
+};
+
+/**
+ * Computes the size of every level of a pyramid over a {@code width} x {@code height} frame,
+ * with {@code data} left null, and returns the arena capacity that holds all of them.
+ *
+ * @return the capacity in bytes, or 0 if the options are invalid or a level would be empty.
+ */
+size_t GetPyramidLayout(int width, int height, const PyramidOptions& options,
+                        std::vector<PyramidLevel>* levels);
+
+/**
+ * Builds a pyramid of successively smaller copies of {@code src}, level 0 being the full
+ * resolution, into a single allocation of {@code arena}. The arena is reset first.
+ *
+ * <p>The frame is split into horizontal stripes that run on {@code pool}, which may be null to
+ * run on the calling thread. With a ratio of 2 every stripe carries its rows all the way down the
+ * pyramid while they are still in the cache, so the source is read once and no level is read
+ * back from memory.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+int BuildPyramid(const PlanarImage& src, const PyramidOptions& options, FrameArena* arena,
+                 StripePool* pool, std::vector<PyramidLevel>* levels);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_PYRAMID_H_
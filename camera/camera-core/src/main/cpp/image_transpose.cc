@@ -0,0 +1,476 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_transpose.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_TRANSPOSE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_TRANSPOSE_SSE2 1
+#endif
+
+#include "libyuv/rotate.h"
+#include "libyuv/rotate_argb.h"
+
+#include "kernel_dispatch.h"
+
+// The block kernels keep whole blocks in registers, which only works out if their loops are
+// fully unrolled. Compilers do not do that on their own at -O2.
+#if defined(__clang__)
+#define CAMERAX_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define CAMERAX_UNROLL _Pragma("GCC unroll 16")
+#else
+#define CAMERAX_UNROLL
+#endif
+
+namespace camerax {
+
+namespace {
+
+constexpr size_t kDefaultTileBytes = 16 * 1024;
+constexpr size_t kMinTileBytes = 1024;
+constexpr size_t kMaxTileBytes = 1024 * 1024;
+
+std::atomic<size_t> g_tile_bytes(kDefaultTileBytes);
+
+// Transposes the 8x8 block of bytes at src into dst.
+inline void Transpose8x8(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride) {
+#if defined(CAMERAX_TRANSPOSE_NEON)
+    uint8x8x2_t t01 = vtrn_u8(vld1_u8(src), vld1_u8(src + src_stride));
+    uint8x8x2_t t23 = vtrn_u8(vld1_u8(src + 2 * src_stride), vld1_u8(src + 3 * src_stride));
+    uint8x8x2_t t45 = vtrn_u8(vld1_u8(src + 4 * src_stride), vld1_u8(src + 5 * src_stride));
+    uint8x8x2_t t67 = vtrn_u8(vld1_u8(src + 6 * src_stride), vld1_u8(src + 7 * src_stride));
+    uint16x4x2_t u02 = vtrn_u16(vreinterpret_u16_u8(t01.val[0]), vreinterpret_u16_u8(t23.val[0]));
+    uint16x4x2_t u13 = vtrn_u16(vreinterpret_u16_u8(t01.val[1]), vreinterpret_u16_u8(t23.val[1]));
+    uint16x4x2_t u46 = vtrn_u16(vreinterpret_u16_u8(t45.val[0]), vreinterpret_u16_u8(t67.val[0]));
+    uint16x4x2_t u57 = vtrn_u16(vreinterpret_u16_u8(t45.val[1]), vreinterpret_u16_u8(t67.val[1]));
+    uint32x2x2_t v04 = vtrn_u32(vreinterpret_u32_u16(u02.val[0]), vreinterpret_u32_u16(u46.val[0]));
+    uint32x2x2_t v26 = vtrn_u32(vreinterpret_u32_u16(u02.val[1]), vreinterpret_u32_u16(u46.val[1]));
+    uint32x2x2_t v15 = vtrn_u32(vreinterpret_u32_u16(u13.val[0]), vreinterpret_u32_u16(u57.val[0]));
+    uint32x2x2_t v37 = vtrn_u32(vreinterpret_u32_u16(u13.val[1]), vreinterpret_u32_u16(u57.val[1]));
+    vst1_u8(dst, vreinterpret_u8_u32(v04.val[0]));
+    vst1_u8(dst + dst_stride, vreinterpret_u8_u32(v15.val[0]));
+    vst1_u8(dst + 2 * dst_stride, vreinterpret_u8_u32(v26.val[0]));
+    vst1_u8(dst + 3 * dst_stride, vreinterpret_u8_u32(v37.val[0]));
+    vst1_u8(dst + 4 * dst_stride, vreinterpret_u8_u32(v04.val[1]));
+    vst1_u8(dst + 5 * dst_stride, vreinterpret_u8_u32(v15.val[1]));
+    vst1_u8(dst + 6 * dst_stride, vreinterpret_u8_u32(v26.val[1]));
+    vst1_u8(dst + 7 * dst_stride, vreinterpret_u8_u32(v37.val[1]));
+#elif defined(CAMERAX_TRANSPOSE_SSE2)
+    __m128i r[8];
+    CAMERAX_UNROLL
+    for (int i = 0; i < 8; ++i) {
+        r[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * src_stride));
+    }
+    __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+    __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+    __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+    __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+    // Each register holds two transposed rows.
+    __m128i c[4] = {_mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2),
+                    _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3)};
+    CAMERAX_UNROLL
+    for (int i = 0; i < 4; ++i) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 2 * i * dst_stride), c[i]);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (2 * i + 1) * dst_stride),
+                         _mm_srli_si128(c[i], 8));
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            dst[j * dst_stride + i] = src[i * src_stride + j];
+        }
+    }
+#endif
+}
+
+// Transposes the 16x16 block of bytes at src into dst.
+//
+// Interleaving register j with register j + 8 rotates the 8-bit (register, byte) index of every
+// element left by one bit, so four rounds swap the register and byte halves of the index.
+inline void Transpose16x16(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride) {
+#if defined(CAMERAX_TRANSPOSE_NEON)
+    uint8x16_t r[16];
+    CAMERAX_UNROLL
+    for (int i = 0; i < 16; ++i) {
+        r[i] = vld1q_u8(src + i * src_stride);
+    }
+    CAMERAX_UNROLL
+    for (int round = 0; round < 4; ++round) {
+        uint8x16_t t[16];
+        CAMERAX_UNROLL
+        for (int j = 0; j < 8; ++j) {
+            uint8x16x2_t zipped = vzipq_u8(r[j], r[j + 8]);
+            t[2 * j] = zipped.val[0];
+            t[2 * j + 1] = zipped.val[1];
+        }
+        CAMERAX_UNROLL
+        for (int i = 0; i < 16; ++i) {
+            r[i] = t[i];
+        }
+    }
+    CAMERAX_UNROLL
+    for (int i = 0; i < 16; ++i) {
+        vst1q_u8(dst + i * dst_stride, r[i]);
+    }
+#elif defined(CAMERAX_TRANSPOSE_SSE2)
+    __m128i r[16];
+    CAMERAX_UNROLL
+    for (int i = 0; i < 16; ++i) {
+        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * src_stride));
+    }
+    CAMERAX_UNROLL
+    for (int round = 0; round < 4; ++round) {
+        __m128i t[16];
+        CAMERAX_UNROLL
+        for (int j = 0; j < 8; ++j) {
+            t[2 * j] = _mm_unpacklo_epi8(r[j], r[j + 8]);
+            t[2 * j + 1] = _mm_unpackhi_epi8(r[j], r[j + 8]);
+        }
+        CAMERAX_UNROLL
+        for (int i = 0; i < 16; ++i) {
+            r[i] = t[i];
+        }
+    }
+    CAMERAX_UNROLL
+    for (int i = 0; i < 16; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dst_stride), r[i]);
+    }
+#else
+    for (int i = 0; i < 16; i += 8) {
+        for (int j = 0; j < 16; j += 8) {
+            Transpose8x8(src + i * src_stride + j, src_stride, dst + j * dst_stride + i,
+                         dst_stride);
+        }
+    }
+#endif
+}
+
+// Transposes the 8x8 block of byte pairs at src_uv, writing the first bytes of the pairs to
+// dst_a and the second ones to dst_b.
+inline void TransposeUV8x8(const uint8_t* src_uv, int src_stride,
+                           uint8_t* dst_a, int dst_stride_a, uint8_t* dst_b, int dst_stride_b) {
+#if defined(CAMERAX_TRANSPOSE_NEON)
+    // Deinterleaves while loading, then transposes both halves as bytes.
+    uint8_t a[64];
+    uint8_t b[64];
+    CAMERAX_UNROLL
+    for (int i = 0; i < 8; ++i) {
+        uint8x8x2_t uv = vld2_u8(src_uv + i * src_stride);
+        vst1_u8(a + 8 * i, uv.val[0]);
+        vst1_u8(b + 8 * i, uv.val[1]);
+    }
+    Transpose8x8(a, 8, dst_a, dst_stride_a);
+    Transpose8x8(b, 8, dst_b, dst_stride_b);
+#elif defined(CAMERAX_TRANSPOSE_SSE2)
+    __m128i r[8];
+    CAMERAX_UNROLL
+    for (int i = 0; i < 8; ++i) {
+        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_uv + i * src_stride));
+    }
+    // 8x8 transpose of 16-bit pairs.
+    __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+    __m128i c[8] = {_mm_unpacklo_epi64(b0, b4), _mm_unpackhi_epi64(b0, b4),
+                    _mm_unpacklo_epi64(b1, b5), _mm_unpackhi_epi64(b1, b5),
+                    _mm_unpacklo_epi64(b2, b6), _mm_unpackhi_epi64(b2, b6),
+                    _mm_unpacklo_epi64(b3, b7), _mm_unpackhi_epi64(b3, b7)};
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    const __m128i zero = _mm_setzero_si128();
+    CAMERAX_UNROLL
+    for (int i = 0; i < 8; ++i) {
+        __m128i first = _mm_packus_epi16(_mm_and_si128(c[i], low_bytes), zero);
+        __m128i second = _mm_packus_epi16(_mm_srli_epi16(c[i], 8), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_a + i * dst_stride_a), first);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_b + i * dst_stride_b), second);
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            dst_a[j * dst_stride_a + i] = src_uv[i * src_stride + 2 * j];
+            dst_b[j * dst_stride_b + i] = src_uv[i * src_stride + 2 * j + 1];
+        }
+    }
+#endif
+}
+
+// Transposes the 4x4 block of 32-bit pixels at src into dst. Strides are in bytes.
+inline void Transpose4x4x32(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride) {
+#if defined(CAMERAX_TRANSPOSE_NEON)
+    uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(reinterpret_cast<const uint32_t*>(src)),
+                                 vld1q_u32(reinterpret_cast<const uint32_t*>(src + src_stride)));
+    uint32x4x2_t t23 = vtrnq_u32(
+            vld1q_u32(reinterpret_cast<const uint32_t*>(src + 2 * src_stride)),
+            vld1q_u32(reinterpret_cast<const uint32_t*>(src + 3 * src_stride)));
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst),
+              vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + dst_stride),
+              vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + 2 * dst_stride),
+              vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + 3 * dst_stride),
+              vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+#elif defined(CAMERAX_TRANSPOSE_SSE2)
+    __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_stride));
+    __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * src_stride));
+    __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * src_stride));
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_stride), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * dst_stride),
+                     _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * dst_stride),
+                     _mm_unpackhi_epi64(t2, t3));
+#else
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            memcpy(dst + j * dst_stride + i * 4, src + i * src_stride + j * 4, 4);
+        }
+    }
+#endif
+}
+
+// Side of a square tile of elements of the given size, a multiple of the largest block.
+int TileSide(size_t element_bytes) {
+    int side = static_cast<int>(std::sqrt(static_cast<double>(GetTransposeTileBytes())
+                                          / element_bytes));
+    return std::max(16, side & ~15);
+}
+
+// Walks a width x height grid of elements in tiles of tile x tile elements. Inside a tile,
+// block(x, y) transposes the kBlock x kBlock elements starting at column x and row y, and
+// element(x, y) transposes a single one at the right and bottom edges.
+template <int kBlock, typename BlockFn, typename ElementFn>
+void TransposeTiled(int width, int height, int tile, BlockFn block, ElementFn element) {
+    for (int ty = 0; ty < height; ty += tile) {
+        const int y_end = std::min(ty + tile, height);
+        const int y_blocks_end = ty + (y_end - ty) / kBlock * kBlock;
+        for (int tx = 0; tx < width; tx += tile) {
+            const int x_end = std::min(tx + tile, width);
+            const int x_blocks_end = tx + (x_end - tx) / kBlock * kBlock;
+            for (int y = ty; y < y_blocks_end; y += kBlock) {
+                for (int x = tx; x < x_blocks_end; x += kBlock) {
+                    block(x, y);
+                }
+                for (int i = y; i < y + kBlock; ++i) {
+                    for (int x = x_blocks_end; x < x_end; ++x) {
+                        element(x, i);
+                    }
+                }
+            }
+            for (int y = y_blocks_end; y < y_end; ++y) {
+                for (int x = tx; x < x_end; ++x) {
+                    element(x, y);
+                }
+            }
+        }
+    }
+}
+
+// TransposeTiled with the SIMD blocks, or with blocks of single elements when the scalar
+// implementation is selected, see GetKernelImpl.
+template <int kBlock, typename BlockFn, typename ElementFn>
+void TransposeTiledDispatched(int width, int height, int tile, BlockFn block,
+                              ElementFn element) {
+    if (GetKernelImpl(Kernel::kTranspose) != KernelImpl::kScalar) {
+        TransposeTiled<kBlock>(width, height, tile, block, element);
+        return;
+    }
+    TransposeTiled<kBlock>(
+            width, height, tile,
+            [&](int x, int y) {
+                for (int i = y; i < y + kBlock; ++i) {
+                    for (int j = x; j < x + kBlock; ++j) {
+                        element(j, i);
+                    }
+                }
+            },
+            element);
+}
+
+// Turns a rotation into a transpose: a 90 degree rotation transposes the source read bottom up,
+// a 270 degree one writes the transposed rows bottom up. Returns false for other rotations.
+template <typename T>
+bool RotationToTranspose(int rotation, int src_rows, int dst_rows, const uint8_t** src,
+                         int* src_stride, T** dsts, int* dst_strides, int dst_count) {
+    if (rotation == 90) {
+        *src += static_cast<ptrdiff_t>(src_rows - 1) * *src_stride;
+        *src_stride = -*src_stride;
+        return true;
+    }
+    if (rotation == 270) {
+        for (int i = 0; i < dst_count; ++i) {
+            dsts[i] += static_cast<ptrdiff_t>(dst_rows - 1) * dst_strides[i];
+            dst_strides[i] = -dst_strides[i];
+        }
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+int RotatePlaneTiled(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                     int width, int height, int rotation) {
+    if (!RotationToTranspose(rotation, height, width, &src, &src_stride, &dst, &dst_stride, 1)) {
+        return -1;
+    }
+    TransposeTiledDispatched<16>(
+            width, height, TileSide(1),
+            [=](int x, int y) {
+                Transpose16x16(src + static_cast<ptrdiff_t>(y) * src_stride + x, src_stride,
+                               dst + static_cast<ptrdiff_t>(x) * dst_stride + y, dst_stride);
+            },
+            [=](int x, int y) {
+                dst[static_cast<ptrdiff_t>(x) * dst_stride + y] =
+                        src[static_cast<ptrdiff_t>(y) * src_stride + x];
+            });
+    return 0;
+}
+
+int RotateUVPlaneTiled(const uint8_t* src_uv, int src_stride_uv,
+                       uint8_t* dst_a, int dst_stride_a, uint8_t* dst_b, int dst_stride_b,
+                       int width, int height, int rotation) {
+    uint8_t* dsts[2] = {dst_a, dst_b};
+    int dst_strides[2] = {dst_stride_a, dst_stride_b};
+    if (!RotationToTranspose(rotation, height, width, &src_uv, &src_stride_uv, dsts, dst_strides,
+                             2)) {
+        return -1;
+    }
+    TransposeTiledDispatched<8>(
+            width, height, TileSide(2),
+            [=](int x, int y) {
+                TransposeUV8x8(src_uv + static_cast<ptrdiff_t>(y) * src_stride_uv + 2 * x,
+                               src_stride_uv,
+                               dsts[0] + static_cast<ptrdiff_t>(x) * dst_strides[0] + y,
+                               dst_strides[0],
+                               dsts[1] + static_cast<ptrdiff_t>(x) * dst_strides[1] + y,
+                               dst_strides[1]);
+            },
+            [=](int x, int y) {
+                const uint8_t* pair = src_uv + static_cast<ptrdiff_t>(y) * src_stride_uv + 2 * x;
+                dsts[0][static_cast<ptrdiff_t>(x) * dst_strides[0] + y] = pair[0];
+                dsts[1][static_cast<ptrdiff_t>(x) * dst_strides[1] + y] = pair[1];
+            });
+    return 0;
+}
+
+int RotateABGRTiled(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                    int width, int height, int rotation) {
+    if (!RotationToTranspose(rotation, height, width, &src, &src_stride, &dst, &dst_stride, 1)) {
+        return -1;
+    }
+    TransposeTiledDispatched<4>(
+            width, height, TileSide(4),
+            [=](int x, int y) {
+                Transpose4x4x32(src + static_cast<ptrdiff_t>(y) * src_stride + 4 * x, src_stride,
+                                dst + static_cast<ptrdiff_t>(x) * dst_stride + 4 * y, dst_stride);
+            },
+            [=](int x, int y) {
+                memcpy(dst + static_cast<ptrdiff_t>(x) * dst_stride + 4 * y,
+                       src + static_cast<ptrdiff_t>(y) * src_stride + 4 * x, 4);
+            });
+    return 0;
+}
+
+int RotateABGR(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+               int width, int height, int rotation) {
+    if (rotation == 90 || rotation == 270) {
+        return RotateABGRTiled(src, src_stride, dst, dst_stride, width, height, rotation);
+    }
+    // libyuv rotation modes are the angles in degrees.
+    return libyuv::ARGBRotate(src, src_stride, dst, dst_stride, width, height,
+                              static_cast<libyuv::RotationMode>(rotation));
+}
+
+int RotatePlane(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                int width, int height, int rotation) {
+    if (rotation == 90 || rotation == 270) {
+        return RotatePlaneTiled(src, src_stride, dst, dst_stride, width, height, rotation);
+    }
+    return libyuv::RotatePlane(src, src_stride, dst, dst_stride, width, height,
+                               static_cast<libyuv::RotationMode>(rotation));
+}
+
+size_t GetTransposeTileBytes() {
+    return g_tile_bytes.load(std::memory_order_relaxed);
+}
+
+void SetTransposeTileBytes(size_t tile_bytes) {
+    g_tile_bytes.store(std::min(std::max(tile_bytes, kMinTileBytes), kMaxTileBytes),
+                       std::memory_order_relaxed);
+}
+
+size_t AutoTuneTransposeTileBytes() {
+    // 8MB of source and destination, beyond the L2 cache of mobile CPUs.
+    constexpr int kSize = 2048;
+    constexpr size_t kCandidates[] = {4 * 1024, 8 * 1024, 16 * 1024, 32 * 1024, 64 * 1024};
+    std::vector<uint8_t> src(static_cast<size_t>(kSize) * kSize, 0x80);
+    std::vector<uint8_t> dst(src.size());
+
+    size_t best_tile_bytes = kDefaultTileBytes;
+    auto best_time = std::chrono::steady_clock::duration::max();
+    for (size_t tile_bytes : kCandidates) {
+        SetTransposeTileBytes(tile_bytes);
+        // The best of a few runs, to filter out preemption.
+        auto time = std::chrono::steady_clock::duration::max();
+        for (int run = 0; run < 3; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            RotatePlaneTiled(src.data(), kSize, dst.data(), kSize, kSize, kSize, 90);
+            time = std::min(time, std::chrono::steady_clock::now() - start);
+        }
+        if (time < best_time) {
+            best_time = time;
+            best_tile_bytes = tile_bytes;
+        }
+    }
+    SetTransposeTileBytes(best_tile_bytes);
+    return best_tile_bytes;
+}
+
+}  // namespace camerax
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_TRANSPOSE_H_
+#define CAMERA_CORE_IMAGE_TRANSPOSE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camerax {
+
+/**
+ * Cache-blocked 90 and 270 degree rotations.
+ *
+ * <p>A straight transpose reads rows and writes columns, so for large frames every written
+ * sample lands on a different cache line and, a few rows apart, on a different page. These
+ * kernels walk the frame in square tiles small enough for source and destination to stay in the
+ * L1 cache, and transpose each tile in blocks held in SIMD registers: 16x16 for 8-bit samples,
+ * 8x8 for sample pairs and 4x4 for 32-bit pixels. Negative strides are supported. Selecting
+ * the scalar implementation of Kernel::kTranspose moves single samples instead.
+ */
+
+/**
+ * Rotates a plane of 8-bit samples by 90 or 270 degrees clockwise into {@code dst}, which is
+ * {@code height} samples wide and {@code width} rows high.
+ *
+ * @return 0 on success or -1 for other rotations.
+ */
+int RotatePlaneTiled(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                     int width, int height, int rotation);
+
+/**
+ * Rotates an interleaved chroma plane of {@code width} x {@code height} sample pairs by 90 or
+ * 270 degrees and splits it into the planes {@code dst_a} and {@code dst_b}, which receive the
+ * first and second sample of every pair.
+ */
+int RotateUVPlaneTiled(const uint8_t* src_uv, int src_stride_uv,
+                       uint8_t* dst_a, int dst_stride_a, uint8_t* dst_b, int dst_stride_b,
+                       int width, int height, int rotation);
+
+/**
+ * Rotates 32-bit pixels, e.g. ABGR, by 90 or 270 degrees. Strides are in bytes.
+ */
+int RotateABGRTiled(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                    int width, int height, int rotation);
+
+/**
+ * Rotates 32-bit pixels by any multiple of 90 degrees, using the tiled kernel for 90 and 270.
+ */
+int RotateABGR(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+               int width, int height, int rotation);
+
+/**
+ * Rotates a plane of 8-bit samples by any multiple of 90 degrees, using the tiled kernel for 90
+ * and 270.
+ */
+int RotatePlane(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                int width, int height, int rotation);
+
+/**
+ * The number of source bytes per tile. Tiles are square, so a tile of 8-bit samples is wider
+ * than one of 32-bit pixels for the same budget. Defaults to 16KB, which keeps a tile and its
+ * transposed copy within a 32KB L1 data cache.
+ */
+size_t GetTransposeTileBytes();
+
+/**
+ * Overrides the tile budget, e.g. with a value tuned for a specific CPU.
+ */
+void SetTransposeTileBytes(size_t tile_bytes);
+
+/**
+ * Times rotations of a frame larger than typical L2 caches with a few tile budgets, keeps the
+ * fastest one and returns it. Takes tens of milliseconds, so it is meant to run once, off the
+ * capture path.
+ */
+size_t AutoTuneTransposeTileBytes();
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_TRANSPOSE_H_
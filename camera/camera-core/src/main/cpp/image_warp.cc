@@ -0,0 +1,227 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_warp.h"
+
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_WARP_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_WARP_SSE2 1
+#endif
+
+#include "libyuv/rotate.h"
+
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// Rotated outputs are written in tiles of this many samples squared.
+constexpr int kTileSize = 32;
+
+// Blends two source rows by fy and resamples the blend along the taps [begin, end). Samples of
+// a channel are pixel_stride bytes apart, outputs out_pixel_stride bytes. With two channels,
+// i.e. interleaved chroma, channel c starts c bytes in and is written to out[c ^ swap]. The
+// vertical blend uses SIMD if simd is set.
+//
+// Blending the rows first keeps the vertical pass a plain SIMD loop. The sums are the same as
+// when lerping horizontally first, so nothing is rounded twice.
+template <int kChannels>
+void SampleRow(const uint8_t* row0, const uint8_t* row1, int fy, int pixel_stride, int src_size,
+               const BilinearTaps& taps, int begin, int end, uint16_t* blend, uint8_t* out,
+               int out_pixel_stride, int swap, bool simd) {
+    // Plain pointers, since stores through out could alias the vectors' bookkeeping.
+    const int* index = taps.index.data();
+    const int* weight = taps.weight.data();
+    const int first = std::min(index[begin], index[end - 1]);
+    const int last = std::min(std::max(index[begin], index[end - 1]) + 1, src_size - 1);
+    const uint8_t* src0 = row0 + first * pixel_stride;
+    const uint8_t* src1 = row1 + first * pixel_stride;
+    const int span = (last - first) * pixel_stride + kChannels;
+    const int fy0 = 256 - fy;
+    int k = 0;
+#if defined(CAMERAX_WARP_NEON)
+    for (; simd && k + 8 <= span; k += 8) {
+        uint16x8_t sum = vmulq_n_u16(vmovl_u8(vld1_u8(src0 + k)), static_cast<uint16_t>(fy0));
+        sum = vmlaq_n_u16(sum, vmovl_u8(vld1_u8(src1 + k)), static_cast<uint16_t>(fy));
+        vst1q_u16(blend + k, sum);
+    }
+#elif defined(CAMERAX_WARP_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w0 = _mm_set1_epi16(static_cast<int16_t>(fy0));
+    const __m128i w1 = _mm_set1_epi16(static_cast<int16_t>(fy));
+    for (; simd && k + 8 <= span; k += 8) {
+        __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src0 + k)),
+                                      zero);
+        __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src1 + k)),
+                                      zero);
+        // The products wrap as 16-bit values but their sum is at most 255 * 256.
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a, w0), _mm_mullo_epi16(b, w1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(blend + k), sum);
+    }
+#endif
+    for (; k < span; ++k) {
+        blend[k] = static_cast<uint16_t>(src0[k] * fy0 + src1[k] * fy);
+    }
+
+    for (int i = begin; i < end; ++i, out += out_pixel_stride) {
+        const int x0 = (index[i] - first) * pixel_stride;
+        const int fx = weight[i];
+        const int x1 = x0 + (fx != 0 ? pixel_stride : 0);
+        for (int c = 0; c < kChannels; ++c) {
+            out[c ^ swap] = static_cast<uint8_t>(
+                    (blend[x0 + c] * (256 - fx) + blend[x1 + c] * fx + 32768) >> 16);
+        }
+    }
+}
+
+// Rotates and resamples a plane of kChannels interleaved channels, see SampleRow.
+template <int kChannels>
+void RotateScalePlane(const Plane& src, int src_width, int src_height, const Plane& dst,
+                      int dst_width, int dst_height, int rotation, int swap, bool simd) {
+    // Source axis and direction each output axis walks along, from the inverse rotation.
+    const bool transpose = rotation == 90 || rotation == 270;
+    const int column_source_size = transpose ? src_height : src_width;
+    const int row_source_size = transpose ? src_width : src_height;
+    const BilinearTaps columns = ComputeBilinearTaps(column_source_size, dst_width,
+                                                     rotation == 90 || rotation == 180);
+    const BilinearTaps rows = ComputeBilinearTaps(row_source_size, dst_height,
+                                                  rotation == 180 || rotation == 270);
+    std::vector<uint16_t> blend(static_cast<size_t>(src_width) * src.pixel_stride + kChannels);
+
+    if (!transpose) {
+        for (int y = 0; y < dst_height; ++y) {
+            const uint8_t* row0 = src.RowAt(rows.index[y]);
+            const uint8_t* row1 = rows.weight[y] != 0 ? row0 + src.row_stride : row0;
+            SampleRow<kChannels>(row0, row1, rows.weight[y], src.pixel_stride, src_width,
+                                 columns, 0, dst_width, blend.data(), dst.RowAt(y),
+                                 dst.pixel_stride, swap, simd);
+        }
+        return;
+    }
+
+    // Output columns run along source rows. Every tile is resampled in source orientation into
+    // a block that stays in the L1 cache, and the block is then transposed into place.
+    constexpr int kBlockStride = kTileSize * kChannels;
+    uint8_t block[kTileSize * kBlockStride];
+    uint8_t transposed[kTileSize * kTileSize];
+    for (int tile_y = 0; tile_y < dst_height; tile_y += kTileSize) {
+        const int tile_rows = std::min(kTileSize, dst_height - tile_y);
+        for (int tile_x = 0; tile_x < dst_width; tile_x += kTileSize) {
+            const int tile_columns = std::min(kTileSize, dst_width - tile_x);
+            for (int i = 0; i < tile_columns; ++i) {
+                const int x = tile_x + i;
+                const uint8_t* row0 = src.RowAt(columns.index[x]);
+                const uint8_t* row1 = columns.weight[x] != 0 ? row0 + src.row_stride : row0;
+                SampleRow<kChannels>(row0, row1, columns.weight[x], src.pixel_stride,
+                                     src_width, rows, tile_y, tile_y + tile_rows, blend.data(),
+                                     block + i * kBlockStride, kChannels, swap, simd);
+            }
+            uint8_t* dst_tile = dst.RowAt(tile_y) + tile_x * dst.pixel_stride;
+            if (kChannels == 1 && dst.pixel_stride == 1) {
+                libyuv::TransposePlane(block, kBlockStride, dst_tile, dst.row_stride, tile_rows,
+                                       tile_columns);
+                continue;
+            }
+            const uint8_t* rows_out = block;
+            int rows_out_stride = kBlockStride;
+            int column_step = kBlockStride;
+            if (kChannels == 1) {
+                libyuv::TransposePlane(block, kBlockStride, transposed, kTileSize, tile_rows,
+                                       tile_columns);
+                rows_out = transposed;
+                rows_out_stride = kTileSize;
+                column_step = 1;
+            }
+            // Scatters the samples, or transposes sample pairs, into the strided destination.
+            for (int j = 0; j < tile_rows; ++j) {
+                uint8_t* out = dst_tile + static_cast<ptrdiff_t>(j) * dst.row_stride;
+                const uint8_t* in = kChannels == 1 ? rows_out + j * rows_out_stride
+                                                   : rows_out + j * kChannels;
+                for (int i = 0; i < tile_columns; ++i) {
+                    for (int c = 0; c < kChannels; ++c) {
+                        out[i * dst.pixel_stride + c] = in[i * column_step + c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool IsSemiPlanar(const PlanarImage& image) {
+    const ChromaLayout layout = image.chroma_layout();
+    return layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU;
+}
+
+}  // namespace
+
+BilinearTaps ComputeBilinearTaps(int src_size, int dst_size, bool reverse) {
+    BilinearTaps taps;
+    taps.index.resize(dst_size);
+    taps.weight.resize(dst_size);
+    const double scale = static_cast<double>(src_size) / dst_size;
+    for (int i = 0; i < dst_size; ++i) {
+        double position = std::min(std::max(0.0, (i + 0.5) * scale - 0.5),
+                                   static_cast<double>(src_size - 1));
+        if (reverse) {
+            position = src_size - 1 - position;
+        }
+        int index = static_cast<int>(position);
+        int weight = static_cast<int>((position - index) * 256 + 0.5);
+        if (weight == 256) {
+            ++index;
+            weight = 0;
+        }
+        taps.index[i] = index;
+        taps.weight[i] = index + 1 < src_size ? weight : 0;
+    }
+    return taps;
+}
+
+int RotateScaleAndroid420(const PlanarImage& src, int rotation, const PlanarImage& dst) {
+    if (!src.IsValid() || !dst.IsValid()
+        || (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270)) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kWarp) != KernelImpl::kScalar;
+    RotateScalePlane<1>(src.y, src.width, src.height, dst.y, dst.width, dst.height, rotation,
+                        0, simd);
+    const int src_chroma_width = src.chroma_width();
+    const int src_chroma_height = src.chroma_height();
+    const int dst_chroma_width = dst.chroma_width();
+    const int dst_chroma_height = dst.chroma_height();
+    if (IsSemiPlanar(src) && IsSemiPlanar(dst)) {
+        // Interleaved chroma is resampled in pairs, so that it is read and written only once.
+        const Plane src_uv = {std::min(src.u.data, src.v.data), src.u.row_stride, 2};
+        const Plane dst_uv = {std::min(dst.u.data, dst.v.data), dst.u.row_stride, 2};
+        const int swap = src.chroma_layout() != dst.chroma_layout() ? 1 : 0;
+        RotateScalePlane<2>(src_uv, src_chroma_width, src_chroma_height, dst_uv,
+                            dst_chroma_width, dst_chroma_height, rotation, swap, simd);
+        return 0;
+    }
+    RotateScalePlane<1>(src.u, src_chroma_width, src_chroma_height, dst.u, dst_chroma_width,
+                        dst_chroma_height, rotation, 0, simd);
+    RotateScalePlane<1>(src.v, src_chroma_width, src_chroma_height, dst.v, dst_chroma_width,
+                        dst_chroma_height, rotation, 0, simd);
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_IMAGE_WARP_H_
+#define CAMERA_CORE_IMAGE_WARP_H_
+
+#include <vector>
+
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Where the output samples along one axis are taken from: between source samples
+ * {@code index[i]} and {@code index[i] + 1}, the latter weighted by {@code weight[i]} / 256.
+ * The second sample is clamped to the edge, where the weight is 0.
+ */
+struct BilinearTaps {
+    std::vector<int> index;
+    std::vector<int> weight;
+};
+
+/**
+ * Computes the taps that resample {@code src_size} samples to {@code dst_size} with pixel
+ * centers aligned. With {@code reverse} set the output runs from the last source sample to the
+ * first, which is how rotations map onto single axes. Sizes that match give exact copies.
+ */
+BilinearTaps ComputeBilinearTaps(int src_size, int dst_size, bool reverse);
+
+/**
+ * Rotates an Android420 image clockwise by {@code rotation} degrees and resamples it
+ * bilinearly to the size of {@code dst} in a single pass: every destination sample is computed
+ * once, straight from the source. Rotated outputs are written in square tiles so that the source
+ * columns they read stay in the cache.
+ *
+ * <p>{@code dst} may use any chroma layout, e.g. the NV12 layout of an encoder input buffer.
+ * Bilinear filtering only reads the two nearest source samples per axis, so downscales beyond
+ * 2x alias and are better served by a box filter.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+int RotateScaleAndroid420(const PlanarImage& src, int rotation, const PlanarImage& dst);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_IMAGE_WARP_H_
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_BLOB_H_
+#define CAMERA_CORE_JPEG_BLOB_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace camerax {
+
+/**
+ * Zero bytes appended after JPEG data written to a BLOB surface so that the content can never
+ * be mistaken for a camera3_jpeg_blob trailer.
+ */
+constexpr size_t kJpegBlobPaddingBytes = 8;
+
+/**
+ * Mirrors camera3_jpeg_blob_t, the trailer the camera HAL places at the very end of a BLOB
+ * buffer to report how many bytes of it are JPEG data.
+ */
+struct Camera3JpegBlob {
+    uint16_t jpeg_blob_id;
+    uint32_t jpeg_size;
+};
+
+constexpr uint16_t kCamera3JpegBlobId = 0x00FF;
+
+/**
+ * Returns the size of a BLOB buffer that can hold up to {@code max_jpeg_size} bytes of JPEG
+ * data followed by the zero padding and the camera3_jpeg_blob trailer.
+ */
+inline size_t JpegBlobBufferSize(size_t max_jpeg_size) {
+    return max_jpeg_size + kJpegBlobPaddingBytes + sizeof(Camera3JpegBlob);
+}
+
+/**
+ * Finishes a BLOB buffer of {@code buffer_size} bytes whose first {@code jpeg_size} bytes hold
+ * the encoded image: zeroes the unused bytes and writes the trailer so that consumers such as
+ * ImageReader report exactly {@code jpeg_size} bytes, even when the buffer had to be sized for
+ * the worst case before encoding.
+ */
+inline void FinishJpegBlob(uint8_t* buffer, size_t buffer_size, size_t jpeg_size) {
+    size_t trailer_offset = buffer_size - sizeof(Camera3JpegBlob);
+    memset(buffer + jpeg_size, 0, trailer_offset - jpeg_size);
+    Camera3JpegBlob blob = {};
+    blob.jpeg_blob_id = kCamera3JpegBlobId;
+    blob.jpeg_size = static_cast<uint32_t>(jpeg_size);
+    memcpy(buffer + trailer_offset, &blob, sizeof(blob));
+}
+
+/**
+ * Clears a locked BLOB buffer of {@code size} bytes that could not be filled. A locked buffer
+ * cannot be cancelled through the NDK, so it still has to be posted, and the trailer cannot flag
+ * the failure since ImageReader reads a jpeg_size of 0 as "the whole buffer". The buffer holds
+ * only zero bytes instead, so it has no SOI marker and every JPEG decoder rejects it, and no
+ * stale image from an earlier use of the buffer survives.
+ */
+inline void ClearFailedJpegBlob(uint8_t* buffer, size_t size) {
+    memset(buffer, 0, size);
+}
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_BLOB_H_
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "jpeg_error.h"
+
+namespace camerax {
+
+namespace {
+
+bool IsValidScaleDenom(int scale_denom) {
+    return scale_denom == 1 || scale_denom == 2 || scale_denom == 4 || scale_denom == 8;
+}
+
+int DivRoundUp(int a, int b) {
+    return (a + b - 1) / b;
+}
+
+// The selected region in the coordinates of the scaled output.
+struct ScaledRegion {
+    int left;
+    int top;
+    int width;
+    int height;
+};
+
+// Maps the full resolution region of the options onto an image scaled to
+// scaled_width x scaled_height. Returns false if the region lies outside of the image.
+bool ScaleRegion(const ScaledDecodeOptions& options, int full_width, int full_height,
+                 int scaled_width, int scaled_height, ScaledRegion* region) {
+    if (options.region.IsEmpty()) {
+        *region = {0, 0, scaled_width, scaled_height};
+        return true;
+    }
+    const DecodeRegion& r = options.region;
+    if (r.left < 0 || r.top < 0 || r.left + r.width > full_width
+        || r.top + r.height > full_height) {
+        return false;
+    }
+    int denom = options.scale_denom;
+    int left = r.left / denom;
+    int top = r.top / denom;
+    int right = std::min(scaled_width, DivRoundUp(r.left + r.width, denom));
+    int bottom = std::min(scaled_height, DivRoundUp(r.top + r.height, denom));
+    *region = {left, top, std::max(1, right - left), std::max(1, bottom - top)};
+    return true;
+}
+
+// Decodes the region selected by the options in the given color space and passes every output
+// row to sink(row, y), where row points at the first pixel of the region in that row.
+template <typename RowSink>
+int DecodeRows(const uint8_t* jpeg, size_t jpeg_size, const ScaledDecodeOptions& options,
+               J_COLOR_SPACE color_space, RowSink sink) {
+    if (jpeg == nullptr || !IsValidScaleDenom(options.scale_denom)) {
+        return -1;
+    }
+
+    // Allocated ahead of setjmp so that an error longjmp does not skip its destructor.
+    std::vector<uint8_t> row_buffer;
+
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = InitJpegErrorManager(&error);
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return -1;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg, static_cast<unsigned long>(jpeg_size));
+    jpeg_read_header(&cinfo, TRUE);
+    // Only warnings about the compressed data count, see below.
+    cinfo.err->num_warnings = 0;
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = options.scale_denom;
+    cinfo.out_color_space = color_space;
+    // Previews favor speed, the fast integer DCT is visually equivalent after downscaling.
+    cinfo.dct_method = JDCT_IFAST;
+    jpeg_start_decompress(&cinfo);
+
+    ScaledRegion region;
+    if (!ScaleRegion(options, cinfo.image_width, cinfo.image_height, cinfo.output_width,
+                     cinfo.output_height, &region)) {
+        jpeg_destroy_decompress(&cinfo);
+        return -1;
+    }
+
+    // Horizontal cropping skips the IDCT of whole iMCU columns. libjpeg may widen the crop to an
+    // iMCU boundary, which is compensated for by offsetting into the decoded rows.
+    int column_offset = 0;
+    if (region.width < static_cast<int>(cinfo.output_width)) {
+        JDIMENSION crop_x = region.left;
+        JDIMENSION crop_width = region.width;
+        jpeg_crop_scanline(&cinfo, &crop_x, &crop_width);
+        column_offset = region.left - static_cast<int>(crop_x);
+    }
+    if (region.top > 0) {
+        jpeg_skip_scanlines(&cinfo, region.top);
+    }
+
+    const int components = cinfo.output_components;
+    row_buffer.resize(static_cast<size_t>(cinfo.output_width) * components);
+    JSAMPROW row = row_buffer.data();
+    for (int y = 0; y < region.height; ++y) {
+        if (jpeg_read_scanlines(&cinfo, &row, 1) != 1) {
+            jpeg_destroy_decompress(&cinfo);
+            return -1;
+        }
+        sink(row + column_offset * components, y);
+    }
+    // libjpeg only warns about truncated or corrupt data and makes up the rows it cannot decode.
+    if (cinfo.err->num_warnings != 0) {
+        jpeg_destroy_decompress(&cinfo);
+        return -1;
+    }
+
+    // Rows below the region are never decoded.
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return 0;
+}
+
+}  // namespace
+
+int ChooseDctScaleDenom(int width, int height, int target_width, int target_height) {
+    int denom = 8;
+    while (denom > 1
+           && (DivRoundUp(width, denom) < target_width
+               || DivRoundUp(height, denom) < target_height)) {
+        denom /= 2;
+    }
+    return denom;
+}
+
+int GetScaledJpegSize(const uint8_t* jpeg, size_t jpeg_size, const ScaledDecodeOptions& options,
+                      int* width, int* height) {
+    if (jpeg == nullptr || !IsValidScaleDenom(options.scale_denom)) {
+        return -1;
+    }
+
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = InitJpegErrorManager(&error);
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return -1;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg, static_cast<unsigned long>(jpeg_size));
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = options.scale_denom;
+    jpeg_calc_output_dimensions(&cinfo);
+
+    ScaledRegion region;
+    bool valid = ScaleRegion(options, cinfo.image_width, cinfo.image_height, cinfo.output_width,
+                             cinfo.output_height, &region);
+    jpeg_destroy_decompress(&cinfo);
+    if (!valid) {
+        return -1;
+    }
+    *width = region.width;
+    *height = region.height;
+    return 0;
+}
+
+int DecodeJpegToRGBA(const uint8_t* jpeg, size_t jpeg_size, const ScaledDecodeOptions& options,
+                     uint8_t* dst, int dst_stride) {
+    if (dst == nullptr) {
+        return -1;
+    }
+    int width = 0;
+    int height = 0;
+    if (GetScaledJpegSize(jpeg, jpeg_size, options, &width, &height) != 0) {
+        return -1;
+    }
+    return DecodeRows(jpeg, jpeg_size, options, JCS_EXT_RGBA,
+                      [=](const uint8_t* row, int y) {
+                          memcpy(dst + static_cast<ptrdiff_t>(y) * dst_stride, row, width * 4);
+                      });
+}
+
+int DecodeJpegToAndroid420(const uint8_t* jpeg, size_t jpeg_size,
+                           const ScaledDecodeOptions& options, const PlanarImage& dst) {
+    int width = 0;
+    int height = 0;
+    if (GetScaledJpegSize(jpeg, jpeg_size, options, &width, &height) != 0) {
+        return -1;
+    }
+    if (dst.y.data == nullptr || dst.u.data == nullptr || dst.v.data == nullptr) {
+        return -1;
+    }
+
+    // Decodes to interleaved full range YCbCr, skipping the color conversion entirely, and
+    // subsamples chroma over pairs of rows.
+    std::vector<uint8_t> even_row(static_cast<size_t>(width) * 3);
+    const int chroma_width = (width + 1) >> 1;
+    auto write_chroma = [&](const uint8_t* row0, const uint8_t* row1, int chroma_row) {
+        uint8_t* u = dst.u.RowAt(chroma_row);
+        uint8_t* v = dst.v.RowAt(chroma_row);
+        for (int x = 0; x < chroma_width; ++x) {
+            int x0 = 2 * x * 3;
+            int x1 = std::min(2 * x + 1, width - 1) * 3;
+            u[x * dst.u.pixel_stride] = static_cast<uint8_t>(
+                    (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2);
+            v[x * dst.v.pixel_stride] = static_cast<uint8_t>(
+                    (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2);
+        }
+    };
+    return DecodeRows(jpeg, jpeg_size, options, JCS_YCbCr,
+                      [&](const uint8_t* row, int y) {
+                          uint8_t* dst_y = dst.y.RowAt(y);
+                          for (int x = 0; x < width; ++x) {
+                              dst_y[x * dst.y.pixel_stride] = row[x * 3];
+                          }
+                          if ((y & 1) == 0) {
+                              memcpy(even_row.data(), row, even_row.size());
+                              if (y == height - 1) {
+                                  write_chroma(row, row, y / 2);
+                              }
+                          } else {
+                              write_chroma(even_row.data(), row, y / 2);
+                          }
+                      });
+}
+
+}  // namespace camerax
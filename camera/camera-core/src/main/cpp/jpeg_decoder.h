@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_DECODER_H_
+#define CAMERA_CORE_JPEG_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * A rectangle in the coordinates of the full resolution JPEG. An empty rectangle selects the
+ * whole image.
+ */
+struct DecodeRegion {
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+};
+
+/**
+ * Parameters of a reduced size decode.
+ */
+struct ScaledDecodeOptions {
+    // One of 1, 2, 4 or 8. The image is scaled in the DCT domain by 1 / scale_denom, so the
+    // discarded resolution is never decoded.
+    int scale_denom = 1;
+    DecodeRegion region;
+};
+
+/**
+ * Returns the largest of 1, 2, 4 or 8 that still yields an image of at least
+ * {@code target_width} x {@code target_height} from one of {@code width} x {@code height}.
+ */
+int ChooseDctScaleDenom(int width, int height, int target_width, int target_height);
+
+/**
+ * Reads the JPEG header and computes the size of the image a decode with {@code options} will
+ * produce. Returns 0 on success or -1 if the header cannot be parsed or the options are invalid.
+ */
+int GetScaledJpegSize(const uint8_t* jpeg, size_t jpeg_size, const ScaledDecodeOptions& options,
+                      int* width, int* height);
+
+/**
+ * Decodes a JPEG to RGBA_8888 at reduced size into {@code dst}, which must be large enough for
+ * the size reported by {@link GetScaledJpegSize}. Rows are written as they are decoded; outside
+ * of a few rows of scratch no full resolution or full size intermediate is allocated. Returns 0
+ * on success or -1 on failure, including truncated or corrupt compressed data.
+ */
+int DecodeJpegToRGBA(const uint8_t* jpeg, size_t jpeg_size, const ScaledDecodeOptions& options,
+                     uint8_t* dst, int dst_stride);
+
+/**
+ * Like {@link DecodeJpegToRGBA} but writes full range YUV 4:2:0 into the planes of {@code dst},
+ * which may be I420, NV12 or NV21.
+ */
+int DecodeJpegToAndroid420(const uint8_t* jpeg, size_t jpeg_size,
+                           const ScaledDecodeOptions& options, const PlanarImage& dst);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_DECODER_H_
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_DESTINATION_H_
+#define CAMERA_CORE_JPEG_DESTINATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "jpeglib.h"
+
+namespace camerax {
+
+/**
+ * libjpeg destination manager that writes into a caller-owned buffer of fixed capacity, such as
+ * a locked BLOB surface buffer. Running out of space aborts the compression through the error
+ * manager.
+ */
+struct FixedDestination {
+    jpeg_destination_mgr pub;
+    uint8_t* buffer;
+    size_t capacity;
+
+    size_t bytes_written() const { return capacity - pub.free_in_buffer; }
+};
+
+inline void InitFixedDestination(j_compress_ptr cinfo) {
+    FixedDestination* dest = reinterpret_cast<FixedDestination*>(cinfo->dest);
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = dest->capacity;
+}
+
+inline boolean EmptyFixedDestination(j_compress_ptr cinfo) {
+    // The buffer is full and cannot grow, abort the compression.
+    cinfo->err->error_exit(reinterpret_cast<j_common_ptr>(cinfo));
+    return FALSE;
+}
+
+inline void TermFixedDestination(j_compress_ptr) {}
+
+inline void SetFixedDestination(j_compress_ptr cinfo, FixedDestination* dest, uint8_t* buffer,
+                                size_t capacity) {
+    dest->pub.init_destination = InitFixedDestination;
+    dest->pub.empty_output_buffer = EmptyFixedDestination;
+    dest->pub.term_destination = TermFixedDestination;
+    dest->buffer = buffer;
+    dest->capacity = capacity;
+    cinfo->dest = &dest->pub;
+}
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_DESTINATION_H_
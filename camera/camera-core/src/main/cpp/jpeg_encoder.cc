@@ -0,0 +1,204 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "libyuv/planar_functions.h"
+
+#include "image_kernels.h"
+#include "jpeg_destination.h"
+#include "jpeg_error.h"
+
+namespace camerax {
+
+namespace {
+
+// Room for the SOI/DQT/DHT/SOF/SOS markers written in front of the entropy coded data.
+constexpr size_t kJpegHeaderBytes = 4096;
+
+// 4:2:0 MCUs cover 16x16 luma samples and 8x8 samples of each chroma component.
+constexpr int kMcuSize = 16;
+constexpr int kChromaMcuSize = kMcuSize / 2;
+
+// Returns a pointer to a row of plane samples that libjpeg can read {@code padded_width}
+// samples from, copying the row into {@code scratch} with the last sample replicated unless the
+// row is already exactly that wide. The row padding of the plane is never encoded: it holds
+// arbitrary bytes, which would bleed into the edge pixels through the DCT of the last MCU.
+JSAMPROW PrepareRow(const Plane& plane, int row, bool is_last_row, int width, int padded_width,
+                    uint8_t* scratch) {
+    const uint8_t* src = plane.RowAt(row);
+    if (plane.pixel_stride == 1 && width == padded_width && !is_last_row) {
+        return const_cast<JSAMPROW>(src);
+    }
+    if (plane.pixel_stride == 1) {
+        memcpy(scratch, src, width);
+    } else {
+        for (int i = 0; i < width; ++i) {
+            scratch[i] = src[i * plane.pixel_stride];
+        }
+    }
+    memset(scratch + width, scratch[width - 1], padded_width - width);
+    return scratch;
+}
+
+// Scratch for one band of rows of each plane, see PrepareRow.
+struct BandScratch {
+    uint8_t* y;
+    uint8_t* u;
+    uint8_t* v;
+};
+
+// Hands the planes of src to libjpeg in bands of kMcuSize rows. Kept apart from the function
+// that calls setjmp, so that none of the locals here are live across it.
+void WriteRawBands(j_compress_ptr cinfo, const PlanarImage& src, const BandScratch& scratch) {
+    const int width = src.width;
+    const int height = src.height;
+    const int chroma_width = src.chroma_width();
+    const int chroma_height = src.chroma_height();
+    const int padded_width = (width + kMcuSize - 1) & ~(kMcuSize - 1);
+    const int padded_chroma_width = padded_width / 2;
+    const ChromaLayout layout = src.chroma_layout();
+    const bool split_uv =
+            layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU;
+    JSAMPROW rows_y[kMcuSize];
+    JSAMPROW rows_u[kChromaMcuSize];
+    JSAMPROW rows_v[kChromaMcuSize];
+    JSAMPARRAY planes[3] = {rows_y, rows_u, rows_v};
+
+    for (int top = 0; top < height; top += kMcuSize) {
+        // Rows past the bottom edge replicate the last row, as libjpeg always consumes full MCUs.
+        for (int i = 0; i < kMcuSize; ++i) {
+            int row = std::min(top + i, height - 1);
+            rows_y[i] = PrepareRow(src.y, row, row == height - 1, width, padded_width,
+                                   scratch.y + i * padded_width);
+        }
+        for (int i = 0; i < kChromaMcuSize; ++i) {
+            int row = std::min(top / 2 + i, chroma_height - 1);
+            bool is_last_row = row == chroma_height - 1;
+            uint8_t* scratch_u = scratch.u + i * padded_chroma_width;
+            uint8_t* scratch_v = scratch.v + i * padded_chroma_width;
+            if (split_uv) {
+                // Deinterleave NV12/NV21 chroma with a single SIMD pass per row.
+                const uint8_t* uv = std::min(src.u.RowAt(row), src.v.RowAt(row));
+                bool vu_order = layout == ChromaLayout::kSemiPlanarVU;
+                libyuv::SplitUVPlane(uv, src.u.row_stride,
+                                     vu_order ? scratch_v : scratch_u, padded_chroma_width,
+                                     vu_order ? scratch_u : scratch_v, padded_chroma_width,
+                                     chroma_width, 1);
+                memset(scratch_u + chroma_width, scratch_u[chroma_width - 1],
+                       padded_chroma_width - chroma_width);
+                memset(scratch_v + chroma_width, scratch_v[chroma_width - 1],
+                       padded_chroma_width - chroma_width);
+                rows_u[i] = scratch_u;
+                rows_v[i] = scratch_v;
+            } else {
+                rows_u[i] = PrepareRow(src.u, row, is_last_row, chroma_width,
+                                       padded_chroma_width, scratch_u);
+                rows_v[i] = PrepareRow(src.v, row, is_last_row, chroma_width,
+                                       padded_chroma_width, scratch_v);
+            }
+        }
+        jpeg_write_raw_data(cinfo, planes, kMcuSize);
+    }
+}
+
+}  // namespace
+
+size_t MaxJpegSize(int width, int height) {
+    return I420BufferSize(width, height) + kJpegHeaderBytes;
+}
+
+long EncodeAndroid420ToJpeg(const PlanarImage& image,
+                            int quality,
+                            const Orientation& orientation,
+                            uint8_t* dst,
+                            size_t dst_capacity) {
+    if (!image.IsValid() || image.subsampling != ChromaSubsampling::k420 || dst == nullptr) {
+        return -1;
+    }
+
+    // Rotation cannot be expressed through raw data rows, so rotated images go through a single
+    // tightly packed I420 frame whose strides libjpeg can read directly. A flip alone only
+    // changes the order in which the rows are handed over.
+    PlanarImage src = orientation.flip_vertical ? FlipPlanarImage(image) : image;
+    std::vector<uint8_t> rotated;
+    if (orientation.rotation != 0) {
+        bool flip_wh = orientation.SwapsDimensions();
+        int rotated_width = flip_wh ? image.height : image.width;
+        int rotated_height = flip_wh ? image.width : image.height;
+        int stride_y = (rotated_width + kMcuSize - 1) & ~(kMcuSize - 1);
+        int stride_uv = stride_y / 2;
+        int halfheight = (rotated_height + 1) >> 1;
+        rotated.resize(static_cast<size_t>(stride_y) * rotated_height
+                       + 2 * static_cast<size_t>(stride_uv) * halfheight);
+        uint8_t* y = rotated.data();
+        uint8_t* u = y + static_cast<size_t>(stride_y) * rotated_height;
+        uint8_t* v = u + static_cast<size_t>(stride_uv) * halfheight;
+        src = WrapAndroid420(y, stride_y, 1, u, stride_uv, v, 1, rotated_width, rotated_height);
+        if (RotateAndroid420ToI420(image, src, orientation) != 0) {
+            return -1;
+        }
+    }
+
+    // Per-band scratch rows, only used for rows libjpeg cannot read in place. Allocated ahead of
+    // setjmp so that an error longjmp does not skip their destructors.
+    const int padded_width = (src.width + kMcuSize - 1) & ~(kMcuSize - 1);
+    std::vector<uint8_t> band_y(static_cast<size_t>(kMcuSize) * padded_width);
+    std::vector<uint8_t> band_u(static_cast<size_t>(kChromaMcuSize) * padded_width / 2);
+    std::vector<uint8_t> band_v(static_cast<size_t>(kChromaMcuSize) * padded_width / 2);
+    BandScratch scratch = {band_y.data(), band_u.data(), band_v.data()};
+
+    jpeg_compress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = InitJpegErrorManager(&error);
+    if (setjmp(error.jump)) {
+        jpeg_destroy_compress(&cinfo);
+        return -1;
+    }
+    jpeg_create_compress(&cinfo);
+
+    FixedDestination dest;
+    SetFixedDestination(&cinfo, &dest, dst, dst_capacity);
+
+    cinfo.image_width = src.width;
+    cinfo.image_height = src.height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_YCbCr;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_colorspace(&cinfo, JCS_YCbCr);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.raw_data_in = TRUE;
+    cinfo.dct_method = JDCT_ISLOW;
+    cinfo.comp_info[0].h_samp_factor = 2;
+    cinfo.comp_info[0].v_samp_factor = 2;
+    cinfo.comp_info[1].h_samp_factor = 1;
+    cinfo.comp_info[1].v_samp_factor = 1;
+    cinfo.comp_info[2].h_samp_factor = 1;
+    cinfo.comp_info[2].v_samp_factor = 1;
+
+    jpeg_start_compress(&cinfo, TRUE);
+    WriteRawBands(&cinfo, src, scratch);
+    jpeg_finish_compress(&cinfo);
+    long size = static_cast<long>(dest.bytes_written());
+    jpeg_destroy_compress(&cinfo);
+    return size;
+}
+
+}  // namespace camerax
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_ENCODER_H_
+#define CAMERA_CORE_JPEG_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Returns the largest JPEG the encoder is allowed to produce for an image of the given size.
+ *
+ * <p>Like the android.jpeg.maxSize contract of camera HALs this is the size of the raw 4:2:0
+ * frame plus room for the headers, which a 4:2:0 JPEG of a camera frame does not exceed.
+ */
+size_t MaxJpegSize(int width, int height);
+
+/**
+ * Encodes an Android420 image as a 4:2:0 baseline JPEG into {@code dst}.
+ *
+ * <p>The planes are handed to libjpeg as raw downsampled data in bands of 16 rows, so no RGB or
+ * full-frame intermediate is created for unrotated images, flipped ones included. Rotated images
+ * are first rotated into a single I420 frame.
+ *
+ * @return the number of bytes written, or -1 if the image is not 4:2:0, the encoding failed or
+ * it did not fit into {@code dst_capacity} bytes.
+ */
+long EncodeAndroid420ToJpeg(const PlanarImage& src,
+                            int quality,
+                            const Orientation& orientation,
+                            uint8_t* dst,
+                            size_t dst_capacity);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_ENCODER_H_
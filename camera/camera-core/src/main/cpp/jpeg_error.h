@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_ERROR_H_
+#define CAMERA_CORE_JPEG_ERROR_H_
+
+#include <csetjmp>
+#include <cstdio>
+
+#include "jpeglib.h"
+
+namespace camerax {
+
+/**
+ * libjpeg error manager that returns control to the caller through longjmp instead of exiting
+ * the process, and drops warnings instead of printing them to stderr.
+ *
+ * <p>Callers must {@code setjmp(error.jump)} before any other libjpeg call and clean up the
+ * codec object when it returns non-zero.
+ */
+struct JpegErrorManager {
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+};
+
+inline void OnJpegError(j_common_ptr cinfo) {
+    longjmp(reinterpret_cast<JpegErrorManager*>(cinfo->err)->jump, 1);
+}
+
+inline void OnJpegMessage(j_common_ptr) {}
+
+inline jpeg_error_mgr* InitJpegErrorManager(JpegErrorManager* error) {
+    jpeg_error_mgr* pub = jpeg_std_error(&error->pub);
+    pub->error_exit = OnJpegError;
+    pub->output_message = OnJpegMessage;
+    return pub;
+}
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_ERROR_H_
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_transform.h"
+
+#include <cstring>
+#include <utility>
+
+#include "jpeg_destination.h"
+#include "jpeg_error.h"
+
+namespace camerax {
+
+namespace {
+
+// Extra room for Huffman tables that end up slightly less efficient than the source ones.
+constexpr size_t kTransformSlackBytes = 64 * 1024;
+
+bool TransposesAxes(JpegTransformOp op) {
+    return op == JpegTransformOp::kTranspose || op == JpegTransformOp::kTransverse
+            || op == JpegTransformOp::kRotate90 || op == JpegTransformOp::kRotate270;
+}
+
+// Whether the destination columns run backwards, i.e. odd horizontal frequencies are negated.
+bool MirrorsColumns(JpegTransformOp op) {
+    return op == JpegTransformOp::kFlipHorizontal || op == JpegTransformOp::kRotate90
+            || op == JpegTransformOp::kRotate180 || op == JpegTransformOp::kTransverse;
+}
+
+// Whether the destination rows run backwards, i.e. odd vertical frequencies are negated.
+bool MirrorsRows(JpegTransformOp op) {
+    return op == JpegTransformOp::kFlipVertical || op == JpegTransformOp::kRotate270
+            || op == JpegTransformOp::kRotate180 || op == JpegTransformOp::kTransverse;
+}
+
+// Copies one DCT block, transposing and negating coefficients as the transformation requires.
+void TransformBlock(const JCOEF* src, JCOEF* dst, bool transpose, bool negate_odd_columns,
+                    bool negate_odd_rows) {
+    for (int i = 0; i < DCTSIZE; ++i) {
+        for (int j = 0; j < DCTSIZE; ++j) {
+            JCOEF coef = transpose ? src[j * DCTSIZE + i] : src[i * DCTSIZE + j];
+            bool negate = ((j & 1) && negate_odd_columns) != ((i & 1) && negate_odd_rows);
+            dst[i * DCTSIZE + j] = negate ? static_cast<JCOEF>(-coef) : coef;
+        }
+    }
+}
+
+void TransposeQuantTables(j_compress_ptr cinfo) {
+    for (int t = 0; t < NUM_QUANT_TBLS; ++t) {
+        JQUANT_TBL* table = cinfo->quant_tbl_ptrs[t];
+        if (table == nullptr) {
+            continue;
+        }
+        for (int i = 0; i < DCTSIZE; ++i) {
+            for (int j = i + 1; j < DCTSIZE; ++j) {
+                std::swap(table->quantval[i * DCTSIZE + j], table->quantval[j * DCTSIZE + i]);
+            }
+        }
+    }
+}
+
+bool IsMarker(jpeg_saved_marker_ptr marker, int code, const char* id, unsigned int id_length) {
+    return marker->marker == code && marker->data_length >= id_length
+            && memcmp(marker->data, id, id_length) == 0;
+}
+
+// Reads the coefficients of srcinfo and writes them rearranged through dstinfo, returning the
+// size of the written JPEG or -1. Runs below the setjmp of TransformJpeg, so that none of the
+// locals here are live across it.
+long TransformCoefficients(j_decompress_ptr srcinfo,
+                           j_compress_ptr dstinfo,
+                           const JpegTransformOptions& options,
+                           uint8_t* dst,
+                           size_t dst_capacity) {
+    const JpegTransformOp op = options.op;
+    const bool transpose = TransposesAxes(op);
+    const bool mirror_dst_columns = MirrorsColumns(op);
+    const bool mirror_dst_rows = MirrorsRows(op);
+    // The same mirroring expressed on the source axes.
+    const bool mirror_src_columns = transpose ? mirror_dst_rows : mirror_dst_columns;
+    const bool mirror_src_rows = transpose ? mirror_dst_columns : mirror_dst_rows;
+
+    jpeg_read_header(srcinfo, TRUE);
+
+    // Blocks can only be mirrored in whole iMCUs, so a partial iMCU at a mirrored edge is either
+    // trimmed or rejected.
+    const int imcu_width = srcinfo->max_h_samp_factor * DCTSIZE;
+    const int imcu_height = srcinfo->max_v_samp_factor * DCTSIZE;
+    int width = static_cast<int>(srcinfo->image_width);
+    int height = static_cast<int>(srcinfo->image_height);
+    bool imperfect = (mirror_src_columns && width % imcu_width != 0)
+            || (mirror_src_rows && height % imcu_height != 0);
+    if (imperfect && options.edge_mode == JpegEdgeMode::kPerfect) {
+        return -1;
+    }
+    if (mirror_src_columns) {
+        width -= width % imcu_width;
+    }
+    if (mirror_src_rows) {
+        height -= height % imcu_height;
+    }
+    if (width <= 0 || height <= 0) {
+        return -1;
+    }
+
+    const int dst_width = transpose ? height : width;
+    const int dst_height = transpose ? width : height;
+    const int dst_max_h = transpose ? srcinfo->max_v_samp_factor : srcinfo->max_h_samp_factor;
+    const int dst_max_v = transpose ? srcinfo->max_h_samp_factor : srcinfo->max_v_samp_factor;
+    const int dst_mcu_cols = (dst_width + dst_max_h * DCTSIZE - 1) / (dst_max_h * DCTSIZE);
+    const int dst_mcu_rows = (dst_height + dst_max_v * DCTSIZE - 1) / (dst_max_v * DCTSIZE);
+    const int num_components = srcinfo->num_components;
+
+    // The destination block arrays have to be requested before the source coefficients are read,
+    // which realizes all virtual arrays of the pool.
+    jvirt_barray_ptr dst_arrays[MAX_COMPONENTS];
+    for (int ci = 0; ci < num_components; ++ci) {
+        const jpeg_component_info& comp = srcinfo->comp_info[ci];
+        int h_samp = transpose ? comp.v_samp_factor : comp.h_samp_factor;
+        int v_samp = transpose ? comp.h_samp_factor : comp.v_samp_factor;
+        dst_arrays[ci] = srcinfo->mem->request_virt_barray(
+                reinterpret_cast<j_common_ptr>(srcinfo), JPOOL_IMAGE, FALSE,
+                static_cast<JDIMENSION>(dst_mcu_cols * h_samp),
+                static_cast<JDIMENSION>(dst_mcu_rows * v_samp),
+                static_cast<JDIMENSION>(v_samp));
+    }
+
+    jvirt_barray_ptr* src_arrays = jpeg_read_coefficients(srcinfo);
+
+    jpeg_copy_critical_parameters(srcinfo, dstinfo);
+    dstinfo->image_width = static_cast<JDIMENSION>(dst_width);
+    dstinfo->image_height = static_cast<JDIMENSION>(dst_height);
+    if (transpose) {
+        for (int ci = 0; ci < num_components; ++ci) {
+            std::swap(dstinfo->comp_info[ci].h_samp_factor, dstinfo->comp_info[ci].v_samp_factor);
+        }
+        TransposeQuantTables(dstinfo);
+    }
+    // Only the Huffman tables are recomputed, the quantized coefficients stay untouched.
+    dstinfo->optimize_coding = TRUE;
+    dstinfo->write_JFIF_header = srcinfo->saw_JFIF_marker;
+
+    FixedDestination dest;
+    SetFixedDestination(dstinfo, &dest, dst, dst_capacity);
+    jpeg_write_coefficients(dstinfo, dst_arrays);
+
+    for (jpeg_saved_marker_ptr marker = srcinfo->marker_list; marker != nullptr;
+         marker = marker->next) {
+        // Markers the compressor already emitted on its own.
+        if ((dstinfo->write_JFIF_header && IsMarker(marker, JPEG_APP0, "JFIF", 5))
+            || (dstinfo->write_Adobe_marker && IsMarker(marker, JPEG_APP0 + 14, "Adobe", 5))) {
+            continue;
+        }
+        jpeg_write_marker(dstinfo, marker->marker, marker->data, marker->data_length);
+    }
+
+    // Rearranges the blocks. Virtual array accesses are plain pointer lookups here since the
+    // arrays are fully memory resident.
+    JBLOCK zero_block;
+    memset(zero_block, 0, sizeof(zero_block));
+    for (int ci = 0; ci < num_components; ++ci) {
+        const jpeg_component_info& comp = srcinfo->comp_info[ci];
+        const int dst_h_samp = transpose ? comp.v_samp_factor : comp.h_samp_factor;
+        const int dst_v_samp = transpose ? comp.h_samp_factor : comp.v_samp_factor;
+        const int dst_cols = dst_mcu_cols * dst_h_samp;
+        const int dst_rows = dst_mcu_rows * dst_v_samp;
+        // Number of source blocks inside the possibly trimmed image along mirrored axes.
+        const int src_cols = width / imcu_width * comp.h_samp_factor;
+        const int src_rows = height / imcu_height * comp.v_samp_factor;
+        const int src_block_cols = static_cast<int>(comp.width_in_blocks);
+        const int src_block_rows = static_cast<int>(comp.height_in_blocks);
+
+        for (int r = 0; r < dst_rows; ++r) {
+            JBLOCKROW dst_row = srcinfo->mem->access_virt_barray(
+                    reinterpret_cast<j_common_ptr>(srcinfo), dst_arrays[ci],
+                    static_cast<JDIMENSION>(r), 1, TRUE)[0];
+            for (int c = 0; c < dst_cols; ++c) {
+                int sr = transpose ? c : r;
+                int sc = transpose ? r : c;
+                if (mirror_src_rows) {
+                    sr = src_rows - 1 - sr;
+                }
+                if (mirror_src_columns) {
+                    sc = src_cols - 1 - sc;
+                }
+                if (sr < 0 || sc < 0 || sr >= src_block_rows || sc >= src_block_cols) {
+                    // Padding blocks beyond the image edge.
+                    memcpy(dst_row[c], zero_block, sizeof(JBLOCK));
+                    continue;
+                }
+                JBLOCKROW src_row = srcinfo->mem->access_virt_barray(
+                        reinterpret_cast<j_common_ptr>(srcinfo), src_arrays[ci],
+                        static_cast<JDIMENSION>(sr), 1, FALSE)[0];
+                TransformBlock(src_row[sc], dst_row[c], transpose, mirror_dst_columns,
+                               mirror_dst_rows);
+            }
+        }
+    }
+
+    jpeg_finish_compress(dstinfo);
+    jpeg_abort_decompress(srcinfo);
+    return static_cast<long>(dest.bytes_written());
+}
+
+}  // namespace
+
+size_t MaxTransformedJpegSize(size_t jpeg_size) {
+    return jpeg_size + jpeg_size / 8 + kTransformSlackBytes;
+}
+
+long TransformJpeg(const uint8_t* jpeg,
+                   size_t jpeg_size,
+                   const JpegTransformOptions& options,
+                   uint8_t* dst,
+                   size_t dst_capacity) {
+    if (jpeg == nullptr || dst == nullptr) {
+        return -1;
+    }
+    // Zero initialized so that destroying a codec that was never created is a no-op.
+    jpeg_decompress_struct srcinfo = {};
+    jpeg_compress_struct dstinfo = {};
+    JpegErrorManager error;
+    srcinfo.err = InitJpegErrorManager(&error);
+    dstinfo.err = srcinfo.err;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_compress(&dstinfo);
+        jpeg_destroy_decompress(&srcinfo);
+        return -1;
+    }
+    jpeg_create_decompress(&srcinfo);
+    jpeg_create_compress(&dstinfo);
+    jpeg_mem_src(&srcinfo, jpeg, static_cast<unsigned long>(jpeg_size));
+    if (options.copy_markers) {
+        jpeg_save_markers(&srcinfo, JPEG_COM, 0xFFFF);
+        for (int m = 0; m < 16; ++m) {
+            jpeg_save_markers(&srcinfo, JPEG_APP0 + m, 0xFFFF);
+        }
+    }
+    long size = TransformCoefficients(&srcinfo, &dstinfo, options, dst, dst_capacity);
+    jpeg_destroy_compress(&dstinfo);
+    jpeg_destroy_decompress(&srcinfo);
+    return size;
+}
+
+}  // namespace camerax
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_JPEG_TRANSFORM_H_
+#define CAMERA_CORE_JPEG_TRANSFORM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camerax {
+
+/**
+ * Lossless JPEG transformations, in the same order as jpegtran's JXFORM_CODE.
+ */
+enum class JpegTransformOp {
+    kNone = 0,
+    kFlipHorizontal = 1,
+    kFlipVertical = 2,
+    kTranspose = 3,
+    kTransverse = 4,
+    kRotate90 = 5,
+    kRotate180 = 6,
+    kRotate270 = 7,
+};
+
+/**
+ * How to treat partial iMCUs at an edge that has to be mirrored by the transformation. Those
+ * blocks cannot be moved losslessly.
+ */
+enum class JpegEdgeMode {
+    // Drop the partial iMCUs, the output is up to 15 pixels narrower or shorter (jpegtran -trim).
+    kTrim = 0,
+    // Fail instead of changing the image size (jpegtran -perfect).
+    kPerfect = 1,
+};
+
+struct JpegTransformOptions {
+    JpegTransformOp op = JpegTransformOp::kNone;
+    JpegEdgeMode edge_mode = JpegEdgeMode::kTrim;
+    // Whether APPn (e.g. EXIF) and COM markers are copied to the output. Note that the EXIF
+    // orientation tag is not rewritten.
+    bool copy_markers = true;
+};
+
+/**
+ * Returns the output capacity that is sufficient to transform a JPEG of {@code jpeg_size} bytes.
+ * The transformation reuses the quantized coefficients and only recomputes the Huffman tables,
+ * so the output is about the size of the input.
+ */
+size_t MaxTransformedJpegSize(size_t jpeg_size);
+
+/**
+ * Transforms a baseline or progressive JPEG without decoding it to pixels: the DCT blocks are
+ * rearranged and their coefficients transposed or negated, like jpegtran does.
+ *
+ * @return the number of bytes written to {@code dst}, or -1 if the JPEG cannot be transformed
+ * (including kPerfect with a partial edge iMCU) or the result does not fit.
+ */
+long TransformJpeg(const uint8_t* jpeg,
+                   size_t jpeg_size,
+                   const JpegTransformOptions& options,
+                   uint8_t* dst,
+                   size_t dst_capacity);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_JPEG_TRANSFORM_H_
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kernel_dispatch.h"
+
+#include <atomic>
+
+#if defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#define CAMERAX_DISPATCH_CPUID 1
+#endif
+
+#include "libyuv/cpu_id.h"
+
+namespace camerax {
+
+namespace {
+
+std::atomic<int> g_overrides[kKernelCount];
+
+#if defined(CAMERAX_DISPATCH_CPUID)
+// Register state the OS saves on context switches, see XGETBV in the Intel SDM.
+uint64_t ReadXcr0() {
+    uint32_t eax;
+    uint32_t edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+uint32_t DetectCpuFeatures() {
+    uint32_t features = 0;
+#if defined(__aarch64__)
+    // Bits of the arm64 uapi hwcap.h, which older NDK headers lack. Advanced SIMD is mandatory.
+    constexpr unsigned long kHwcapAsimdDp = 1UL << 20;
+    constexpr unsigned long kHwcap2Sve2 = 1UL << 1;
+    constexpr unsigned long kHwcap2I8mm = 1UL << 13;
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    features |= kCpuNeon;
+    if ((hwcap & kHwcapAsimdDp) != 0) {
+        features |= kCpuDotProd;
+    }
+    if ((hwcap2 & kHwcap2Sve2) != 0) {
+        features |= kCpuSve2;
+    }
+    if ((hwcap2 & kHwcap2I8mm) != 0) {
+        features |= kCpuI8mm;
+    }
+#elif defined(__arm__)
+    constexpr unsigned long kHwcapNeon = 1UL << 12;
+    if ((getauxval(AT_HWCAP) & kHwcapNeon) != 0) {
+        features |= kCpuNeon;
+    }
+#elif defined(CAMERAX_DISPATCH_CPUID)
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int ecx;
+    unsigned int edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+    if ((edx & bit_SSE2) != 0) {
+        features |= kCpuSse2;
+    }
+    if ((ecx & bit_SSE4_1) != 0) {
+        features |= kCpuSse41;
+    }
+    // The wide registers are only usable if the OS saves them: YMM for AVX2, also the opmask
+    // and ZMM state for AVX-512.
+    const uint64_t xcr0 = (ecx & bit_OSXSAVE) != 0 ? ReadXcr0() : 0;
+    const bool os_avx = (xcr0 & 0x6) == 0x6;
+    const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        if (os_avx && (ebx & bit_AVX2) != 0) {
+            features |= kCpuAvx2;
+        }
+        if (os_avx512 && (ebx & bit_AVX512F) != 0) {
+            features |= kCpuAvx512;
+        }
+    }
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // A build whose baseline includes NEON only runs on CPUs that have it.
+    features |= kCpuNeon;
+#endif
+    return features;
+}
+
+uint32_t ImplBit(KernelImpl impl) {
+    return 1U << static_cast<int>(impl);
+}
+
+// Implementations compiled into the library.
+uint32_t CompiledImpls(Kernel kernel) {
+    uint32_t impls = ImplBit(KernelImpl::kScalar);
+    if (kernel == Kernel::kLibyuv) {
+        // libyuv carries code for every level of its architecture.
+#if defined(__aarch64__) || defined(__arm__)
+        impls |= ImplBit(KernelImpl::kNeon);
+#elif defined(__x86_64__) || defined(__i386__)
+        impls |= ImplBit(KernelImpl::kSse2) | ImplBit(KernelImpl::kSse41)
+                | ImplBit(KernelImpl::kAvx2) | ImplBit(KernelImpl::kAvx512);
+#endif
+        return impls;
+    }
+    // The kernels of this library are written for the baseline SIMD of the build.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    impls |= ImplBit(KernelImpl::kNeon);
+#elif defined(__SSE2__)
+    impls |= ImplBit(KernelImpl::kSse2);
+#endif
+#if defined(CAMERAX_TARGET_AVX2)
+    if (kernel == Kernel::kPlaneHash) {
+        impls |= ImplBit(KernelImpl::kAvx2);
+    }
+#endif
+    return impls;
+}
+
+uint32_t RequiredFeature(KernelImpl impl) {
+    switch (impl) {
+        case KernelImpl::kNeon:
+            return kCpuNeon;
+        case KernelImpl::kSse2:
+            return kCpuSse2;
+        case KernelImpl::kSse41:
+            return kCpuSse41;
+        case KernelImpl::kAvx2:
+            return kCpuAvx2;
+        case KernelImpl::kAvx512:
+            return kCpuAvx512;
+        default:
+            return 0;
+    }
+}
+
+KernelImpl BestImpl(Kernel kernel) {
+    for (int impl = static_cast<int>(KernelImpl::kAvx512);
+         impl > static_cast<int>(KernelImpl::kScalar); --impl) {
+        if (IsKernelImplAvailable(kernel, static_cast<KernelImpl>(impl))) {
+            return static_cast<KernelImpl>(impl);
+        }
+    }
+    return KernelImpl::kScalar;
+}
+
+// The libyuv CPU flags that enable the given level and the ones below it.
+int LibyuvCpuMask(KernelImpl impl) {
+    int mask = libyuv::kCpuInitialized;
+    switch (impl) {
+        case KernelImpl::kScalar:
+            return mask;
+        case KernelImpl::kSse2:
+            return mask | libyuv::kCpuHasX86 | libyuv::kCpuHasSSE2;
+        case KernelImpl::kSse41:
+            return LibyuvCpuMask(KernelImpl::kSse2) | libyuv::kCpuHasSSSE3
+                    | libyuv::kCpuHasSSE41 | libyuv::kCpuHasSSE42;
+        case KernelImpl::kAvx2:
+            return LibyuvCpuMask(KernelImpl::kSse41) | libyuv::kCpuHasAVX | libyuv::kCpuHasAVX2
+                    | libyuv::kCpuHasERMS | libyuv::kCpuHasFMA3 | libyuv::kCpuHasF16C;
+        default:
+            // Everything libyuv detects, e.g. also dot product and SVE paths on arm64.
+            return -1;
+    }
+}
+
+}  // namespace
+
+uint32_t GetCpuFeatures() {
+    static const uint32_t features = DetectCpuFeatures();
+    return features;
+}
+
+bool IsKernelImplAvailable(Kernel kernel, KernelImpl impl) {
+    // Also guards ImplBit against values that are not enumerators, e.g. from JNI.
+    if (static_cast<int>(impl) < 0 || static_cast<int>(impl) >= kKernelImplCount) {
+        return false;
+    }
+    if (impl == KernelImpl::kAuto || impl == KernelImpl::kScalar) {
+        return true;
+    }
+    return (CompiledImpls(kernel) & ImplBit(impl)) != 0
+            && (GetCpuFeatures() & RequiredFeature(impl)) != 0;
+}
+
+KernelImpl GetKernelImpl(Kernel kernel) {
+    static const KernelImpl best[kKernelCount] = {
+            BestImpl(Kernel::kTranspose), BestImpl(Kernel::kWarp),
+            BestImpl(Kernel::kPlaneHash), BestImpl(Kernel::kLibyuv),
+            BestImpl(Kernel::kChromaDownsample), BestImpl(Kernel::kRawUnpack),
+            BestImpl(Kernel::kDepth), BestImpl(Kernel::kRgbToYuv),
+            BestImpl(Kernel::kOverlay), BestImpl(Kernel::kMask),
+            BestImpl(Kernel::kBurstMerge)};
+    const int index = static_cast<int>(kernel);
+    const auto impl = static_cast<KernelImpl>(g_overrides[index].load(std::memory_order_relaxed));
+    return impl != KernelImpl::kAuto ? impl : best[index];
+}
+
+int SetKernelImpl(Kernel kernel, KernelImpl impl) {
+    const int index = static_cast<int>(kernel);
+    if (index < 0 || index >= kKernelCount || !IsKernelImplAvailable(kernel, impl)) {
+        return -1;
+    }
+    if (kernel == Kernel::kLibyuv) {
+        libyuv::MaskCpuFlags(LibyuvCpuMask(impl));
+    }
+    g_overrides[index].store(static_cast<int>(impl), std::memory_order_relaxed);
+    return 0;
+}
+
+KernelImpl GetKernelImplOverride(Kernel kernel) {
+    return static_cast<KernelImpl>(
+            g_overrides[static_cast<int>(kernel)].load(std::memory_order_relaxed));
+}
+
+const char* GetKernelImplName(KernelImpl impl) {
+    switch (impl) {
+        case KernelImpl::kAuto:
+            return "auto";
+        case KernelImpl::kScalar:
+            return "scalar";
+        case KernelImpl::kNeon:
+            return "neon";
+        case KernelImpl::kSse2:
+            return "sse2";
+        case KernelImpl::kSse41:
+            return "sse4.1";
+        case KernelImpl::kAvx2:
+            return "avx2";
+        case KernelImpl::kAvx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+const char* GetKernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::kTranspose:
+            return "transpose";
+        case Kernel::kWarp:
+            return "warp";
+        case Kernel::kPlaneHash:
+            return "plane_hash";
+        case Kernel::kLibyuv:
+            return "libyuv";
+        case Kernel::kChromaDownsample:
+            return "chroma_downsample";
+        case Kernel::kRawUnpack:
+            return "raw_unpack";
+        case Kernel::kDepth:
+            return "depth";
+        case Kernel::kRgbToYuv:
+            return "rgb_to_yuv";
+        case Kernel::kOverlay:
+            return "overlay";
+        case Kernel::kMask:
+            return "mask";
+        case Kernel::kBurstMerge:
+            return "burst_merge";
+    }
+    return "unknown";
+}
+
+}  // namespace camerax
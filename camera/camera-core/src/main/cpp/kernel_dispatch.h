@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_KERNEL_DISPATCH_H_
+#define CAMERA_CORE_KERNEL_DISPATCH_H_
+
+#include <cstdint>
+
+// Functions can be compiled for AVX2 with the target attribute, whatever the baseline of the
+// build, and are only called after the CPU was checked.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CAMERAX_TARGET_AVX2 1
+#endif
+
+namespace camerax {
+
+/**
+ * Instruction set extensions of the CPU, detected at runtime.
+ */
+enum CpuFeature : uint32_t {
+    kCpuNeon = 1 << 0,
+    kCpuDotProd = 1 << 1,
+    kCpuI8mm = 1 << 2,
+    kCpuSve2 = 1 << 3,
+    kCpuSse2 = 1 << 8,
+    kCpuSse41 = 1 << 9,
+    kCpuAvx2 = 1 << 10,
+    kCpuAvx512 = 1 << 11,
+};
+
+/**
+ * Kernels that come in more than one implementation. The values are part of the JNI API.
+ */
+enum class Kernel {
+    // The cache-blocked 90 and 270 degree rotations of image_transpose.
+    kTranspose = 0,
+    // The fused rotate and scale of image_warp.
+    kWarp = 1,
+    // The plane hash of plane_hash.
+    kPlaneHash = 2,
+    // Every libyuv function, through libyuv::MaskCpuFlags.
+    kLibyuv = 3,
+    // The 4:2:2 and 4:4:4 to 4:2:0 downsampling of chroma_subsampling.
+    kChromaDownsample = 4,
+    // The RAW10 and RAW12 unpacking of raw_kernels.
+    kRawUnpack = 5,
+    // The DEPTH16 decoding and point cloud packing of depth_kernels.
+    kDepth = 6,
+    // The RGB to YUV conversion of rgb_to_yuv.
+    kRgbToYuv = 7,
+    // The overlay blend of yuv_overlay.
+    kOverlay = 8,
+    // The blur and mosaic passes of privacy_mask.
+    kMask = 9,
+    // The alignment and accumulation of burst_merge.
+    kBurstMerge = 10,
+};
+
+constexpr int kKernelCount = 11;
+
+/**
+ * Implementations of a kernel, in the order they are preferred. The values are part of the JNI
+ * API.
+ */
+enum class KernelImpl {
+    // The best implementation available, not an implementation itself.
+    kAuto = 0,
+    kScalar = 1,
+    kNeon = 2,
+    kSse2 = 3,
+    kSse41 = 4,
+    kAvx2 = 5,
+    kAvx512 = 6,
+};
+
+constexpr int kKernelImplCount = 7;
+
+/** Returns the {@link CpuFeature} bits of this CPU. */
+uint32_t GetCpuFeatures();
+
+/**
+ * Whether {@code impl} of {@code kernel} is compiled into the library and supported by the CPU.
+ * kAuto and kScalar are always available.
+ */
+bool IsKernelImplAvailable(Kernel kernel, KernelImpl impl);
+
+/**
+ * Returns the implementation of {@code kernel} that runs: the override if one is set, else the
+ * best available one. Cheap enough to call once per kernel invocation.
+ */
+KernelImpl GetKernelImpl(Kernel kernel);
+
+/**
+ * Forces {@code impl} for {@code kernel}, e.g. to compare implementations on the same device or
+ * to switch off a miscompiled one. kAuto restores the default. The override applies to calls
+ * that start afterwards; for libyuv it is process wide.
+ *
+ * @return 0 on success or -1 if the implementation is not available.
+ */
+int SetKernelImpl(Kernel kernel, KernelImpl impl);
+
+/**
+ * Returns the implementation forced with {@link SetKernelImpl}, or kAuto if none is. Lets a
+ * caller keep a kernel opt-in until it is known to pay off.
+ */
+KernelImpl GetKernelImplOverride(Kernel kernel);
+
+/** Lower case name of an implementation, e.g. "neon". */
+const char* GetKernelImplName(KernelImpl impl);
+
+/** Lower case name of a kernel, e.g. "transpose". */
+const char* GetKernelName(Kernel kernel);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_KERNEL_DISPATCH_H_
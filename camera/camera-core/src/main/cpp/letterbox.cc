@@ -0,0 +1,324 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "letterbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "image_kernels.h"
+#include "image_pipeline.h"
+
+namespace camerax {
+
+namespace {
+
+// Size of the ABGR bands tensor outputs are converted in, small enough for the L2 cache.
+constexpr int kBandBytes = 64 * 1024;
+
+// Float value of every byte of each channel. A lookup is exact and cheaper than the arithmetic.
+struct FloatTables {
+    float value[3][256];
+};
+
+bool IsTensor(LetterboxFormat format) {
+    return format == LetterboxFormat::kRGB || format == LetterboxFormat::kFloatNHWC
+            || format == LetterboxFormat::kFloatNCHW;
+}
+
+// Plans the conversion of the oriented crop into the image's rectangle of the box and computes
+// the placement of that rectangle.
+int PlanContent(const PlanarImage& src, const LetterboxRequest& request, PipelinePlan* plan,
+                LetterboxPlacement* placement) {
+    if (request.box_width <= 0 || request.box_height <= 0) {
+        return -1;
+    }
+    PipelineRequest pipeline_request;
+    pipeline_request.crop_left = request.crop_left;
+    pipeline_request.crop_top = request.crop_top;
+    pipeline_request.crop_width = request.crop_width;
+    pipeline_request.crop_height = request.crop_height;
+    pipeline_request.orientation = request.orientation;
+    pipeline_request.output_format = PipelineFormat::kABGR;
+    // Planning at the size of the oriented crop checks the crop and rounds its edges.
+    PipelinePlan oriented;
+    if (PlanPipeline(src, pipeline_request, &oriented) != 0) {
+        return -1;
+    }
+    const int oriented_width = oriented.output_width;
+    const int oriented_height = oriented.output_height;
+    const double scale = std::min(static_cast<double>(request.box_width) / oriented_width,
+                                  static_cast<double>(request.box_height) / oriented_height);
+    const int width = std::min(std::max(static_cast<int>(std::lround(oriented_width * scale)), 1),
+                               request.box_width);
+    const int height = std::min(
+            std::max(static_cast<int>(std::lround(oriented_height * scale)), 1),
+            request.box_height);
+    pipeline_request.output_width = width;
+    pipeline_request.output_height = height;
+    if (PlanPipeline(src, pipeline_request, plan) != 0) {
+        return -1;
+    }
+
+    placement->left = request.center ? (request.box_width - width) / 2 : 0;
+    placement->top = request.center ? (request.box_height - height) / 2 : 0;
+    placement->width = width;
+    placement->height = height;
+
+    // Follows a source point through the crop, the flip, the rotation and the scale. All of
+    // them are affine, so the transform is read off the images of the origin and the two unit
+    // vectors.
+    const double crop_width = plan->crop_width;
+    const double crop_height = plan->crop_height;
+    const double scale_x = static_cast<double>(width) / oriented_width;
+    const double scale_y = static_cast<double>(height) / oriented_height;
+    auto map = [&](double x, double y, double* box_x, double* box_y) {
+        x -= plan->crop_left;
+        y -= plan->crop_top;
+        if (request.orientation.flip_vertical) {
+            y = crop_height - y;
+        }
+        double oriented_x = x;
+        double oriented_y = y;
+        switch (request.orientation.rotation) {
+            case 90:
+                oriented_x = crop_height - y;
+                oriented_y = x;
+                break;
+            case 180:
+                oriented_x = crop_width - x;
+                oriented_y = crop_height - y;
+                break;
+            case 270:
+                oriented_x = y;
+                oriented_y = crop_width - x;
+                break;
+            default:
+                break;
+        }
+        *box_x = oriented_x * scale_x + placement->left;
+        *box_y = oriented_y * scale_y + placement->top;
+    };
+    double origin_x, origin_y, x_axis_x, x_axis_y, y_axis_x, y_axis_y;
+    map(0, 0, &origin_x, &origin_y);
+    map(1, 0, &x_axis_x, &x_axis_y);
+    map(0, 1, &y_axis_x, &y_axis_y);
+    const double values[9] = {x_axis_x - origin_x, y_axis_x - origin_x, origin_x,
+                              x_axis_y - origin_y, y_axis_y - origin_y, origin_y,
+                              0, 0, 1};
+    for (int i = 0; i < 9; ++i) {
+        placement->transform[i] = static_cast<float>(values[i]);
+    }
+    return 0;
+}
+
+void FillPixels(uint8_t* dst, int count, const uint8_t pixel[4]) {
+    for (int i = 0; i < count; ++i) {
+        memcpy(dst + 4 * i, pixel, 4);
+    }
+}
+
+// Writes count tensor pixels from pixel index on. The channels come from the ABGR pixels abgr or,
+// if it is null, from the padding color pad. plane_size is the number of pixels of the box,
+// which separates the planes of NCHW tensors.
+void WriteTensorPixels(LetterboxFormat format, const uint8_t* abgr, const uint8_t* pad,
+                       const FloatTables& tables, size_t index, int count, size_t plane_size,
+                       uint8_t* dst) {
+    const int step = abgr != nullptr ? 4 : 0;
+    const uint8_t* in = abgr != nullptr ? abgr : pad;
+    switch (format) {
+        case LetterboxFormat::kRGB: {
+            uint8_t* out = dst + index * 3;
+            for (int i = 0; i < count; ++i, in += step, out += 3) {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+            }
+            break;
+        }
+        case LetterboxFormat::kFloatNHWC: {
+            float* out = reinterpret_cast<float*>(dst) + index * 3;
+            for (int i = 0; i < count; ++i, in += step, out += 3) {
+                out[0] = tables.value[0][in[0]];
+                out[1] = tables.value[1][in[1]];
+                out[2] = tables.value[2][in[2]];
+            }
+            break;
+        }
+        case LetterboxFormat::kFloatNCHW: {
+            float* out = reinterpret_cast<float*>(dst) + index;
+            for (int i = 0; i < count; ++i, in += step) {
+                out[i] = tables.value[0][in[0]];
+                out[plane_size + i] = tables.value[1][in[1]];
+                out[2 * plane_size + i] = tables.value[2][in[2]];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+}  // namespace
+
+int GetLetterboxPlacement(const PlanarImage& src, const LetterboxRequest& request,
+                          LetterboxPlacement* placement) {
+    PipelinePlan plan;
+    return placement != nullptr ? PlanContent(src, request, &plan, placement) : -1;
+}
+
+int Letterbox(const PlanarImage& src, const LetterboxRequest& request, uint8_t* dst,
+              int dst_stride, StripePool* pool, LetterboxPlacement* placement) {
+    const LetterboxFormat format = request.output_format;
+    PipelinePlan plan;
+    LetterboxPlacement result;
+    if (dst == nullptr || (format != LetterboxFormat::kABGR && !IsTensor(format))
+        || (format == LetterboxFormat::kABGR && dst_stride < request.box_width * 4)
+        || PlanContent(src, request, &plan, &result) != 0) {
+        return -1;
+    }
+    const int box_width = request.box_width;
+    const int box_height = request.box_height;
+    const int right = result.left + result.width;
+    const int bottom = result.top + result.height;
+
+    if (format == LetterboxFormat::kABGR) {
+        // The image goes straight into its rectangle, so only the padding is left to write.
+        PipelineDestination content;
+        content.abgr = dst + static_cast<ptrdiff_t>(result.top) * dst_stride + result.left * 4;
+        content.abgr_stride = dst_stride;
+        if (RunPipeline(src, plan, content, nullptr, 0, nullptr) != 0) {
+            return -1;
+        }
+        const uint8_t pixel[4] = {request.pad_color[0], request.pad_color[1],
+                                  request.pad_color[2], 255};
+        RunRowStripes(pool, box_height, 1, [&](int begin, int end) {
+            for (int y = begin; y < end; ++y) {
+                uint8_t* row = dst + static_cast<ptrdiff_t>(y) * dst_stride;
+                if (y < result.top || y >= bottom) {
+                    FillPixels(row, box_width, pixel);
+                    continue;
+                }
+                FillPixels(row, result.left, pixel);
+                FillPixels(row + right * 4, box_width - right, pixel);
+            }
+        });
+    } else {
+        // Tensors are packed from ABGR rows. When the pipeline ends with the conversion to
+        // ABGR, it stops short of it at I420, under half the size, and each stripe converts its
+        // rows in bands that stay in the cache right before packing them. Plans that scale or
+        // rotate in the ABGR domain leave the whole ABGR content in scratch instead.
+        const bool convert_in_bands = plan.stages.back().op == PipelineOp::kConvertToABGR;
+        PipelinePlan content_plan = plan;
+        if (convert_in_bands) {
+            content_plan.stages.pop_back();
+            content_plan.output_format = PipelineFormat::kI420;
+        }
+        const int content_stride = result.width * 4;
+        size_t content_bytes = 0;
+        if (!convert_in_bands) {
+            content_bytes = static_cast<size_t>(content_stride) * result.height;
+        } else if (!content_plan.stages.empty()) {
+            content_bytes = I420BufferSize(result.width, result.height);
+        }
+        std::vector<uint8_t> scratch(content_bytes + plan.scratch_bytes);
+        PlanarImage yuv;
+        if (convert_in_bands && content_plan.stages.empty()) {
+            // Only the conversion was planned, so the bands come straight from the source.
+            yuv = CropPlanarImage(src, plan.crop_left, plan.crop_top, plan.crop_width,
+                                  plan.crop_height);
+            if (plan.orientation.flip_vertical) {
+                yuv = FlipPlanarImage(yuv);
+            }
+        } else {
+            PipelineDestination content;
+            if (convert_in_bands) {
+                yuv = WrapI420(scratch.data(), result.width, result.height, result.width);
+                content.yuv = yuv;
+            } else {
+                content.abgr = scratch.data();
+                content.abgr_stride = content_stride;
+            }
+            if (RunPipeline(src, content_plan, content, scratch.data() + content_bytes,
+                            plan.scratch_bytes, nullptr) != 0) {
+                return -1;
+            }
+        }
+        FloatTables tables;
+        if (format != LetterboxFormat::kRGB) {
+            for (int c = 0; c < 3; ++c) {
+                for (int value = 0; value < 256; ++value) {
+                    tables.value[c][value] = (value - request.mean[c]) * request.scale[c];
+                }
+            }
+        }
+        const size_t plane_size = static_cast<size_t>(box_width) * box_height;
+        const uint8_t* pad = request.pad_color;
+        // Bands start on even rows to share chroma rows with the full frame conversion.
+        const int band_rows = std::max(kBandBytes / content_stride, 2) & ~1;
+        std::atomic<int> failures(0);
+        RunRowStripes(pool, box_height, 1, [&](int begin, int end) {
+            std::vector<uint8_t> band;
+            int band_top = 0;
+            int band_bottom = 0;
+            for (int y = begin; y < end; ++y) {
+                const size_t index = static_cast<size_t>(y) * box_width;
+                if (y < result.top || y >= bottom) {
+                    WriteTensorPixels(format, nullptr, pad, tables, index, box_width, plane_size,
+                                      dst);
+                    continue;
+                }
+                const int row = y - result.top;
+                const uint8_t* abgr = nullptr;
+                if (!convert_in_bands) {
+                    abgr = scratch.data() + static_cast<size_t>(row) * content_stride;
+                } else {
+                    if (row >= band_bottom) {
+                        band_top = row & ~1;
+                        band_bottom = std::min(band_top + band_rows, result.height);
+                        band.resize(static_cast<size_t>(content_stride) * band_rows);
+                        if (Android420ToABGR(CropPlanarImage(yuv, 0, band_top, result.width,
+                                                             band_bottom - band_top),
+                                             band.data(), content_stride,
+                                             /* is_full_swing = */true) != 0) {
+                            failures.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                    abgr = band.data() + static_cast<size_t>(row - band_top) * content_stride;
+                }
+                WriteTensorPixels(format, nullptr, pad, tables, index, result.left, plane_size,
+                                  dst);
+                WriteTensorPixels(format, abgr, pad, tables, index + result.left, result.width,
+                                  plane_size, dst);
+                WriteTensorPixels(format, nullptr, pad, tables, index + right, box_width - right,
+                                  plane_size, dst);
+            }
+        });
+        if (failures.load() != 0) {
+            return -1;
+        }
+    }
+    if (placement != nullptr) {
+        *placement = result;
+    }
+    return 0;
+}
+
+}  // namespace camerax
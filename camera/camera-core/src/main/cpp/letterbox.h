@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_LETTERBOX_H_
+#define CAMERA_CORE_LETTERBOX_H_
+
+#include <cstdint>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * Layouts {@link Letterbox} writes. The tensor layouts hold R, G and B, without alpha, and are
+ * tightly packed.
+ */
+enum class LetterboxFormat {
+    // R, G, B, A bytes, as in RGBA_8888 Bitmaps.
+    kABGR = 0,
+    // R, G, B bytes, as quantized models take.
+    kRGB = 1,
+    // Interleaved floats, i.e. an NHWC tensor.
+    kFloatNHWC = 2,
+    // A plane of floats per channel, i.e. an NCHW tensor.
+    kFloatNCHW = 3,
+};
+
+/**
+ * Crop and orientation of an Android420 frame and the box it is fitted into, e.g. the square
+ * input of an object detection model. The oriented crop is scaled, keeping its aspect ratio, to
+ * the largest size that fits the box, and the rest of the box is padding.
+ */
+struct LetterboxRequest {
+    // Region of the source to keep, in source coordinates. An empty region keeps the whole
+    // frame. The left and top edges are rounded down to even values.
+    int crop_left = 0;
+    int crop_top = 0;
+    int crop_width = 0;
+    int crop_height = 0;
+    Orientation orientation;
+    int box_width = 0;
+    int box_height = 0;
+    // Centers the image in the box. Otherwise it goes to the top left corner and the padding to
+    // the right and bottom.
+    bool center = true;
+    // R, G and B of the padding.
+    uint8_t pad_color[3] = {0, 0, 0};
+    LetterboxFormat output_format = LetterboxFormat::kABGR;
+    // Float outputs hold (c - mean) * scale for each channel value c in [0, 255], e.g. a mean of
+    // 0 and a scale of 1 / 255 for inputs in [0, 1]. The padding is normalized the same way.
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    float scale[3] = {1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * Where the image ended up in the box.
+ */
+struct LetterboxPlacement {
+    // The rectangle of the box covered by the image; the rest is padding.
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+    // Maps source coordinates to box coordinates, in the order of the values of an
+    // android.graphics.Matrix. Its inverse maps boxes found by a model back onto the frame.
+    float transform[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+/**
+ * Computes where {@link Letterbox} places frames shaped like {@code src}, without converting
+ * anything.
+ *
+ * @return 0 on success or -1 if the request does not fit the frame.
+ */
+int GetLetterboxPlacement(const PlanarImage& src, const LetterboxRequest& request,
+                          LetterboxPlacement* placement);
+
+/**
+ * Crops, orients and scales {@code src} into the box of {@code request} and pads the rest of the
+ * box, writing every byte of {@code dst} once. {@code dst_stride} is the row stride in bytes of
+ * kABGR outputs; tensors are tightly packed, so {@code dst} needs {@code box_width *
+ * box_height * 3} samples. {@code placement} may be null.
+ *
+ * <p>kABGR outputs are converted by the pipeline straight into the image's rectangle of the
+ * box. Tensor outputs are packed, together with the padding, in stripes of rows that run on
+ * {@code pool}, which may be null to run on the calling thread. Each stripe converts its rows to
+ * ABGR in small bands right before packing them; only plans that scale or rotate in the ABGR
+ * domain convert the whole image into scratch memory first.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+int Letterbox(const PlanarImage& src, const LetterboxRequest& request, uint8_t* dst,
+              int dst_stride, StripePool* pool, LetterboxPlacement* placement);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_LETTERBOX_H_
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "luma_pipeline.h"
+
+#include <vector>
+
+#include "libyuv/planar_functions.h"
+#include "libyuv/scale.h"
+
+#include "image_transpose.h"
+
+namespace camerax {
+
+namespace {
+
+// The crop rectangle of a request, with an empty one standing for the whole plane.
+struct LumaCrop {
+    int left;
+    int top;
+    int width;
+    int height;
+};
+
+bool ResolveCrop(int width, int height, const LumaRequest& request, LumaCrop* crop) {
+    if (request.crop_width <= 0 || request.crop_height <= 0) {
+        *crop = {0, 0, width, height};
+        return width > 0 && height > 0;
+    }
+    *crop = {request.crop_left, request.crop_top, request.crop_width, request.crop_height};
+    return crop->left >= 0 && crop->top >= 0 && crop->left + crop->width <= width
+            && crop->top + crop->height <= height;
+}
+
+}  // namespace
+
+int GetLumaOutputSize(int width, int height, const LumaRequest& request,
+                      int* output_width, int* output_height) {
+    LumaCrop crop;
+    if (!ResolveCrop(width, height, request, &crop)) {
+        return -1;
+    }
+    const bool swap = request.orientation.SwapsDimensions();
+    *output_width = request.output_width > 0 ? request.output_width
+                                             : (swap ? crop.height : crop.width);
+    *output_height = request.output_height > 0 ? request.output_height
+                                               : (swap ? crop.width : crop.height);
+    return 0;
+}
+
+int ProcessLuma(const Plane& src_y, int width, int height, const LumaRequest& request,
+                uint8_t* dst, int dst_stride) {
+    LumaCrop crop;
+    int output_width = 0;
+    int output_height = 0;
+    if (src_y.data == nullptr || dst == nullptr || src_y.pixel_stride < 1
+        || !ResolveCrop(width, height, request, &crop)
+        || GetLumaOutputSize(width, height, request, &output_width, &output_height) != 0) {
+        return -1;
+    }
+
+    // Crop and flip only change how the source is addressed. Samples that are not packed, which
+    // Android allows for Y but cameras do not produce in practice, are gathered first.
+    const uint8_t* src = src_y.RowAt(crop.top) + crop.left * src_y.pixel_stride;
+    int src_stride = src_y.row_stride;
+    std::vector<uint8_t> packed;
+    if (src_y.pixel_stride != 1) {
+        packed.resize(static_cast<size_t>(crop.width) * crop.height);
+        for (int y = 0; y < crop.height; ++y) {
+            const uint8_t* row = src + static_cast<ptrdiff_t>(y) * src_stride;
+            for (int x = 0; x < crop.width; ++x) {
+                packed[static_cast<size_t>(y) * crop.width + x] = row[x * src_y.pixel_stride];
+            }
+        }
+        src = packed.data();
+        src_stride = crop.width;
+    }
+    if (request.orientation.flip_vertical) {
+        src += static_cast<ptrdiff_t>(crop.height - 1) * src_stride;
+        src_stride = -src_stride;
+    }
+
+    const int rotation = request.orientation.rotation;
+    const bool swap = request.orientation.SwapsDimensions();
+    const int oriented_width = swap ? crop.height : crop.width;
+    const int oriented_height = swap ? crop.width : crop.height;
+    const bool scale = output_width != oriented_width || output_height != oriented_height;
+    if (!scale) {
+        return RotatePlane(src, src_stride, dst, dst_stride, crop.width, crop.height, rotation);
+    }
+    // ScalePlane only reports errors for invalid arguments, which were ruled out above, and
+    // older libyuv versions declare it void, so its result is not looked at.
+    if (rotation == 0) {
+        libyuv::ScalePlane(src, src_stride, crop.width, crop.height,
+                           dst, dst_stride, output_width, output_height, libyuv::kFilterBox);
+        return 0;
+    }
+
+    std::vector<uint8_t> scratch;
+    if (static_cast<int64_t>(output_width) * output_height
+        < static_cast<int64_t>(crop.width) * crop.height) {
+        // Scales in source orientation, then rotates the smaller plane into place.
+        const int scaled_width = swap ? output_height : output_width;
+        const int scaled_height = swap ? output_width : output_height;
+        scratch.resize(static_cast<size_t>(scaled_width) * scaled_height);
+        libyuv::ScalePlane(src, src_stride, crop.width, crop.height,
+                           scratch.data(), scaled_width, scaled_width, scaled_height,
+                           libyuv::kFilterBox);
+        return RotatePlane(scratch.data(), scaled_width, dst, dst_stride,
+                           scaled_width, scaled_height, rotation);
+    }
+    scratch.resize(static_cast<size_t>(oriented_width) * oriented_height);
+    int result = RotatePlane(src, src_stride, scratch.data(), oriented_width,
+                             crop.width, crop.height, rotation);
+    if (result != 0) {
+        return result;
+    }
+    libyuv::ScalePlane(scratch.data(), oriented_width, oriented_width, oriented_height,
+                       dst, dst_stride, output_width, output_height, libyuv::kFilterBox);
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_LUMA_PIPELINE_H_
+#define CAMERA_CORE_LUMA_PIPELINE_H_
+
+#include <cstdint>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Crop, orientation and scale of a luma plane, e.g. for barcode or text recognition that only
+ * looks at grayscale.
+ */
+struct LumaRequest {
+    // Region of the source to keep, in source coordinates. An empty region keeps the whole
+    // plane. Unlike PipelineRequest there is no chroma to stay aligned with, so odd edges are
+    // kept as they are.
+    int crop_left = 0;
+    int crop_top = 0;
+    int crop_width = 0;
+    int crop_height = 0;
+    Orientation orientation;
+    // Size of the output, in output orientation. 0 keeps the size of the oriented crop.
+    int output_width = 0;
+    int output_height = 0;
+};
+
+/**
+ * Computes the size of the plane {@link ProcessLuma} writes for a {@code width} x
+ * {@code height} source.
+ *
+ * @return 0 on success or -1 if the crop does not fit the source.
+ */
+int GetLumaOutputSize(int width, int height, const LumaRequest& request,
+                      int* output_width, int* output_height);
+
+/**
+ * Crops, orients and scales the {@code width} x {@code height} luma plane {@code src_y} into
+ * the packed 8-bit plane {@code dst}. Chroma is never touched, which saves two thirds of the
+ * memory traffic of a full YUV pass.
+ *
+ * <p>Scaling down happens before the rotation and scaling up after it, so that the transpose
+ * always works on the smaller of the two planes.
+ *
+ * @return 0 on success or -1 on failure.
+ */
+int ProcessLuma(const Plane& src_y, int width, int height, const LumaRequest& request,
+                uint8_t* dst, int dst_stride);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_LUMA_PIPELINE_H_
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plane_hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "kernel_dispatch.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_HASH_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_HASH_SSE2 1
+#endif
+#if defined(CAMERAX_TARGET_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace camerax {
+
+namespace {
+
+constexpr int kLanes = 8;
+constexpr int kStripeBytes = kLanes * 8;
+constexpr int kStripesPerScramble = 16;
+
+constexpr uint64_t kPrime32_1 = 0x9E3779B1U;
+constexpr uint64_t kPrime32_2 = 0x85EBCA77U;
+constexpr uint64_t kPrime32_3 = 0xC2B2AE3DU;
+constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+// Keys the stripes are mixed with, taken from the start of the XXH3 default secret.
+alignas(16) constexpr uint64_t kKey[kLanes] = {
+        0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL,
+        0x1F67B3B7A4A44072ULL, 0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL,
+        0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL,
+};
+
+uint64_t Load64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Adds stripe_count stripes of 64 bytes at p to the lanes. Every implementation gives the same
+// result.
+void AccumulateStripesScalar(uint64_t* acc, const uint8_t* p, int stripe_count) {
+    for (int s = 0; s < stripe_count; ++s, p += kStripeBytes) {
+        for (int i = 0; i < kLanes; ++i) {
+            const uint64_t data = Load64(p + 8 * i);
+            const uint64_t key = data ^ kKey[i];
+            acc[i ^ 1] += data;
+            acc[i] += (key & 0xFFFFFFFFU) * (key >> 32);
+        }
+    }
+}
+
+#if defined(CAMERAX_HASH_NEON)
+void AccumulateStripesSimd(uint64_t* acc, const uint8_t* p, int stripe_count) {
+    uint64x2_t lanes[kLanes / 2];
+    uint64x2_t keys[kLanes / 2];
+    for (int j = 0; j < kLanes / 2; ++j) {
+        lanes[j] = vld1q_u64(acc + 2 * j);
+        keys[j] = vld1q_u64(kKey + 2 * j);
+    }
+    for (int s = 0; s < stripe_count; ++s, p += kStripeBytes) {
+        for (int j = 0; j < kLanes / 2; ++j) {
+            const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(p + 16 * j));
+            const uint64x2_t key = veorq_u64(data, keys[j]);
+            const uint64x2_t product = vmull_u32(vmovn_u64(key), vshrn_n_u64(key, 32));
+            lanes[j] = vaddq_u64(lanes[j], vaddq_u64(vextq_u64(data, data, 1), product));
+        }
+    }
+    for (int j = 0; j < kLanes / 2; ++j) {
+        vst1q_u64(acc + 2 * j, lanes[j]);
+    }
+}
+#elif defined(CAMERAX_HASH_SSE2)
+void AccumulateStripesSimd(uint64_t* acc, const uint8_t* p, int stripe_count) {
+    __m128i lanes[kLanes / 2];
+    __m128i keys[kLanes / 2];
+    for (int j = 0; j < kLanes / 2; ++j) {
+        lanes[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + 2 * j));
+        keys[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(kKey + 2 * j));
+    }
+    for (int s = 0; s < stripe_count; ++s, p += kStripeBytes) {
+        for (int j = 0; j < kLanes / 2; ++j) {
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * j));
+            const __m128i key = _mm_xor_si128(data, keys[j]);
+            const __m128i product =
+                    _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+            const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[j] = _mm_add_epi64(lanes[j], _mm_add_epi64(swapped, product));
+        }
+    }
+    for (int j = 0; j < kLanes / 2; ++j) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * j), lanes[j]);
+    }
+}
+#endif
+
+#if defined(CAMERAX_TARGET_AVX2)
+// The SSE2 loop on twice the lanes per register; the shuffles stay within 128-bit halves.
+__attribute__((target("avx2")))
+void AccumulateStripesAvx2(uint64_t* acc, const uint8_t* p, int stripe_count) {
+    __m256i lanes[kLanes / 4];
+    __m256i keys[kLanes / 4];
+    for (int j = 0; j < kLanes / 4; ++j) {
+        lanes[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + 4 * j));
+        keys[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kKey + 4 * j));
+    }
+    for (int s = 0; s < stripe_count; ++s, p += kStripeBytes) {
+        for (int j = 0; j < kLanes / 4; ++j) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * j));
+            const __m256i key = _mm256_xor_si256(data, keys[j]);
+            const __m256i product =
+                    _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+            const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[j] = _mm256_add_epi64(lanes[j], _mm256_add_epi64(swapped, product));
+        }
+    }
+    for (int j = 0; j < kLanes / 4; ++j) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4 * j), lanes[j]);
+    }
+}
+#endif
+
+typedef void (*AccumulateStripesFn)(uint64_t*, const uint8_t*, int);
+
+AccumulateStripesFn SelectAccumulateStripes() {
+    switch (GetKernelImpl(Kernel::kPlaneHash)) {
+#if defined(CAMERAX_TARGET_AVX2)
+        case KernelImpl::kAvx2:
+            return AccumulateStripesAvx2;
+#endif
+#if defined(CAMERAX_HASH_NEON) || defined(CAMERAX_HASH_SSE2)
+        case KernelImpl::kNeon:
+        case KernelImpl::kSse2:
+            return AccumulateStripesSimd;
+#endif
+        default:
+            return AccumulateStripesScalar;
+    }
+}
+
+void Scramble(uint64_t* acc) {
+    for (int i = 0; i < kLanes; ++i) {
+        acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ kKey[(i + 3) % kLanes]) * kPrime32_1;
+    }
+}
+
+uint64_t Mul128Fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    // 32-bit targets, e.g. armeabi-v7a, lack a 128-bit type.
+    const uint64_t lo_lo = (a & 0xFFFFFFFFU) * (b & 0xFFFFFFFFU);
+    const uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFU);
+    const uint64_t lo_hi = (a & 0xFFFFFFFFU) * (b >> 32);
+    const uint64_t hi_hi = (a >> 32) * (b >> 32);
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFU) + lo_hi;
+    const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFU);
+    return lower ^ upper;
+#endif
+}
+
+// Streams rows into the lanes stripe by stripe, scrambling every kStripesPerScramble stripes.
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed)
+            : acc_{kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2,
+                   kPrime64_5, kPrime32_1},
+              accumulate_(SelectAccumulateStripes()) {
+        acc_[0] += seed;
+        acc_[1] -= seed;
+    }
+
+    void AddRow(const uint8_t* row, int bytes) {
+        int stripes = bytes / kStripeBytes;
+        while (stripes > 0) {
+            const int run = std::min(stripes, kStripesPerScramble - pending_);
+            accumulate_(acc_, row, run);
+            row += run * kStripeBytes;
+            stripes -= run;
+            AddPending(run);
+        }
+        const int tail = bytes % kStripeBytes;
+        if (tail != 0) {
+            // The last partial stripe is zero padded; the length below tells paddings apart.
+            uint8_t stripe[kStripeBytes] = {};
+            std::memcpy(stripe, row, tail);
+            accumulate_(acc_, stripe, 1);
+            AddPending(1);
+        }
+        length_ += static_cast<uint64_t>(bytes);
+    }
+
+    uint64_t Finish() const {
+        uint64_t hash = length_ * kPrime64_1;
+        for (int i = 0; i < kLanes; i += 2) {
+            hash += Mul128Fold64(acc_[i] ^ kKey[(i + 5) % kLanes],
+                                 acc_[i + 1] ^ kKey[(i + 6) % kLanes]);
+        }
+        hash ^= hash >> 37;
+        hash *= kPrime64_3;
+        return hash ^ (hash >> 32);
+    }
+
+private:
+    void AddPending(int stripes) {
+        pending_ += stripes;
+        if (pending_ == kStripesPerScramble) {
+            Scramble(acc_);
+            pending_ = 0;
+        }
+    }
+
+    uint64_t acc_[kLanes];
+    const AccumulateStripesFn accumulate_;
+    uint64_t length_ = 0;
+    int pending_ = 0;
+};
+
+}  // namespace
+
+uint64_t HashPlane(const Plane& plane, int width, int height, int row_step, uint64_t seed) {
+    row_step = std::max(row_step, 1);
+    // Samples of interleaved planes are hashed along with the bytes between them.
+    const int row_bytes = width > 0 ? (width - 1) * plane.pixel_stride + 1 : 0;
+    Hasher hasher(seed ^ (static_cast<uint64_t>(width) << 32) ^ static_cast<uint64_t>(height));
+    for (int y = 0; y < height; y += row_step) {
+        hasher.AddRow(plane.RowAt(y), row_bytes);
+    }
+    return hasher.Finish();
+}
+
+uint64_t HashAndroid420(const PlanarImage& image, int row_step) {
+    uint64_t hash = HashPlane(image.y, image.width, image.height, row_step, row_step);
+    const int chroma_width = image.chroma_width();
+    const int chroma_height = image.chroma_height();
+    const ChromaLayout layout = image.chroma_layout();
+    if (layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU) {
+        const Plane uv = {std::min(image.u.data, image.v.data), image.u.row_stride, 1};
+        return HashPlane(uv, 2 * chroma_width, chroma_height, row_step, hash);
+    }
+    hash = HashPlane(image.u, chroma_width, chroma_height, row_step, hash);
+    return HashPlane(image.v, chroma_width, chroma_height, row_step, hash);
+}
+
+}  // namespace camerax
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_PLANE_HASH_H_
+#define CAMERA_CORE_PLANE_HASH_H_
+
+#include <cstdint>
+
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Hashes {@code height} rows of a plane, reading the {@code width} samples of each row and
+ * skipping the padding. Only every {@code row_step}-th row is read, 1 reads all of them.
+ *
+ * <p>The mixing follows XXH3: 64-byte stripes are accumulated into eight 64-bit lanes with
+ * 32x32 bit multiplies, which map directly onto NEON, SSE2 and AVX2, and the lanes are scrambled
+ * every 1 KiB. The implementation is picked by {@link GetKernelImpl}; all of them give the same
+ * value. The hash is not the reference XXH3 and is only meant for comparisons within a process.
+ */
+uint64_t HashPlane(const Plane& plane, int width, int height, int row_step, uint64_t seed);
+
+/**
+ * Hashes all planes of an Android420 image, see {@link HashPlane}. Interleaved chroma is read as
+ * one plane, so the same picture hashes differently in different chroma layouts.
+ *
+ * <p>With a {@code row_step} above 1 the hash samples the image: it runs proportionally faster
+ * but misses changes confined to the skipped rows.
+ */
+uint64_t HashAndroid420(const PlanarImage& image, int row_step);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_PLANE_HASH_H_
@@ -0,0 +1,359 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "privacy_mask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_MASK_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_MASK_SSE2 1
+#endif
+
+#include "libyuv/rotate.h"
+
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// Window sums of at most 255 samples of 255, plus the rounding, fit 16 bits.
+constexpr int kMaxBlurRadius = 127;
+// Column sums of a block of at most 257 rows fit 16 bits.
+constexpr int kMaxBlockSize = 256;
+// Stripes are a multiple of this many columns or rows, the widest SIMD step.
+constexpr int kStripeAlignment = 16;
+// Regions with fewer samples are masked on the calling thread, where waking the pool costs
+// more than it saves.
+constexpr int kMinParallelSamples = 64 * 1024;
+
+// The effect on one plane, in its samples.
+struct Effect {
+    MaskMode mode;
+    // Box radius and number of box passes of a blur.
+    int radius;
+    int passes;
+    // Block size of a mosaic.
+    int block;
+};
+
+Effect ComputeEffect(MaskMode mode, double size) {
+    Effect effect = {mode, 1, 1, 1};
+    if (mode == MaskMode::kGaussianBlur) {
+        // Three boxes of radius r have a variance of r * (r + 1).
+        effect.radius = static_cast<int>(std::lround((std::sqrt(1 + 4 * size * size) - 1) / 2));
+        effect.passes = 3;
+    } else {
+        effect.radius = static_cast<int>(std::lround(size));
+    }
+    effect.radius = std::min(std::max(effect.radius, 1), kMaxBlurRadius);
+    effect.block = std::min(std::max(static_cast<int>(std::lround(size)), 1), kMaxBlockSize);
+    return effect;
+}
+
+// Adds the width samples of row to sums.
+void AddRow(const uint8_t* row, int width, bool simd, uint16_t* sums) {
+    int x = 0;
+#if defined(CAMERAX_MASK_NEON)
+    for (; simd && x + 16 <= width; x += 16) {
+        const uint8x16_t samples = vld1q_u8(row + x);
+        vst1q_u16(sums + x, vaddw_u8(vld1q_u16(sums + x), vget_low_u8(samples)));
+        vst1q_u16(sums + x + 8, vaddw_u8(vld1q_u16(sums + x + 8), vget_high_u8(samples)));
+    }
+#elif defined(CAMERAX_MASK_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; simd && x + 16 <= width; x += 16) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        __m128i* low = reinterpret_cast<__m128i*>(sums + x);
+        __m128i* high = reinterpret_cast<__m128i*>(sums + x + 8);
+        _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low),
+                                            _mm_unpacklo_epi8(samples, zero)));
+        _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high),
+                                             _mm_unpackhi_epi8(samples, zero)));
+    }
+#endif
+    for (; x < width; ++x) {
+        sums[x] = static_cast<uint16_t>(sums[x] + row[x]);
+    }
+}
+
+// Writes the window means of sums to out, then slides the windows down by a row: adds the
+// row entering them and subtracts the one leaving. Dividing by the window is a multiplication
+// by 65536 / window, which keeps the SIMD lanes at 16 bits.
+void StepRow(uint16_t* sums, const uint8_t* entering, const uint8_t* leaving, int width,
+             int radius, uint16_t reciprocal, bool simd, uint8_t* out) {
+    int x = 0;
+#if defined(CAMERAX_MASK_NEON)
+    const uint16x8_t rounding = vdupq_n_u16(static_cast<uint16_t>(radius));
+    const uint16x4_t factor = vdup_n_u16(reciprocal);
+    for (; simd && x + 16 <= width; x += 16) {
+        const uint16x8_t low = vld1q_u16(sums + x);
+        const uint16x8_t high = vld1q_u16(sums + x + 8);
+        const uint16x8_t low_rounded = vaddq_u16(low, rounding);
+        const uint16x8_t high_rounded = vaddq_u16(high, rounding);
+        const uint16x8_t low_mean = vcombine_u16(
+                vshrn_n_u32(vmull_u16(vget_low_u16(low_rounded), factor), 16),
+                vshrn_n_u32(vmull_u16(vget_high_u16(low_rounded), factor), 16));
+        const uint16x8_t high_mean = vcombine_u16(
+                vshrn_n_u32(vmull_u16(vget_low_u16(high_rounded), factor), 16),
+                vshrn_n_u32(vmull_u16(vget_high_u16(high_rounded), factor), 16));
+        vst1q_u8(out + x, vcombine_u8(vmovn_u16(low_mean), vmovn_u16(high_mean)));
+        const uint8x16_t in = vld1q_u8(entering + x);
+        const uint8x16_t gone = vld1q_u8(leaving + x);
+        vst1q_u16(sums + x, vsubw_u8(vaddw_u8(low, vget_low_u8(in)), vget_low_u8(gone)));
+        vst1q_u16(sums + x + 8, vsubw_u8(vaddw_u8(high, vget_high_u8(in)), vget_high_u8(gone)));
+    }
+#elif defined(CAMERAX_MASK_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(static_cast<int16_t>(radius));
+    const __m128i factor = _mm_set1_epi16(static_cast<int16_t>(reciprocal));
+    for (; simd && x + 16 <= width; x += 16) {
+        __m128i* low_sums = reinterpret_cast<__m128i*>(sums + x);
+        __m128i* high_sums = reinterpret_cast<__m128i*>(sums + x + 8);
+        const __m128i low = _mm_loadu_si128(low_sums);
+        const __m128i high = _mm_loadu_si128(high_sums);
+        const __m128i low_mean = _mm_mulhi_epu16(_mm_add_epi16(low, rounding), factor);
+        const __m128i high_mean = _mm_mulhi_epu16(_mm_add_epi16(high, rounding), factor);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x),
+                         _mm_packus_epi16(low_mean, high_mean));
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entering + x));
+        const __m128i gone = _mm_loadu_si128(reinterpret_cast<const __m128i*>(leaving + x));
+        // The sums wrap as 16-bit values in between, but end up in range.
+        _mm_storeu_si128(low_sums, _mm_sub_epi16(_mm_add_epi16(low, _mm_unpacklo_epi8(in, zero)),
+                                                 _mm_unpacklo_epi8(gone, zero)));
+        _mm_storeu_si128(high_sums,
+                         _mm_sub_epi16(_mm_add_epi16(high, _mm_unpackhi_epi8(in, zero)),
+                                       _mm_unpackhi_epi8(gone, zero)));
+    }
+#endif
+    for (; x < width; ++x) {
+        out[x] = static_cast<uint8_t>(((sums[x] + radius) * reciprocal) >> 16);
+        sums[x] = static_cast<uint16_t>(sums[x] + entering[x] - leaving[x]);
+    }
+}
+
+// Box filters the width columns of the height rows of src into dst, repeating the first and
+// last row beyond the edges.
+void BoxColumns(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride, int width,
+                int height, int radius, bool simd, uint16_t* sums) {
+    const auto row = [&](int y) {
+        return src + static_cast<ptrdiff_t>(std::min(std::max(y, 0), height - 1)) * src_stride;
+    };
+    const uint16_t reciprocal = static_cast<uint16_t>(65536 / (2 * radius + 1));
+    std::fill(sums, sums + width, 0);
+    for (int y = -radius; y <= radius; ++y) {
+        AddRow(row(y), width, simd, sums);
+    }
+    for (int y = 0; y < height; ++y) {
+        StepRow(sums, row(y + radius + 1), row(y - radius), width, radius, reciprocal, simd,
+                dst + static_cast<ptrdiff_t>(y) * dst_stride);
+    }
+}
+
+// Runs the passes of a blur over columns [begin, end) of src, ping-ponging between buf_a and
+// buf_b, which have a row stride of stride. Returns the buffer holding the result.
+uint8_t* BlurColumns(const uint8_t* src, int src_stride, int begin, int end, int rows,
+                     const Effect& effect, bool simd, uint8_t* buf_a, uint8_t* buf_b,
+                     int stride) {
+    std::vector<uint16_t> sums(end - begin);
+    uint8_t* out = buf_a;
+    uint8_t* spare = buf_b;
+    for (int pass = 0; pass < effect.passes; ++pass) {
+        BoxColumns(src, src_stride, out + begin, stride, end - begin, rows, effect.radius, simd,
+                   sums.data());
+        src = out + begin;
+        src_stride = stride;
+        std::swap(out, spare);
+    }
+    return spare;
+}
+
+// Blurs the width x height samples of region. The columns are blurred first, straight from the
+// plane if its samples are adjacent. The result is transposed, so that the rows can be blurred
+// as columns, and transposed back into place.
+void BlurRegion(const Plane& region, int width, int height, const Effect& effect, bool simd,
+                StripePool* pool, std::vector<uint8_t>* buffer) {
+    const size_t area = static_cast<size_t>(width) * height;
+    buffer->resize(3 * area);
+    uint8_t* buf_a = buffer->data();
+    uint8_t* buf_b = buf_a + area;
+    uint8_t* transposed = buf_b + area;
+    const bool adjacent = region.pixel_stride == 1;
+
+    uint8_t* columns_done = nullptr;
+    RunRowStripes(pool, width, kStripeAlignment, [&](int begin, int end) {
+        const uint8_t* src = region.data + begin;
+        int src_stride = region.row_stride;
+        if (!adjacent) {
+            for (int y = 0; y < height; ++y) {
+                const uint8_t* in = region.RowAt(y);
+                uint8_t* out = buf_b + static_cast<size_t>(y) * width;
+                for (int x = begin; x < end; ++x) {
+                    out[x] = in[x * region.pixel_stride];
+                }
+            }
+            src = buf_b + begin;
+            src_stride = width;
+        }
+        // Every stripe ends in the same buffer, as the number of passes is the same.
+        uint8_t* result = BlurColumns(src, src_stride, begin, end, height, effect, simd, buf_a,
+                                      buf_b, width);
+        if (begin == 0) {
+            columns_done = result;
+        }
+    });
+
+    // The transposed region has width rows of height samples. Each stripe owns rows
+    // [begin, end) of the region, i.e. columns of the transposed region.
+    uint8_t* spare = columns_done == buf_a ? buf_b : buf_a;
+    RunRowStripes(pool, height, kStripeAlignment, [&](int begin, int end) {
+        const int rows = end - begin;
+        libyuv::TransposePlane(columns_done + static_cast<size_t>(begin) * width, width,
+                               transposed + begin, height, width, rows);
+        const uint8_t* result = BlurColumns(transposed + begin, height, begin, end, width,
+                                            effect, simd, spare, transposed, height);
+        if (adjacent) {
+            libyuv::TransposePlane(result + begin, height, region.RowAt(begin), region.row_stride,
+                                   rows, width);
+            return;
+        }
+        uint8_t* rows_out = columns_done + static_cast<size_t>(begin) * width;
+        libyuv::TransposePlane(result + begin, height, rows_out, width, rows, width);
+        for (int y = 0; y < rows; ++y) {
+            uint8_t* out = region.RowAt(begin + y);
+            const uint8_t* in = rows_out + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                out[x * region.pixel_stride] = in[x];
+            }
+        }
+    });
+}
+
+// Fills every block of the width x height samples of region with its mean. Blocks start at the
+// top left corner of the region and are cut at its right and bottom edges.
+void PixelateRegion(const Plane& region, int width, int height, int block, bool simd,
+                    StripePool* pool) {
+    RunRowStripes(pool, height, block, [&](int begin, int end) {
+        std::vector<uint16_t> sums(width);
+        std::vector<uint8_t> means(width);
+        std::vector<uint8_t> gathered(region.pixel_stride == 1 ? 0 : width);
+        for (int top = begin; top < end; top += block) {
+            const int rows = std::min(block, end - top);
+            std::fill(sums.begin(), sums.end(), 0);
+            for (int y = top; y < top + rows; ++y) {
+                const uint8_t* row = region.RowAt(y);
+                if (region.pixel_stride != 1) {
+                    for (int x = 0; x < width; ++x) {
+                        gathered[x] = row[x * region.pixel_stride];
+                    }
+                    row = gathered.data();
+                }
+                AddRow(row, width, simd, sums.data());
+            }
+            for (int left = 0; left < width; left += block) {
+                const int columns = std::min(block, width - left);
+                uint32_t total = 0;
+                for (int x = left; x < left + columns; ++x) {
+                    total += sums[x];
+                }
+                const uint32_t count = static_cast<uint32_t>(rows * columns);
+                std::fill_n(means.begin() + left, columns,
+                            static_cast<uint8_t>((total + count / 2) / count));
+            }
+            for (int y = top; y < top + rows; ++y) {
+                uint8_t* row = region.RowAt(y);
+                if (region.pixel_stride == 1) {
+                    memcpy(row, means.data(), width);
+                    continue;
+                }
+                for (int x = 0; x < width; ++x) {
+                    row[x * region.pixel_stride] = means[x];
+                }
+            }
+        }
+    });
+}
+
+void MaskPlane(const Plane& plane, int left, int top, int right, int bottom,
+               const Effect& effect, bool simd, StripePool* pool,
+               std::vector<uint8_t>* buffer) {
+    const int width = right - left;
+    const int height = bottom - top;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    const Plane region = {plane.RowAt(top) + left * plane.pixel_stride, plane.row_stride,
+                          plane.pixel_stride};
+    if (static_cast<size_t>(width) * height < kMinParallelSamples) {
+        pool = nullptr;
+    }
+    if (effect.mode == MaskMode::kPixelate) {
+        PixelateRegion(region, width, height, effect.block, simd, pool);
+    } else {
+        BlurRegion(region, width, height, effect, simd, pool, buffer);
+    }
+}
+
+}  // namespace
+
+int MaskRegions(const PlanarImage& image, const MaskRegion* regions, int count,
+                const MaskOptions& options, StripePool* pool) {
+    if (!image.IsValid() || image.subsampling != ChromaSubsampling::k420 || count < 0
+        || (count > 0 && regions == nullptr) || options.size < 1
+        || (options.mode != MaskMode::kBoxBlur && options.mode != MaskMode::kGaussianBlur
+            && options.mode != MaskMode::kPixelate)) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kMask) != KernelImpl::kScalar;
+    const Effect luma_effect = ComputeEffect(options.mode, options.size);
+    const Effect chroma_effect = ComputeEffect(options.mode, options.size / 2.0);
+    std::vector<uint8_t> buffer;
+    for (int i = 0; i < count; ++i) {
+        const MaskRegion& region = regions[i];
+        // Grown to even edges, so that every chroma sample the region touches is masked.
+        int left = std::max(region.left, 0);
+        int top = std::max(region.top, 0);
+        left -= left & 1;
+        top -= top & 1;
+        int64_t right = std::min<int64_t>(static_cast<int64_t>(region.left) + region.width,
+                                          image.width);
+        int64_t bottom = std::min<int64_t>(static_cast<int64_t>(region.top) + region.height,
+                                           image.height);
+        if (right <= left || bottom <= top) {
+            continue;
+        }
+        right = std::min<int64_t>(right + (right & 1), image.width);
+        bottom = std::min<int64_t>(bottom + (bottom & 1), image.height);
+        MaskPlane(image.y, left, top, static_cast<int>(right), static_cast<int>(bottom),
+                  luma_effect, simd, pool, &buffer);
+        const int chroma_right = static_cast<int>((right + 1) / 2);
+        const int chroma_bottom = static_cast<int>((bottom + 1) / 2);
+        MaskPlane(image.u, left / 2, top / 2, chroma_right, chroma_bottom, chroma_effect, simd,
+                  pool, &buffer);
+        MaskPlane(image.v, left / 2, top / 2, chroma_right, chroma_bottom, chroma_effect, simd,
+                  pool, &buffer);
+    }
+    return 0;
+}
+
+}  // namespace camerax
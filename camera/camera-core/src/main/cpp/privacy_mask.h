@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_PRIVACY_MASK_H_
+#define CAMERA_CORE_PRIVACY_MASK_H_
+
+#include "image_planes.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * How {@link MaskRegions} hides the content of a region.
+ */
+enum class MaskMode {
+    // A box blur of radius size.
+    kBoxBlur = 0,
+    // A blur with a standard deviation of size, approximated by three box blurs.
+    kGaussianBlur = 1,
+    // Blocks of size x size pixels filled with their mean.
+    kPixelate = 2,
+};
+
+struct MaskOptions {
+    MaskMode mode = MaskMode::kGaussianBlur;
+    // Strength of the effect in luma pixels, see MaskMode. Chroma uses half of it. Blurs are
+    // limited to 127 and blocks to 256.
+    int size = 16;
+};
+
+/**
+ * A rectangle of an image in pixels.
+ */
+struct MaskRegion {
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * Blurs or pixelates the {@code count} regions of the 4:2:0 image {@code image} in place, e.g.
+ * to hide faces and license plates. Any chroma layout works. Regions are grown to even
+ * coordinates, so that chroma is hidden as well, and clipped to the image; only their samples
+ * are read and written. Blurs only see the samples of their region, whose edges are repeated.
+ *
+ * <p>A blur runs as separable passes of running sums, so its cost does not grow with the size.
+ * Columns are summed with SIMD; rows are transposed so that they can be summed the same way.
+ * The passes over large regions are split into stripes that run on {@code pool}, which may be
+ * null to run on the calling thread.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+int MaskRegions(const PlanarImage& image, const MaskRegion* regions, int count,
+                const MaskOptions& options, StripePool* pool);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_PRIVACY_MASK_H_
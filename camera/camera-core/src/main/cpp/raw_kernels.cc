@@ -0,0 +1,503 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "raw_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_RAW_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_RAW_SSE2 1
+#endif
+
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// Output rows a demosaic stripe produces at a time.
+constexpr int kBandRows = 16;
+// Rows and columns around a demosaiced pixel that are read: two for the green gradients, one
+// more row for the red and blue of the rows next to a band.
+constexpr int kLinearPad = 2;
+constexpr int kBandMargin = 3;
+// Entries of the transfer curves, indexed by the top 12 bits of a linear sample.
+constexpr int kCurveSize = 4096;
+
+enum Color { kRed = 0, kGreen = 1, kBlue = 2 };
+
+// Colors of the four positions of a 2x2 block, in row major order, for every CfaPattern.
+constexpr int kPatternColors[4][4] = {
+        {kRed, kGreen, kGreen, kBlue},
+        {kGreen, kRed, kBlue, kGreen},
+        {kGreen, kBlue, kRed, kGreen},
+        {kBlue, kGreen, kGreen, kRed},
+};
+
+// RawDevelopOptions resolved for the four positions of a 2x2 block.
+struct DevelopParams {
+    int colors[4];
+    // The linear value of every sensor value up to the white level, for each position. A table
+    // lookup is cheaper than the subtraction, scaling and clamping it replaces.
+    std::vector<uint16_t> linear[4];
+    int white;
+    const uint8_t* curve;
+};
+
+// Maps 12-bit linear values to 8 bits, with the sRGB transfer curve if gamma is set.
+const uint8_t* TransferCurve(bool gamma) {
+    static const std::vector<uint8_t> curves = [] {
+        std::vector<uint8_t> table(2 * kCurveSize);
+        for (int i = 0; i < kCurveSize; ++i) {
+            const double linear = static_cast<double>(i) / (kCurveSize - 1);
+            const double encoded = linear <= 0.0031308
+                    ? 12.92 * linear : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            table[i] = static_cast<uint8_t>(std::lround(linear * 255));
+            table[kCurveSize + i] = static_cast<uint8_t>(std::lround(encoded * 255));
+        }
+        return table;
+    }();
+    return curves.data() + (gamma ? kCurveSize : 0);
+}
+
+bool ResolveOptions(const RawDevelopOptions& options, DevelopParams* params) {
+    const int pattern = static_cast<int>(options.pattern);
+    if (pattern < 0 || pattern > 3) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        const int color = kPatternColors[pattern][i];
+        const float gain = color == kRed ? options.gains[0]
+                : color == kBlue ? options.gains[3]
+                : options.gains[i < 2 ? 1 : 2];
+        const int black = options.black_level[i];
+        if (!(gain > 0.0f) || black < 0 || black >= options.white_level
+            || options.white_level > 65535) {
+            return false;
+        }
+        params->colors[i] = color;
+        const float scale = gain * 65535.0f / static_cast<float>(options.white_level - black);
+        std::vector<uint16_t>& table = params->linear[i];
+        table.resize(options.white_level + 1);
+        for (int value = 0; value <= options.white_level; ++value) {
+            const float linear = static_cast<float>(value - black) * scale;
+            table[value] = linear <= 0.0f ? 0 : linear >= 65535.0f ? 65535
+                    : static_cast<uint16_t>(linear + 0.5f);
+        }
+    }
+    params->white = options.white_level;
+    params->curve = TransferCurve(options.apply_gamma);
+    return true;
+}
+
+// Unpacks a RAW10 row. Every 5 bytes hold the high bits of 4 pixels and then their low bits,
+// those of the first pixel in the lowest 2 bits.
+void UnpackRaw10Row(const uint8_t* src, int width, bool simd, uint16_t* dst) {
+    const int row_bytes = width / 4 * 5;
+    int x = 0;
+    int i = 0;
+    // Every iteration unpacks 8 pixels from 10 bytes but loads 16, so it stops early enough
+    // not to read past the row.
+#if defined(CAMERAX_RAW_NEON)
+    static const uint8_t kHighIndex[8] = {0, 1, 2, 3, 5, 6, 7, 8};
+    static const uint8_t kLowIndex[8] = {4, 4, 4, 4, 9, 9, 9, 9};
+    static const int16_t kLowShift[8] = {0, -2, -4, -6, 0, -2, -4, -6};
+    const uint8x8_t high_index = vld1_u8(kHighIndex);
+    const uint8x8_t low_index = vld1_u8(kLowIndex);
+    const int16x8_t low_shift = vld1q_s16(kLowShift);
+    for (; simd && i + 16 <= row_bytes; i += 10, x += 8) {
+        const uint8x16_t bytes = vld1q_u8(src + i);
+        uint8x8x2_t table;
+        table.val[0] = vget_low_u8(bytes);
+        table.val[1] = vget_high_u8(bytes);
+        uint16x8_t high = vshlq_n_u16(vmovl_u8(vtbl2_u8(table, high_index)), 2);
+        uint16x8_t low = vandq_u16(vshlq_u16(vmovl_u8(vtbl2_u8(table, low_index)), low_shift),
+                                   vdupq_n_u16(3));
+        vst1q_u16(dst + x, vorrq_u16(high, low));
+    }
+#elif defined(CAMERAX_RAW_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    // Shifting the low bits byte left by 6 - 2k and then right by 6 moves the bits of pixel k
+    // down without per lane shifts.
+    const __m128i low_scale = _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1);
+    const __m128i low_mask = _mm_set1_epi16(3);
+    for (; simd && i + 16 <= row_bytes; i += 10, x += 8) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i high = _mm_unpacklo_epi64(_mm_unpacklo_epi8(bytes, zero),
+                                          _mm_unpacklo_epi8(_mm_srli_si128(bytes, 5), zero));
+        // Bytes 4 to 11 as 16-bit lanes, the low bits are in lanes 0 and 5.
+        __m128i low_bytes = _mm_unpacklo_epi8(_mm_srli_si128(bytes, 4), zero);
+        __m128i low = _mm_unpacklo_epi64(_mm_shufflelo_epi16(low_bytes, 0),
+                                         _mm_shufflelo_epi16(_mm_srli_si128(low_bytes, 10), 0));
+        low = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(low, low_scale), 6), low_mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_or_si128(_mm_slli_epi16(high, 2), low));
+    }
+#endif
+    for (; x < width; i += 5, x += 4) {
+        const int low = src[i + 4];
+        dst[x] = static_cast<uint16_t>((src[i] << 2) | (low & 3));
+        dst[x + 1] = static_cast<uint16_t>((src[i + 1] << 2) | ((low >> 2) & 3));
+        dst[x + 2] = static_cast<uint16_t>((src[i + 2] << 2) | ((low >> 4) & 3));
+        dst[x + 3] = static_cast<uint16_t>((src[i + 3] << 2) | (low >> 6));
+    }
+}
+
+// Unpacks a RAW12 row. Every 3 bytes hold the high bits of 2 pixels and then their low bits,
+// those of the first pixel in the low nibble.
+void UnpackRaw12Row(const uint8_t* src, int width, bool simd, uint16_t* dst) {
+    const int row_bytes = width / 2 * 3;
+    int x = 0;
+    int i = 0;
+#if defined(CAMERAX_RAW_NEON)
+    static const uint8_t kHighIndex[8] = {0, 1, 3, 4, 6, 7, 9, 10};
+    static const uint8_t kLowIndex[8] = {2, 2, 5, 5, 8, 8, 11, 11};
+    static const int16_t kLowShift[8] = {0, -4, 0, -4, 0, -4, 0, -4};
+    const uint8x8_t high_index = vld1_u8(kHighIndex);
+    const uint8x8_t low_index = vld1_u8(kLowIndex);
+    const int16x8_t low_shift = vld1q_s16(kLowShift);
+    for (; simd && i + 16 <= row_bytes; i += 12, x += 8) {
+        const uint8x16_t bytes = vld1q_u8(src + i);
+        uint8x8x2_t table;
+        table.val[0] = vget_low_u8(bytes);
+        table.val[1] = vget_high_u8(bytes);
+        uint16x8_t high = vshlq_n_u16(vmovl_u8(vtbl2_u8(table, high_index)), 4);
+        uint16x8_t low = vandq_u16(vshlq_u16(vmovl_u8(vtbl2_u8(table, low_index)), low_shift),
+                                   vdupq_n_u16(15));
+        vst1q_u16(dst + x, vorrq_u16(high, low));
+    }
+#elif defined(CAMERAX_RAW_SSE2)
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i nibble_mask = _mm_set1_epi32(0xF);
+    for (; simd && i + 16 <= row_bytes; i += 12, x += 8) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Every 32-bit lane gets the 3 bytes of one pair of pixels.
+        const __m128i pairs = _mm_unpacklo_epi64(
+                _mm_unpacklo_epi32(bytes, _mm_srli_si128(bytes, 3)),
+                _mm_unpacklo_epi32(_mm_srli_si128(bytes, 6), _mm_srli_si128(bytes, 9)));
+        __m128i first = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(pairs, byte_mask), 4),
+                                     _mm_and_si128(_mm_srli_epi32(pairs, 16), nibble_mask));
+        __m128i second = _mm_or_si128(
+                _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(pairs, 8), byte_mask), 4),
+                _mm_and_si128(_mm_srli_epi32(pairs, 20), nibble_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_or_si128(first, _mm_slli_epi32(second, 16)));
+    }
+#endif
+    for (; x < width; i += 3, x += 2) {
+        const int low = src[i + 2];
+        dst[x] = static_cast<uint16_t>((src[i] << 4) | (low & 15));
+        dst[x + 1] = static_cast<uint16_t>((src[i + 1] << 4) | (low >> 4));
+    }
+}
+
+void UnpackRow(const RawImage& src, int y, bool simd, uint16_t* dst) {
+    const uint8_t* row = src.data + static_cast<ptrdiff_t>(y) * src.row_stride;
+    switch (src.format) {
+        case RawFormat::kRaw10:
+            UnpackRaw10Row(row, src.width, simd, dst);
+            break;
+        case RawFormat::kRaw12:
+            UnpackRaw12Row(row, src.width, simd, dst);
+            break;
+        case RawFormat::kRaw16:
+            memcpy(dst, row, static_cast<size_t>(src.width) * 2);
+            break;
+    }
+}
+
+// Applies the black level and white balance to a row of unpacked samples in place, see
+// LinearizeRaw.
+void LinearizeRow(const DevelopParams& params, int y, int width, uint16_t* row) {
+    const uint16_t* even = params.linear[(y & 1) * 2].data();
+    const uint16_t* odd = params.linear[(y & 1) * 2 + 1].data();
+    const int white = params.white;
+    for (int x = 0; x < width; x += 2) {
+        row[x] = even[std::min<int>(row[x], white)];
+        row[x + 1] = odd[std::min<int>(row[x + 1], white)];
+    }
+}
+
+// Unpacks and linearizes source row y, mirrored at the top and bottom, into row, whose
+// kLinearPad samples on either side receive mirrored columns.
+void LoadLinearRow(const RawImage& src, const DevelopParams& params, int y, bool simd,
+                   uint16_t* row) {
+    if (y < 0) {
+        y = -y;
+    } else if (y >= src.height) {
+        y = 2 * src.height - 2 - y;
+    }
+    uint16_t* samples = row + kLinearPad;
+    UnpackRow(src, y, simd, samples);
+    LinearizeRow(params, y, src.width, samples);
+    for (int k = 1; k <= kLinearPad; ++k) {
+        samples[-k] = samples[k];
+        samples[src.width - 1 + k] = samples[src.width - 1 - k];
+    }
+}
+
+uint16_t Clamp16(int value) {
+    return static_cast<uint16_t>(std::min(std::max(value, 0), 65535));
+}
+
+void StoreABGR(const uint8_t* curve, int r, int g, int b, uint8_t* out) {
+    out[0] = curve[r >> 4];
+    out[1] = curve[g >> 4];
+    out[2] = curve[b >> 4];
+    out[3] = 255;
+}
+
+// Interpolates the green of row y from the linear rows y - 2 to y + 2, with the center row
+// rows[2]. green has one mirrored column on either side.
+void InterpolateGreenRow(const DevelopParams& params, const uint16_t* const rows[5], int y,
+                         int width, bool edge_aware, uint16_t* green) {
+    const uint16_t* up2 = rows[0];
+    const uint16_t* up = rows[1];
+    const uint16_t* center = rows[2];
+    const uint16_t* down = rows[3];
+    const uint16_t* down2 = rows[4];
+    // Every row of a Bayer mosaic has green at either the even or the odd columns.
+    const int green_column = params.colors[(y & 1) * 2] == kGreen ? 0 : 1;
+    for (int x = green_column; x < width; x += 2) {
+        green[x] = center[x];
+    }
+    for (int x = 1 - green_column; x < width; x += 2) {
+        const int left = center[x - 1];
+        const int right = center[x + 1];
+        const int above = up[x];
+        const int below = down[x];
+        if (!edge_aware) {
+            green[x] = static_cast<uint16_t>((left + right + above + below + 2) >> 2);
+            continue;
+        }
+        // Green along each axis, corrected by the second derivative of the center color.
+        const int laplacian_h = 2 * center[x] - center[x - 2] - center[x + 2];
+        const int laplacian_v = 2 * center[x] - up2[x] - down2[x];
+        const int gradient_h = std::abs(left - right) + std::abs(laplacian_h);
+        const int gradient_v = std::abs(above - below) + std::abs(laplacian_v);
+        const int sum_h = 2 * (left + right) + laplacian_h;
+        const int sum_v = 2 * (above + below) + laplacian_v;
+        const int sum = gradient_h < gradient_v ? 2 * sum_h
+                : gradient_v < gradient_h ? 2 * sum_v : sum_h + sum_v;
+        green[x] = Clamp16((sum + 4) >> 3);
+    }
+    green[-1] = green[1];
+    green[width] = green[width - 2];
+}
+
+// Writes output row y from the linear rows y - 1 to y + 1 and their greens.
+void DemosaicRow(const DevelopParams& params, const uint16_t* const linear[3],
+                 const uint16_t* const green[3], int y, int width, bool edge_aware,
+                 uint8_t* out) {
+    const uint16_t* l0 = linear[0];
+    const uint16_t* l1 = linear[1];
+    const uint16_t* l2 = linear[2];
+    const uint16_t* g0 = green[0];
+    const uint16_t* g1 = green[1];
+    const uint16_t* g2 = green[2];
+    const int block_row = (y & 1) * 2;
+    for (int x = 0; x < width; ++x, out += 4) {
+        const int color = params.colors[block_row + (x & 1)];
+        int rgb[3];
+        if (color == kGreen) {
+            // Red and blue are the horizontal and the vertical neighbors, in either order.
+            const int horizontal = params.colors[block_row + ((x + 1) & 1)];
+            int h;
+            int v;
+            if (edge_aware) {
+                h = Clamp16((2 * g1[x] + l1[x - 1] - g1[x - 1] + l1[x + 1] - g1[x + 1] + 1) >> 1);
+                v = Clamp16((2 * g1[x] + l0[x] - g0[x] + l2[x] - g2[x] + 1) >> 1);
+            } else {
+                h = (l1[x - 1] + l1[x + 1] + 1) >> 1;
+                v = (l0[x] + l2[x] + 1) >> 1;
+            }
+            rgb[kGreen] = l1[x];
+            rgb[horizontal] = h;
+            rgb[kRed + kBlue - horizontal] = v;
+        } else {
+            // The other of red and blue sits on the diagonals.
+            int diagonal;
+            if (edge_aware) {
+                diagonal = Clamp16((4 * g1[x] + l0[x - 1] - g0[x - 1] + l0[x + 1] - g0[x + 1]
+                                    + l2[x - 1] - g2[x - 1] + l2[x + 1] - g2[x + 1] + 2) >> 2);
+            } else {
+                diagonal = (l0[x - 1] + l0[x + 1] + l2[x - 1] + l2[x + 1] + 2) >> 2;
+            }
+            rgb[color] = l1[x];
+            rgb[kGreen] = g1[x];
+            rgb[kRed + kBlue - color] = diagonal;
+        }
+        StoreABGR(params.curve, rgb[kRed], rgb[kGreen], rgb[kBlue], out);
+    }
+}
+
+}  // namespace
+
+int RawImage::row_bytes() const {
+    switch (format) {
+        case RawFormat::kRaw10:
+            return width / 4 * 5;
+        case RawFormat::kRaw12:
+            return width / 2 * 3;
+        case RawFormat::kRaw16:
+            return width * 2;
+    }
+    return 0;
+}
+
+bool RawImage::IsValid() const {
+    return data != nullptr && width >= 4 && height >= 4 && width % 2 == 0 && height % 2 == 0
+            && (format != RawFormat::kRaw10 || width % 4 == 0)
+            && (format == RawFormat::kRaw10 || format == RawFormat::kRaw12
+                || format == RawFormat::kRaw16)
+            && row_stride >= row_bytes();
+}
+
+int UnpackRaw(const RawImage& src, uint16_t* dst, int dst_stride, StripePool* pool) {
+    if (!src.IsValid() || dst == nullptr || dst_stride < src.width) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kRawUnpack) != KernelImpl::kScalar;
+    RunRowStripes(pool, src.height, 2, [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            UnpackRow(src, y, simd, dst + static_cast<ptrdiff_t>(y) * dst_stride);
+        }
+    });
+    return 0;
+}
+
+int LinearizeRaw(const RawImage& src, const RawDevelopOptions& options, uint16_t* dst,
+                 int dst_stride, StripePool* pool) {
+    DevelopParams params;
+    if (!src.IsValid() || !ResolveOptions(options, &params) || dst == nullptr
+        || dst_stride < src.width) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kRawUnpack) != KernelImpl::kScalar;
+    RunRowStripes(pool, src.height, 2, [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            uint16_t* row = dst + static_cast<ptrdiff_t>(y) * dst_stride;
+            UnpackRow(src, y, simd, row);
+            LinearizeRow(params, y, src.width, row);
+        }
+    });
+    return 0;
+}
+
+int BinRawToABGR(const RawImage& src, const RawDevelopOptions& options, uint8_t* dst_abgr,
+                 int dst_stride_abgr, StripePool* pool) {
+    DevelopParams params;
+    if (!src.IsValid() || !ResolveOptions(options, &params) || dst_abgr == nullptr) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kRawUnpack) != KernelImpl::kScalar;
+    const int width = src.width;
+    // Offsets of the colors of a 2x2 block in the two rows that hold it.
+    int red = 0;
+    int blue = 0;
+    int greens[2];
+    for (int i = 0, g = 0; i < 4; ++i) {
+        const int offset = (i >> 1) * width + (i & 1);
+        if (params.colors[i] == kRed) {
+            red = offset;
+        } else if (params.colors[i] == kBlue) {
+            blue = offset;
+        } else {
+            greens[g++] = offset;
+        }
+    }
+    RunRowStripes(pool, src.height / 2, 1, [&](int top, int bottom) {
+        std::vector<uint16_t> rows(static_cast<size_t>(width) * 2);
+        const uint16_t* block = rows.data();
+        const uint8_t* curve = params.curve;
+        for (int y = top; y < bottom; ++y) {
+            for (int i = 0; i < 2; ++i) {
+                uint16_t* row = rows.data() + static_cast<size_t>(width) * i;
+                UnpackRow(src, 2 * y + i, simd, row);
+                LinearizeRow(params, 2 * y + i, width, row);
+            }
+            uint8_t* out = dst_abgr + static_cast<ptrdiff_t>(y) * dst_stride_abgr;
+            for (int x = 0; x < width; x += 2, out += 4) {
+                StoreABGR(curve, block[red + x],
+                          (block[greens[0] + x] + block[greens[1] + x] + 1) >> 1,
+                          block[blue + x], out);
+            }
+        }
+    });
+    return 0;
+}
+
+int DemosaicRawToABGR(const RawImage& src, const RawDevelopOptions& options, uint8_t* dst_abgr,
+                      int dst_stride_abgr, StripePool* pool) {
+    DevelopParams params;
+    if (!src.IsValid() || !ResolveOptions(options, &params) || dst_abgr == nullptr) {
+        return -1;
+    }
+    const bool simd = GetKernelImpl(Kernel::kRawUnpack) != KernelImpl::kScalar;
+    const bool edge_aware = options.method == DemosaicMethod::kEdgeAware;
+    const int width = src.width;
+    const int linear_stride = width + 2 * kLinearPad;
+    const int green_stride = width + 2;
+    RunRowStripes(pool, src.height, 2, [&](int top, int bottom) {
+        // Linear rows of a band and the margin around it, and the greens of the band and the
+        // rows right above and below it.
+        std::vector<uint16_t> linear(static_cast<size_t>(linear_stride)
+                                     * (kBandRows + 2 * kBandMargin));
+        std::vector<uint16_t> green(static_cast<size_t>(green_stride) * (kBandRows + 2));
+        for (int band_top = top; band_top < bottom; band_top += kBandRows) {
+            const int band_bottom = std::min(bottom, band_top + kBandRows);
+            const int first_linear = band_top - kBandMargin;
+            const int linear_rows = band_bottom - band_top + 2 * kBandMargin;
+            for (int i = 0; i < linear_rows; ++i) {
+                LoadLinearRow(src, params, first_linear + i, simd,
+                              linear.data() + static_cast<size_t>(linear_stride) * i);
+            }
+            // Row y of the band in either buffer, pointing at column 0.
+            auto linear_row = [&](int y) -> const uint16_t* {
+                return linear.data() + static_cast<size_t>(linear_stride) * (y - first_linear)
+                        + kLinearPad;
+            };
+            auto green_row = [&](int y) -> uint16_t* {
+                return green.data() + static_cast<size_t>(green_stride) * (y - band_top + 1) + 1;
+            };
+            for (int y = band_top - 1; y <= band_bottom; ++y) {
+                const uint16_t* const rows[5] = {linear_row(y - 2), linear_row(y - 1),
+                                                 linear_row(y), linear_row(y + 1),
+                                                 linear_row(y + 2)};
+                InterpolateGreenRow(params, rows, y, width, edge_aware, green_row(y));
+            }
+            for (int y = band_top; y < band_bottom; ++y) {
+                const uint16_t* const linear_rows3[3] = {linear_row(y - 1), linear_row(y),
+                                                         linear_row(y + 1)};
+                const uint16_t* const green_rows3[3] = {green_row(y - 1), green_row(y),
+                                                        green_row(y + 1)};
+                DemosaicRow(params, linear_rows3, green_rows3, y, width, edge_aware,
+                            dst_abgr + static_cast<ptrdiff_t>(y) * dst_stride_abgr);
+            }
+        }
+    });
+    return 0;
+}
+
+}  // namespace camerax
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_RAW_KERNELS_H_
+#define CAMERA_CORE_RAW_KERNELS_H_
+
+#include <cstdint>
+
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * Sample packings of Bayer RAW images.
+ */
+enum class RawFormat {
+    // MIPI RAW10: 4 pixels in 5 bytes, the high 8 bits of each followed by a byte of low bits.
+    kRaw10 = 0,
+    // MIPI RAW12: 2 pixels in 3 bytes, the high 8 bits of each followed by a byte of low bits.
+    kRaw12 = 1,
+    // One little endian 16-bit sample per pixel (RAW_SENSOR).
+    kRaw16 = 2,
+};
+
+/**
+ * Color of the top left 2x2 block of the sensor, in the order of
+ * SENSOR_INFO_COLOR_FILTER_ARRANGEMENT.
+ */
+enum class CfaPattern {
+    kRggb = 0,
+    kGrbg = 1,
+    kGbrg = 2,
+    kBggr = 3,
+};
+
+enum class DemosaicMethod {
+    // Averages the nearest samples of each color.
+    kBilinear = 0,
+    // Interpolates green along the direction of the weaker gradient and red and blue as color
+    // differences to green (Hamilton-Adams), which keeps edges free of zippering.
+    kEdgeAware = 1,
+};
+
+/**
+ * Describes a Bayer RAW image in memory. The descriptor does not own the memory.
+ */
+struct RawImage {
+    const uint8_t* data = nullptr;
+    // Bytes between the starts of two rows.
+    int row_stride = 0;
+    int width = 0;
+    int height = 0;
+    RawFormat format = RawFormat::kRaw10;
+
+    /** Bytes taken by the pixels of a row, without padding. */
+    int row_bytes() const;
+
+    /**
+     * Whether the size fits a Bayer mosaic and the packing, i.e. is even and, for RAW10, a
+     * multiple of 4 wide, and the rows fit their stride.
+     */
+    bool IsValid() const;
+};
+
+/**
+ * Camera characteristics and capture results that turn sensor values into colors.
+ */
+struct RawDevelopOptions {
+    CfaPattern pattern = CfaPattern::kRggb;
+    // Black level of the four positions of a 2x2 block in row major order, as in
+    // BlackLevelPattern.
+    int black_level[4] = {0, 0, 0, 0};
+    // The sensor value of saturated pixels, SENSOR_INFO_WHITE_LEVEL.
+    int white_level = 1023;
+    // White balance gains for red, green on even rows, green on odd rows and blue, as in
+    // RggbChannelVector.
+    float gains[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    // Whether RGBA outputs get the sRGB transfer curve, for display. They are linear otherwise.
+    bool apply_gamma = true;
+    DemosaicMethod method = DemosaicMethod::kEdgeAware;
+};
+
+/**
+ * Unpacks {@code src} to one 16-bit sample per pixel with the sensor's value range, e.g. 0 to
+ * 1023 for RAW10. {@code dst_stride} is in samples. The rows are split into stripes that run on
+ * {@code pool}, which may be null to run on the calling thread.
+ *
+ * @return 0 on success or -1 if {@code src} is invalid.
+ */
+int UnpackRaw(const RawImage& src, uint16_t* dst, int dst_stride, StripePool* pool);
+
+/**
+ * Subtracts the black level from every sample of {@code src}, applies the white balance gains
+ * and scales the result so that the white level maps to 65535, clamping at both ends. The
+ * output is a linear Bayer mosaic with one 16-bit sample per pixel; {@code dst_stride} is in
+ * samples. Packed formats are unpacked on the way.
+ *
+ * @return 0 on success or -1 if {@code src} or the options are invalid.
+ */
+int LinearizeRaw(const RawImage& src, const RawDevelopOptions& options, uint16_t* dst,
+                 int dst_stride, StripePool* pool);
+
+/**
+ * Bins every 2x2 block of {@code src} into one RGBA pixel, averaging its two greens, for a
+ * preview of half the width and half the height. Black level, white balance and the transfer
+ * curve of {@code options} are applied; the demosaic method is not used.
+ *
+ * @return 0 on success or -1 if {@code src} or the options are invalid.
+ */
+int BinRawToABGR(const RawImage& src, const RawDevelopOptions& options, uint8_t* dst_abgr,
+                 int dst_stride_abgr, StripePool* pool);
+
+/**
+ * Demosaics {@code src} into a full resolution RGBA image with the method of {@code options},
+ * after applying its black level and white balance. Borders are mirrored.
+ *
+ * <p>Every stripe works through bands of 16 rows, unpacking and linearizing only the rows a
+ * band needs into buffers that stay in the cache, so no full frame intermediate is created.
+ *
+ * @return 0 on success or -1 if {@code src} or the options are invalid.
+ */
+int DemosaicRawToABGR(const RawImage& src, const RawDevelopOptions& options, uint8_t* dst_abgr,
+                      int dst_stride_abgr, StripePool* pool);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_RAW_KERNELS_H_
@@ -0,0 +1,308 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rgb_to_yuv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_RGB_TO_YUV_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_RGB_TO_YUV_SSE2 1
+#endif
+
+#include "libyuv/planar_functions.h"
+
+#include "image_transpose.h"
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// Output rows converted from one rotated buffer, even so that chroma rows are not split.
+constexpr int kBandRows = 16;
+void ConvertLumaRow(const uint8_t* rgb, int width, const YuvWeights& w, bool simd, uint8_t* y) {
+    int x = 0;
+#if defined(CAMERAX_RGB_TO_YUV_NEON)
+    const uint8x8_t w0 = vdup_n_u8(static_cast<uint8_t>(w.y[0]));
+    const uint8x8_t w1 = vdup_n_u8(static_cast<uint8_t>(w.y[1]));
+    const uint8x8_t w2 = vdup_n_u8(static_cast<uint8_t>(w.y[2]));
+    const uint8x8_t offset = vdup_n_u8(static_cast<uint8_t>(w.y_offset));
+    for (; simd && x + 8 <= width; x += 8) {
+        const uint8x8x4_t pixels = vld4_u8(rgb + 4 * x);
+        uint16x8_t sum = vmull_u8(pixels.val[0], w0);
+        sum = vmlal_u8(sum, pixels.val[1], w1);
+        sum = vmlal_u8(sum, pixels.val[2], w2);
+        vst1_u8(y + x, vadd_u8(vrshrn_n_u16(sum, 8), offset));
+    }
+#elif defined(CAMERAX_RGB_TO_YUV_SSE2)
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i w0 = _mm_set1_epi16(static_cast<int16_t>(w.y[0]));
+    const __m128i w1 = _mm_set1_epi16(static_cast<int16_t>(w.y[1]));
+    const __m128i w2 = _mm_set1_epi16(static_cast<int16_t>(w.y[2]));
+    const __m128i rounding = _mm_set1_epi16(128);
+    const __m128i offset = _mm_set1_epi16(static_cast<int16_t>(w.y_offset));
+    for (; simd && x + 8 <= width; x += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 4 * x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 4 * x + 16));
+        // The bytes of each channel as 16-bit lanes.
+        const __m128i c0 = _mm_packs_epi32(_mm_and_si128(a, byte_mask),
+                                           _mm_and_si128(b, byte_mask));
+        const __m128i c1 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(a, 8), byte_mask),
+                                           _mm_and_si128(_mm_srli_epi32(b, 8), byte_mask));
+        const __m128i c2 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(a, 16), byte_mask),
+                                           _mm_and_si128(_mm_srli_epi32(b, 16), byte_mask));
+        // The products and sums exceed int16 but not 16 bits, so they are right as unsigned.
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(c0, w0), _mm_mullo_epi16(c1, w1));
+        sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_mullo_epi16(c2, w2), rounding));
+        const __m128i luma = _mm_add_epi16(_mm_srli_epi16(sum, 8), offset);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(y + x), _mm_packus_epi16(luma, luma));
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* p = rgb + 4 * x;
+        y[x] = w.Luma(p[0], p[1], p[2]);
+    }
+}
+
+// Computes a row of chroma from the average of 2x2 blocks of the rows rgb0 and rgb1. The last
+// column of an odd width stands in for the missing one.
+void ConvertChromaRow(const uint8_t* rgb0, const uint8_t* rgb1, int width, const YuvWeights& w,
+                      bool simd, uint8_t* u, uint8_t* v) {
+    int x = 0;
+#if defined(CAMERAX_RGB_TO_YUV_NEON)
+    const uint16x8_t bias = vdupq_n_u16(static_cast<uint16_t>(YuvWeights::kChromaBias));
+    for (; simd && x + 16 <= width; x += 16) {
+        const uint8x16x4_t top = vld4q_u8(rgb0 + 4 * x);
+        const uint8x16x4_t bottom = vld4q_u8(rgb1 + 4 * x);
+        int16x8_t average[3];
+        for (int c = 0; c < 3; ++c) {
+            const uint16x8_t sum = vaddq_u16(vpaddlq_u8(top.val[c]), vpaddlq_u8(bottom.val[c]));
+            average[c] = vreinterpretq_s16_u16(vrshrq_n_u16(sum, 2));
+        }
+        int16x8_t sum_u = vmulq_n_s16(average[0], static_cast<int16_t>(w.u[0]));
+        sum_u = vmlaq_n_s16(sum_u, average[1], static_cast<int16_t>(w.u[1]));
+        sum_u = vmlaq_n_s16(sum_u, average[2], static_cast<int16_t>(w.u[2]));
+        int16x8_t sum_v = vmulq_n_s16(average[0], static_cast<int16_t>(w.v[0]));
+        sum_v = vmlaq_n_s16(sum_v, average[1], static_cast<int16_t>(w.v[1]));
+        sum_v = vmlaq_n_s16(sum_v, average[2], static_cast<int16_t>(w.v[2]));
+        vst1_u8(u + x / 2, vshrn_n_u16(vaddq_u16(vreinterpretq_u16_s16(sum_u), bias), 8));
+        vst1_u8(v + x / 2, vshrn_n_u16(vaddq_u16(vreinterpretq_u16_s16(sum_v), bias), 8));
+    }
+#elif defined(CAMERAX_RGB_TO_YUV_SSE2)
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i bias = _mm_set1_epi16(static_cast<int16_t>(YuvWeights::kChromaBias));
+    __m128i weights_u[3];
+    __m128i weights_v[3];
+    for (int c = 0; c < 3; ++c) {
+        weights_u[c] = _mm_set1_epi16(static_cast<int16_t>(w.u[c]));
+        weights_v[c] = _mm_set1_epi16(static_cast<int16_t>(w.v[c]));
+    }
+    for (; simd && x + 16 <= width; x += 16) {
+        // Channel c of 16 pixels, summed over both rows, as two vectors of 8 lanes.
+        __m128i column_sums[3][2];
+        for (int half = 0; half < 2; ++half) {
+            const int offset = 4 * x + 32 * half;
+            const __m128i top0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb0 + offset));
+            const __m128i top1 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb0 + offset + 16));
+            const __m128i bottom0 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb1 + offset));
+            const __m128i bottom1 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb1 + offset + 16));
+            for (int c = 0; c < 3; ++c) {
+                const __m128i top = _mm_packs_epi32(
+                        _mm_and_si128(_mm_srli_epi32(top0, 8 * c), byte_mask),
+                        _mm_and_si128(_mm_srli_epi32(top1, 8 * c), byte_mask));
+                const __m128i bottom = _mm_packs_epi32(
+                        _mm_and_si128(_mm_srli_epi32(bottom0, 8 * c), byte_mask),
+                        _mm_and_si128(_mm_srli_epi32(bottom1, 8 * c), byte_mask));
+                column_sums[c][half] = _mm_add_epi16(top, bottom);
+            }
+        }
+        __m128i sum_u = _mm_setzero_si128();
+        __m128i sum_v = _mm_setzero_si128();
+        for (int c = 0; c < 3; ++c) {
+            // Adds up horizontal pairs into the 2x2 block sums and rounds them to averages.
+            const __m128i block_sums = _mm_packs_epi32(_mm_madd_epi16(column_sums[c][0], ones),
+                                                       _mm_madd_epi16(column_sums[c][1], ones));
+            const __m128i average = _mm_srli_epi16(_mm_add_epi16(block_sums, two), 2);
+            sum_u = _mm_add_epi16(sum_u, _mm_mullo_epi16(average, weights_u[c]));
+            sum_v = _mm_add_epi16(sum_v, _mm_mullo_epi16(average, weights_v[c]));
+        }
+        const __m128i chroma_u = _mm_srli_epi16(_mm_add_epi16(sum_u, bias), 8);
+        const __m128i chroma_v = _mm_srli_epi16(_mm_add_epi16(sum_v, bias), 8);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2),
+                         _mm_packus_epi16(chroma_u, chroma_u));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2),
+                         _mm_packus_epi16(chroma_v, chroma_v));
+    }
+#endif
+    for (; x < width; x += 2) {
+        const int x1 = std::min(x + 1, width - 1);
+        int average[3];
+        for (int c = 0; c < 3; ++c) {
+            average[c] = (rgb0[4 * x + c] + rgb0[4 * x1 + c] + rgb1[4 * x + c] + rgb1[4 * x1 + c]
+                          + 2) >> 2;
+        }
+        u[x / 2] = w.U(average[0], average[1], average[2]);
+        v[x / 2] = w.V(average[0], average[1], average[2]);
+    }
+}
+
+// Converts row y of the output from rgb, straight into dst if its samples are packed.
+void ConvertLuma(const uint8_t* rgb, const YuvWeights& w, bool simd, const PlanarImage& dst,
+                 int y, uint8_t* buffer) {
+    uint8_t* dst_y = dst.y.RowAt(y);
+    if (dst.y.pixel_stride == 1) {
+        ConvertLumaRow(rgb, dst.width, w, simd, dst_y);
+        return;
+    }
+    ConvertLumaRow(rgb, dst.width, w, simd, buffer);
+    for (int i = 0; i < dst.width; ++i) {
+        dst_y[i * dst.y.pixel_stride] = buffer[i];
+    }
+}
+
+// Converts chroma row y of the output from the rows rgb0 and rgb1, through buffer unless the
+// chroma is planar.
+void ConvertChroma(const uint8_t* rgb0, const uint8_t* rgb1, const YuvWeights& w, bool simd,
+                   const PlanarImage& dst, ChromaLayout layout, int y, uint8_t* buffer) {
+    const int count = dst.chroma_width();
+    uint8_t* dst_u = dst.u.RowAt(y);
+    uint8_t* dst_v = dst.v.RowAt(y);
+    if (layout == ChromaLayout::kPlanar) {
+        ConvertChromaRow(rgb0, rgb1, dst.width, w, simd, dst_u, dst_v);
+        return;
+    }
+    uint8_t* u = buffer;
+    uint8_t* v = buffer + count;
+    ConvertChromaRow(rgb0, rgb1, dst.width, w, simd, u, v);
+    if (layout == ChromaLayout::kSemiPlanarUV) {
+        libyuv::MergeUVPlane(u, 0, v, 0, dst_u, 0, count, 1);
+    } else if (layout == ChromaLayout::kSemiPlanarVU) {
+        libyuv::MergeUVPlane(v, 0, u, 0, dst_v, 0, count, 1);
+    } else {
+        for (int i = 0; i < count; ++i) {
+            dst_u[i * dst.u.pixel_stride] = u[i];
+            dst_v[i * dst.v.pixel_stride] = v[i];
+        }
+    }
+}
+
+}  // namespace
+
+YuvWeights ComputeYuvWeights(const RgbToYuvOptions& options) {
+    const double kr = options.matrix == YuvMatrix::kBt709 ? 0.2126 : 0.299;
+    const double kb = options.matrix == YuvMatrix::kBt709 ? 0.0722 : 0.114;
+    const double luma_scale = (options.full_range ? 255.0 : 219.0) / 255.0 * 256.0;
+    const double chroma_scale = (options.full_range ? 255.0 : 224.0) / 255.0 * 256.0;
+    // In R, G, B order. Green takes up the rounding so that gray maps to neutral chroma and
+    // white to the top of the luma range.
+    const int y_red = static_cast<int>(std::lround(kr * luma_scale));
+    const int y_blue = static_cast<int>(std::lround(kb * luma_scale));
+    const int y_rgb[3] = {y_red, static_cast<int>(std::lround(luma_scale)) - y_red - y_blue,
+                          y_blue};
+    const int u_red = static_cast<int>(std::lround(-kr / (2 * (1 - kb)) * chroma_scale));
+    const int u_blue = static_cast<int>(std::lround(0.5 * chroma_scale));
+    const int u_rgb[3] = {u_red, -u_red - u_blue, u_blue};
+    const int v_red = static_cast<int>(std::lround(0.5 * chroma_scale));
+    const int v_blue = static_cast<int>(std::lround(-kb / (2 * (1 - kr)) * chroma_scale));
+    const int v_rgb[3] = {v_red, -v_red - v_blue, v_blue};
+
+    YuvWeights weights;
+    for (int i = 0; i < 3; ++i) {
+        const int channel = options.order == RgbOrder::kABGR ? i : 2 - i;
+        weights.y[i] = y_rgb[channel];
+        weights.u[i] = u_rgb[channel];
+        weights.v[i] = v_rgb[channel];
+    }
+    weights.y_offset = options.full_range ? 0 : 16;
+    return weights;
+}
+
+int RgbToYuv420(const uint8_t* src, int src_stride, int width, int height,
+                const RgbToYuvOptions& options, const PlanarImage& dst, StripePool* pool) {
+    const int rotation = options.rotation;
+    const bool transpose = rotation == 90 || rotation == 270;
+    if (src == nullptr || width <= 0 || height <= 0 || src_stride < 4 * width
+        || (rotation != 0 && rotation != 180 && !transpose)
+        || (options.matrix != YuvMatrix::kBt601 && options.matrix != YuvMatrix::kBt709)
+        || (options.order != RgbOrder::kABGR && options.order != RgbOrder::kARGB) || !dst.IsValid()
+        || dst.subsampling != ChromaSubsampling::k420
+        || dst.width != (transpose ? height : width)
+        || dst.height != (transpose ? width : height)) {
+        return -1;
+    }
+    const YuvWeights weights = ComputeYuvWeights(options);
+    const bool simd = GetKernelImpl(Kernel::kRgbToYuv) != KernelImpl::kScalar;
+    const ChromaLayout layout = dst.chroma_layout();
+    const int out_width = dst.width;
+    const int out_height = dst.height;
+
+    RunRowStripes(pool, out_height, kBandRows, [&](int top, int bottom) {
+        std::vector<uint8_t> buffer(static_cast<size_t>(std::max(out_width,
+                                                                 2 * dst.chroma_width())));
+        // Rotated pixels are converted from a buffer that holds one band.
+        std::vector<uint8_t> rotated;
+        if (rotation != 0) {
+            rotated.resize(static_cast<size_t>(out_width) * 4 * kBandRows);
+        }
+        for (int band_top = top; band_top < bottom; band_top += kBandRows) {
+            const int band_rows = std::min(kBandRows, bottom - band_top);
+            const uint8_t* band = src + static_cast<ptrdiff_t>(band_top) * src_stride;
+            int band_stride = src_stride;
+            if (rotation != 0) {
+                // The source strip whose rotation is this band.
+                const uint8_t* strip;
+                if (rotation == 90) {
+                    strip = src + 4 * band_top;
+                } else if (rotation == 270) {
+                    strip = src + 4 * (width - band_top - band_rows);
+                } else {
+                    strip = src + static_cast<ptrdiff_t>(height - band_top - band_rows)
+                            * src_stride;
+                }
+                RotateABGR(strip, src_stride, rotated.data(), out_width * 4,
+                           transpose ? band_rows : width, transpose ? height : band_rows,
+                           rotation);
+                band = rotated.data();
+                band_stride = out_width * 4;
+            }
+            for (int i = 0; i < band_rows; i += 2) {
+                const uint8_t* row0 = band + static_cast<ptrdiff_t>(i) * band_stride;
+                const uint8_t* row1 = i + 1 < band_rows ? row0 + band_stride : row0;
+                const int y = band_top + i;
+                ConvertLuma(row0, weights, simd, dst, y, buffer.data());
+                if (i + 1 < band_rows) {
+                    ConvertLuma(row1, weights, simd, dst, y + 1, buffer.data());
+                }
+                ConvertChroma(row0, row1, weights, simd, dst, layout, y / 2, buffer.data());
+            }
+        }
+    });
+    return 0;
+}
+
+}  // namespace camerax
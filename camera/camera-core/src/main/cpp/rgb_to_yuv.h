@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_RGB_TO_YUV_H_
+#define CAMERA_CORE_RGB_TO_YUV_H_
+
+#include <cstdint>
+
+#include "image_planes.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * The matrix between R'G'B' and Y'CbCr.
+ */
+enum class YuvMatrix {
+    // SD video and JPEG.
+    kBt601 = 0,
+    // HD video.
+    kBt709 = 1,
+};
+
+/**
+ * Byte order of 32-bit RGB pixels, named like libyuv, i.e. after the order of a little endian
+ * 32-bit word. The alpha byte is ignored.
+ */
+enum class RgbOrder {
+    // R, G, B, A in memory, as in Bitmap.Config#ARGB_8888 and RGBA_8888 surfaces.
+    kABGR = 0,
+    // B, G, R, A in memory.
+    kARGB = 1,
+};
+
+struct RgbToYuvOptions {
+    YuvMatrix matrix = YuvMatrix::kBt601;
+    // Full range uses all 256 codes, as JPEG does. Limited range puts luma in [16, 235] and
+    // chroma in [16, 240], as video encoders expect unless told otherwise.
+    bool full_range = false;
+    RgbOrder order = RgbOrder::kABGR;
+    // Clockwise rotation of the output in degrees, one of 0, 90, 180 or 270.
+    int rotation = 0;
+};
+
+/**
+ * 8-bit fixed point weights of the three color bytes of a pixel, in memory order, as used by
+ * {@link RgbToYuv420}. Every weighted sum fits 16 bits: the luma weights are positive and add up
+ * to at most 256, and the chroma weights add up to 0 with the positive one at most 128.
+ */
+struct YuvWeights {
+    // Added before dropping the 8 fraction bits of chroma: 128 for the offset and 127 for
+    // rounding. One less than a full half keeps the largest sum within 16 bits.
+    static constexpr int kChromaBias = (128 << 8) + 127;
+
+    int y[3];
+    int u[3];
+    int v[3];
+    int y_offset;
+
+    uint8_t Luma(int c0, int c1, int c2) const {
+        return static_cast<uint8_t>(((y[0] * c0 + y[1] * c1 + y[2] * c2 + 128) >> 8) + y_offset);
+    }
+    uint8_t U(int c0, int c1, int c2) const {
+        return static_cast<uint8_t>((u[0] * c0 + u[1] * c1 + u[2] * c2 + kChromaBias) >> 8);
+    }
+    uint8_t V(int c0, int c1, int c2) const {
+        return static_cast<uint8_t>((v[0] * c0 + v[1] * c1 + v[2] * c2 + kChromaBias) >> 8);
+    }
+};
+
+/** The weights for the matrix, range and byte order of {@code options}. */
+YuvWeights ComputeYuvWeights(const RgbToYuvOptions& options);
+
+/**
+ * Converts the {@code width} x {@code height} RGB image {@code src} into the 4:2:0 image
+ * {@code dst}, whose size is the rotated size of {@code src}. Any chroma layout works, so
+ * {@code dst} can wrap a codec buffer (see {@link WrapCodecBuffer}), the planes of an Image
+ * dequeued from an ImageWriter or a locked hardware buffer. Chroma is computed from the average
+ * of each 2x2 block of pixels.
+ *
+ * <p>Rotated outputs are converted in bands of rows: each band's pixels are first rotated into
+ * a small buffer with the tiled transpose. The bands are split into stripes that run on
+ * {@code pool}, which may be null to run on the calling thread.
+ *
+ * @return 0 on success or -1 on invalid arguments.
+ */
+int RgbToYuv420(const uint8_t* src, int src_stride, int width, int height,
+                const RgbToYuvOptions& options, const PlanarImage& dst, StripePool* pool);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_RGB_TO_YUV_H_
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stripe_pool.h"
+
+#include <algorithm>
+
+namespace camerax {
+
+StripePool::StripePool(int thread_count) {
+    if (thread_count <= 0) {
+        thread_count = std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                kMaxDefaultThreads);
+    }
+    for (int i = 1; i < thread_count; ++i) {
+        workers_.emplace_back(&StripePool::WorkerLoop, this);
+    }
+}
+
+StripePool::~StripePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void StripePool::Run(int stripe_count, const std::function<void(int)>& stripe_fn) {
+    if (stripe_count <= 0) {
+        return;
+    }
+    if (workers_.empty() || stripe_count == 1) {
+        for (int i = 0; i < stripe_count; ++i) {
+            stripe_fn(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &stripe_fn;
+        stripe_count_ = stripe_count;
+        next_stripe_ = 0;
+        pending_stripes_ = stripe_count;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+    RunStripes();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_stripes_ == 0; });
+    job_ = nullptr;
+}
+
+void StripePool::RunStripes() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (job_ != nullptr && next_stripe_ < stripe_count_) {
+        const std::function<void(int)>& job = *job_;
+        const int stripe = next_stripe_++;
+        lock.unlock();
+        job(stripe);
+        lock.lock();
+        if (--pending_stripes_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void StripePool::WorkerLoop() {
+    unsigned seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        RunStripes();
+    }
+}
+
+void RunStripes(StripePool* pool, int stripe_count, const std::function<void(int)>& stripe_fn) {
+    if (pool != nullptr) {
+        pool->Run(stripe_count, stripe_fn);
+        return;
+    }
+    for (int i = 0; i < stripe_count; ++i) {
+        stripe_fn(i);
+    }
+}
+
+void RunRowStripes(StripePool* pool, int rows, int alignment,
+                   const std::function<void(int, int)>& stripe_fn) {
+    constexpr int kStripesPerThread = 3;
+    const int stripe_target = pool != nullptr ? pool->thread_count() * kStripesPerThread : 1;
+    const int stripe_rows = std::max(alignment, ((rows + stripe_target - 1) / stripe_target
+                                                 + alignment - 1) / alignment * alignment);
+    const int stripe_count = (rows + stripe_rows - 1) / stripe_rows;
+    RunStripes(pool, stripe_count, [&](int stripe) {
+        const int top = stripe * stripe_rows;
+        stripe_fn(top, std::min(rows, top + stripe_rows));
+    });
+}
+
+}  // namespace camerax
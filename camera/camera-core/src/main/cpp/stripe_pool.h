@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_STRIPE_POOL_H_
+#define CAMERA_CORE_STRIPE_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace camerax {
+
+/**
+ * A fixed set of worker threads that process the stripes of a frame in parallel. The calling
+ * thread works on stripes too, so a pool of one thread runs everything inline.
+ *
+ * <p>Only one {@link #Run} can be in flight at a time; concurrent callers are serialized.
+ */
+class StripePool {
+public:
+    /**
+     * Creates a pool of {@code thread_count} threads including the caller. 0 picks the number
+     * of CPUs, capped at {@link #kMaxDefaultThreads}.
+     */
+    explicit StripePool(int thread_count = 0);
+    ~StripePool();
+
+    StripePool(const StripePool&) = delete;
+    StripePool& operator=(const StripePool&) = delete;
+
+    /**
+     * Calls {@code stripe_fn(i)} for every {@code i} in [0, stripe_count), spread across the
+     * threads, and returns once all calls returned.
+     */
+    void Run(int stripe_count, const std::function<void(int)>& stripe_fn);
+
+    int thread_count() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /** Big cores of current phones; the little ones would only add stragglers. */
+    static constexpr int kMaxDefaultThreads = 4;
+
+private:
+    void WorkerLoop();
+    // Claims and runs stripes of the current job until none are left.
+    void RunStripes();
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int)>* job_ = nullptr;
+    int stripe_count_ = 0;
+    int next_stripe_ = 0;
+    int pending_stripes_ = 0;
+    unsigned generation_ = 0;
+    bool stopping_ = false;
+};
+
+/**
+ * Runs the stripes on {@code pool} like {@link StripePool#Run}, or one after the other on the
+ * calling thread if {@code pool} is null.
+ */
+void RunStripes(StripePool* pool, int stripe_count, const std::function<void(int)>& stripe_fn);
+
+/**
+ * Splits rows [0, {@code rows}) into stripes whose height is a multiple of {@code alignment}, a
+ * few per thread of {@code pool} so that slower stripes even out, and calls
+ * {@code stripe_fn(top, bottom)} for each of them with {@link #RunStripes}.
+ */
+void RunRowStripes(StripePool* pool, int rows, int alignment,
+                   const std::function<void(int, int)>& stripe_fn);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_STRIPE_POOL_H_
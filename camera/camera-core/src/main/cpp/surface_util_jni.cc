@@ -15,30 +15,143 @@
  */
 
 #include <android/native_window_jni.h>
+#include <dlfcn.h>
 
-#include <cassert>
+#include <algorithm>
+
+namespace {
+
+// Outcome of a surface query, reported to Java in place of a crash.
+enum SurfaceInfoStatus : jint {
+    kSurfaceInfoOk = 0,
+    // The object is null or has no native window, e.g. it was released.
+    kSurfaceInfoInvalid = -1,
+    // The window exists but its consumer is gone, so its queries fail.
+    kSurfaceInfoAbandoned = -2,
+    // The caller passed no array or one too short for the result, nothing was queried.
+    kSurfaceInfoBadArgument = -3,
+};
+
+// Number of ints written per surface: {status, format, width, height, dataspace}.
+constexpr int kSurfaceInfoSize = 5;
+// Surfaces whose info is staged on the stack before it is copied to the Java array.
+constexpr int kSurfaceInfoChunk = 16;
+
+typedef int32_t (*GetBuffersDataSpaceFn)(ANativeWindow*);
+
+// ANativeWindow_getBuffersDataSpace is only available from API level 28, so it is resolved at
+// runtime. Returns null on older devices.
+GetBuffersDataSpaceFn GetBuffersDataSpace() {
+    static const GetBuffersDataSpaceFn fn = [] {
+        void* lib = dlopen("libandroid.so", RTLD_NOW);
+        return lib != nullptr ? reinterpret_cast<GetBuffersDataSpaceFn>(
+                dlsym(lib, "ANativeWindow_getBuffersDataSpace")) : nullptr;
+    }();
+    return fn;
+}
+
+// Writes {status, format, width, height, dataspace} of the surface to info and returns the
+// status. Values that could not be queried are -1, as is the dataspace before API level 28.
+jint QuerySurfaceInfo(JNIEnv* env, jobject surface, jint* info) {
+    std::fill(info, info + kSurfaceInfoSize, -1);
+    ANativeWindow* window = surface != nullptr ? ANativeWindow_fromSurface(env, surface) : nullptr;
+    if (window == nullptr) {
+        info[0] = kSurfaceInfoInvalid;
+        return info[0];
+    }
+    // The queries return negative error codes, e.g. -ENODEV, once the window is abandoned.
+    int32_t format = ANativeWindow_getFormat(window);
+    int32_t width = ANativeWindow_getWidth(window);
+    int32_t height = ANativeWindow_getHeight(window);
+    if (format < 0 || width < 0 || height < 0) {
+        info[0] = kSurfaceInfoAbandoned;
+    } else {
+        GetBuffersDataSpaceFn get_data_space = GetBuffersDataSpace();
+        info[0] = kSurfaceInfoOk;
+        info[1] = format;
+        info[2] = width;
+        info[3] = height;
+        info[4] = get_data_space != nullptr ? get_data_space(window) : -1;
+    }
+    ANativeWindow_release(window);
+    return info[0];
+}
+
+}  // namespace
 
 extern "C" {
 
 /**
  * Returns an int array of length 3 that the format, width and height values stored at position
- * 0, 1, 2 correspondingly.
+ * 0, 1, 2 correspondingly. All values are -1 if the surface is invalid or abandoned.
  */
 JNIEXPORT jintArray JNICALL
 Java_androidx_camera_core_impl_utils_SurfaceUtil_nativeGetSurfaceInfo(JNIEnv *env, jclass clazz,
                                                                       jobject jsurface) {
-    // Retrieves surface info via native mothods
-    ANativeWindow *nativeWindow = ANativeWindow_fromSurface(env, jsurface);
-    assert(nativeWindow != nullptr);
-    int32_t format = ANativeWindow_getFormat(nativeWindow);
-    int32_t width = ANativeWindow_getWidth(nativeWindow);
-    int32_t height = ANativeWindow_getHeight(nativeWindow);
-    ANativeWindow_release(nativeWindow);
+    jint info[kSurfaceInfoSize];
+    QuerySurfaceInfo(env, jsurface, info);
 
     jintArray resultArray = env->NewIntArray(3);
-    jint surfaceInfo[3] = {format, width, height};
-    env->SetIntArrayRegion(resultArray, 0, 3, surfaceInfo);
-
+    if (resultArray != nullptr) {
+        env->SetIntArrayRegion(resultArray, 0, 3, info + 1);
+    }
     return resultArray;
 }
-}
\ No newline at end of file
+
+/**
+ * Writes {status, format, width, height, dataspace} of the surface to the first five ints of
+ * {@code out_info} without allocating. The status is 0 on success, -1 for a null or released
+ * surface and -2 for a surface whose consumer is gone; the other values are -1 unless the
+ * status is 0.
+ *
+ * @return the status, or -3 if {@code out_info} is null or too small, so that a programming
+ * error is not mistaken for a bad surface.
+ */
+JNIEXPORT jint JNICALL
+Java_androidx_camera_core_impl_utils_SurfaceUtil_nativeQuerySurfaceInfo(JNIEnv *env, jclass clazz,
+                                                                        jobject jsurface,
+                                                                        jintArray out_info) {
+    if (out_info == nullptr || env->GetArrayLength(out_info) < kSurfaceInfoSize) {
+        return kSurfaceInfoBadArgument;
+    }
+    jint info[kSurfaceInfoSize];
+    jint status = QuerySurfaceInfo(env, jsurface, info);
+    env->SetIntArrayRegion(out_info, 0, kSurfaceInfoSize, info);
+    return status;
+}
+
+/**
+ * Like nativeQuerySurfaceInfo for every surface of the array in one call, writing consecutive
+ * groups of five ints to {@code out_info}.
+ *
+ * @return the number of surfaces queried, or -1 if {@code out_info} is too small.
+ */
+JNIEXPORT jint JNICALL
+Java_androidx_camera_core_impl_utils_SurfaceUtil_nativeGetSurfaceInfos(JNIEnv *env, jclass clazz,
+                                                                       jobjectArray jsurfaces,
+                                                                       jintArray out_info) {
+    if (jsurfaces == nullptr || out_info == nullptr) {
+        return -1;
+    }
+    const jsize count = env->GetArrayLength(jsurfaces);
+    if (env->GetArrayLength(out_info) < count * kSurfaceInfoSize) {
+        return -1;
+    }
+
+    // Staged on the stack so that the Java array is written with one call per chunk and no
+    // buffer has to be allocated.
+    jint chunk[kSurfaceInfoChunk * kSurfaceInfoSize];
+    for (jsize start = 0; start < count; start += kSurfaceInfoChunk) {
+        const jsize chunk_count = std::min<jsize>(kSurfaceInfoChunk, count - start);
+        for (jsize i = 0; i < chunk_count; ++i) {
+            jobject surface = env->GetObjectArrayElement(jsurfaces, start + i);
+            QuerySurfaceInfo(env, surface, chunk + i * kSurfaceInfoSize);
+            // Keeps the local reference table from growing with the number of surfaces.
+            env->DeleteLocalRef(surface);
+        }
+        env->SetIntArrayRegion(out_info, start * kSurfaceInfoSize,
+                               chunk_count * kSurfaceInfoSize, chunk);
+    }
+    return count;
+}
+}
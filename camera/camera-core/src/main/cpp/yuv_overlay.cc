@@ -0,0 +1,303 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "yuv_overlay.h"
+
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CAMERAX_OVERLAY_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CAMERAX_OVERLAY_SSE2 1
+#endif
+
+#include "image_transpose.h"
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+namespace {
+
+// (overlay * alpha + frame * (255 - alpha)) / 255, rounded. The division is exact for every
+// sum up to 255 * 255, and the SIMD kernels compute the same.
+inline uint8_t BlendSample(int frame, int overlay, int alpha) {
+    const int sum = overlay * alpha + frame * (255 - alpha) + 128;
+    return static_cast<uint8_t>((sum + (sum >> 8)) >> 8);
+}
+
+#if defined(CAMERAX_OVERLAY_NEON)
+inline uint8x8_t BlendLanes(uint8x8_t frame, uint8x8_t overlay, uint8x8_t alpha) {
+    const uint16x8_t sum = vmlal_u8(vmull_u8(overlay, alpha), frame, vmvn_u8(alpha));
+    return vraddhn_u16(sum, vrshrq_n_u16(sum, 8));
+}
+
+inline uint8x16_t BlendLanes(uint8x16_t frame, uint8x16_t overlay, uint8x16_t alpha) {
+    return vcombine_u8(
+            BlendLanes(vget_low_u8(frame), vget_low_u8(overlay), vget_low_u8(alpha)),
+            BlendLanes(vget_high_u8(frame), vget_high_u8(overlay), vget_high_u8(alpha)));
+}
+#elif defined(CAMERAX_OVERLAY_SSE2)
+// Blends 16-bit lanes holding bytes. The products and their sum stay below 65536, so they are
+// right as unsigned even though mullo and add are signed.
+inline __m128i BlendLanes(__m128i frame, __m128i overlay, __m128i alpha) {
+    const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(overlay, alpha),
+                                _mm_mullo_epi16(frame, inverse));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+}
+
+inline __m128i LoadBytes(const uint8_t* p) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+                             _mm_setzero_si128());
+}
+#endif
+
+// Blends count samples into frame, whose samples are step bytes apart.
+void BlendRow(uint8_t* frame, int step, const uint8_t* overlay, const uint8_t* alpha, int count,
+              bool simd) {
+    int i = 0;
+    if (step == 1) {
+#if defined(CAMERAX_OVERLAY_NEON)
+        for (; simd && i + 16 <= count; i += 16) {
+            vst1q_u8(frame + i, BlendLanes(vld1q_u8(frame + i), vld1q_u8(overlay + i),
+                                           vld1q_u8(alpha + i)));
+        }
+#elif defined(CAMERAX_OVERLAY_SSE2)
+        for (; simd && i + 8 <= count; i += 8) {
+            const __m128i blended = BlendLanes(LoadBytes(frame + i), LoadBytes(overlay + i),
+                                               LoadBytes(alpha + i));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(frame + i),
+                             _mm_packus_epi16(blended, blended));
+        }
+#endif
+    }
+    for (; i < count; ++i) {
+        uint8_t* sample = frame + static_cast<ptrdiff_t>(i) * step;
+        *sample = BlendSample(*sample, overlay[i], alpha[i]);
+    }
+}
+
+// Blends count sample pairs into interleaved chroma, first into the first sample of every pair
+// and second into the second.
+void BlendPairRow(uint8_t* frame, const uint8_t* first, const uint8_t* second,
+                  const uint8_t* alpha, int count, bool simd) {
+    int i = 0;
+#if defined(CAMERAX_OVERLAY_NEON)
+    for (; simd && i + 16 <= count; i += 16) {
+        uint8x16x2_t pairs = vld2q_u8(frame + 2 * i);
+        const uint8x16_t a = vld1q_u8(alpha + i);
+        pairs.val[0] = BlendLanes(pairs.val[0], vld1q_u8(first + i), a);
+        pairs.val[1] = BlendLanes(pairs.val[1], vld1q_u8(second + i), a);
+        vst2q_u8(frame + 2 * i, pairs);
+    }
+#elif defined(CAMERAX_OVERLAY_SSE2)
+    const __m128i low_bytes = _mm_set1_epi16(0xFF);
+    for (; simd && i + 8 <= count; i += 8) {
+        const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + 2 * i));
+        const __m128i a = LoadBytes(alpha + i);
+        const __m128i even = BlendLanes(_mm_and_si128(pairs, low_bytes), LoadBytes(first + i), a);
+        const __m128i odd = BlendLanes(_mm_srli_epi16(pairs, 8), LoadBytes(second + i), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + 2 * i),
+                         _mm_or_si128(even, _mm_slli_epi16(odd, 8)));
+    }
+#endif
+    for (; i < count; ++i) {
+        frame[2 * i] = BlendSample(frame[2 * i], first[i], alpha[i]);
+        frame[2 * i + 1] = BlendSample(frame[2 * i + 1], second[i], alpha[i]);
+    }
+}
+
+// The color of the pixels weighted by their alpha, given the sum of their colors and of their
+// alphas. Premultiplied colors already carry their weight.
+inline int WeightedColor(int color_sum, int alpha_sum, bool premultiplied) {
+    const int numerator = premultiplied ? color_sum * 255 : color_sum;
+    return std::min(255, (numerator + alpha_sum / 2) / alpha_sum);
+}
+
+}  // namespace
+
+YuvOverlay::YuvOverlay(const uint8_t* src, int src_stride, int width, int height,
+                       bool premultiplied, const RgbToYuvOptions& options) {
+    const int rotation = options.rotation;
+    if (src == nullptr || width <= 0 || height <= 0 || src_stride < width * 4
+        || (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270)
+        || (options.matrix != YuvMatrix::kBt601 && options.matrix != YuvMatrix::kBt709)
+        || (options.order != RgbOrder::kABGR && options.order != RgbOrder::kARGB)) {
+        return;
+    }
+    const bool transpose = rotation == 90 || rotation == 270;
+    const int out_width = transpose ? height : width;
+    const int out_height = transpose ? width : height;
+    const uint8_t* rgba = src;
+    int stride = src_stride;
+    std::vector<uint8_t> rotated;
+    if (rotation != 0) {
+        rotated.resize(static_cast<size_t>(out_width) * out_height * 4);
+        if (RotateABGR(src, src_stride, rotated.data(), out_width * 4, width, height,
+                       rotation) != 0) {
+            return;
+        }
+        rgba = rotated.data();
+        stride = out_width * 4;
+    }
+    const YuvWeights weights = ComputeYuvWeights(options);
+    const auto pixel = [&](int x, int y) {
+        return rgba + static_cast<ptrdiff_t>(y) * stride + 4 * x;
+    };
+
+    const size_t luma_size = static_cast<size_t>(out_width) * out_height;
+    luma_.resize(luma_size);
+    luma_alpha_.resize(luma_size);
+    luma_spans_.resize(out_height);
+    for (int y = 0; y < out_height; ++y) {
+        uint8_t* luma = luma_.data() + static_cast<size_t>(y) * out_width;
+        uint8_t* alpha = luma_alpha_.data() + static_cast<size_t>(y) * out_width;
+        Span& span = luma_spans_[y];
+        span.begin = out_width;
+        for (int x = 0; x < out_width; ++x) {
+            const uint8_t* p = pixel(x, y);
+            alpha[x] = p[3];
+            luma[x] = 0;
+            if (p[3] == 0) {
+                continue;
+            }
+            const int weight = premultiplied ? 1 : p[3];
+            luma[x] = weights.Luma(WeightedColor(p[0] * weight, p[3], premultiplied),
+                                   WeightedColor(p[1] * weight, p[3], premultiplied),
+                                   WeightedColor(p[2] * weight, p[3], premultiplied));
+            span.begin = std::min(span.begin, x);
+            span.end = x + 1;
+        }
+        span.begin = std::min(span.begin, span.end);
+    }
+
+    // Pixels past an odd edge are transparent, as the frame pixels they stand for are not
+    // covered.
+    chroma_width_ = (out_width + 1) / 2;
+    chroma_height_ = (out_height + 1) / 2;
+    const size_t chroma_size = static_cast<size_t>(chroma_width_) * chroma_height_;
+    u_.resize(chroma_size);
+    v_.resize(chroma_size);
+    chroma_alpha_.resize(chroma_size);
+    chroma_spans_.resize(chroma_height_);
+    for (int y = 0; y < chroma_height_; ++y) {
+        const size_t row = static_cast<size_t>(y) * chroma_width_;
+        Span& span = chroma_spans_[y];
+        span.begin = chroma_width_;
+        for (int x = 0; x < chroma_width_; ++x) {
+            int color_sum[3] = {0, 0, 0};
+            int alpha_sum = 0;
+            for (int dy = 0; dy < 2 && 2 * y + dy < out_height; ++dy) {
+                for (int dx = 0; dx < 2 && 2 * x + dx < out_width; ++dx) {
+                    const uint8_t* p = pixel(2 * x + dx, 2 * y + dy);
+                    // Straight colors are weighted here, premultiplied ones already are.
+                    const int weight = premultiplied ? 1 : p[3];
+                    for (int c = 0; c < 3; ++c) {
+                        color_sum[c] += p[c] * weight;
+                    }
+                    alpha_sum += p[3];
+                }
+            }
+            chroma_alpha_[row + x] = static_cast<uint8_t>((alpha_sum + 2) / 4);
+            u_[row + x] = 128;
+            v_[row + x] = 128;
+            if (chroma_alpha_[row + x] == 0) {
+                continue;
+            }
+            const int c0 = WeightedColor(color_sum[0], alpha_sum, premultiplied);
+            const int c1 = WeightedColor(color_sum[1], alpha_sum, premultiplied);
+            const int c2 = WeightedColor(color_sum[2], alpha_sum, premultiplied);
+            u_[row + x] = weights.U(c0, c1, c2);
+            v_[row + x] = weights.V(c0, c1, c2);
+            span.begin = std::min(span.begin, x);
+            span.end = x + 1;
+        }
+        span.begin = std::min(span.begin, span.end);
+    }
+    width_ = out_width;
+    height_ = out_height;
+}
+
+int YuvOverlay::BlendInto(const PlanarImage& dst, int x, int y, StripePool* pool) const {
+    if (!IsValid() || !dst.IsValid() || dst.subsampling != ChromaSubsampling::k420) {
+        return -1;
+    }
+    x -= x & 1;
+    y -= y & 1;
+    // The covered rectangle of dst, in luma and in chroma samples.
+    const int left = std::max(x, 0);
+    const int top = std::max(y, 0);
+    const int right = std::min(x + width_, dst.width);
+    const int bottom = std::min(y + height_, dst.height);
+    if (left >= right || top >= bottom) {
+        return 0;
+    }
+    const int chroma_left = left / 2;
+    const int chroma_right = std::min((x + width_ + 1) / 2, dst.chroma_width());
+    const bool simd = GetKernelImpl(Kernel::kOverlay) != KernelImpl::kScalar;
+    const ChromaLayout layout = dst.chroma_layout();
+    const bool interleaved =
+            layout == ChromaLayout::kSemiPlanarUV || layout == ChromaLayout::kSemiPlanarVU;
+
+    // Both edges of a stripe are even, so every stripe blends whole chroma rows.
+    RunRowStripes(pool, bottom - top, 2, [&](int stripe_top, int stripe_bottom) {
+        for (int row = top + stripe_top; row < top + stripe_bottom; ++row) {
+            const int overlay_row = row - y;
+            const Span& span = luma_spans_[overlay_row];
+            const int begin = std::max(left - x, span.begin);
+            const int end = std::min(right - x, span.end);
+            if (begin >= end) {
+                continue;
+            }
+            const size_t offset = static_cast<size_t>(overlay_row) * width_ + begin;
+            BlendRow(dst.y.RowAt(row) + (x + begin) * dst.y.pixel_stride, dst.y.pixel_stride,
+                     luma_.data() + offset, luma_alpha_.data() + offset, end - begin, simd);
+        }
+        const int chroma_bottom = std::min((top + stripe_bottom + 1) / 2, dst.chroma_height());
+        for (int row = (top + stripe_top) / 2; row < chroma_bottom; ++row) {
+            const int overlay_row = row - y / 2;
+            const Span& span = chroma_spans_[overlay_row];
+            const int begin = std::max(chroma_left - x / 2, span.begin);
+            const int end = std::min(chroma_right - x / 2, span.end);
+            if (begin >= end) {
+                continue;
+            }
+            const size_t offset = static_cast<size_t>(overlay_row) * chroma_width_ + begin;
+            const uint8_t* alpha = chroma_alpha_.data() + offset;
+            uint8_t* u = dst.u.RowAt(row) + (x / 2 + begin) * dst.u.pixel_stride;
+            uint8_t* v = dst.v.RowAt(row) + (x / 2 + begin) * dst.v.pixel_stride;
+            if (interleaved) {
+                const bool uv = layout == ChromaLayout::kSemiPlanarUV;
+                BlendPairRow(uv ? u : v, (uv ? u_ : v_).data() + offset,
+                             (uv ? v_ : u_).data() + offset, alpha, end - begin, simd);
+            } else {
+                BlendRow(u, dst.u.pixel_stride, u_.data() + offset, alpha, end - begin, simd);
+                BlendRow(v, dst.v.pixel_stride, v_.data() + offset, alpha, end - begin, simd);
+            }
+        }
+    });
+    return 0;
+}
+
+size_t YuvOverlay::memory_size() const {
+    return luma_.size() + luma_alpha_.size() + u_.size() + v_.size() + chroma_alpha_.size()
+            + (luma_spans_.size() + chroma_spans_.size()) * sizeof(Span);
+}
+
+}  // namespace camerax
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_YUV_OVERLAY_H_
+#define CAMERA_CORE_YUV_OVERLAY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "rgb_to_yuv.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+
+/**
+ * An RGBA image converted once for blending into YUV frames, e.g. a watermark, a timestamp or
+ * a sticker. Blending in the YUV domain spares a frame the round trip through RGBA for a few
+ * kilobytes of overlay.
+ *
+ * <p>Luma is stored with the alpha of every pixel, chroma with the mean alpha of every 2x2
+ * block. The chroma color is the alpha weighted mean of the block, so that transparent pixels
+ * do not bleed into the edges. Every row also records the span of pixels that are not fully
+ * transparent, so that the empty margins around text and logos are skipped.
+ *
+ * <p>An overlay does not change after it is created and can be blended into several frames at
+ * the same time.
+ */
+class YuvOverlay {
+public:
+    /**
+     * Converts the {@code width} x {@code height} RGBA image {@code src}, whose alpha is the
+     * last byte of each pixel. The color is premultiplied by alpha if {@code premultiplied} is
+     * set, as in Android bitmaps. The overlay is rotated by {@code options.rotation}, so that an
+     * upright overlay can be stamped on frames in sensor orientation.
+     */
+    YuvOverlay(const uint8_t* src, int src_stride, int width, int height, bool premultiplied,
+               const RgbToYuvOptions& options);
+
+    YuvOverlay(const YuvOverlay&) = delete;
+    YuvOverlay& operator=(const YuvOverlay&) = delete;
+
+    /** False if the arguments of the constructor were invalid. */
+    bool IsValid() const { return width_ > 0; }
+
+    /**
+     * Blends the overlay into the 4:2:0 image {@code dst}, which may have any chroma layout,
+     * with its top left corner at ({@code x}, {@code y}). Both are rounded down to even so that
+     * the chroma blocks line up, and may be negative. Only the covered spans of the rows are
+     * read and written; anything outside of {@code dst} is clipped.
+     *
+     * <p>The rows are split into stripes that run on {@code pool}, which may be null to run on
+     * the calling thread.
+     *
+     * @return 0 on success or -1 if the overlay or {@code dst} is invalid.
+     */
+    int BlendInto(const PlanarImage& dst, int x, int y, StripePool* pool) const;
+
+    /** Size after rotation. */
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    /** Bytes of memory held by the overlay. */
+    size_t memory_size() const;
+
+private:
+    // Columns [begin, end) of a row hold every pixel that is not fully transparent.
+    struct Span {
+        int begin = 0;
+        int end = 0;
+    };
+
+    int width_ = 0;
+    int height_ = 0;
+    int chroma_width_ = 0;
+    int chroma_height_ = 0;
+    std::vector<uint8_t> luma_;
+    std::vector<uint8_t> luma_alpha_;
+    std::vector<Span> luma_spans_;
+    std::vector<uint8_t> u_;
+    std::vector<uint8_t> v_;
+    std::vector<uint8_t> chroma_alpha_;
+    std::vector<Span> chroma_spans_;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_YUV_OVERLAY_H_
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "burst_merge.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+constexpr int kWidth = 150;
+constexpr int kHeight = 86;
+constexpr int kMargin = 8;
+
+// Crops of one scene at (kMargin + dx, kMargin + dy), so that frame i shows the scene moved
+// by (-dx, -dy) relative to the first.
+const int kOffsets[][2] = {{0, 0}, {2, -4}, {-6, 2}, {4, 4}};
+
+// A burst of crops of one scene followed by unrelated frames, which are rejected as motion.
+// Their shifts are wherever the noise happens to match best, so they depend on every bit of
+// the sums of absolute differences.
+class TestBurst {
+public:
+    explicit TestBurst(ChromaLayout layout)
+            : scene_(kWidth + 2 * kMargin, kHeight + 2 * kMargin, layout, 1),
+              other_{{kWidth, kHeight, layout, 2}, {kWidth, kHeight, layout, 3},
+                     {kWidth, kHeight, layout, 4}, {kWidth, kHeight, layout, 5}} {}
+
+    PlanarImage frame(int i) const {
+        if (i >= kSceneFrames) {
+            return other_[i - kSceneFrames].image();
+        }
+        return CropPlanarImage(scene_.image(), kMargin + kOffsets[i][0],
+                               kMargin + kOffsets[i][1], kWidth, kHeight);
+    }
+
+    static constexpr int kSceneFrames = 4;
+    static constexpr int kFrameCount = kSceneFrames + 4;
+
+private:
+    TestFrame scene_;
+    TestFrame other_[4];
+};
+
+// Merges the burst with options into YUV of layout and into RGBA, followed by the shifts and
+// the merged sample count.
+std::vector<int64_t> Merge(const TestBurst& burst, const BurstMergeOptions& options,
+                           ChromaLayout layout, StripePool* pool) {
+    BurstMerger merger(options);
+    EXPECT_TRUE(merger.IsValid());
+    std::vector<int64_t> shifts;
+    for (int i = 0; i < TestBurst::kFrameCount; ++i) {
+        int shift_x = 0;
+        int shift_y = 0;
+        EXPECT_EQ(merger.AddFrame(burst.frame(i), pool, &shift_x, &shift_y), 0);
+        shifts.push_back(shift_x);
+        shifts.push_back(shift_y);
+    }
+    const TestFrame merged(kWidth, kHeight, layout);
+    EXPECT_EQ(merger.MergeToYuv(merged.image(), pool), 0);
+    std::vector<uint8_t> abgr(static_cast<size_t>(kWidth) * kHeight * 4);
+    EXPECT_EQ(merger.MergeToABGR(abgr.data(), kWidth * 4, true, pool), 0);
+
+    const std::vector<uint8_t> i420 = ToI420(merged.image());
+    std::vector<int64_t> out(i420.begin(), i420.end());
+    out.insert(out.end(), abgr.begin(), abgr.end());
+    out.insert(out.end(), shifts.begin(), shifts.end());
+    out.push_back(merger.stats().merged_samples);
+    return out;
+}
+
+TEST(BurstMergeTest, AlignsTranslatedFrames) {
+    const TestBurst burst(ChromaLayout::kSemiPlanarUV);
+    BurstMergeOptions options;
+    options.width = kWidth;
+    options.height = kHeight;
+    options.max_shift = 16;
+    BurstMerger merger(options);
+    ASSERT_TRUE(merger.IsValid());
+    for (int i = 0; i < TestBurst::kSceneFrames; ++i) {
+        int shift_x = 0;
+        int shift_y = 0;
+        ASSERT_EQ(merger.AddFrame(burst.frame(i), nullptr, &shift_x, &shift_y), 0);
+        EXPECT_EQ(shift_x, -kOffsets[i][0]) << i;
+        EXPECT_EQ(shift_y, -kOffsets[i][1]) << i;
+    }
+}
+
+TEST(BurstMergeTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kBurstMerge);
+    ASSERT_FALSE(impls.empty());
+    StripePool pool(2);
+    for (bool align : {true, false}) {
+        for (int threshold : {24, 255}) {
+            BurstMergeOptions options;
+            options.width = kWidth;
+            options.height = kHeight;
+            options.align = align;
+            options.max_shift = 16;
+            options.motion_threshold = threshold;
+            for (ChromaLayout layout : kLayouts) {
+                const TestBurst burst(layout);
+                std::vector<int64_t> expected;
+                {
+                    const ScopedKernelImpl scalar(Kernel::kBurstMerge, KernelImpl::kScalar);
+                    ASSERT_TRUE(scalar.ok());
+                    expected = Merge(burst, options, layout, nullptr);
+                }
+                for (KernelImpl impl : impls) {
+                    const ScopedKernelImpl simd(Kernel::kBurstMerge, impl);
+                    ASSERT_TRUE(simd.ok());
+                    EXPECT_EQ(Merge(burst, options, layout, &pool), expected)
+                            << GetKernelImplName(impl) << " align " << align << " threshold "
+                            << threshold << " layout " << static_cast<int>(layout);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
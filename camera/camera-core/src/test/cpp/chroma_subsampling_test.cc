@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "chroma_subsampling.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Sizes with and without SIMD tails, odd ones repeating the last row and column.
+constexpr int kSizes[][2] = {{64, 8}, {67, 13}, {130, 5}, {2, 2}};
+
+// Downsamples src into a new 4:2:0 frame of dst_layout and returns it as I420.
+std::vector<uint8_t> Downsample(const PlanarImage& src, ChromaLayout dst_layout) {
+    const TestFrame dst(src.width, src.height, dst_layout);
+    EXPECT_EQ(DownsampleChromaTo420(src, dst.image()), 0);
+    return ToI420(dst.image());
+}
+
+// The chroma planes of a tightly packed I420 buffer, worked out sample by sample.
+std::vector<uint8_t> ReferenceChroma(const PlanarImage& src) {
+    const int width = (src.width + 1) / 2;
+    const int height = (src.height + 1) / 2;
+    const bool horizontal = src.subsampling == ChromaSubsampling::k444;
+    std::vector<uint8_t> chroma;
+    for (const Plane* plane : {&src.u, &src.v}) {
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* row0 = plane->RowAt(2 * y);
+            const uint8_t* row1 = plane->RowAt(std::min(2 * y + 1, src.chroma_height() - 1));
+            for (int x = 0; x < width; ++x) {
+                if (!horizontal) {
+                    const int x0 = x * plane->pixel_stride;
+                    chroma.push_back(static_cast<uint8_t>((row0[x0] + row1[x0] + 1) >> 1));
+                    continue;
+                }
+                const int x0 = 2 * x * plane->pixel_stride;
+                const int x1 = std::min(2 * x + 1, src.width - 1) * plane->pixel_stride;
+                chroma.push_back(static_cast<uint8_t>(
+                        (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2));
+            }
+        }
+    }
+    return chroma;
+}
+
+TEST(ChromaSubsamplingTest, AveragesTheSamplesEachOutputCovers) {
+    for (ChromaSubsampling subsampling : {ChromaSubsampling::k422, ChromaSubsampling::k444}) {
+        for (ChromaLayout src_layout : kLayouts) {
+            for (ChromaLayout dst_layout : kLayouts) {
+                const TestFrame src(67, 13, src_layout, 3, 64, subsampling);
+                const std::vector<uint8_t> i420 = Downsample(src.image(), dst_layout);
+                const std::vector<uint8_t> chroma(i420.begin() + 67 * 13, i420.end());
+                EXPECT_EQ(chroma, ReferenceChroma(src.image()))
+                        << static_cast<int>(subsampling) << " " << static_cast<int>(src_layout)
+                        << " -> " << static_cast<int>(dst_layout);
+            }
+        }
+    }
+}
+
+TEST(ChromaSubsamplingTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kChromaDownsample);
+    ASSERT_FALSE(impls.empty());
+    for (ChromaSubsampling subsampling : {ChromaSubsampling::k422, ChromaSubsampling::k444}) {
+        for (const auto& size : kSizes) {
+            for (ChromaLayout src_layout : kLayouts) {
+                const TestFrame src(size[0], size[1], src_layout, 5, 64, subsampling);
+                for (ChromaLayout dst_layout : kLayouts) {
+                    std::vector<uint8_t> expected;
+                    {
+                        const ScopedKernelImpl scalar(Kernel::kChromaDownsample,
+                                                      KernelImpl::kScalar);
+                        ASSERT_TRUE(scalar.ok());
+                        expected = Downsample(src.image(), dst_layout);
+                    }
+                    for (KernelImpl impl : impls) {
+                        const ScopedKernelImpl simd(Kernel::kChromaDownsample, impl);
+                        ASSERT_TRUE(simd.ok());
+                        EXPECT_EQ(Downsample(src.image(), dst_layout), expected)
+                                << GetKernelImplName(impl) << " " << size[0] << "x" << size[1]
+                                << " " << static_cast<int>(subsampling) << " "
+                                << static_cast<int>(src_layout) << " -> "
+                                << static_cast<int>(dst_layout);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(ChromaSubsamplingTest, RejectsMismatchedImages) {
+    const TestFrame src(64, 8, ChromaLayout::kPlanar, 0, 64, ChromaSubsampling::k422);
+    const TestFrame dst(64, 8, ChromaLayout::kPlanar);
+    const TestFrame small(32, 8, ChromaLayout::kPlanar);
+    EXPECT_EQ(DownsampleChromaTo420(dst.image(), dst.image()), -1);
+    EXPECT_EQ(DownsampleChromaTo420(src.image(), src.image()), -1);
+    EXPECT_EQ(DownsampleChromaTo420(src.image(), small.image()), -1);
+}
+
+}  // namespace
+}  // namespace camerax
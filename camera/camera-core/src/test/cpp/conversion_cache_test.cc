@@ -0,0 +1,177 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "conversion_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace camerax {
+namespace {
+
+ConversionKey KeyFor(uint64_t source_id, uint32_t params = 0) {
+    ConversionKey key;
+    key.source_id = source_id;
+    key.width = 16;
+    key.height = 4;
+    key.params = params;
+    return key;
+}
+
+// A {@code rows} x {@code row_bytes} result with a row stride of {@code stride}, whose bytes
+// depend on {@code seed} and whose padding is 0xee.
+std::vector<uint8_t> MakeResult(int row_bytes, int rows, int stride, int seed) {
+    std::vector<uint8_t> result(static_cast<size_t>(stride) * rows, 0xee);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < row_bytes; ++x) {
+            result[static_cast<size_t>(y) * stride + x] = static_cast<uint8_t>(seed + 7 * y + x);
+        }
+    }
+    return result;
+}
+
+void Insert(ConversionCache* cache, const ConversionKey& key, int seed, int row_bytes = 64,
+            int rows = 4) {
+    std::vector<uint8_t> result = MakeResult(row_bytes, rows, row_bytes + 8, seed);
+    cache->Insert(key, result.data(), row_bytes + 8, row_bytes, rows);
+}
+
+// Looks {@code key} up into a buffer of a different stride and checks it holds the result
+// inserted with {@code seed}, with the padding left alone.
+bool LookupMatches(ConversionCache* cache, const ConversionKey& key, int seed,
+                   int row_bytes = 64, int rows = 4) {
+    const int stride = row_bytes + 3;
+    std::vector<uint8_t> dst(static_cast<size_t>(stride) * rows, 0xee);
+    if (!cache->Lookup(key, dst.data(), stride, row_bytes, rows)) {
+        return false;
+    }
+    EXPECT_EQ(dst, MakeResult(row_bytes, rows, stride, seed));
+    return true;
+}
+
+TEST(ConversionCacheTest, ReturnsTheInsertedResult) {
+    ConversionCache cache;
+    Insert(&cache, KeyFor(1), 10);
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 10));
+    EXPECT_EQ(cache.size_bytes(), 64u * 4);
+
+    // Every field of the key tells results apart.
+    ConversionKey other = KeyFor(1);
+    other.by_timestamp = true;
+    EXPECT_FALSE(LookupMatches(&cache, other, 10));
+    other = KeyFor(1);
+    other.width = 17;
+    EXPECT_FALSE(LookupMatches(&cache, other, 10));
+    other = KeyFor(1);
+    other.height = 5;
+    EXPECT_FALSE(LookupMatches(&cache, other, 10));
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(1, 1), 10));
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(2), 10));
+}
+
+TEST(ConversionCacheTest, MissesWhenTheSizeDiffers) {
+    ConversionCache cache;
+    Insert(&cache, KeyFor(1), 10, 64, 4);
+    std::vector<uint8_t> dst(128 * 8, 0x5a);
+    EXPECT_FALSE(cache.Lookup(KeyFor(1), dst.data(), 128, 32, 4));
+    EXPECT_FALSE(cache.Lookup(KeyFor(1), dst.data(), 128, 64, 3));
+    EXPECT_FALSE(cache.Lookup(KeyFor(1), dst.data(), 128, 128, 2));
+    // A miss leaves the destination alone and keeps the result.
+    EXPECT_EQ(dst, std::vector<uint8_t>(128 * 8, 0x5a));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 10, 64, 4));
+}
+
+TEST(ConversionCacheTest, EvictsTheLeastRecentlyUsedResult) {
+    // Room for three results of 256 bytes.
+    ConversionCache cache(3 * 256);
+    Insert(&cache, KeyFor(1), 1);
+    Insert(&cache, KeyFor(2), 2);
+    Insert(&cache, KeyFor(3), 3);
+    // Using the oldest result makes the second one the least recently used.
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 1));
+
+    Insert(&cache, KeyFor(4), 4);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(2), 2));
+    EXPECT_EQ(cache.size_bytes(), 3u * 256);
+
+    // A result twice the size makes room by evicting the two least recently used ones.
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(3), 3));
+    Insert(&cache, KeyFor(5), 5, 64, 8);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(1), 1));
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(4), 4));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(3), 3));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(5), 5, 64, 8));
+    EXPECT_EQ(cache.size_bytes(), 3u * 256);
+}
+
+TEST(ConversionCacheTest, ReinsertReplacesTheResult) {
+    ConversionCache cache(3 * 256);
+    Insert(&cache, KeyFor(1), 1);
+    Insert(&cache, KeyFor(2), 2);
+    Insert(&cache, KeyFor(1), 11, 32, 4);
+    EXPECT_EQ(cache.size_bytes(), 256u + 128);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(1), 1));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 11, 32, 4));
+
+    // Replacing a result many times neither leaks its size nor evicts the others.
+    for (int i = 0; i < 10; ++i) {
+        Insert(&cache, KeyFor(1), 20 + i);
+    }
+    EXPECT_EQ(cache.size_bytes(), 2u * 256);
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(2), 2));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 29));
+
+    // A replacement too large to store still drops the old result.
+    Insert(&cache, KeyFor(1), 40, 256, 4);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(1), 29));
+    EXPECT_EQ(cache.size_bytes(), 256u);
+}
+
+TEST(ConversionCacheTest, SetMaxBytesEvictsAndZeroDisables) {
+    ConversionCache cache(4 * 256);
+    for (int i = 1; i <= 4; ++i) {
+        Insert(&cache, KeyFor(i), i);
+    }
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 1));
+    cache.SetMaxBytes(2 * 256);
+    EXPECT_EQ(cache.size_bytes(), 2u * 256);
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(1), 1));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(4), 4));
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(2), 2));
+
+    cache.SetMaxBytes(0);
+    EXPECT_EQ(cache.size_bytes(), 0u);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(1), 1));
+    Insert(&cache, KeyFor(5), 5);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(5), 5));
+    EXPECT_EQ(cache.size_bytes(), 0u);
+
+    cache.SetMaxBytes(256);
+    Insert(&cache, KeyFor(5), 5);
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(5), 5));
+    Insert(&cache, KeyFor(6), 6, 64, 5);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(6), 6, 64, 5));
+    EXPECT_TRUE(LookupMatches(&cache, KeyFor(5), 5));
+    cache.Clear();
+    EXPECT_EQ(cache.size_bytes(), 0u);
+    EXPECT_FALSE(LookupMatches(&cache, KeyFor(5), 5));
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "depth_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "image_orientation.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+
+namespace camerax {
+namespace {
+
+// The bit patterns of floats, so that comparisons tell -0 from 0 and NaNs match.
+std::vector<uint32_t> Bits(const std::vector<float>& values, size_t count) {
+    std::vector<uint32_t> bits(count);
+    std::memcpy(bits.data(), values.data(), count * sizeof(float));
+    return bits;
+}
+
+std::vector<uint16_t> Depth16(int width, int height) {
+    std::vector<uint16_t> samples(static_cast<size_t>(width) * height);
+    uint32_t state = static_cast<uint32_t>(width);
+    for (uint16_t& sample : samples) {
+        state = state * 1664525U + 1013904223U;
+        sample = static_cast<uint16_t>(state >> 16);
+    }
+    return samples;
+}
+
+// Depth and confidence of a DEPTH16 image decoded with an orientation and a crop.
+std::vector<uint32_t> DecodeDepth(int width, int height, const DepthRequest& request) {
+    const std::vector<uint16_t> src = Depth16(width, height);
+    int out_width = 0;
+    int out_height = 0;
+    EXPECT_EQ(GetDepthOutputSize(width, height, request, &out_width, &out_height), 0);
+    const size_t size = static_cast<size_t>(out_width) * out_height;
+    std::vector<float> depth(size);
+    std::vector<float> confidence(size);
+    EXPECT_EQ(Depth16ToFloat(src.data(), width, width, height, request, depth.data(), out_width,
+                             confidence.data(), out_width),
+              0);
+    std::vector<uint32_t> bits = Bits(depth, size);
+    const std::vector<uint32_t> confidence_bits = Bits(confidence, size);
+    bits.insert(bits.end(), confidence_bits.begin(), confidence_bits.end());
+    // Depth alone takes another path through the kernel.
+    EXPECT_EQ(Depth16ToFloat(src.data(), width, width, height, request, depth.data(), out_width,
+                             nullptr, 0),
+              0);
+    const std::vector<uint32_t> depth_only = Bits(depth, size);
+    bits.insert(bits.end(), depth_only.begin(), depth_only.end());
+    return bits;
+}
+
+// The packed points of a point cloud, the count of points last.
+std::vector<uint32_t> PackPoints(int count, const Orientation& orientation,
+                                 float min_confidence) {
+    std::vector<float> points(static_cast<size_t>(count) * 4);
+    for (int i = 0; i < count; ++i) {
+        points[4 * i] = 0.25f * static_cast<float>(i) - 2.0f;
+        points[4 * i + 1] = i % 3 == 0 ? 0.0f : -0.125f * static_cast<float>(i);
+        points[4 * i + 2] = 1.0f + 0.5f * static_cast<float>(i);
+        points[4 * i + 3] = static_cast<float>(i % 8) / 7.0f;
+    }
+    std::vector<float> xyz(static_cast<size_t>(count) * 3 + 1, -1.0f);
+    const int written = PointCloudToXyz(points.data(), count, orientation, min_confidence,
+                                        xyz.data());
+    EXPECT_GE(written, 0);
+    std::vector<uint32_t> bits = Bits(xyz, static_cast<size_t>(written > 0 ? written : 0) * 3);
+    bits.push_back(static_cast<uint32_t>(written));
+    return bits;
+}
+
+// Every orientation, uncropped and cropped to the middle of a width x 9 image.
+std::vector<DepthRequest> Requests(int width) {
+    std::vector<DepthRequest> requests;
+    for (int rotation : {0, 90, 180, 270}) {
+        for (bool flip : {false, true}) {
+            DepthRequest request;
+            request.orientation.rotation = rotation;
+            request.orientation.flip_vertical = flip;
+            requests.push_back(request);
+            request.crop_left = 3;
+            request.crop_top = 1;
+            request.crop_width = width - 4;
+            request.crop_height = 5;
+            requests.push_back(request);
+        }
+    }
+    return requests;
+}
+
+TEST(DepthKernelsTest, DecodesRangeAndConfidence) {
+    // 1 mm at confidence code 0 (certain), 8191 mm at code 1 (0) and 0 mm at code 7 (6 / 7).
+    const uint16_t src[] = {0x0001, 0x3FFF, 0xE000};
+    float depth[3];
+    float confidence[3];
+    ASSERT_EQ(Depth16ToFloat(src, 3, 3, 1, DepthRequest(), depth, 3, confidence, 3), 0);
+    EXPECT_FLOAT_EQ(depth[0], 0.001f);
+    EXPECT_FLOAT_EQ(depth[1], 8.191f);
+    EXPECT_EQ(depth[2], 0.0f);
+    EXPECT_EQ(confidence[0], 1.0f);
+    EXPECT_EQ(confidence[1], 0.0f);
+    EXPECT_FLOAT_EQ(confidence[2], 6.0f / 7.0f);
+}
+
+TEST(DepthKernelsTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kDepth);
+    ASSERT_FALSE(impls.empty());
+    for (int width : {7, 8, 29, 64}) {
+        for (const DepthRequest& request : Requests(width)) {
+            std::vector<uint32_t> expected;
+            {
+                const ScopedKernelImpl scalar(Kernel::kDepth, KernelImpl::kScalar);
+                ASSERT_TRUE(scalar.ok());
+                expected = DecodeDepth(width, 9, request);
+            }
+            for (KernelImpl impl : impls) {
+                const ScopedKernelImpl simd(Kernel::kDepth, impl);
+                ASSERT_TRUE(simd.ok());
+                EXPECT_EQ(DecodeDepth(width, 9, request), expected)
+                        << GetKernelImplName(impl) << " width " << width << " rotation "
+                        << request.orientation.rotation << " crop " << request.crop_width;
+            }
+        }
+    }
+    for (int count : {0, 1, 2, 5, 33}) {
+        for (int rotation : {0, 90, 180, 270}) {
+            for (float min_confidence : {0.0f, 0.5f, 1.0f}) {
+                const Orientation orientation = Orientation::FromRotation(rotation, count % 2 == 1);
+                std::vector<uint32_t> expected;
+                {
+                    const ScopedKernelImpl scalar(Kernel::kDepth, KernelImpl::kScalar);
+                    expected = PackPoints(count, orientation, min_confidence);
+                }
+                for (KernelImpl impl : impls) {
+                    const ScopedKernelImpl simd(Kernel::kDepth, impl);
+                    EXPECT_EQ(PackPoints(count, orientation, min_confidence), expected)
+                            << GetKernelImplName(impl) << " count " << count << " rotation "
+                            << rotation << " min " << min_confidence;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
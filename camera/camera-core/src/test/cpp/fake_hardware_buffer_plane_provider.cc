@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_hardware_buffer_plane_provider.h"
+
+#include "test_frames.h"
+
+namespace camerax {
+
+FakeHardwareBufferPlaneProvider::FakeHardwareBufferPlaneProvider(int width, int height,
+                                                                 ChromaLayout layout,
+                                                                 int row_alignment)
+        : image_(AllocateTestPlanes(width, height, layout, row_alignment, &memory_)) {}
+
+int FakeHardwareBufferPlaneProvider::Lock(bool write, PlanarImage* image) {
+    if (locked_) {
+        return -1;
+    }
+    locked_ = true;
+    locked_for_write_ = write;
+    lock_count_++;
+    if (write) {
+        write_lock_count_++;
+    } else {
+        read_snapshot_ = memory_;
+    }
+    *image = image_;
+    return 0;
+}
+
+void FakeHardwareBufferPlaneProvider::Unlock() {
+    if (!locked_for_write_ && memory_ != read_snapshot_) {
+        written_under_read_lock_ = true;
+    }
+    read_snapshot_.clear();
+    locked_ = false;
+}
+
+}  // namespace camerax
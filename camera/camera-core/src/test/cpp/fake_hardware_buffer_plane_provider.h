@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_FAKE_HARDWARE_BUFFER_PLANE_PROVIDER_H_
+#define CAMERA_CORE_FAKE_HARDWARE_BUFFER_PLANE_PROVIDER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "hardware_buffer_planes.h"
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * A {@link PlaneProvider} backed by heap memory that mimics the plane layouts hardware buffers
+ * are commonly allocated with, including padded row strides, so that the kernels can be run
+ * through the provider interface on the host.
+ *
+ * <p>Like a hardware buffer locked for reading, the memory must not be written while it is
+ * locked without {@code write}; the fake records when it was.
+ */
+class FakeHardwareBufferPlaneProvider : public PlaneProvider {
+public:
+    FakeHardwareBufferPlaneProvider(int width, int height, ChromaLayout layout,
+                                    int row_alignment = 64);
+
+    int Lock(bool write, PlanarImage* image) override;
+    void Unlock() override;
+
+    bool locked() const { return locked_; }
+    int lock_count() const { return lock_count_; }
+    int write_lock_count() const { return write_lock_count_; }
+
+    /** Whether the memory changed during a lock taken without {@code write}. */
+    bool written_under_read_lock() const { return written_under_read_lock_; }
+
+private:
+    std::vector<uint8_t> memory_;
+    // Copy of the memory taken by a read lock, compared on unlock.
+    std::vector<uint8_t> read_snapshot_;
+    PlanarImage image_;
+    bool locked_ = false;
+    bool locked_for_write_ = false;
+    bool written_under_read_lock_ = false;
+    int lock_count_ = 0;
+    int write_lock_count_ = 0;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_FAKE_HARDWARE_BUFFER_PLANE_PROVIDER_H_
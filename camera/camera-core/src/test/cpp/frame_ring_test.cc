@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "frame_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "image_planes.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr int64_t kFrameIntervalNs = 33'000'000;
+
+int64_t TimestampOf(int frame) {
+    return frame * kFrameIntervalNs;
+}
+
+class FrameRingTest : public testing::TestWithParam<bool> {
+protected:
+    FrameRingOptions Options(int width, int height, int capacity, int max_retained) const {
+        FrameRingOptions options;
+        options.width = width;
+        options.height = height;
+        options.capacity = capacity;
+        options.max_retained = max_retained;
+        options.compress_chroma = GetParam();
+        // Enough log for every slot even with incompressible chroma, so that only the tests of
+        // the log itself lose frames to it.
+        options.chroma_budget_bytes = static_cast<size_t>(width + 2) * (height + 2) * capacity;
+        return options;
+    }
+};
+
+// Pushes frame number {@code frame} of a stream whose content depends on the number.
+std::unique_ptr<TestFrame> PushFrame(FrameRing* ring, int width, int height, int frame,
+                                     ChromaLayout layout = ChromaLayout::kSemiPlanarUV) {
+    auto image = std::make_unique<TestFrame>(width, height, layout, frame);
+    EXPECT_GE(ring->Push(image->image(), TimestampOf(frame)), 0) << "frame " << frame;
+    return image;
+}
+
+void ExpectFrame(const FrameRing& ring, int slot, const TestFrame& expected, int frame) {
+    EXPECT_EQ(ring.GetTimestamp(slot), TimestampOf(frame));
+    PlanarImage image = ring.GetFrame(slot);
+    ASSERT_TRUE(image.IsValid());
+    EXPECT_EQ(ToI420(image), ToI420(expected.image())) << "frame " << frame;
+}
+
+TEST_P(FrameRingTest, RoundTripsEveryLayoutExactly) {
+    // Odd widths give an odd chroma width, which ends the codec rows with a partial block.
+    const int sizes[][2] = {{64, 48}, {37, 21}, {3, 3}};
+    for (const auto& size : sizes) {
+        for (ChromaLayout layout : {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                    ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible}) {
+            SCOPED_TRACE(testing::Message() << size[0] << "x" << size[1] << " layout "
+                                            << static_cast<int>(layout));
+            FrameRing ring(Options(size[0], size[1], 3, 1));
+            ASSERT_TRUE(ring.IsValid());
+            // Noise has residuals of every size, the smooth pattern mostly small ones.
+            TestFrame noise(size[0], size[1], layout, 5);
+            TestFrame smooth(size[0], size[1], layout);
+            FillSmoothTestPattern(smooth.image(), 5);
+            ASSERT_GE(ring.Push(noise.image(), TimestampOf(0)), 0);
+            ASSERT_GE(ring.Push(smooth.image(), TimestampOf(1)), 0);
+
+            for (int frame = 0; frame < 2; ++frame) {
+                int slot = ring.Acquire(TimestampOf(frame), 0);
+                ASSERT_GE(slot, 0);
+                ExpectFrame(ring, slot, frame == 0 ? noise : smooth, frame);
+                EXPECT_EQ(ring.Release(slot), 0);
+            }
+        }
+    }
+}
+
+TEST_P(FrameRingTest, AcquireFailsOnceMaxRetainedIsReached) {
+    FrameRing ring(Options(32, 16, 4, 2));
+    std::vector<std::unique_ptr<TestFrame>> frames;
+    for (int frame = 0; frame < 4; ++frame) {
+        frames.push_back(PushFrame(&ring, 32, 16, frame));
+    }
+    int first = ring.Acquire(TimestampOf(0), 0);
+    int second = ring.Acquire(TimestampOf(1), 0);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    EXPECT_EQ(ring.Acquire(TimestampOf(2), 0), -1);
+    // Retaining a frame that is already retained takes no further room.
+    EXPECT_EQ(ring.Acquire(TimestampOf(1), 0), second);
+    EXPECT_EQ(ring.Release(second), 0);
+    EXPECT_EQ(ring.Acquire(TimestampOf(2), 0), -1);
+
+    EXPECT_EQ(ring.Release(second), 0);
+    EXPECT_EQ(ring.Release(second), -1);
+    int third = ring.Acquire(TimestampOf(2), 0);
+    ASSERT_GE(third, 0);
+    ExpectFrame(ring, first, *frames[0], 0);
+    ExpectFrame(ring, third, *frames[2], 2);
+}
+
+TEST_P(FrameRingTest, AcquireTakesTheClosestFrameWithinTheTolerance) {
+    FrameRing ring(Options(16, 16, 4, 1));
+    std::vector<std::unique_ptr<TestFrame>> frames;
+    for (int frame = 0; frame < 3; ++frame) {
+        frames.push_back(PushFrame(&ring, 16, 16, frame));
+    }
+    EXPECT_EQ(ring.Acquire(TimestampOf(3), kFrameIntervalNs / 2), -1);
+    int slot = ring.Acquire(TimestampOf(1) + kFrameIntervalNs / 3, kFrameIntervalNs / 2);
+    ASSERT_GE(slot, 0);
+    ExpectFrame(ring, slot, *frames[1], 1);
+}
+
+TEST_P(FrameRingTest, PushNeverOverwritesARetainedFrame) {
+    FrameRing ring(Options(40, 30, 3, 2));
+    std::vector<std::unique_ptr<TestFrame>> frames;
+    for (int frame = 0; frame < 3; ++frame) {
+        frames.push_back(PushFrame(&ring, 40, 30, frame));
+    }
+    // The oldest frame, which the next push would replace.
+    int oldest = ring.Acquire(TimestampOf(0), 0);
+    ASSERT_GE(oldest, 0);
+    for (int frame = 3; frame < 12; ++frame) {
+        frames.push_back(PushFrame(&ring, 40, 30, frame));
+        int slot = ring.Acquire(TimestampOf(frame), 0);
+        ASSERT_GE(slot, 0);
+        ASSERT_NE(slot, oldest);
+        ExpectFrame(ring, slot, *frames[frame], frame);
+        ASSERT_EQ(ring.Release(slot), 0);
+    }
+    ExpectFrame(ring, oldest, *frames[0], 0);
+
+    // With every slot retained there is nowhere left to push to.
+    FrameRing full(Options(40, 30, 2, 2));
+    PushFrame(&full, 40, 30, 0);
+    PushFrame(&full, 40, 30, 1);
+    ASSERT_GE(full.Acquire(TimestampOf(0), 0), 0);
+    ASSERT_GE(full.Acquire(TimestampOf(1), 0), 0);
+    TestFrame extra(40, 30, ChromaLayout::kPlanar, 2);
+    EXPECT_EQ(full.Push(extra.image(), TimestampOf(2)), -1);
+}
+
+TEST_P(FrameRingTest, RejectsFramesOfTheWrongShape) {
+    FrameRing ring(Options(32, 16, 2, 1));
+    TestFrame wrong_size(32, 18, ChromaLayout::kPlanar);
+    TestFrame wrong_subsampling(32, 16, ChromaLayout::kPlanar, 0, 64, ChromaSubsampling::k422);
+    EXPECT_EQ(ring.Push(wrong_size.image(), 0), -1);
+    EXPECT_EQ(ring.Push(wrong_subsampling.image(), 0), -1);
+    EXPECT_EQ(ring.frame_count(), 0);
+    EXPECT_FALSE(FrameRing(Options(0, 16, 2, 1)).IsValid());
+}
+
+INSTANTIATE_TEST_SUITE_P(CompressChroma, FrameRingTest, testing::Bool());
+
+TEST(FrameRingChromaLogTest, EvictsFramesWhenTheLogWrapsButKeepsRetainedOnes) {
+    FrameRingOptions options;
+    options.width = 64;
+    options.height = 32;
+    options.capacity = 8;
+    options.max_retained = 1;
+    options.compress_chroma = true;
+    // Room for about two frames of noisy chroma, far less than the eight slots.
+    options.chroma_budget_bytes = 64 * 16 * 2 + 64;
+    FrameRing ring(options);
+    ASSERT_TRUE(ring.IsValid());
+
+    std::vector<std::unique_ptr<TestFrame>> frames;
+    frames.push_back(PushFrame(&ring, 64, 32, 0));
+    int retained = ring.Acquire(TimestampOf(0), 0);
+    ASSERT_GE(retained, 0);
+    for (int frame = 1; frame < 6; ++frame) {
+        frames.push_back(PushFrame(&ring, 64, 32, frame));
+    }
+    // The log wrapped over the older frames: only the newest ones and the retained one are left,
+    // although every slot still holds its luma.
+    EXPECT_LT(ring.frame_count(), 6);
+    EXPECT_EQ(ring.Acquire(TimestampOf(1), 0), -1);
+    ExpectFrame(ring, retained, *frames[0], 0);
+
+    // Its chroma now only lives in the decoded plane, so releasing the frame drops it.
+    const int count = ring.frame_count();
+    EXPECT_EQ(ring.Release(retained), 0);
+    EXPECT_EQ(ring.frame_count(), count - 1);
+    EXPECT_EQ(ring.Acquire(TimestampOf(0), 0), -1);
+
+    int newest = ring.Acquire(TimestampOf(5), 0);
+    ASSERT_GE(newest, 0);
+    ExpectFrame(ring, newest, *frames[5], 5);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hardware_buffer_planes.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "fake_hardware_buffer_plane_provider.h"
+#include "image_kernels.h"
+#include "image_orientation.h"
+#include "image_planes.h"
+
+namespace camerax {
+namespace {
+
+constexpr int kWidth = 62;
+constexpr int kHeight = 46;
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+uint8_t LumaAt(int x, int y) {
+    return static_cast<uint8_t>(16 + (x * 7 + y * 13) % 220);
+}
+
+uint8_t UAt(int x, int y) {
+    return static_cast<uint8_t>(64 + (x * 5 + y * 3) % 128);
+}
+
+uint8_t VAt(int x, int y) {
+    return static_cast<uint8_t>(192 - (x * 3 + y * 11) % 128);
+}
+
+void FillTestPattern(const PlanarImage& image) {
+    for (int y = 0; y < image.height; ++y) {
+        for (int x = 0; x < image.width; ++x) {
+            image.y.RowAt(y)[x * image.y.pixel_stride] = LumaAt(x, y);
+        }
+    }
+    for (int y = 0; y < image.chroma_height(); ++y) {
+        for (int x = 0; x < image.chroma_width(); ++x) {
+            image.u.RowAt(y)[x * image.u.pixel_stride] = UAt(x, y);
+            image.v.RowAt(y)[x * image.v.pixel_stride] = VAt(x, y);
+        }
+    }
+}
+
+// The same pattern in tightly packed I420 memory, the reference the locked planes are compared
+// against.
+struct PlainFrame {
+    std::vector<uint8_t> memory = std::vector<uint8_t>(I420BufferSize(kWidth, kHeight));
+    PlanarImage image = WrapI420(memory.data(), kWidth, kHeight, kWidth);
+
+    PlainFrame() { FillTestPattern(image); }
+};
+
+class HardwareBufferPlanesTest : public testing::TestWithParam<ChromaLayout> {};
+
+TEST_P(HardwareBufferPlanesTest, LockDescribesPaddedPlanes) {
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, GetParam());
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ false);
+        ASSERT_TRUE(lock.ok());
+        EXPECT_TRUE(provider.locked());
+        const PlanarImage& image = lock.image();
+        EXPECT_TRUE(image.IsValid());
+        EXPECT_EQ(image.chroma_layout(), GetParam());
+        EXPECT_EQ(image.width, kWidth);
+        EXPECT_EQ(image.height, kHeight);
+        EXPECT_EQ(image.y.row_stride % 64, 0);
+        EXPECT_EQ(image.u.row_stride % 64, 0);
+    }
+    EXPECT_FALSE(provider.locked());
+    EXPECT_EQ(provider.lock_count(), 1);
+    EXPECT_EQ(provider.write_lock_count(), 0);
+}
+
+TEST_P(HardwareBufferPlanesTest, SecondLockFailsWithoutUnlocking) {
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, GetParam());
+    ScopedPlaneLock first(&provider, /* write= */ true);
+    ASSERT_TRUE(first.ok());
+    {
+        ScopedPlaneLock second(&provider, /* write= */ false);
+        EXPECT_FALSE(second.ok());
+    }
+    // The failed lock must not have released the first one.
+    EXPECT_TRUE(provider.locked());
+}
+
+TEST_P(HardwareBufferPlanesTest, ConvertsToABGRLikePlainMemory) {
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, GetParam());
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ true);
+        ASSERT_TRUE(lock.ok());
+        FillTestPattern(lock.image());
+    }
+    PlainFrame plain;
+    std::vector<uint8_t> expected(kWidth * kHeight * 4);
+    ASSERT_EQ(Android420ToABGR(plain.image, expected.data(), kWidth * 4, true), 0);
+
+    std::vector<uint8_t> actual(kWidth * kHeight * 4);
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ false);
+        ASSERT_TRUE(lock.ok());
+        ASSERT_EQ(Android420ToABGR(lock.image(), actual.data(), kWidth * 4, true), 0);
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_FALSE(provider.written_under_read_lock());
+}
+
+TEST_P(HardwareBufferPlanesTest, RotatesLikePlainMemory) {
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, GetParam());
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ true);
+        ASSERT_TRUE(lock.ok());
+        FillTestPattern(lock.image());
+    }
+    const Orientation orientation = Orientation::FromRotation(90, /* mirror= */ true);
+    PlainFrame plain;
+    std::vector<uint8_t> expected(I420BufferSize(kHeight, kWidth));
+    ASSERT_EQ(RotateAndroid420ToI420(plain.image, WrapI420(expected.data(), kHeight, kWidth,
+                                                           kHeight), orientation), 0);
+
+    std::vector<uint8_t> actual(I420BufferSize(kHeight, kWidth));
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ false);
+        ASSERT_TRUE(lock.ok());
+        ASSERT_EQ(RotateAndroid420ToI420(lock.image(), WrapI420(actual.data(), kHeight, kWidth,
+                                                                kHeight), orientation), 0);
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_FALSE(provider.written_under_read_lock());
+}
+
+TEST_P(HardwareBufferPlanesTest, WritesIntoLockedPlanes) {
+    PlainFrame plain;
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, GetParam());
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ true);
+        ASSERT_TRUE(lock.ok());
+        ASSERT_EQ(CopyAndroid420(plain.image, lock.image()), 0);
+    }
+    EXPECT_EQ(provider.write_lock_count(), 1);
+
+    std::vector<uint8_t> copy(I420BufferSize(kWidth, kHeight));
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ false);
+        ASSERT_TRUE(lock.ok());
+        ASSERT_EQ(CopyAndroid420(lock.image(), WrapI420(copy.data(), kWidth, kHeight, kWidth)),
+                  0);
+    }
+    EXPECT_EQ(copy, plain.memory);
+}
+
+TEST(FakeHardwareBufferPlaneProviderTest, RecordsWritesUnderReadLock) {
+    FakeHardwareBufferPlaneProvider provider(kWidth, kHeight, ChromaLayout::kSemiPlanarUV);
+    {
+        ScopedPlaneLock lock(&provider, /* write= */ false);
+        ASSERT_TRUE(lock.ok());
+        lock.image().y.data[0] ^= 1;
+    }
+    EXPECT_TRUE(provider.written_under_read_lock());
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, HardwareBufferPlanesTest, testing::ValuesIn(kLayouts));
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "image_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Bytes past the oriented row in the destination, which must be left alone.
+constexpr int kDstRowPadding = 12;
+constexpr uint8_t kPaddingByte = 0xA5;
+
+std::vector<uint8_t> ToRotatedABGR(const PlanarImage& src, const Orientation& orientation,
+                                   int dst_stride) {
+    int height = orientation.SwapsDimensions() ? src.width : src.height;
+    std::vector<uint8_t> scratch(static_cast<size_t>(src.width) * src.height * 4);
+    std::vector<uint8_t> abgr(static_cast<size_t>(dst_stride) * height, kPaddingByte);
+    EXPECT_EQ(Android420ToRotatedABGR(src, PixelShift(), scratch.data(), abgr.data(), dst_stride,
+                                      orientation),
+              0);
+    return abgr;
+}
+
+TEST(Android420ToRotatedABGRInBandsTest, MatchesTheFullFrameConversion) {
+    // Odd sizes leave a band with an odd number of rows and chroma rows shared by one luma row.
+    const int sizes[][2] = {{32, 24}, {33, 17}, {18, 7}, {5, 3}, {40, 50}};
+    for (ChromaLayout layout : kLayouts) {
+        for (const auto& size : sizes) {
+            TestFrame frame(size[0], size[1], layout, 11);
+            const size_t row_bytes = static_cast<size_t>(size[0]) * 4;
+            // Band heights of 2, 6, 16 and the whole frame. 3 and 7 rows round down to even
+            // bands, 20 rows to 16, and most of them do not divide the height.
+            const size_t budgets[] = {0, row_bytes * 3, row_bytes * 7, row_bytes * 16,
+                                      row_bytes * 20, row_bytes * 1000};
+            for (int rotation : {0, 90, 180, 270}) {
+                for (bool mirror : {false, true}) {
+                    Orientation orientation = Orientation::FromRotation(rotation, mirror);
+                    int width = orientation.SwapsDimensions() ? size[1] : size[0];
+                    int height = orientation.SwapsDimensions() ? size[0] : size[1];
+                    int dst_stride = width * 4 + kDstRowPadding;
+                    std::vector<uint8_t> expected =
+                            ToRotatedABGR(frame.image(), orientation, dst_stride);
+                    for (size_t budget : budgets) {
+                        SCOPED_TRACE(testing::Message()
+                                     << "layout " << static_cast<int>(layout) << " " << size[0]
+                                     << "x" << size[1] << " rotation " << rotation << " mirror "
+                                     << mirror << " budget " << budget);
+                        std::vector<uint8_t> banded(expected.size(), kPaddingByte);
+                        ASSERT_EQ(Android420ToRotatedABGRInBands(frame.image(), banded.data(),
+                                                                 dst_stride, orientation,
+                                                                 budget),
+                                  0);
+                        for (int y = 0; y < height; ++y) {
+                            ASSERT_EQ(memcmp(&banded[static_cast<size_t>(y) * dst_stride],
+                                             &expected[static_cast<size_t>(y) * dst_stride],
+                                             dst_stride),
+                                      0)
+                                    << "row " << y;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(Android420ToRotatedABGRInBandsTest, RejectsInvalidInput) {
+    TestFrame frame(16, 16, ChromaLayout::kPlanar);
+    std::vector<uint8_t> abgr(16 * 16 * 4);
+    EXPECT_EQ(Android420ToRotatedABGRInBands(frame.image(), nullptr, 64,
+                                             Orientation::FromRotation(90, false), 1024),
+              -1);
+    EXPECT_EQ(Android420ToRotatedABGRInBands(PlanarImage(), abgr.data(), 64,
+                                             Orientation::FromRotation(90, false), 1024),
+              -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "image_orientation.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "image_kernels.h"
+#include "image_planes.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Even, odd and tiny sizes, odd ones giving chroma planes that do not cover the luma evenly.
+constexpr int kSizes[][2] = {{32, 24}, {33, 17}, {18, 7}, {5, 3}};
+
+// One plane of tightly packed samples.
+struct Samples {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;
+
+    uint8_t At(int x, int y) const { return data[static_cast<size_t>(y) * width + x]; }
+};
+
+// Splits the output of ToI420 into its planes.
+std::vector<Samples> PlanesOf(const std::vector<uint8_t>& i420, int width, int height) {
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    size_t luma_size = static_cast<size_t>(width) * height;
+    size_t chroma_size = static_cast<size_t>(chroma_width) * chroma_height;
+    auto begin = i420.begin();
+    return {{width, height, std::vector<uint8_t>(begin, begin + luma_size)},
+            {chroma_width, chroma_height,
+             std::vector<uint8_t>(begin + luma_size, begin + luma_size + chroma_size)},
+            {chroma_width, chroma_height,
+             std::vector<uint8_t>(begin + luma_size + chroma_size, i420.end())}};
+}
+
+// Reverses the order of the pixels of {@code bytes_per_pixel} bytes within every row.
+std::vector<uint8_t> ReverseColumns(const std::vector<uint8_t>& image, int width, int height,
+                                    int bytes_per_pixel) {
+    std::vector<uint8_t> reversed(image.size());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int b = 0; b < bytes_per_pixel; ++b) {
+                size_t row = static_cast<size_t>(y) * width;
+                reversed[(row + width - 1 - x) * bytes_per_pixel + b] =
+                        image[(row + x) * bytes_per_pixel + b];
+            }
+        }
+    }
+    return reversed;
+}
+
+std::vector<uint8_t> RotateToI420(const PlanarImage& src, const Orientation& orientation) {
+    int width = orientation.SwapsDimensions() ? src.height : src.width;
+    int height = orientation.SwapsDimensions() ? src.width : src.height;
+    std::vector<uint8_t> memory;
+    PlanarImage dst = AllocateTestPlanes(width, height, ChromaLayout::kPlanar, 1, &memory);
+    EXPECT_EQ(RotateAndroid420ToI420(src, dst, orientation), 0);
+    return ToI420(dst);
+}
+
+std::vector<uint8_t> RotateToABGR(const PlanarImage& src, const Orientation& orientation) {
+    int width = orientation.SwapsDimensions() ? src.height : src.width;
+    std::vector<uint8_t> scratch(static_cast<size_t>(src.width) * src.height * 4);
+    std::vector<uint8_t> abgr(scratch.size());
+    EXPECT_EQ(Android420ToRotatedABGR(src, PixelShift(), scratch.data(), abgr.data(), width * 4,
+                                      orientation),
+              0);
+    return abgr;
+}
+
+TEST(OrientationTest, FromRotationNormalizesTheAngle) {
+    EXPECT_EQ(Orientation::FromRotation(-90, false).rotation, 270);
+    EXPECT_EQ(Orientation::FromRotation(450, false).rotation, 90);
+    EXPECT_TRUE(Orientation::FromRotation(360, false).IsIdentity());
+}
+
+// The EXIF definition of each tag as the source pixel shown at (x, y) of the upright image.
+struct ExifCase {
+    int tag;
+    std::function<void(int x, int y, int width, int height, int* sx, int* sy)> source_of;
+};
+
+TEST(OrientationTest, FromExifDisplaysEveryTagUpright) {
+    const ExifCase cases[] = {
+            {1, [](int x, int y, int, int, int* sx, int* sy) { *sx = x, *sy = y; }},
+            {2, [](int x, int y, int w, int, int* sx, int* sy) { *sx = w - 1 - x, *sy = y; }},
+            {3, [](int x, int y, int w, int h, int* sx, int* sy) {
+                 *sx = w - 1 - x, *sy = h - 1 - y;
+             }},
+            {4, [](int x, int y, int, int h, int* sx, int* sy) { *sx = x, *sy = h - 1 - y; }},
+            {5, [](int x, int y, int, int, int* sx, int* sy) { *sx = y, *sy = x; }},
+            {6, [](int x, int y, int, int h, int* sx, int* sy) { *sx = y, *sy = h - 1 - x; }},
+            {7, [](int x, int y, int w, int h, int* sx, int* sy) {
+                 *sx = w - 1 - y, *sy = h - 1 - x;
+             }},
+            {8, [](int x, int y, int w, int, int* sx, int* sy) { *sx = w - 1 - y, *sy = x; }},
+    };
+    TestFrame frame(10, 6, ChromaLayout::kPlanar);
+    std::vector<Samples> src = PlanesOf(ToI420(frame.image()), 10, 6);
+    for (const ExifCase& exif : cases) {
+        SCOPED_TRACE(testing::Message() << "tag " << exif.tag);
+        Orientation orientation = Orientation::FromExif(exif.tag);
+        bool transposed = exif.tag >= 5;
+        EXPECT_EQ(orientation.SwapsDimensions(), transposed);
+        int width = transposed ? 6 : 10;
+        int height = transposed ? 10 : 6;
+        std::vector<Samples> dst =
+                PlanesOf(RotateToI420(frame.image(), orientation), width, height);
+        for (int p = 0; p < 3; ++p) {
+            for (int y = 0; y < dst[p].height; ++y) {
+                for (int x = 0; x < dst[p].width; ++x) {
+                    int sx = 0;
+                    int sy = 0;
+                    exif.source_of(x, y, src[p].width, src[p].height, &sx, &sy);
+                    ASSERT_EQ(dst[p].At(x, y), src[p].At(sx, sy))
+                            << "plane " << p << " at " << x << "," << y;
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(Orientation::FromExif(0).IsIdentity());
+    EXPECT_TRUE(Orientation::FromExif(9).IsIdentity());
+}
+
+TEST(OrientationTest, MirroredI420IsTheUnmirroredWithColumnsReversed) {
+    for (ChromaLayout layout : kLayouts) {
+        for (const auto& size : kSizes) {
+            TestFrame frame(size[0], size[1], layout, 3);
+            for (int rotation : {0, 90, 180, 270}) {
+                SCOPED_TRACE(testing::Message() << "layout " << static_cast<int>(layout) << " "
+                                                << size[0] << "x" << size[1] << " rotation "
+                                                << rotation);
+                Orientation plain = Orientation::FromRotation(rotation, false);
+                int width = plain.SwapsDimensions() ? size[1] : size[0];
+                int height = plain.SwapsDimensions() ? size[0] : size[1];
+                std::vector<Samples> expected =
+                        PlanesOf(RotateToI420(frame.image(), plain), width, height);
+                std::vector<Samples> mirrored = PlanesOf(
+                        RotateToI420(frame.image(), Orientation::FromRotation(rotation, true)),
+                        width, height);
+                for (int p = 0; p < 3; ++p) {
+                    EXPECT_EQ(mirrored[p].data,
+                              ReverseColumns(expected[p].data, expected[p].width,
+                                             expected[p].height, 1))
+                            << "plane " << p;
+                }
+            }
+        }
+    }
+}
+
+TEST(OrientationTest, MirroredABGRIsTheUnmirroredWithColumnsReversed) {
+    for (ChromaLayout layout : kLayouts) {
+        for (const auto& size : kSizes) {
+            TestFrame frame(size[0], size[1], layout, 4);
+            for (int rotation : {0, 90, 180, 270}) {
+                SCOPED_TRACE(testing::Message() << "layout " << static_cast<int>(layout) << " "
+                                                << size[0] << "x" << size[1] << " rotation "
+                                                << rotation);
+                Orientation plain = Orientation::FromRotation(rotation, false);
+                int width = plain.SwapsDimensions() ? size[1] : size[0];
+                int height = plain.SwapsDimensions() ? size[0] : size[1];
+                std::vector<uint8_t> expected = RotateToABGR(frame.image(), plain);
+                EXPECT_EQ(RotateToABGR(frame.image(), Orientation::FromRotation(rotation, true)),
+                          ReverseColumns(expected, width, height, 4));
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
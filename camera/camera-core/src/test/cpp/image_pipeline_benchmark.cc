@@ -0,0 +1,92 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// The encoder input pipeline of nativeProcessAndroid420ToCodecBuffer on plain memory: a camera
+// NV12 frame rotated by 90 degrees and scaled into a 16-aligned NV12 codec buffer, through the
+// libyuv stages and through the fused rotate and scale kernel.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_pipeline.h"
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+// {source width, source height, output width, output height}, the output in portrait.
+void CodecSizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Args({1920, 1080, 720, 1280})
+            ->Args({3840, 2160, 1080, 1920})
+            ->Unit(benchmark::kMillisecond);
+}
+
+void RunCodecPipeline(benchmark::State& state, bool fused) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    const int dst_width = static_cast<int>(state.range(2));
+    const int dst_height = static_cast<int>(state.range(3));
+    TestFrame frame(width, height, ChromaLayout::kSemiPlanarUV);
+    const CodecBufferLayout layout = GetCodecBufferLayout(
+            dst_width, dst_height, ChromaLayout::kSemiPlanarUV, 16, 16);
+    std::vector<uint8_t> codec_buffer(layout.size);
+    PipelineDestination dst;
+    dst.yuv = WrapCodecBuffer(codec_buffer.data(), dst_width, dst_height,
+                              ChromaLayout::kSemiPlanarUV, layout);
+
+    PipelineRequest request;
+    request.orientation = Orientation::FromRotation(90, /* mirror= */ false);
+    request.output_width = dst_width;
+    request.output_height = dst_height;
+    request.output_format = PipelineFormat::kNV12;
+    if (fused) {
+        SetKernelImpl(Kernel::kWarp, GetKernelImpl(Kernel::kWarp));
+    }
+    PipelinePlan plan;
+    if (PlanPipeline(frame.image(), request, &plan) != 0) {
+        state.SkipWithError("PlanPipeline failed");
+    }
+    SetKernelImpl(Kernel::kWarp, KernelImpl::kAuto);
+    std::vector<uint8_t> scratch(plan.scratch_bytes);
+
+    PipelineStats stats;
+    for (auto _ : state) {
+        RunPipeline(frame.image(), plan, dst, scratch.data(), scratch.size(), &stats);
+        benchmark::ClobberMemory();
+    }
+    state.counters["stages"] = static_cast<double>(plan.stages.size());
+    state.counters["estimated_MB"] = static_cast<double>(plan.estimated_bytes) / 1e6;
+    state.counters["measured_MB"] = static_cast<double>(stats.measured_bytes) / 1e6;
+}
+
+void BM_CodecPipeline_Libyuv(benchmark::State& state) {
+    RunCodecPipeline(state, /* fused= */ false);
+}
+BENCHMARK(BM_CodecPipeline_Libyuv)->Apply(CodecSizes);
+
+void BM_CodecPipeline_Fused(benchmark::State& state) {
+    RunCodecPipeline(state, /* fused= */ true);
+}
+BENCHMARK(BM_CodecPipeline_Fused)->Apply(CodecSizes);
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "image_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "image_kernels.h"
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "libyuv/rotate_argb.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+libyuv::RotationMode RotationModeOf(int rotation) {
+    switch (rotation) {
+        case 90:
+            return libyuv::kRotate90;
+        case 180:
+            return libyuv::kRotate180;
+        case 270:
+            return libyuv::kRotate270;
+        default:
+            return libyuv::kRotate0;
+    }
+}
+
+// What nativeConvertAndroid420ToABGR did before the planner: convert at 4 bytes per pixel, then
+// rotate the ABGR result.
+std::vector<uint8_t> ConvertThenRotate(const PlanarImage& src, int rotation) {
+    std::vector<uint8_t> converted(static_cast<size_t>(src.width) * src.height * 4);
+    EXPECT_EQ(Android420ToABGR(src, converted.data(), src.width * 4, true), 0);
+    if (rotation == 0) {
+        return converted;
+    }
+    bool transposed = rotation == 90 || rotation == 270;
+    int dst_width = transposed ? src.height : src.width;
+    std::vector<uint8_t> rotated(converted.size());
+    EXPECT_EQ(libyuv::ARGBRotate(converted.data(), src.width * 4, rotated.data(), dst_width * 4,
+                                 src.width, src.height, RotationModeOf(rotation)),
+              0);
+    return rotated;
+}
+
+// What nativeConvertAndroid420ToABGR does now, see ConvertToSurface.
+std::vector<uint8_t> PlanAndRun(const PlanarImage& src, int rotation) {
+    PipelineRequest request;
+    request.orientation = Orientation::FromRotation(rotation, /* mirror= */ false);
+    PipelinePlan plan;
+    EXPECT_EQ(PlanPipeline(src, request, &plan), 0);
+    std::vector<uint8_t> abgr(static_cast<size_t>(src.width) * src.height * 4);
+    PipelineDestination dst;
+    dst.abgr = abgr.data();
+    dst.abgr_stride = plan.output_width * 4;
+    // The converted buffer of the entry point holds a full ABGR frame.
+    std::vector<uint8_t> scratch(abgr.size());
+    EXPECT_LE(plan.scratch_bytes, scratch.size());
+    EXPECT_EQ(RunPipeline(src, plan, dst, scratch.data(), scratch.size(), nullptr), 0);
+    return abgr;
+}
+
+class PipelineMatchesConvertThenRotateTest
+        : public testing::TestWithParam<std::tuple<ChromaLayout, int>> {};
+
+TEST_P(PipelineMatchesConvertThenRotateTest, EvenSize) {
+    TestFrame frame(64, 48, std::get<0>(GetParam()));
+    int rotation = std::get<1>(GetParam());
+    EXPECT_EQ(PlanAndRun(frame.image(), rotation), ConvertThenRotate(frame.image(), rotation));
+}
+
+// Rotating odd sized 4:2:0 in YUV pairs the last row or column with other chroma samples, so
+// ConvertToSurface rotates those frames after converting, through Android420ToRotatedABGR.
+TEST_P(PipelineMatchesConvertThenRotateTest, OddSizeThroughConvertedBuffer) {
+    TestFrame frame(61, 45, std::get<0>(GetParam()), /* seed= */ 1);
+    int rotation = std::get<1>(GetParam());
+    const Orientation orientation = Orientation::FromRotation(rotation, /* mirror= */ false);
+    int dst_width = orientation.SwapsDimensions() ? 45 : 61;
+    std::vector<uint8_t> abgr(61 * 45 * 4);
+    std::vector<uint8_t> converted(abgr.size());
+    ASSERT_EQ(Android420ToRotatedABGR(frame.image(), PixelShift(), converted.data(), abgr.data(),
+                                      dst_width * 4, orientation),
+              0);
+    EXPECT_EQ(abgr, ConvertThenRotate(frame.image(), rotation));
+}
+
+TEST(ImagePipelineTest, RotatesBeforeConverting) {
+    TestFrame frame(64, 48, ChromaLayout::kSemiPlanarUV);
+    PipelineRequest request;
+    request.orientation = Orientation::FromRotation(90, /* mirror= */ false);
+    PipelinePlan plan;
+    ASSERT_EQ(PlanPipeline(frame.image(), request, &plan), 0);
+    ASSERT_EQ(plan.stages.size(), 2u);
+    EXPECT_EQ(plan.stages[0].op, PipelineOp::kRotateYUV);
+    EXPECT_EQ(plan.stages[1].op, PipelineOp::kConvertToABGR);
+    EXPECT_EQ(plan.output_width, 48);
+    EXPECT_EQ(plan.output_height, 64);
+}
+
+TEST(ImagePipelineTest, FusesRotateAndScaleOnlyWhenWarpIsForced) {
+    TestFrame frame(64, 48, ChromaLayout::kSemiPlanarUV);
+    PipelineRequest request;
+    request.orientation = Orientation::FromRotation(90, /* mirror= */ false);
+    request.output_width = 36;
+    request.output_height = 48;
+    request.output_format = PipelineFormat::kNV12;
+    PipelinePlan plan;
+    ASSERT_EQ(PlanPipeline(frame.image(), request, &plan), 0);
+    for (const PipelineStage& stage : plan.stages) {
+        EXPECT_NE(stage.op, PipelineOp::kRotateScaleYUV);
+    }
+
+    ASSERT_EQ(SetKernelImpl(Kernel::kWarp, GetKernelImpl(Kernel::kWarp)), 0);
+    PipelinePlan fused;
+    EXPECT_EQ(PlanPipeline(frame.image(), request, &fused), 0);
+    ASSERT_EQ(SetKernelImpl(Kernel::kWarp, KernelImpl::kAuto), 0);
+    ASSERT_EQ(fused.stages.size(), 1u);
+    EXPECT_EQ(fused.stages[0].op, PipelineOp::kRotateScaleYUV);
+    EXPECT_LT(fused.estimated_bytes, plan.estimated_bytes);
+}
+
+INSTANTIATE_TEST_SUITE_P(LayoutsAndRotations, PipelineMatchesConvertThenRotateTest,
+                         testing::Combine(testing::ValuesIn(kLayouts),
+                                          testing::Values(0, 90, 180, 270)));
+
+}  // namespace
+}  // namespace camerax
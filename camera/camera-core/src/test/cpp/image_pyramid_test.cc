@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "image_pyramid.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "frame_arena.h"
+#include "image_kernels.h"
+#include "image_planes.h"
+#include "stripe_pool.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+// A level of the reference pyramid, tightly packed.
+struct Level {
+    int width;
+    int height;
+    std::vector<uint8_t> data;
+};
+
+Level FullResolution(const PlanarImage& src, PyramidFormat format) {
+    Level level = {src.width, src.height, {}};
+    if (format == PyramidFormat::kABGR) {
+        level.data.resize(static_cast<size_t>(src.width) * src.height * 4);
+        EXPECT_EQ(Android420ToABGR(src, level.data.data(), src.width * 4, true), 0);
+    } else {
+        level.data = ToI420(src);
+        level.data.resize(static_cast<size_t>(src.width) * src.height);
+    }
+    return level;
+}
+
+// 2x2 box average with rounding, dropping an odd last row or column.
+Level Halve(const Level& src, int channels) {
+    Level dst = {src.width / 2, src.height / 2, {}};
+    dst.data.resize(static_cast<size_t>(dst.width) * dst.height * channels);
+    auto at = [&](int x, int y, int c) {
+        return src.data[(static_cast<size_t>(y) * src.width + x) * channels + c];
+    };
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                int sum = at(2 * x, 2 * y, c) + at(2 * x + 1, 2 * y, c) + at(2 * x, 2 * y + 1, c)
+                        + at(2 * x + 1, 2 * y + 1, c);
+                dst.data[(static_cast<size_t>(y) * dst.width + x) * channels + c] =
+                        static_cast<uint8_t>((sum + 2) >> 2);
+            }
+        }
+    }
+    return dst;
+}
+
+// Bilinear resampling with pixel centers aligned and positions clamped to the edges, in floating
+// point.
+Level Resample(const Level& src, int width, int height, int channels) {
+    Level dst = {width, height, {}};
+    dst.data.resize(static_cast<size_t>(width) * height * channels);
+    auto position = [](int i, int src_size, int dst_size) {
+        double p = (i + 0.5) * src_size / dst_size - 0.5;
+        return std::min(std::max(0.0, p), static_cast<double>(src_size - 1));
+    };
+    for (int y = 0; y < height; ++y) {
+        double py = position(y, src.height, height);
+        int y0 = static_cast<int>(py);
+        int y1 = std::min(y0 + 1, src.height - 1);
+        double fy = py - y0;
+        for (int x = 0; x < width; ++x) {
+            double px = position(x, src.width, width);
+            int x0 = static_cast<int>(px);
+            int x1 = std::min(x0 + 1, src.width - 1);
+            double fx = px - x0;
+            for (int c = 0; c < channels; ++c) {
+                auto at = [&](int sx, int sy) {
+                    return src.data[(static_cast<size_t>(sy) * src.width + sx) * channels + c];
+                };
+                double top = at(x0, y0) * (1 - fx) + at(x1, y0) * fx;
+                double bottom = at(x0, y1) * (1 - fx) + at(x1, y1) * fx;
+                dst.data[(static_cast<size_t>(y) * width + x) * channels + c] =
+                        static_cast<uint8_t>(std::lround(top * (1 - fy) + bottom * fy));
+            }
+        }
+    }
+    return dst;
+}
+
+Level CopyLevel(const PyramidLevel& level, int channels) {
+    Level copy = {level.width, level.height, {}};
+    for (int y = 0; y < level.height; ++y) {
+        const uint8_t* row = level.data + static_cast<ptrdiff_t>(y) * level.stride;
+        copy.data.insert(copy.data.end(), row, row + level.width * channels);
+    }
+    return copy;
+}
+
+// Compares a level with the reference, allowing {@code max_difference} per sample. Row padding
+// is ignored.
+void ExpectLevel(const PyramidLevel& level, const Level& expected, int channels,
+                 int max_difference) {
+    ASSERT_EQ(level.width, expected.width);
+    ASSERT_EQ(level.height, expected.height);
+    ASSERT_GE(level.stride, level.width * channels);
+    for (int y = 0; y < level.height; ++y) {
+        const uint8_t* row = level.data + static_cast<ptrdiff_t>(y) * level.stride;
+        for (int i = 0; i < level.width * channels; ++i) {
+            int want = expected.data[static_cast<size_t>(y) * level.width * channels + i];
+            ASSERT_LE(std::abs(row[i] - want), max_difference)
+                    << "at row " << y << " byte " << i;
+        }
+    }
+}
+
+struct PyramidCase {
+    PyramidFormat format;
+    float ratio;
+    int level_count;
+};
+
+class PyramidTest : public testing::TestWithParam<PyramidCase> {};
+
+TEST_P(PyramidTest, MatchesAScalarReferenceWithAndWithoutPool) {
+    const PyramidCase& param = GetParam();
+    const int channels = param.format == PyramidFormat::kABGR ? 4 : 1;
+    PyramidOptions options;
+    options.format = param.format;
+    options.ratio = param.ratio;
+    options.level_count = param.level_count;
+    StripePool pool(3);
+    // Odd sizes drop the last row or column at some levels.
+    const int sizes[][2] = {{128, 96}, {203, 117}};
+    for (ChromaLayout layout : {ChromaLayout::kPlanar, ChromaLayout::kFlexible}) {
+        for (const auto& size : sizes) {
+            TestFrame frame(size[0], size[1], layout, 31);
+            for (StripePool* stripe_pool : {static_cast<StripePool*>(nullptr), &pool}) {
+                SCOPED_TRACE(testing::Message() << "layout " << static_cast<int>(layout) << " "
+                                                << size[0] << "x" << size[1] << " pool "
+                                                << (stripe_pool != nullptr));
+                // Poisoned memory, so that rows left unwritten show up.
+                std::vector<PyramidLevel> levels;
+                std::vector<uint8_t> memory(
+                        GetPyramidLayout(size[0], size[1], options, &levels), 0xA5);
+                ASSERT_FALSE(memory.empty());
+                FrameArena arena(memory.data(), memory.size());
+                ASSERT_EQ(BuildPyramid(frame.image(), options, &arena, stripe_pool, &levels), 0);
+                ASSERT_EQ(levels.size(), static_cast<size_t>(param.level_count));
+                ExpectLevel(levels[0], FullResolution(frame.image(), param.format), channels, 0);
+                // Every level is compared with the reference downscale of the level above as
+                // built, so that rounding differences do not add up over the levels.
+                for (size_t i = 1; i < levels.size(); ++i) {
+                    SCOPED_TRACE(testing::Message() << "level " << i);
+                    Level previous = CopyLevel(levels[i - 1], channels);
+                    Level expected = param.ratio == 2.0f
+                            ? Halve(previous, channels)
+                            : Resample(previous, static_cast<int>(previous.width / param.ratio),
+                                       static_cast<int>(previous.height / param.ratio),
+                                       channels);
+                    // The bilinear weights are quantized to 1/256, and the SIMD box filter of
+                    // libyuv for ARGB rounds after each of its two averaging steps.
+                    int max_difference = param.ratio != 2.0f || channels == 4 ? 1 : 0;
+                    ExpectLevel(levels[i], expected, channels, max_difference);
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(FormatsAndRatios, PyramidTest,
+                         testing::Values(PyramidCase{PyramidFormat::kY8, 2.0f, 4},
+                                         PyramidCase{PyramidFormat::kY8, 2.0f, 6},
+                                         PyramidCase{PyramidFormat::kABGR, 2.0f, 4},
+                                         PyramidCase{PyramidFormat::kY8, 1.5f, 5},
+                                         PyramidCase{PyramidFormat::kABGR, 1.7f, 3}));
+
+TEST(PyramidLayoutTest, RejectsEmptyLevelsAndInvalidOptions) {
+    std::vector<PyramidLevel> levels;
+    PyramidOptions options;
+    options.level_count = 5;
+    EXPECT_GT(GetPyramidLayout(16, 16, options, &levels), 0u);
+    EXPECT_EQ(levels.back().width, 1);
+    options.level_count = 6;
+    EXPECT_EQ(GetPyramidLayout(16, 16, options, &levels), 0u);
+    options.level_count = 2;
+    options.ratio = 1.0f;
+    EXPECT_EQ(GetPyramidLayout(16, 16, options, &levels), 0u);
+}
+
+}  // namespace
+}  // namespace camerax
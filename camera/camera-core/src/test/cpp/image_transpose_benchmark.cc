@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Tiled rotations against the libyuv calls they replace, at 12MP (4000x3000) and
+// 50MP (8160x6120).
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_kernels.h"
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "image_transpose.h"
+#include "libyuv/rotate.h"
+#include "libyuv/rotate_argb.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+void FrameSizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Args({4000, 3000})->Args({8160, 6120})->Unit(benchmark::kMillisecond);
+}
+
+void SetBytesProcessed(benchmark::State& state, size_t bytes_per_frame) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes_per_frame));
+}
+
+void BM_RotatePlane90_Libyuv(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> src(static_cast<size_t>(width) * height, 0x80);
+    std::vector<uint8_t> dst(src.size());
+    for (auto _ : state) {
+        libyuv::RotatePlane(src.data(), width, dst.data(), height, width, height,
+                            libyuv::kRotate90);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, src.size());
+}
+BENCHMARK(BM_RotatePlane90_Libyuv)->Apply(FrameSizes);
+
+void BM_RotatePlane90_Tiled(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> src(static_cast<size_t>(width) * height, 0x80);
+    std::vector<uint8_t> dst(src.size());
+    for (auto _ : state) {
+        RotatePlaneTiled(src.data(), width, dst.data(), height, width, height, 90);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, src.size());
+}
+BENCHMARK(BM_RotatePlane90_Tiled)->Apply(FrameSizes);
+
+void BM_RotateABGR90_Libyuv(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> src(static_cast<size_t>(width) * height * 4, 0x80);
+    std::vector<uint8_t> dst(src.size());
+    for (auto _ : state) {
+        libyuv::ARGBRotate(src.data(), width * 4, dst.data(), height * 4, width, height,
+                           libyuv::kRotate90);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, src.size());
+}
+BENCHMARK(BM_RotateABGR90_Libyuv)->Apply(FrameSizes);
+
+void BM_RotateABGR90_Tiled(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> src(static_cast<size_t>(width) * height * 4, 0x80);
+    std::vector<uint8_t> dst(src.size());
+    for (auto _ : state) {
+        RotateABGRTiled(src.data(), width * 4, dst.data(), height * 4, width, height, 90);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, src.size());
+}
+BENCHMARK(BM_RotateABGR90_Tiled)->Apply(FrameSizes);
+
+// A whole NV12 frame into I420, as RotateAndroid420ToI420 did through libyuv before the tiled
+// kernels.
+void BM_RotateNV12ToI420_Libyuv(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    TestFrame frame(width, height, ChromaLayout::kSemiPlanarUV);
+    const PlanarImage& src = frame.image();
+    std::vector<uint8_t> dst_memory(I420BufferSize(height, width));
+    PlanarImage dst = WrapI420(dst_memory.data(), height, width, height);
+    for (auto _ : state) {
+        libyuv::Android420ToI420Rotate(src.y.data, src.y.row_stride, src.u.data, src.u.row_stride,
+                                       src.v.data, src.v.row_stride, src.u.pixel_stride,
+                                       dst.y.data, dst.y.row_stride, dst.u.data,
+                                       dst.u.row_stride, dst.v.data, dst.v.row_stride, width,
+                                       height, libyuv::kRotate90);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, dst_memory.size());
+}
+BENCHMARK(BM_RotateNV12ToI420_Libyuv)->Apply(FrameSizes);
+
+void BM_RotateNV12ToI420_Tiled(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    TestFrame frame(width, height, ChromaLayout::kSemiPlanarUV);
+    std::vector<uint8_t> dst_memory(I420BufferSize(height, width));
+    PlanarImage dst = WrapI420(dst_memory.data(), height, width, height);
+    const Orientation orientation = Orientation::FromRotation(90, /* mirror= */ false);
+    for (auto _ : state) {
+        RotateAndroid420ToI420(frame.image(), dst, orientation);
+        benchmark::ClobberMemory();
+    }
+    SetBytesProcessed(state, dst_memory.size());
+}
+BENCHMARK(BM_RotateNV12ToI420_Tiled)->Apply(FrameSizes);
+
+}  // namespace
+}  // namespace camerax
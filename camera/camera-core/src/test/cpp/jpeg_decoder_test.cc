@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jpeg_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "jpeg_encoder.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+// Scaling in the DCT domain and box filtering the full decode agree closely on smooth content.
+constexpr double kMinPsnr = 30;
+
+std::vector<uint8_t> EncodeSmoothFrame(int width, int height) {
+    TestFrame frame(width, height, ChromaLayout::kSemiPlanarVU);
+    FillSmoothTestPattern(frame.image(), 7);
+    std::vector<uint8_t> jpeg(MaxJpegSize(width, height));
+    long size = EncodeAndroid420ToJpeg(frame.image(), 95, Orientation(), jpeg.data(),
+                                       jpeg.size());
+    EXPECT_GT(size, 0);
+    jpeg.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    return jpeg;
+}
+
+// Averages denom x denom blocks of an interleaved image, clipping the blocks at the right and
+// bottom edges the way a scaled decode covers them.
+std::vector<uint8_t> BoxDownscale(const std::vector<uint8_t>& src, int width, int height,
+                                  int channels, int denom) {
+    int dst_width = (width + denom - 1) / denom;
+    int dst_height = (height + denom - 1) / denom;
+    std::vector<uint8_t> dst(static_cast<size_t>(dst_width) * dst_height * channels);
+    for (int y = 0; y < dst_height; ++y) {
+        for (int x = 0; x < dst_width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                int sum = 0;
+                int count = 0;
+                for (int sy = y * denom; sy < std::min(height, (y + 1) * denom); ++sy) {
+                    for (int sx = x * denom; sx < std::min(width, (x + 1) * denom); ++sx) {
+                        sum += src[(static_cast<size_t>(sy) * width + sx) * channels + c];
+                        ++count;
+                    }
+                }
+                dst[(static_cast<size_t>(y) * dst_width + x) * channels + c] =
+                        static_cast<uint8_t>((sum + count / 2) / count);
+            }
+        }
+    }
+    return dst;
+}
+
+// Drops the alpha channel, which is always opaque and would only inflate the PSNR.
+std::vector<uint8_t> RgbOf(const std::vector<uint8_t>& rgba) {
+    std::vector<uint8_t> rgb;
+    rgb.reserve(rgba.size() / 4 * 3);
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        rgb.insert(rgb.end(), rgba.begin() + i, rgba.begin() + i + 3);
+    }
+    return rgb;
+}
+
+std::vector<uint8_t> DecodeRGBA(const std::vector<uint8_t>& jpeg, int scale_denom, int* width,
+                                int* height) {
+    ScaledDecodeOptions options;
+    options.scale_denom = scale_denom;
+    EXPECT_EQ(GetScaledJpegSize(jpeg.data(), jpeg.size(), options, width, height), 0);
+    std::vector<uint8_t> rgba(static_cast<size_t>(*width) * *height * 4);
+    EXPECT_EQ(DecodeJpegToRGBA(jpeg.data(), jpeg.size(), options, rgba.data(), *width * 4), 0);
+    return rgba;
+}
+
+std::vector<uint8_t> DecodeI420(const std::vector<uint8_t>& jpeg, int scale_denom, int* width,
+                                int* height) {
+    ScaledDecodeOptions options;
+    options.scale_denom = scale_denom;
+    EXPECT_EQ(GetScaledJpegSize(jpeg.data(), jpeg.size(), options, width, height), 0);
+    std::vector<uint8_t> memory;
+    PlanarImage dst = AllocateTestPlanes(*width, *height, ChromaLayout::kPlanar, 1, &memory);
+    EXPECT_EQ(DecodeJpegToAndroid420(jpeg.data(), jpeg.size(), options, dst), 0);
+    return ToI420(dst);
+}
+
+class ScaledDecodeTest : public testing::TestWithParam<int> {};
+
+TEST_P(ScaledDecodeTest, RGBAMatchesADownscaledFullDecode) {
+    const int denom = GetParam();
+    // 203 x 117 leaves partial MCUs and partial scaled blocks at the edges.
+    for (const auto& size : {std::make_pair(256, 128), std::make_pair(203, 117)}) {
+        SCOPED_TRACE(testing::Message() << size.first << "x" << size.second);
+        std::vector<uint8_t> jpeg = EncodeSmoothFrame(size.first, size.second);
+        int full_width = 0;
+        int full_height = 0;
+        std::vector<uint8_t> full = RgbOf(DecodeRGBA(jpeg, 1, &full_width, &full_height));
+        ASSERT_EQ(full_width, size.first);
+        ASSERT_EQ(full_height, size.second);
+
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> scaled = RgbOf(DecodeRGBA(jpeg, denom, &width, &height));
+        EXPECT_EQ(width, (size.first + denom - 1) / denom);
+        EXPECT_EQ(height, (size.second + denom - 1) / denom);
+        EXPECT_GT(Psnr(BoxDownscale(full, full_width, full_height, 3, denom), scaled), kMinPsnr);
+    }
+}
+
+TEST_P(ScaledDecodeTest, Android420MatchesADownscaledFullDecode) {
+    const int denom = GetParam();
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(203, 117);
+    int full_width = 0;
+    int full_height = 0;
+    std::vector<uint8_t> full = DecodeI420(jpeg, 1, &full_width, &full_height);
+    full.resize(static_cast<size_t>(full_width) * full_height);
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> scaled = DecodeI420(jpeg, denom, &width, &height);
+    ASSERT_EQ(width, (203 + denom - 1) / denom);
+    ASSERT_EQ(height, (117 + denom - 1) / denom);
+    scaled.resize(static_cast<size_t>(width) * height);
+    EXPECT_GT(Psnr(BoxDownscale(full, full_width, full_height, 1, denom), scaled), kMinPsnr);
+}
+
+INSTANTIATE_TEST_SUITE_P(Denominators, ScaledDecodeTest, testing::Values(2, 4, 8));
+
+TEST(JpegDecoderTest, RejectsTruncatedInput) {
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(96, 64);
+    std::vector<uint8_t> rgba(96 * 64 * 4);
+    ScaledDecodeOptions options;
+    int width = 0;
+    int height = 0;
+    // Cut inside the headers and inside the entropy coded data.
+    for (size_t size : {size_t(0), size_t(2), size_t(100), jpeg.size() / 2, jpeg.size() - 64}) {
+        SCOPED_TRACE(testing::Message() << size << " of " << jpeg.size() << " bytes");
+        std::vector<uint8_t> truncated(jpeg.begin(), jpeg.begin() + size);
+        if (size < 200) {
+            EXPECT_EQ(GetScaledJpegSize(truncated.data(), size, options, &width, &height), -1);
+        }
+        EXPECT_EQ(DecodeJpegToRGBA(truncated.data(), size, options, rgba.data(), 96 * 4), -1);
+    }
+}
+
+TEST(JpegDecoderTest, RejectsCorruptInput) {
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(96, 64);
+    std::vector<uint8_t> memory;
+    PlanarImage dst = AllocateTestPlanes(96, 64, ChromaLayout::kSemiPlanarUV, 64, &memory);
+    ScaledDecodeOptions options;
+
+    std::vector<uint8_t> not_a_jpeg(jpeg.size(), 0x5A);
+    EXPECT_EQ(DecodeJpegToAndroid420(not_a_jpeg.data(), not_a_jpeg.size(), options, dst), -1);
+
+    // A marker in the middle of the entropy coded data ends the scan early.
+    std::vector<uint8_t> corrupt = jpeg;
+    size_t middle = corrupt.size() / 2;
+    corrupt[middle] = 0xFF;
+    corrupt[middle + 1] = 0xD9;
+    EXPECT_EQ(DecodeJpegToAndroid420(corrupt.data(), corrupt.size(), options, dst), -1);
+
+    EXPECT_EQ(DecodeJpegToAndroid420(nullptr, jpeg.size(), options, dst), -1);
+    options.scale_denom = 3;
+    EXPECT_EQ(DecodeJpegToAndroid420(jpeg.data(), jpeg.size(), options, dst), -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jpeg_encoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "image_kernels.h"
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "jpeg_blob.h"
+#include "test_frames.h"
+#include "test_jpeg.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Quality 95 on the smooth pattern stays well above this in every plane.
+constexpr double kMinPsnr = 38;
+
+std::vector<uint8_t> Encode(const PlanarImage& src, int quality, const Orientation& orientation) {
+    std::vector<uint8_t> jpeg(MaxJpegSize(src.width, src.height));
+    long size = EncodeAndroid420ToJpeg(src, quality, orientation, jpeg.data(), jpeg.size());
+    EXPECT_GT(size, 0);
+    jpeg.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    return jpeg;
+}
+
+// Compares each plane separately, since a broken chroma plane barely moves the PSNR of the whole
+// frame.
+void ExpectCloseI420(const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual,
+                     int width, int height) {
+    ASSERT_EQ(expected.size(), actual.size());
+    size_t luma_size = static_cast<size_t>(width) * height;
+    size_t chroma_size = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    const size_t offsets[] = {0, luma_size, luma_size + chroma_size, expected.size()};
+    for (int p = 0; p < 3; ++p) {
+        std::vector<uint8_t> a(expected.begin() + offsets[p], expected.begin() + offsets[p + 1]);
+        std::vector<uint8_t> b(actual.begin() + offsets[p], actual.begin() + offsets[p + 1]);
+        EXPECT_GT(Psnr(a, b), kMinPsnr) << "plane " << p;
+    }
+}
+
+TEST(JpegEncoderTest, RoundTripsEveryLayout) {
+    // Odd sizes leave partial MCUs at the right and bottom edges.
+    const int sizes[][2] = {{64, 48}, {37, 29}, {130, 18}};
+    for (ChromaLayout layout : kLayouts) {
+        for (const auto& size : sizes) {
+            SCOPED_TRACE(testing::Message() << "layout " << static_cast<int>(layout) << " "
+                                            << size[0] << "x" << size[1]);
+            std::vector<uint8_t> memory;
+            PlanarImage src = AllocateTestPlanes(size[0], size[1], layout, 64, &memory);
+            FillSmoothTestPattern(src, 1);
+
+            std::vector<uint8_t> jpeg = Encode(src, 95, Orientation());
+            DecodedJpeg decoded;
+            ASSERT_TRUE(DecodeReferenceJpeg(jpeg.data(), jpeg.size(), &decoded));
+            ASSERT_EQ(decoded.width, size[0]);
+            ASSERT_EQ(decoded.height, size[1]);
+            ExpectCloseI420(ToI420(src), DecodedJpegToI420(decoded), size[0], size[1]);
+        }
+    }
+}
+
+TEST(JpegEncoderTest, AppliesTheOrientation) {
+    TestFrame frame(45, 27, ChromaLayout::kSemiPlanarVU);
+    FillSmoothTestPattern(frame.image(), 2);
+    for (int rotation : {0, 90, 180, 270}) {
+        for (bool mirror : {false, true}) {
+            SCOPED_TRACE(testing::Message() << "rotation " << rotation << " mirror " << mirror);
+            Orientation orientation = Orientation::FromRotation(rotation, mirror);
+            int width = orientation.SwapsDimensions() ? 27 : 45;
+            int height = orientation.SwapsDimensions() ? 45 : 27;
+            std::vector<uint8_t> memory;
+            PlanarImage rotated =
+                    AllocateTestPlanes(width, height, ChromaLayout::kPlanar, 1, &memory);
+            ASSERT_EQ(RotateAndroid420ToI420(frame.image(), rotated, orientation), 0);
+
+            std::vector<uint8_t> jpeg = Encode(frame.image(), 95, orientation);
+            DecodedJpeg decoded;
+            ASSERT_TRUE(DecodeReferenceJpeg(jpeg.data(), jpeg.size(), &decoded));
+            ASSERT_EQ(decoded.width, width);
+            ASSERT_EQ(decoded.height, height);
+            ExpectCloseI420(ToI420(rotated), DecodedJpegToI420(decoded), width, height);
+        }
+    }
+}
+
+TEST(JpegEncoderTest, IgnoresTheRowPadding) {
+    // 75 = 4 * 16 + 11, so the last MCU column reaches into the row padding of every plane.
+    for (ChromaLayout layout : {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV}) {
+        SCOPED_TRACE(testing::Message() << "layout " << static_cast<int>(layout));
+        std::vector<uint8_t> zero_padded;
+        PlanarImage src = AllocateTestPlanes(75, 40, layout, 128, &zero_padded);
+        FillSmoothTestPattern(src, 6);
+
+        // The same samples with every other byte of the buffer set.
+        std::vector<uint8_t> set_padded;
+        PlanarImage copy = AllocateTestPlanes(75, 40, layout, 128, &set_padded);
+        std::fill(set_padded.begin(), set_padded.end(), 0xFF);
+        FillSmoothTestPattern(copy, 6);
+        ASSERT_EQ(ToI420(copy), ToI420(src));
+
+        EXPECT_EQ(Encode(copy, 90, Orientation()), Encode(src, 90, Orientation()));
+    }
+}
+
+// What EncodeToBlobSurface does with the locked BLOB buffer.
+TEST(JpegEncoderTest, FinishesTheBlobWithATrailer) {
+    TestFrame frame(96, 64, ChromaLayout::kSemiPlanarUV);
+    FillSmoothTestPattern(frame.image(), 3);
+    const size_t max_jpeg_size = MaxJpegSize(96, 64);
+    std::vector<uint8_t> blob(JpegBlobBufferSize(max_jpeg_size), 0xAB);
+
+    long jpeg_size = EncodeAndroid420ToJpeg(frame.image(), 95, Orientation(), blob.data(),
+                                            max_jpeg_size);
+    ASSERT_GT(jpeg_size, 0);
+    ASSERT_LE(static_cast<size_t>(jpeg_size), max_jpeg_size);
+    FinishJpegBlob(blob.data(), blob.size(), static_cast<size_t>(jpeg_size));
+
+    Camera3JpegBlob trailer;
+    memcpy(&trailer, blob.data() + blob.size() - sizeof(Camera3JpegBlob), sizeof(trailer));
+    EXPECT_EQ(trailer.jpeg_blob_id, kCamera3JpegBlobId);
+    EXPECT_EQ(trailer.jpeg_size, static_cast<uint32_t>(jpeg_size));
+    for (size_t i = jpeg_size; i < blob.size() - sizeof(Camera3JpegBlob); ++i) {
+        ASSERT_EQ(blob[i], 0) << "at " << i;
+    }
+
+    DecodedJpeg decoded;
+    ASSERT_TRUE(DecodeReferenceJpeg(blob.data(), trailer.jpeg_size, &decoded));
+    ASSERT_EQ(decoded.width, 96);
+    ASSERT_EQ(decoded.height, 64);
+    ExpectCloseI420(ToI420(frame.image()), DecodedJpegToI420(decoded), 96, 64);
+}
+
+TEST(JpegEncoderTest, MaxJpegSizeHoldsNoiseAtFullQuality) {
+    for (int rotation : {0, 90}) {
+        TestFrame frame(61, 35, ChromaLayout::kPlanar, 4);
+        std::vector<uint8_t> jpeg(MaxJpegSize(61, 35));
+        EXPECT_GT(EncodeAndroid420ToJpeg(frame.image(), 100,
+                                         Orientation::FromRotation(rotation, false),
+                                         jpeg.data(), jpeg.size()),
+                  0);
+    }
+}
+
+TEST(JpegEncoderTest, FailsWithinTheCapacityWhenTheJpegDoesNotFit) {
+    TestFrame frame(128, 96, ChromaLayout::kFlexible, 5);
+    const size_t max_jpeg_size = MaxJpegSize(128, 96);
+    std::vector<uint8_t> blob(JpegBlobBufferSize(max_jpeg_size), 0xAB);
+    // Far too small for the noise of the test pattern.
+    const size_t capacity = max_jpeg_size / 16;
+
+    EXPECT_EQ(EncodeAndroid420ToJpeg(frame.image(), 100, Orientation(), blob.data(), capacity),
+              -1);
+    for (size_t i = capacity; i < blob.size(); ++i) {
+        ASSERT_EQ(blob[i], 0xAB) << "written past the capacity at " << i;
+    }
+
+    // The failed buffer is posted cleared, without a trailer a consumer could trust.
+    ClearFailedJpegBlob(blob.data(), blob.size());
+    for (size_t i = 0; i < blob.size(); ++i) {
+        ASSERT_EQ(blob[i], 0) << "at " << i;
+    }
+    Camera3JpegBlob trailer;
+    memcpy(&trailer, blob.data() + blob.size() - sizeof(Camera3JpegBlob), sizeof(trailer));
+    EXPECT_NE(trailer.jpeg_blob_id, kCamera3JpegBlobId);
+}
+
+TEST(JpegEncoderTest, RejectsInvalidInput) {
+    TestFrame frame(16, 16, ChromaLayout::kPlanar);
+    std::vector<uint8_t> jpeg(MaxJpegSize(16, 16));
+    EXPECT_EQ(EncodeAndroid420ToJpeg(frame.image(), 90, Orientation(), nullptr, jpeg.size()), -1);
+    EXPECT_EQ(EncodeAndroid420ToJpeg(PlanarImage(), 90, Orientation(), jpeg.data(), jpeg.size()),
+              -1);
+    TestFrame frame_422(16, 16, ChromaLayout::kPlanar, 0, 64, ChromaSubsampling::k422);
+    EXPECT_EQ(EncodeAndroid420ToJpeg(frame_422.image(), 90, Orientation(), jpeg.data(),
+                                     jpeg.size()),
+              -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jpeg_transform.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_planes.h"
+#include "jpeg_encoder.h"
+#include "test_frames.h"
+#include "test_jpeg.h"
+
+namespace camerax {
+namespace {
+
+// 4:2:0 iMCUs are 16x16 pixels.
+constexpr int kImcuSize = 16;
+
+// The inverse DCT rounds a little differently on transposed blocks.
+constexpr int kMaxDifference = 2;
+
+struct OpGeometry {
+    JpegTransformOp op;
+    bool transpose;
+    // Whether the source columns and rows are walked backwards.
+    bool mirror_columns;
+    bool mirror_rows;
+};
+
+constexpr OpGeometry kOps[] = {
+        {JpegTransformOp::kNone, false, false, false},
+        {JpegTransformOp::kFlipHorizontal, false, true, false},
+        {JpegTransformOp::kFlipVertical, false, false, true},
+        {JpegTransformOp::kTranspose, true, false, false},
+        {JpegTransformOp::kTransverse, true, true, true},
+        {JpegTransformOp::kRotate90, true, false, true},
+        {JpegTransformOp::kRotate180, false, true, true},
+        {JpegTransformOp::kRotate270, true, true, false},
+};
+
+std::vector<uint8_t> EncodeSmoothFrame(int width, int height) {
+    TestFrame frame(width, height, ChromaLayout::kPlanar);
+    FillSmoothTestPattern(frame.image(), 9);
+    std::vector<uint8_t> jpeg(MaxJpegSize(width, height));
+    long size = EncodeAndroid420ToJpeg(frame.image(), 90, Orientation(), jpeg.data(),
+                                       jpeg.size());
+    EXPECT_GT(size, 0);
+    jpeg.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    return jpeg;
+}
+
+// Applies the transformation to decoded pixels, trimming partial iMCUs at mirrored edges first.
+DecodedJpeg TransformPixels(const DecodedJpeg& src, const OpGeometry& geometry) {
+    int width = src.width;
+    int height = src.height;
+    if (geometry.mirror_columns) {
+        width -= width % kImcuSize;
+    }
+    if (geometry.mirror_rows) {
+        height -= height % kImcuSize;
+    }
+    DecodedJpeg dst;
+    dst.width = geometry.transpose ? height : width;
+    dst.height = geometry.transpose ? width : height;
+    dst.ycbcr.resize(static_cast<size_t>(dst.width) * dst.height * 3);
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            int sx = geometry.transpose ? y : x;
+            int sy = geometry.transpose ? x : y;
+            if (geometry.mirror_columns) {
+                sx = width - 1 - sx;
+            }
+            if (geometry.mirror_rows) {
+                sy = height - 1 - sy;
+            }
+            for (int c = 0; c < 3; ++c) {
+                dst.ycbcr[(static_cast<size_t>(y) * dst.width + x) * 3 + c] =
+                        src.ycbcr[(static_cast<size_t>(sy) * src.width + sx) * 3 + c];
+            }
+        }
+    }
+    return dst;
+}
+
+class JpegTransformTest
+        : public testing::TestWithParam<std::tuple<OpGeometry, std::pair<int, int>>> {};
+
+TEST_P(JpegTransformTest, MatchesDecodeThenTransform) {
+    const OpGeometry& geometry = std::get<0>(GetParam());
+    const int width = std::get<1>(GetParam()).first;
+    const int height = std::get<1>(GetParam()).second;
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(width, height);
+    DecodedJpeg decoded;
+    ASSERT_TRUE(DecodeReferenceJpeg(jpeg.data(), jpeg.size(), &decoded));
+    DecodedJpeg expected = TransformPixels(decoded, geometry);
+
+    JpegTransformOptions options;
+    options.op = geometry.op;
+    std::vector<uint8_t> transformed(MaxTransformedJpegSize(jpeg.size()));
+    long size = TransformJpeg(jpeg.data(), jpeg.size(), options, transformed.data(),
+                              transformed.size());
+    ASSERT_GT(size, 0);
+    DecodedJpeg actual;
+    ASSERT_TRUE(DecodeReferenceJpeg(transformed.data(), static_cast<size_t>(size), &actual));
+    ASSERT_EQ(actual.width, expected.width);
+    ASSERT_EQ(actual.height, expected.height);
+    for (size_t i = 0; i < expected.ycbcr.size(); ++i) {
+        ASSERT_LE(std::abs(actual.ycbcr[i] - expected.ycbcr[i]), kMaxDifference)
+                << "at pixel " << i / 3 << " component " << i % 3;
+    }
+}
+
+TEST_P(JpegTransformTest, PerfectFailsOnlyOnPartialMirroredEdges) {
+    const OpGeometry& geometry = std::get<0>(GetParam());
+    const int width = std::get<1>(GetParam()).first;
+    const int height = std::get<1>(GetParam()).second;
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(width, height);
+
+    JpegTransformOptions options;
+    options.op = geometry.op;
+    options.edge_mode = JpegEdgeMode::kPerfect;
+    std::vector<uint8_t> transformed(MaxTransformedJpegSize(jpeg.size()));
+    long size = TransformJpeg(jpeg.data(), jpeg.size(), options, transformed.data(),
+                              transformed.size());
+    bool imperfect = (geometry.mirror_columns && width % kImcuSize != 0)
+            || (geometry.mirror_rows && height % kImcuSize != 0);
+    if (imperfect) {
+        EXPECT_EQ(size, -1);
+    } else {
+        EXPECT_GT(size, 0);
+    }
+}
+
+std::string NameOf(
+        const testing::TestParamInfo<std::tuple<OpGeometry, std::pair<int, int>>>& info) {
+    return "Op" + std::to_string(static_cast<int>(std::get<0>(info.param).op)) + "_"
+            + std::to_string(std::get<1>(info.param).first) + "x"
+            + std::to_string(std::get<1>(info.param).second);
+}
+
+// 64x48 is made of whole iMCUs, 61x45 and 40x70 are not along either or one axis.
+INSTANTIATE_TEST_SUITE_P(AllOps, JpegTransformTest,
+                         testing::Combine(testing::ValuesIn(kOps),
+                                          testing::Values(std::make_pair(64, 48),
+                                                          std::make_pair(61, 45),
+                                                          std::make_pair(40, 70))),
+                         NameOf);
+
+TEST(JpegTransformTest, FailsWhenTheOutputDoesNotFit) {
+    std::vector<uint8_t> jpeg = EncodeSmoothFrame(64, 48);
+    JpegTransformOptions options;
+    options.op = JpegTransformOp::kRotate90;
+    std::vector<uint8_t> transformed(jpeg.size() / 4);
+    EXPECT_EQ(TransformJpeg(jpeg.data(), jpeg.size(), options, transformed.data(),
+                            transformed.size()),
+              -1);
+    std::vector<uint8_t> not_a_jpeg(jpeg.size(), 0x5A);
+    transformed.resize(MaxTransformedJpegSize(jpeg.size()));
+    EXPECT_EQ(TransformJpeg(not_a_jpeg.data(), not_a_jpeg.size(), options, transformed.data(),
+                            transformed.size()),
+              -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "kernel_dispatch.h"
+
+#include <gtest/gtest.h>
+
+namespace camerax {
+namespace {
+
+TEST(KernelDispatchTest, RejectsImplsThatAreNotEnumerators) {
+    for (int impl : {-1, kKernelImplCount, 31, 32, 1 << 30}) {
+        EXPECT_FALSE(IsKernelImplAvailable(Kernel::kTranspose, static_cast<KernelImpl>(impl)));
+        EXPECT_EQ(SetKernelImpl(Kernel::kTranspose, static_cast<KernelImpl>(impl)), -1);
+    }
+    EXPECT_EQ(GetKernelImplOverride(Kernel::kTranspose), KernelImpl::kAuto);
+}
+
+TEST(KernelDispatchTest, ForcesAndRestoresAnImpl) {
+    const KernelImpl best = GetKernelImpl(Kernel::kMask);
+    ASSERT_EQ(SetKernelImpl(Kernel::kMask, KernelImpl::kScalar), 0);
+    EXPECT_EQ(GetKernelImpl(Kernel::kMask), KernelImpl::kScalar);
+    EXPECT_EQ(GetKernelImplOverride(Kernel::kMask), KernelImpl::kScalar);
+    ASSERT_EQ(SetKernelImpl(Kernel::kMask, KernelImpl::kAuto), 0);
+    EXPECT_EQ(GetKernelImpl(Kernel::kMask), best);
+    EXPECT_EQ(GetKernelImplOverride(Kernel::kMask), KernelImpl::kAuto);
+}
+
+TEST(KernelDispatchTest, DefaultsToAnAvailableImpl) {
+    for (int kernel = 0; kernel < kKernelCount; ++kernel) {
+        EXPECT_TRUE(IsKernelImplAvailable(static_cast<Kernel>(kernel),
+                                          GetKernelImpl(static_cast<Kernel>(kernel))))
+                << GetKernelName(static_cast<Kernel>(kernel));
+    }
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+TEST(KernelDispatchTest, CompilesNeonIntoEveryKernel) {
+    for (int kernel = 0; kernel < kKernelCount; ++kernel) {
+        // libyuv is prebuilt for the host.
+        if (static_cast<Kernel>(kernel) != Kernel::kLibyuv) {
+            EXPECT_TRUE(IsKernelImplAvailable(static_cast<Kernel>(kernel), KernelImpl::kNeon))
+                    << GetKernelName(static_cast<Kernel>(kernel));
+        }
+    }
+}
+#endif
+
+}  // namespace
+}  // namespace camerax
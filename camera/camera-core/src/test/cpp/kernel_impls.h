@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAMERA_CORE_TEST_KERNEL_IMPLS_H_
+#define CAMERA_CORE_TEST_KERNEL_IMPLS_H_
+
+#include <vector>
+
+#include "kernel_dispatch.h"
+
+namespace camerax {
+
+/**
+ * The SIMD implementations of {@code kernel} that this build and CPU run, i.e. every available
+ * one except kAuto and kScalar. The NEON build of the tests runs kNeon against the scalar model
+ * of <arm_neon.h>.
+ */
+inline std::vector<KernelImpl> SimdImpls(Kernel kernel) {
+    std::vector<KernelImpl> impls;
+    for (int impl = static_cast<int>(KernelImpl::kScalar) + 1; impl < kKernelImplCount; ++impl) {
+        if (IsKernelImplAvailable(kernel, static_cast<KernelImpl>(impl))) {
+            impls.push_back(static_cast<KernelImpl>(impl));
+        }
+    }
+    return impls;
+}
+
+/** Forces an implementation of a kernel while in scope, then restores kAuto. */
+class ScopedKernelImpl {
+public:
+    ScopedKernelImpl(Kernel kernel, KernelImpl impl) : kernel_(kernel) {
+        ok_ = SetKernelImpl(kernel, impl) == 0;
+    }
+
+    ~ScopedKernelImpl() { SetKernelImpl(kernel_, KernelImpl::kAuto); }
+
+    ScopedKernelImpl(const ScopedKernelImpl&) = delete;
+    ScopedKernelImpl& operator=(const ScopedKernelImpl&) = delete;
+
+    /** Whether the implementation was available and is forced. */
+    bool ok() const { return ok_; }
+
+private:
+    const Kernel kernel_;
+    bool ok_;
+};
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_TEST_KERNEL_IMPLS_H_
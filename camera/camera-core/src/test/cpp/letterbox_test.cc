@@ -0,0 +1,318 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "letterbox.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_pipeline.h"
+#include "image_planes.h"
+#include "stripe_pool.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+constexpr uint8_t kPoison = 0xa5;
+
+// A source size, the crop of the request (empty for the whole frame) and the box.
+struct Case {
+    int width;
+    int height;
+    int crop_left;
+    int crop_top;
+    int crop_width;
+    int crop_height;
+    int box_width;
+    int box_height;
+};
+
+constexpr Case kCases[] = {
+        // The oriented crop fits the box unscaled, at an odd offset when centered.
+        {64, 48, 6, 4, 40, 30, 40, 40},
+        // Scaled down, and up, which the planner may do in the ABGR domain.
+        {64, 48, 6, 4, 40, 30, 24, 20},
+        {64, 48, 6, 4, 40, 30, 96, 64},
+        // Odd sizes.
+        {61, 45, 2, 2, 37, 29, 31, 41},
+        // Large enough for tensors to be converted in several bands.
+        {320, 240, 0, 0, 0, 0, 200, 300},
+};
+
+Orientation OrientationOf(int rotation, bool flip_vertical) {
+    Orientation orientation;
+    orientation.rotation = rotation;
+    orientation.flip_vertical = flip_vertical;
+    return orientation;
+}
+
+LetterboxRequest RequestFor(const Case& c, const Orientation& orientation, bool center) {
+    LetterboxRequest request;
+    request.crop_left = c.crop_left;
+    request.crop_top = c.crop_top;
+    request.crop_width = c.crop_width;
+    request.crop_height = c.crop_height;
+    request.orientation = orientation;
+    request.box_width = c.box_width;
+    request.box_height = c.box_height;
+    request.center = center;
+    request.pad_color[0] = 10;
+    request.pad_color[1] = 200;
+    request.pad_color[2] = 77;
+    return request;
+}
+
+// The image of the box, from a plain pipeline run at the size of the placement.
+std::vector<uint8_t> RunPlainPipeline(const PlanarImage& src, const LetterboxRequest& request,
+                                      const LetterboxPlacement& placement) {
+    PipelineRequest pipeline_request;
+    pipeline_request.crop_left = request.crop_left;
+    pipeline_request.crop_top = request.crop_top;
+    pipeline_request.crop_width = request.crop_width;
+    pipeline_request.crop_height = request.crop_height;
+    pipeline_request.orientation = request.orientation;
+    pipeline_request.output_width = placement.width;
+    pipeline_request.output_height = placement.height;
+    PipelinePlan plan;
+    EXPECT_EQ(PlanPipeline(src, pipeline_request, &plan), 0);
+    std::vector<uint8_t> abgr(static_cast<size_t>(placement.width) * placement.height * 4);
+    PipelineDestination dst;
+    dst.abgr = abgr.data();
+    dst.abgr_stride = placement.width * 4;
+    EXPECT_EQ(RunPipeline(src, plan, dst, nullptr, 0, nullptr), 0);
+    return abgr;
+}
+
+// The ABGR pixel the letterbox should hold at (x, y) of the box.
+const uint8_t* ExpectedPixel(const std::vector<uint8_t>& content,
+                             const LetterboxPlacement& placement, const uint8_t pad[4], int x,
+                             int y) {
+    if (x < placement.left || x >= placement.left + placement.width || y < placement.top
+        || y >= placement.top + placement.height) {
+        return pad;
+    }
+    return content.data()
+            + (static_cast<size_t>(y - placement.top) * placement.width + x - placement.left) * 4;
+}
+
+class LetterboxTest
+        : public testing::TestWithParam<std::tuple<ChromaLayout, int, bool, bool>> {
+protected:
+    Orientation orientation() const {
+        return OrientationOf(std::get<1>(GetParam()), std::get<2>(GetParam()));
+    }
+    bool center() const { return std::get<3>(GetParam()); }
+};
+
+TEST_P(LetterboxTest, ABGRMatchesThePipelineAndPadsExactly) {
+    for (const Case& c : kCases) {
+        SCOPED_TRACE(testing::Message() << c.width << "x" << c.height << " into " << c.box_width
+                                        << "x" << c.box_height);
+        TestFrame frame(c.width, c.height, std::get<0>(GetParam()), 3);
+        const LetterboxRequest request = RequestFor(c, orientation(), center());
+        // Row padding that must be left alone.
+        const int dst_stride = c.box_width * 4 + 12;
+        std::vector<uint8_t> dst(static_cast<size_t>(dst_stride) * c.box_height, kPoison);
+        LetterboxPlacement placement;
+        ASSERT_EQ(Letterbox(frame.image(), request, dst.data(), dst_stride, nullptr, &placement),
+                  0);
+
+        LetterboxPlacement planned;
+        ASSERT_EQ(GetLetterboxPlacement(frame.image(), request, &planned), 0);
+        EXPECT_EQ(std::memcmp(&planned, &placement, sizeof(placement)), 0);
+        // The image touches two opposite edges of the box and is centered or at the top left.
+        EXPECT_TRUE(placement.width == c.box_width || placement.height == c.box_height);
+        EXPECT_EQ(placement.left, center() ? (c.box_width - placement.width) / 2 : 0);
+        EXPECT_EQ(placement.top, center() ? (c.box_height - placement.height) / 2 : 0);
+
+        const std::vector<uint8_t> content = RunPlainPipeline(frame.image(), request, placement);
+        const uint8_t pad[4] = {10, 200, 77, 255};
+        for (int y = 0; y < c.box_height; ++y) {
+            const uint8_t* row = dst.data() + static_cast<size_t>(y) * dst_stride;
+            for (int x = 0; x < c.box_width; ++x) {
+                ASSERT_EQ(std::memcmp(row + x * 4, ExpectedPixel(content, placement, pad, x, y),
+                                      4),
+                          0)
+                        << "at " << x << ", " << y;
+            }
+            for (int x = c.box_width * 4; x < dst_stride; ++x) {
+                ASSERT_EQ(row[x], kPoison) << "stride byte " << x << " of row " << y;
+            }
+        }
+    }
+}
+
+TEST_P(LetterboxTest, TensorsHoldTheChannelsOfTheABGROutput) {
+    StripePool pool(3);
+    for (const Case& c : kCases) {
+        SCOPED_TRACE(testing::Message() << c.width << "x" << c.height << " into " << c.box_width
+                                        << "x" << c.box_height);
+        TestFrame frame(c.width, c.height, std::get<0>(GetParam()), 5);
+        LetterboxRequest request = RequestFor(c, orientation(), center());
+        const size_t pixels = static_cast<size_t>(c.box_width) * c.box_height;
+        std::vector<uint8_t> abgr(pixels * 4);
+        ASSERT_EQ(Letterbox(frame.image(), request, abgr.data(), c.box_width * 4, nullptr,
+                            nullptr),
+                  0);
+
+        request.mean[0] = 127.5f;
+        request.mean[1] = 0.0f;
+        request.mean[2] = 10.0f;
+        request.scale[0] = 1.0f / 127.5f;
+        request.scale[1] = 1.0f / 255.0f;
+        request.scale[2] = 2.0f;
+        for (StripePool* stripe_pool : {static_cast<StripePool*>(nullptr), &pool}) {
+            // Poisoned so that pixels left unwritten show up.
+            request.output_format = LetterboxFormat::kRGB;
+            std::vector<uint8_t> rgb(pixels * 3, kPoison);
+            ASSERT_EQ(Letterbox(frame.image(), request, rgb.data(), 0, stripe_pool, nullptr), 0);
+            request.output_format = LetterboxFormat::kFloatNHWC;
+            std::vector<float> nhwc(pixels * 3, NAN);
+            ASSERT_EQ(Letterbox(frame.image(), request, reinterpret_cast<uint8_t*>(nhwc.data()),
+                                0, stripe_pool, nullptr),
+                      0);
+            request.output_format = LetterboxFormat::kFloatNCHW;
+            std::vector<float> nchw(pixels * 3, NAN);
+            ASSERT_EQ(Letterbox(frame.image(), request, reinterpret_cast<uint8_t*>(nchw.data()),
+                                0, stripe_pool, nullptr),
+                      0);
+
+            for (size_t i = 0; i < pixels; ++i) {
+                for (int channel = 0; channel < 3; ++channel) {
+                    const uint8_t value = abgr[i * 4 + channel];
+                    const float normalized =
+                            (value - request.mean[channel]) * request.scale[channel];
+                    ASSERT_EQ(rgb[i * 3 + channel], value) << "pixel " << i;
+                    ASSERT_EQ(nhwc[i * 3 + channel], normalized) << "pixel " << i;
+                    ASSERT_EQ(nchw[channel * pixels + i], normalized) << "pixel " << i;
+                }
+            }
+        }
+    }
+}
+
+// A point in source or box coordinates.
+struct Point {
+    double x;
+    double y;
+};
+
+TEST_P(LetterboxTest, TransformMapsTheCropCornersOntoTheImage) {
+    // The source corners, as {right, bottom}, that end up at the top left and top right of the
+    // image for each rotation, unflipped and flipped vertically before rotating.
+    const int top_left[4][2][2] = {{{0, 0}, {0, 1}},
+                                   {{0, 1}, {0, 0}},
+                                   {{1, 1}, {1, 0}},
+                                   {{1, 0}, {1, 1}}};
+    const int top_right[4][2][2] = {{{1, 0}, {1, 1}},
+                                    {{0, 0}, {0, 1}},
+                                    {{0, 1}, {0, 0}},
+                                    {{1, 1}, {1, 0}}};
+    const Orientation orientation = this->orientation();
+    const int rotation_index = orientation.rotation / 90;
+    const int flip_index = orientation.flip_vertical ? 1 : 0;
+    for (const Case& c : kCases) {
+        SCOPED_TRACE(testing::Message() << c.width << "x" << c.height << " into " << c.box_width
+                                        << "x" << c.box_height);
+        TestFrame frame(c.width, c.height, std::get<0>(GetParam()));
+        LetterboxPlacement placement;
+        ASSERT_EQ(GetLetterboxPlacement(frame.image(),
+                                        RequestFor(c, orientation, center()), &placement),
+                  0);
+        const int crop_width = c.crop_width != 0 ? c.crop_width : c.width;
+        const int crop_height = c.crop_height != 0 ? c.crop_height : c.height;
+        auto corner = [&](const int (&side)[2]) {
+            return Point{static_cast<double>(c.crop_left + side[0] * crop_width),
+                         static_cast<double>(c.crop_top + side[1] * crop_height)};
+        };
+        auto map = [&](Point p) {
+            const float* m = placement.transform;
+            EXPECT_EQ(m[6], 0.0f);
+            EXPECT_EQ(m[7], 0.0f);
+            EXPECT_EQ(m[8], 1.0f);
+            return Point{m[0] * p.x + m[1] * p.y + m[2], m[3] * p.x + m[4] * p.y + m[5]};
+        };
+        const double left = placement.left;
+        const double right = placement.left + placement.width;
+        const double top = placement.top;
+        const double bottom = placement.top + placement.height;
+
+        Point mapped = map(corner(top_left[rotation_index][flip_index]));
+        EXPECT_NEAR(mapped.x, left, 1e-3);
+        EXPECT_NEAR(mapped.y, top, 1e-3);
+        mapped = map(corner(top_right[rotation_index][flip_index]));
+        EXPECT_NEAR(mapped.x, right, 1e-3);
+        EXPECT_NEAR(mapped.y, top, 1e-3);
+        // The other two corners go to the bottom of the image.
+        for (int side_x = 0; side_x < 2; ++side_x) {
+            for (int side_y = 0; side_y < 2; ++side_y) {
+                const int side[2] = {side_x, side_y};
+                mapped = map(corner(side));
+                EXPECT_TRUE(std::abs(mapped.x - left) < 1e-3 || std::abs(mapped.x - right) < 1e-3)
+                        << mapped.x;
+                EXPECT_TRUE(std::abs(mapped.y - top) < 1e-3 || std::abs(mapped.y - bottom) < 1e-3)
+                        << mapped.y;
+            }
+        }
+        // The center of the crop goes to the center of the image.
+        mapped = map(Point{c.crop_left + crop_width / 2.0, c.crop_top + crop_height / 2.0});
+        EXPECT_NEAR(mapped.x, (left + right) / 2, 1e-3);
+        EXPECT_NEAR(mapped.y, (top + bottom) / 2, 1e-3);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllOrientations, LetterboxTest,
+                         testing::Combine(testing::ValuesIn(kLayouts),
+                                          testing::Values(0, 90, 180, 270), testing::Bool(),
+                                          testing::Bool()));
+
+TEST(LetterboxRejectTest, RejectsInvalidRequests) {
+    TestFrame frame(64, 48, ChromaLayout::kPlanar);
+    LetterboxRequest request = RequestFor(kCases[0], Orientation(), true);
+    std::vector<uint8_t> dst(static_cast<size_t>(request.box_width) * request.box_height * 16);
+    const int stride = request.box_width * 4;
+    LetterboxPlacement placement;
+    EXPECT_EQ(Letterbox(frame.image(), request, nullptr, stride, nullptr, nullptr), -1);
+    EXPECT_EQ(Letterbox(frame.image(), request, dst.data(), stride - 1, nullptr, nullptr), -1);
+    EXPECT_EQ(GetLetterboxPlacement(frame.image(), request, nullptr), -1);
+
+    LetterboxRequest empty_box = request;
+    empty_box.box_height = 0;
+    EXPECT_EQ(Letterbox(frame.image(), empty_box, dst.data(), stride, nullptr, nullptr), -1);
+    EXPECT_EQ(GetLetterboxPlacement(frame.image(), empty_box, &placement), -1);
+
+    LetterboxRequest outside = request;
+    outside.crop_left = 30;
+    EXPECT_EQ(Letterbox(frame.image(), outside, dst.data(), stride, nullptr, nullptr), -1);
+
+    LetterboxRequest unknown_format = request;
+    unknown_format.output_format = static_cast<LetterboxFormat>(7);
+    EXPECT_EQ(Letterbox(frame.image(), unknown_format, dst.data(), stride, nullptr, nullptr), -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "luma_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "image_orientation.h"
+#include "image_pipeline.h"
+#include "image_planes.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Bytes past every output row, which must be left alone.
+constexpr int kDstRowPadding = 8;
+constexpr uint8_t kPaddingByte = 0xA5;
+
+// ProcessLuma always scales down before rotating, while the full pipeline may rotate first,
+// depending on the chroma layout. A box filter is not anchored symmetrically, so the two orders
+// sample the smooth test pattern up to a source pixel apart.
+constexpr int kMaxScaleDifference = 8;
+
+// Runs ProcessLuma into rows padded by kDstRowPadding and returns them without the padding.
+std::vector<uint8_t> RunLuma(const Plane& y, int width, int height, const LumaRequest& request) {
+    int output_width = 0;
+    int output_height = 0;
+    EXPECT_EQ(GetLumaOutputSize(width, height, request, &output_width, &output_height), 0);
+    int stride = output_width + kDstRowPadding;
+    std::vector<uint8_t> padded(static_cast<size_t>(stride) * output_height, kPaddingByte);
+    EXPECT_EQ(ProcessLuma(y, width, height, request, padded.data(), stride), 0);
+    std::vector<uint8_t> luma;
+    for (int row = 0; row < output_height; ++row) {
+        auto begin = padded.begin() + static_cast<ptrdiff_t>(row) * stride;
+        luma.insert(luma.end(), begin, begin + output_width);
+        for (int x = output_width; x < stride; ++x) {
+            EXPECT_EQ(begin[x], kPaddingByte) << "row padding written at row " << row;
+        }
+    }
+    return luma;
+}
+
+// The Y plane of the full pipeline run for the same request.
+std::vector<uint8_t> RunPipelineY(const PlanarImage& src, const LumaRequest& luma) {
+    PipelineRequest request;
+    request.crop_left = luma.crop_left;
+    request.crop_top = luma.crop_top;
+    request.crop_width = luma.crop_width;
+    request.crop_height = luma.crop_height;
+    request.orientation = luma.orientation;
+    request.output_width = luma.output_width;
+    request.output_height = luma.output_height;
+    request.output_format = PipelineFormat::kI420;
+    PipelinePlan plan;
+    EXPECT_EQ(PlanPipeline(src, request, &plan), 0);
+    std::vector<uint8_t> memory;
+    PipelineDestination dst;
+    dst.yuv = AllocateTestPlanes(plan.output_width, plan.output_height, ChromaLayout::kPlanar, 64,
+                                 &memory);
+    EXPECT_EQ(RunPipeline(src, plan, dst, nullptr, 0, nullptr), 0);
+    std::vector<uint8_t> i420 = ToI420(dst.yuv);
+    i420.resize(static_cast<size_t>(plan.output_width) * plan.output_height);
+    return i420;
+}
+
+TEST(LumaPipelineTest, MatchesTheYPlaneOfTheFullPipeline) {
+    const int sizes[][2] = {{64, 48}, {37, 29}};
+    for (ChromaLayout layout : kLayouts) {
+        for (const auto& size : sizes) {
+            TestFrame frame(size[0], size[1], layout);
+            FillSmoothTestPattern(frame.image(), 21);
+            // The whole frame and an even aligned crop, which the full pipeline keeps as is.
+            const int crops[][4] = {{0, 0, 0, 0}, {4, 2, size[0] - 10, size[1] - 7}};
+            for (const auto& crop : crops) {
+                for (int rotation : {0, 90, 180, 270}) {
+                    for (bool mirror : {false, true}) {
+                        LumaRequest request;
+                        request.crop_left = crop[0];
+                        request.crop_top = crop[1];
+                        request.crop_width = crop[2];
+                        request.crop_height = crop[3];
+                        request.orientation = Orientation::FromRotation(rotation, mirror);
+                        int width = 0;
+                        int height = 0;
+                        ASSERT_EQ(GetLumaOutputSize(size[0], size[1], request, &width, &height),
+                                  0);
+                        // Unscaled, scaled down and scaled up.
+                        const int outputs[][2] = {
+                                {0, 0}, {width / 2, height / 3}, {width * 3 / 2, height + 5}};
+                        for (const auto& output : outputs) {
+                            SCOPED_TRACE(testing::Message()
+                                         << "layout " << static_cast<int>(layout) << " "
+                                         << size[0] << "x" << size[1] << " crop " << crop[2]
+                                         << " rotation " << rotation << " mirror " << mirror
+                                         << " output " << output[0] << "x" << output[1]);
+                            request.output_width = output[0];
+                            request.output_height = output[1];
+                            std::vector<uint8_t> luma =
+                                    RunLuma(frame.image().y, size[0], size[1], request);
+                            std::vector<uint8_t> expected = RunPipelineY(frame.image(), request);
+                            if (output[0] == 0) {
+                                EXPECT_EQ(luma, expected);
+                                continue;
+                            }
+                            ASSERT_EQ(luma.size(), expected.size());
+                            for (size_t i = 0; i < luma.size(); ++i) {
+                                ASSERT_LE(std::abs(luma[i] - expected[i]), kMaxScaleDifference)
+                                        << "at " << i;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(LumaPipelineTest, KeepsOddCropEdges) {
+    TestFrame frame(40, 30, ChromaLayout::kPlanar, 22);
+    LumaRequest request;
+    request.crop_left = 3;
+    request.crop_top = 5;
+    request.crop_width = 17;
+    request.crop_height = 11;
+    std::vector<uint8_t> luma = RunLuma(frame.image().y, 40, 30, request);
+    ASSERT_EQ(luma.size(), 17u * 11u);
+    for (int y = 0; y < 11; ++y) {
+        for (int x = 0; x < 17; ++x) {
+            ASSERT_EQ(luma[y * 17 + x], frame.image().y.RowAt(y + 5)[x + 3]);
+        }
+    }
+}
+
+TEST(LumaPipelineTest, GathersStridedSamples) {
+    TestFrame frame(30, 20, ChromaLayout::kPlanar, 23);
+    // The same samples two bytes apart.
+    std::vector<uint8_t> strided(static_cast<size_t>(30) * 2 * 20, 0);
+    Plane y = {strided.data(), 60, 2};
+    for (int row = 0; row < 20; ++row) {
+        for (int x = 0; x < 30; ++x) {
+            y.RowAt(row)[x * 2] = frame.image().y.RowAt(row)[x];
+        }
+    }
+    LumaRequest request;
+    request.crop_left = 1;
+    request.crop_width = 25;
+    request.crop_height = 20;
+    request.orientation = Orientation::FromRotation(90, true);
+    request.output_width = 10;
+    request.output_height = 12;
+    EXPECT_EQ(RunLuma(y, 30, 20, request), RunLuma(frame.image().y, 30, 20, request));
+}
+
+TEST(LumaPipelineTest, RejectsCropsOutsideThePlane) {
+    TestFrame frame(16, 16, ChromaLayout::kPlanar);
+    std::vector<uint8_t> dst(16 * 16);
+    LumaRequest request;
+    request.crop_left = 8;
+    request.crop_width = 9;
+    request.crop_height = 4;
+    int width = 0;
+    int height = 0;
+    EXPECT_EQ(GetLumaOutputSize(16, 16, request, &width, &height), -1);
+    EXPECT_EQ(ProcessLuma(frame.image().y, 16, 16, request, dst.data(), 16), -1);
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,608 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// A scalar model of the subset of <arm_neon.h> the kernels of camera-core use, so that their
+// NEON paths can be compiled and compared against the scalar paths on hosts without an ARM
+// toolchain. Only the kernels' own test build puts this directory on the include path.
+//
+// The model follows the Arm intrinsics reference lane by lane, including wrapping arithmetic
+// and the rounding of the narrowing shifts. It is stricter than the real header in two ways
+// that catch mistakes a real build would also reject: every vector type is its own struct, so
+// an int16x8_t is never accepted for a uint16x8_t, and immediate operands (shift counts, lane
+// indices) must be constant expressions within the range the instruction encodes.
+//
+// It does not model timing, alignment faults or the GCC vector operators on NEON types.
+
+#ifndef CAMERA_CORE_TEST_NEON_MODEL_ARM_NEON_H_
+#define CAMERA_CORE_TEST_NEON_MODEL_ARM_NEON_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace camerax_neon_model {
+
+template <typename T, int N>
+struct Vector {
+    T lane[N];
+};
+
+template <typename V, int K>
+struct VectorArray {
+    V val[K];
+};
+
+}  // namespace camerax_neon_model
+
+typedef camerax_neon_model::Vector<uint8_t, 8> uint8x8_t;
+typedef camerax_neon_model::Vector<uint8_t, 16> uint8x16_t;
+typedef camerax_neon_model::Vector<uint16_t, 4> uint16x4_t;
+typedef camerax_neon_model::Vector<uint16_t, 8> uint16x8_t;
+typedef camerax_neon_model::Vector<uint32_t, 2> uint32x2_t;
+typedef camerax_neon_model::Vector<uint32_t, 4> uint32x4_t;
+typedef camerax_neon_model::Vector<uint64_t, 1> uint64x1_t;
+typedef camerax_neon_model::Vector<uint64_t, 2> uint64x2_t;
+typedef camerax_neon_model::Vector<int8_t, 8> int8x8_t;
+typedef camerax_neon_model::Vector<int8_t, 16> int8x16_t;
+typedef camerax_neon_model::Vector<int16_t, 4> int16x4_t;
+typedef camerax_neon_model::Vector<int16_t, 8> int16x8_t;
+typedef camerax_neon_model::Vector<int32_t, 2> int32x2_t;
+typedef camerax_neon_model::Vector<int32_t, 4> int32x4_t;
+typedef camerax_neon_model::Vector<float, 2> float32x2_t;
+typedef camerax_neon_model::Vector<float, 4> float32x4_t;
+
+typedef camerax_neon_model::VectorArray<uint8x8_t, 2> uint8x8x2_t;
+typedef camerax_neon_model::VectorArray<uint8x8_t, 4> uint8x8x4_t;
+typedef camerax_neon_model::VectorArray<uint8x16_t, 2> uint8x16x2_t;
+typedef camerax_neon_model::VectorArray<uint8x16_t, 4> uint8x16x4_t;
+typedef camerax_neon_model::VectorArray<uint16x4_t, 2> uint16x4x2_t;
+typedef camerax_neon_model::VectorArray<uint32x2_t, 2> uint32x2x2_t;
+typedef camerax_neon_model::VectorArray<uint32x4_t, 2> uint32x4x2_t;
+
+namespace camerax_neon_model {
+
+// Unsigned types of the same width, so that signed arithmetic can wrap like the hardware
+// without undefined behavior.
+template <typename T> struct Unsigned { typedef T type; };
+template <> struct Unsigned<int8_t> { typedef uint8_t type; };
+template <> struct Unsigned<int16_t> { typedef uint16_t type; };
+template <> struct Unsigned<int32_t> { typedef uint32_t type; };
+template <> struct Unsigned<int64_t> { typedef uint64_t type; };
+
+template <typename T>
+T Wrap(uint64_t value) {
+    return static_cast<T>(static_cast<typename Unsigned<T>::type>(value));
+}
+
+template <typename T, int N>
+Vector<T, N> Load(const T* ptr) {
+    Vector<T, N> r;
+    std::memcpy(r.lane, ptr, sizeof(r.lane));
+    return r;
+}
+
+template <typename T, int N>
+void Store(T* ptr, const Vector<T, N>& v) {
+    std::memcpy(ptr, v.lane, sizeof(v.lane));
+}
+
+template <typename T, int N>
+Vector<T, N> Dup(T value) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = value;
+    return r;
+}
+
+template <typename T, int N, int K>
+VectorArray<Vector<T, N>, K> LoadInterleaved(const T* ptr) {
+    VectorArray<Vector<T, N>, K> r;
+    for (int i = 0; i < N; ++i) {
+        for (int k = 0; k < K; ++k) r.val[k].lane[i] = ptr[i * K + k];
+    }
+    return r;
+}
+
+template <typename T, int N, int K>
+void StoreInterleaved(T* ptr, const VectorArray<Vector<T, N>, K>& v) {
+    for (int i = 0; i < N; ++i) {
+        for (int k = 0; k < K; ++k) ptr[i * K + k] = v.val[k].lane[i];
+    }
+}
+
+template <typename T, int N>
+Vector<T, N> Add(const Vector<T, N>& a, const Vector<T, N>& b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = Wrap<T>(static_cast<uint64_t>(a.lane[i]) + static_cast<uint64_t>(b.lane[i]));
+    }
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N> Sub(const Vector<T, N>& a, const Vector<T, N>& b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = Wrap<T>(static_cast<uint64_t>(a.lane[i]) - static_cast<uint64_t>(b.lane[i]));
+    }
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N> MulScalar(const Vector<T, N>& a, T b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = Wrap<T>(static_cast<uint64_t>(a.lane[i]) * static_cast<uint64_t>(b));
+    }
+    return r;
+}
+
+template <int N>
+Vector<float, N> MulScalar(const Vector<float, N>& a, float b) {
+    Vector<float, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = a.lane[i] * b;
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N> And(const Vector<T, N>& a, const Vector<T, N>& b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = static_cast<T>(a.lane[i] & b.lane[i]);
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N> Or(const Vector<T, N>& a, const Vector<T, N>& b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = static_cast<T>(a.lane[i] | b.lane[i]);
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N> Xor(const Vector<T, N>& a, const Vector<T, N>& b) {
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = static_cast<T>(a.lane[i] ^ b.lane[i]);
+    return r;
+}
+
+// Widens every lane of a to W.
+template <typename W, typename T, int N>
+Vector<W, N> Widen(const Vector<T, N>& a) {
+    Vector<W, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = static_cast<W>(a.lane[i]);
+    return r;
+}
+
+// Keeps the low half of the bits of every lane.
+template <typename R, typename T, int N>
+Vector<R, N> Narrow(const Vector<T, N>& a) {
+    Vector<R, N> r;
+    for (int i = 0; i < N; ++i) r.lane[i] = static_cast<R>(a.lane[i]);
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N / 2> Low(const Vector<T, N>& a) {
+    Vector<T, N / 2> r;
+    for (int i = 0; i < N / 2; ++i) r.lane[i] = a.lane[i];
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, N / 2> High(const Vector<T, N>& a) {
+    Vector<T, N / 2> r;
+    for (int i = 0; i < N / 2; ++i) r.lane[i] = a.lane[N / 2 + i];
+    return r;
+}
+
+template <typename T, int N>
+Vector<T, 2 * N> Combine(const Vector<T, N>& low, const Vector<T, N>& high) {
+    Vector<T, 2 * N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = low.lane[i];
+        r.lane[N + i] = high.lane[i];
+    }
+    return r;
+}
+
+template <typename R, typename V>
+R Reinterpret(const V& v) {
+    static_assert(sizeof(R) == sizeof(V), "vreinterpret between vectors of different sizes");
+    R r;
+    std::memcpy(&r, &v, sizeof(r));
+    return r;
+}
+
+template <typename T, int N>
+VectorArray<Vector<T, N>, 2> Transpose(const Vector<T, N>& a, const Vector<T, N>& b) {
+    VectorArray<Vector<T, N>, 2> r;
+    for (int i = 0; i < N; i += 2) {
+        r.val[0].lane[i] = a.lane[i];
+        r.val[0].lane[i + 1] = b.lane[i];
+        r.val[1].lane[i] = a.lane[i + 1];
+        r.val[1].lane[i + 1] = b.lane[i + 1];
+    }
+    return r;
+}
+
+// Lane i of the result is (a[i] >> shift) with rounding if requested, computed without
+// overflow and narrowed to R.
+template <typename R, int kShift, bool kRound, typename T, int N>
+Vector<R, N> ShiftRightNarrow(const Vector<T, N>& a) {
+    static_assert(kShift >= 1 && kShift <= static_cast<int>(sizeof(R) * 8),
+                  "narrowing shift count out of range");
+    Vector<R, N> r;
+    for (int i = 0; i < N; ++i) {
+        unsigned __int128 value = a.lane[i];
+        if (kRound) value += static_cast<unsigned __int128>(1) << (kShift - 1);
+        r.lane[i] = static_cast<R>(value >> kShift);
+    }
+    return r;
+}
+
+template <int kShift, bool kRound, typename T, int N>
+Vector<T, N> ShiftRight(const Vector<T, N>& a) {
+    static_assert(kShift >= 1 && kShift <= static_cast<int>(sizeof(T) * 8),
+                  "right shift count out of range");
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        unsigned __int128 value = a.lane[i];
+        if (kRound) value += static_cast<unsigned __int128>(1) << (kShift - 1);
+        r.lane[i] = static_cast<T>(value >> kShift);
+    }
+    return r;
+}
+
+template <int kShift, typename T, int N>
+Vector<T, N> ShiftLeft(const Vector<T, N>& a) {
+    static_assert(kShift >= 0 && kShift < static_cast<int>(sizeof(T) * 8),
+                  "left shift count out of range");
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = static_cast<T>(static_cast<uint64_t>(a.lane[i]) << kShift);
+    }
+    return r;
+}
+
+template <int kLane, typename T, int N>
+T GetLane(const Vector<T, N>& a) {
+    static_assert(kLane >= 0 && kLane < N, "lane index out of range");
+    return a.lane[kLane];
+}
+
+template <int kStart, typename T, int N>
+Vector<T, N> Extract(const Vector<T, N>& a, const Vector<T, N>& b) {
+    static_assert(kStart >= 0 && kStart < N, "vext start out of range");
+    Vector<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = i + kStart < N ? a.lane[i + kStart] : b.lane[i + kStart - N];
+    }
+    return r;
+}
+
+template <typename M, typename T, int N>
+Vector<M, N> CompareMask(const Vector<T, N>& a, const Vector<T, N>& b, bool (*compare)(T, T)) {
+    Vector<M, N> r;
+    for (int i = 0; i < N; ++i) {
+        r.lane[i] = compare(a.lane[i], b.lane[i]) ? static_cast<M>(~M(0)) : M(0);
+    }
+    return r;
+}
+
+}  // namespace camerax_neon_model
+
+// Loads and stores.
+
+inline uint8x8_t vld1_u8(const uint8_t* p) { return camerax_neon_model::Load<uint8_t, 8>(p); }
+inline uint8x16_t vld1q_u8(const uint8_t* p) { return camerax_neon_model::Load<uint8_t, 16>(p); }
+inline uint16x8_t vld1q_u16(const uint16_t* p) { return camerax_neon_model::Load<uint16_t, 8>(p); }
+inline uint32x4_t vld1q_u32(const uint32_t* p) { return camerax_neon_model::Load<uint32_t, 4>(p); }
+inline uint64x2_t vld1q_u64(const uint64_t* p) { return camerax_neon_model::Load<uint64_t, 2>(p); }
+inline int16x8_t vld1q_s16(const int16_t* p) { return camerax_neon_model::Load<int16_t, 8>(p); }
+inline float32x4_t vld1q_f32(const float* p) { return camerax_neon_model::Load<float, 4>(p); }
+
+inline void vst1_u8(uint8_t* p, uint8x8_t v) { camerax_neon_model::Store(p, v); }
+inline void vst1q_u8(uint8_t* p, uint8x16_t v) { camerax_neon_model::Store(p, v); }
+inline void vst1q_u16(uint16_t* p, uint16x8_t v) { camerax_neon_model::Store(p, v); }
+inline void vst1q_u32(uint32_t* p, uint32x4_t v) { camerax_neon_model::Store(p, v); }
+inline void vst1q_u64(uint64_t* p, uint64x2_t v) { camerax_neon_model::Store(p, v); }
+inline void vst1q_f32(float* p, float32x4_t v) { camerax_neon_model::Store(p, v); }
+
+inline uint8x8x2_t vld2_u8(const uint8_t* p) {
+    return camerax_neon_model::LoadInterleaved<uint8_t, 8, 2>(p);
+}
+inline uint8x16x2_t vld2q_u8(const uint8_t* p) {
+    return camerax_neon_model::LoadInterleaved<uint8_t, 16, 2>(p);
+}
+inline uint8x8x4_t vld4_u8(const uint8_t* p) {
+    return camerax_neon_model::LoadInterleaved<uint8_t, 8, 4>(p);
+}
+inline uint8x16x4_t vld4q_u8(const uint8_t* p) {
+    return camerax_neon_model::LoadInterleaved<uint8_t, 16, 4>(p);
+}
+inline void vst2_u8(uint8_t* p, uint8x8x2_t v) { camerax_neon_model::StoreInterleaved(p, v); }
+inline void vst2q_u8(uint8_t* p, uint8x16x2_t v) { camerax_neon_model::StoreInterleaved(p, v); }
+
+// Duplication.
+
+inline uint8x8_t vdup_n_u8(uint8_t v) { return camerax_neon_model::Dup<uint8_t, 8>(v); }
+inline uint16x4_t vdup_n_u16(uint16_t v) { return camerax_neon_model::Dup<uint16_t, 4>(v); }
+inline uint8x16_t vdupq_n_u8(uint8_t v) { return camerax_neon_model::Dup<uint8_t, 16>(v); }
+inline uint16x8_t vdupq_n_u16(uint16_t v) { return camerax_neon_model::Dup<uint16_t, 8>(v); }
+inline uint32x4_t vdupq_n_u32(uint32_t v) { return camerax_neon_model::Dup<uint32_t, 4>(v); }
+inline int32x4_t vdupq_n_s32(int32_t v) { return camerax_neon_model::Dup<int32_t, 4>(v); }
+inline float32x4_t vdupq_n_f32(float v) { return camerax_neon_model::Dup<float, 4>(v); }
+
+// Halves and combination.
+
+inline uint8x8_t vget_low_u8(uint8x16_t v) { return camerax_neon_model::Low(v); }
+inline uint8x8_t vget_high_u8(uint8x16_t v) { return camerax_neon_model::High(v); }
+inline uint16x4_t vget_low_u16(uint16x8_t v) { return camerax_neon_model::Low(v); }
+inline uint16x4_t vget_high_u16(uint16x8_t v) { return camerax_neon_model::High(v); }
+inline uint32x2_t vget_low_u32(uint32x4_t v) { return camerax_neon_model::Low(v); }
+inline uint32x2_t vget_high_u32(uint32x4_t v) { return camerax_neon_model::High(v); }
+inline float32x2_t vget_low_f32(float32x4_t v) { return camerax_neon_model::Low(v); }
+inline float32x2_t vget_high_f32(float32x4_t v) { return camerax_neon_model::High(v); }
+inline uint8x16_t vcombine_u8(uint8x8_t l, uint8x8_t h) {
+    return camerax_neon_model::Combine(l, h);
+}
+inline uint16x8_t vcombine_u16(uint16x4_t l, uint16x4_t h) {
+    return camerax_neon_model::Combine(l, h);
+}
+inline uint32x4_t vcombine_u32(uint32x2_t l, uint32x2_t h) {
+    return camerax_neon_model::Combine(l, h);
+}
+inline float32x4_t vcombine_f32(float32x2_t l, float32x2_t h) {
+    return camerax_neon_model::Combine(l, h);
+}
+
+// Reinterpretation.
+
+inline uint8x8_t vreinterpret_u8_u32(uint32x2_t v) {
+    return camerax_neon_model::Reinterpret<uint8x8_t>(v);
+}
+inline uint32x2_t vreinterpret_u32_u16(uint16x4_t v) {
+    return camerax_neon_model::Reinterpret<uint32x2_t>(v);
+}
+inline uint16x4_t vreinterpret_u16_u8(uint8x8_t v) {
+    return camerax_neon_model::Reinterpret<uint16x4_t>(v);
+}
+inline uint16x8_t vreinterpretq_u16_s16(int16x8_t v) {
+    return camerax_neon_model::Reinterpret<uint16x8_t>(v);
+}
+inline int16x8_t vreinterpretq_s16_u16(uint16x8_t v) {
+    return camerax_neon_model::Reinterpret<int16x8_t>(v);
+}
+inline uint64x2_t vreinterpretq_u64_u8(uint8x16_t v) {
+    return camerax_neon_model::Reinterpret<uint64x2_t>(v);
+}
+inline uint32x4_t vreinterpretq_u32_f32(float32x4_t v) {
+    return camerax_neon_model::Reinterpret<uint32x4_t>(v);
+}
+inline float32x4_t vreinterpretq_f32_u32(uint32x4_t v) {
+    return camerax_neon_model::Reinterpret<float32x4_t>(v);
+}
+inline int32x4_t vreinterpretq_s32_u32(uint32x4_t v) {
+    return camerax_neon_model::Reinterpret<int32x4_t>(v);
+}
+
+// Arithmetic, wrapping like the hardware.
+
+inline uint8x8_t vadd_u8(uint8x8_t a, uint8x8_t b) { return camerax_neon_model::Add(a, b); }
+inline uint16x8_t vaddq_u16(uint16x8_t a, uint16x8_t b) { return camerax_neon_model::Add(a, b); }
+inline uint64x2_t vaddq_u64(uint64x2_t a, uint64x2_t b) { return camerax_neon_model::Add(a, b); }
+inline uint8x16_t vsubq_u8(uint8x16_t a, uint8x16_t b) { return camerax_neon_model::Sub(a, b); }
+inline int32x4_t vsubq_s32(int32x4_t a, int32x4_t b) { return camerax_neon_model::Sub(a, b); }
+
+inline uint16x8_t vaddw_u8(uint16x8_t a, uint8x8_t b) {
+    return camerax_neon_model::Add(a, camerax_neon_model::Widen<uint16_t>(b));
+}
+inline uint16x8_t vsubw_u8(uint16x8_t a, uint8x8_t b) {
+    return camerax_neon_model::Sub(a, camerax_neon_model::Widen<uint16_t>(b));
+}
+inline uint16x8_t vmovl_u8(uint8x8_t a) { return camerax_neon_model::Widen<uint16_t>(a); }
+inline uint32x4_t vmovl_u16(uint16x4_t a) { return camerax_neon_model::Widen<uint32_t>(a); }
+inline uint8x8_t vmovn_u16(uint16x8_t a) { return camerax_neon_model::Narrow<uint8_t>(a); }
+inline uint32x2_t vmovn_u64(uint64x2_t a) { return camerax_neon_model::Narrow<uint32_t>(a); }
+
+inline uint16x8_t vpaddlq_u8(uint8x16_t a) {
+    uint16x8_t r;
+    for (int i = 0; i < 8; ++i) {
+        r.lane[i] = static_cast<uint16_t>(a.lane[2 * i] + a.lane[2 * i + 1]);
+    }
+    return r;
+}
+inline uint32x4_t vpadalq_u16(uint32x4_t a, uint16x8_t b) {
+    uint32x4_t r;
+    for (int i = 0; i < 4; ++i) {
+        r.lane[i] = a.lane[i] + static_cast<uint32_t>(b.lane[2 * i]) + b.lane[2 * i + 1];
+    }
+    return r;
+}
+
+inline uint16x8_t vmull_u8(uint8x8_t a, uint8x8_t b) {
+    uint16x8_t r;
+    for (int i = 0; i < 8; ++i) r.lane[i] = static_cast<uint16_t>(a.lane[i] * b.lane[i]);
+    return r;
+}
+inline uint32x4_t vmull_u16(uint16x4_t a, uint16x4_t b) {
+    uint32x4_t r;
+    for (int i = 0; i < 4; ++i) r.lane[i] = static_cast<uint32_t>(a.lane[i]) * b.lane[i];
+    return r;
+}
+inline uint64x2_t vmull_u32(uint32x2_t a, uint32x2_t b) {
+    uint64x2_t r;
+    for (int i = 0; i < 2; ++i) r.lane[i] = static_cast<uint64_t>(a.lane[i]) * b.lane[i];
+    return r;
+}
+inline uint16x8_t vmlal_u8(uint16x8_t a, uint8x8_t b, uint8x8_t c) {
+    return camerax_neon_model::Add(a, vmull_u8(b, c));
+}
+inline int16x8_t vmulq_n_s16(int16x8_t a, int16_t b) { return camerax_neon_model::MulScalar(a, b); }
+inline uint16x8_t vmulq_n_u16(uint16x8_t a, uint16_t b) {
+    return camerax_neon_model::MulScalar(a, b);
+}
+inline float32x4_t vmulq_n_f32(float32x4_t a, float b) {
+    return camerax_neon_model::MulScalar(a, b);
+}
+inline int16x8_t vmlaq_n_s16(int16x8_t a, int16x8_t b, int16_t c) {
+    return camerax_neon_model::Add(a, camerax_neon_model::MulScalar(b, c));
+}
+inline uint16x8_t vmlaq_n_u16(uint16x8_t a, uint16x8_t b, uint16_t c) {
+    return camerax_neon_model::Add(a, camerax_neon_model::MulScalar(b, c));
+}
+
+inline uint8x16_t vabdq_u8(uint8x16_t a, uint8x16_t b) {
+    uint8x16_t r;
+    for (int i = 0; i < 16; ++i) {
+        r.lane[i] = static_cast<uint8_t>(a.lane[i] > b.lane[i] ? a.lane[i] - b.lane[i]
+                                                               : b.lane[i] - a.lane[i]);
+    }
+    return r;
+}
+inline uint8x16_t vrhaddq_u8(uint8x16_t a, uint8x16_t b) {
+    uint8x16_t r;
+    for (int i = 0; i < 16; ++i) r.lane[i] = static_cast<uint8_t>((a.lane[i] + b.lane[i] + 1) >> 1);
+    return r;
+}
+inline uint8x8_t vraddhn_u16(uint16x8_t a, uint16x8_t b) {
+    uint8x8_t r;
+    for (int i = 0; i < 8; ++i) {
+        r.lane[i] = static_cast<uint8_t>((static_cast<uint32_t>(a.lane[i]) + b.lane[i] + 128) >> 8);
+    }
+    return r;
+}
+
+inline float32x4_t vcvtq_f32_u32(uint32x4_t a) { return camerax_neon_model::Widen<float>(a); }
+inline float32x4_t vcvtq_f32_s32(int32x4_t a) { return camerax_neon_model::Widen<float>(a); }
+
+// Bitwise operations.
+
+inline uint8x16_t vandq_u8(uint8x16_t a, uint8x16_t b) { return camerax_neon_model::And(a, b); }
+inline uint16x8_t vandq_u16(uint16x8_t a, uint16x8_t b) { return camerax_neon_model::And(a, b); }
+inline uint16x8_t vorrq_u16(uint16x8_t a, uint16x8_t b) { return camerax_neon_model::Or(a, b); }
+inline uint32x4_t veorq_u32(uint32x4_t a, uint32x4_t b) { return camerax_neon_model::Xor(a, b); }
+inline uint64x2_t veorq_u64(uint64x2_t a, uint64x2_t b) { return camerax_neon_model::Xor(a, b); }
+inline uint8x8_t vmvn_u8(uint8x8_t a) {
+    uint8x8_t r;
+    for (int i = 0; i < 8; ++i) r.lane[i] = static_cast<uint8_t>(~a.lane[i]);
+    return r;
+}
+inline float32x4_t vbslq_f32(uint32x4_t mask, float32x4_t a, float32x4_t b) {
+    const uint32x4_t bits_a = vreinterpretq_u32_f32(a);
+    const uint32x4_t bits_b = vreinterpretq_u32_f32(b);
+    uint32x4_t r;
+    for (int i = 0; i < 4; ++i) {
+        r.lane[i] = (mask.lane[i] & bits_a.lane[i]) | (~mask.lane[i] & bits_b.lane[i]);
+    }
+    return vreinterpretq_f32_u32(r);
+}
+
+// Comparisons.
+
+inline uint8x16_t vcleq_u8(uint8x16_t a, uint8x16_t b) {
+    return camerax_neon_model::CompareMask<uint8_t>(
+            a, b, +[](uint8_t x, uint8_t y) { return x <= y; });
+}
+inline uint32x4_t vceqq_u32(uint32x4_t a, uint32x4_t b) {
+    return camerax_neon_model::CompareMask<uint32_t>(
+            a, b, +[](uint32_t x, uint32_t y) { return x == y; });
+}
+
+// Shifts by a register, negative counts shift right.
+
+inline uint16x8_t vshlq_u16(uint16x8_t a, int16x8_t b) {
+    uint16x8_t r;
+    for (int i = 0; i < 8; ++i) {
+        // Only the low byte of the count is used.
+        const int count = static_cast<int8_t>(b.lane[i] & 0xFF);
+        if (count >= 16 || count <= -16) {
+            r.lane[i] = 0;
+        } else if (count >= 0) {
+            r.lane[i] = static_cast<uint16_t>(a.lane[i] << count);
+        } else {
+            r.lane[i] = static_cast<uint16_t>(a.lane[i] >> -count);
+        }
+    }
+    return r;
+}
+
+// Permutations.
+
+inline uint8x8x2_t vtrn_u8(uint8x8_t a, uint8x8_t b) { return camerax_neon_model::Transpose(a, b); }
+inline uint16x4x2_t vtrn_u16(uint16x4_t a, uint16x4_t b) {
+    return camerax_neon_model::Transpose(a, b);
+}
+inline uint32x2x2_t vtrn_u32(uint32x2_t a, uint32x2_t b) {
+    return camerax_neon_model::Transpose(a, b);
+}
+inline uint32x4x2_t vtrnq_u32(uint32x4_t a, uint32x4_t b) {
+    return camerax_neon_model::Transpose(a, b);
+}
+inline uint8x16x2_t vzipq_u8(uint8x16_t a, uint8x16_t b) {
+    uint8x16x2_t r;
+    for (int i = 0; i < 16; ++i) {
+        const int k = i / 8;
+        const int j = i % 8;
+        r.val[k].lane[2 * j] = a.lane[i];
+        r.val[k].lane[2 * j + 1] = b.lane[i];
+    }
+    return r;
+}
+inline uint8x8_t vtbl2_u8(uint8x8x2_t table, uint8x8_t index) {
+    uint8x8_t r;
+    for (int i = 0; i < 8; ++i) {
+        const int j = index.lane[i];
+        r.lane[i] = j < 16 ? table.val[j / 8].lane[j % 8] : 0;
+    }
+    return r;
+}
+inline float32x2_t vrev64_f32(float32x2_t a) {
+    float32x2_t r;
+    r.lane[0] = a.lane[1];
+    r.lane[1] = a.lane[0];
+    return r;
+}
+inline uint8x16_t vrev16q_u8(uint8x16_t a) {
+    uint8x16_t r;
+    for (int i = 0; i < 16; i += 2) {
+        r.lane[i] = a.lane[i + 1];
+        r.lane[i + 1] = a.lane[i];
+    }
+    return r;
+}
+
+// Immediate forms. Macros, so that the immediate has to be a constant expression in range.
+
+#define vshlq_n_u16(a, n) (camerax_neon_model::ShiftLeft<(n)>(static_cast<uint16x8_t>(a)))
+#define vshrq_n_u16(a, n) \
+    (camerax_neon_model::ShiftRight<(n), false>(static_cast<uint16x8_t>(a)))
+#define vrshrq_n_u16(a, n) \
+    (camerax_neon_model::ShiftRight<(n), true>(static_cast<uint16x8_t>(a)))
+#define vshrn_n_u16(a, n) \
+    (camerax_neon_model::ShiftRightNarrow<uint8_t, (n), false>(static_cast<uint16x8_t>(a)))
+#define vrshrn_n_u16(a, n) \
+    (camerax_neon_model::ShiftRightNarrow<uint8_t, (n), true>(static_cast<uint16x8_t>(a)))
+#define vshrn_n_u32(a, n) \
+    (camerax_neon_model::ShiftRightNarrow<uint16_t, (n), false>(static_cast<uint32x4_t>(a)))
+#define vshrn_n_u64(a, n) \
+    (camerax_neon_model::ShiftRightNarrow<uint32_t, (n), false>(static_cast<uint64x2_t>(a)))
+#define vgetq_lane_u32(a, lane) \
+    (camerax_neon_model::GetLane<(lane)>(static_cast<uint32x4_t>(a)))
+#define vgetq_lane_f32(a, lane) \
+    (camerax_neon_model::GetLane<(lane)>(static_cast<float32x4_t>(a)))
+#define vextq_u64(a, b, n) \
+    (camerax_neon_model::Extract<(n)>(static_cast<uint64x2_t>(a), static_cast<uint64x2_t>(b)))
+
+#endif  // CAMERA_CORE_TEST_NEON_MODEL_ARM_NEON_H_
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "plane_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+struct HashCase {
+    int width;
+    int pixel_stride;
+    int row_step;
+    uint64_t seed;
+};
+
+// Hashes of a 2048 x 48 byte pattern for a range of widths: partial stripes, runs across the
+// scramble every 16 stripes and interleaved samples.
+std::vector<uint64_t> HashPlanes() {
+    constexpr int kStride = 2048;
+    constexpr int kHeight = 48;
+    std::vector<uint8_t> bytes(static_cast<size_t>(kStride) * kHeight);
+    uint32_t state = 1;
+    for (uint8_t& byte : bytes) {
+        state = state * 1664525U + 1013904223U;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    const HashCase cases[] = {
+            {1, 1, 1, 0},   {63, 1, 1, 0},   {64, 1, 1, 7},      {65, 1, 2, 0},
+            {640, 1, 1, 1}, {1024, 1, 3, 0}, {1087, 1, 1, ~0ULL}, {2048, 1, 1, 0},
+            {17, 2, 1, 0},  {700, 2, 1, 5},  {1024, 2, 4, 0},
+    };
+    std::vector<uint64_t> hashes;
+    for (const HashCase& c : cases) {
+        const Plane plane = {bytes.data(), kStride, c.pixel_stride};
+        hashes.push_back(HashPlane(plane, c.width, kHeight, c.row_step, c.seed));
+    }
+    for (ChromaLayout layout : kLayouts) {
+        const TestFrame frame(333, 97, layout, 11);
+        hashes.push_back(HashAndroid420(frame.image(), 1));
+        hashes.push_back(HashAndroid420(frame.image(), 5));
+    }
+    return hashes;
+}
+
+TEST(PlaneHashTest, SimdMatchesScalar) {
+    std::vector<uint64_t> expected;
+    {
+        const ScopedKernelImpl scalar(Kernel::kPlaneHash, KernelImpl::kScalar);
+        ASSERT_TRUE(scalar.ok());
+        expected = HashPlanes();
+    }
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kPlaneHash);
+    ASSERT_FALSE(impls.empty());
+    for (KernelImpl impl : impls) {
+        const ScopedKernelImpl simd(Kernel::kPlaneHash, impl);
+        ASSERT_TRUE(simd.ok());
+        EXPECT_EQ(HashPlanes(), expected) << GetKernelImplName(impl);
+    }
+}
+
+TEST(PlaneHashTest, SeesEveryRowAndSample) {
+    TestFrame frame(64, 16, ChromaLayout::kSemiPlanarUV);
+    const uint64_t hash = HashAndroid420(frame.image(), 1);
+    frame.image().y.RowAt(15)[63] ^= 1;
+    EXPECT_NE(HashAndroid420(frame.image(), 1), hash);
+    frame.image().y.RowAt(15)[63] ^= 1;
+    frame.image().u.RowAt(7)[0] ^= 0x80;
+    EXPECT_NE(HashAndroid420(frame.image(), 1), hash);
+    frame.image().u.RowAt(7)[0] ^= 0x80;
+    EXPECT_EQ(HashAndroid420(frame.image(), 1), hash);
+}
+
+}  // namespace
+}  // namespace camerax
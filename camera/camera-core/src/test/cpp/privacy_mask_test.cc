@@ -0,0 +1,92 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "privacy_mask.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Regions narrower and wider than the SIMD loops, odd ones and ones reaching past the edges.
+const MaskRegion kRegions[] = {{3, 5, 90, 41}, {-10, 60, 37, 30}, {150, -4, 80, 20},
+                               {100, 70, 9, 9}};
+
+std::vector<uint8_t> Mask(ChromaLayout layout, const MaskOptions& options, StripePool* pool) {
+    const TestFrame frame(200, 96, layout, 4);
+    EXPECT_EQ(MaskRegions(frame.image(), kRegions, 4, options, pool), 0);
+    return ToI420(frame.image());
+}
+
+TEST(PrivacyMaskTest, PixelatesToTheBlockMean) {
+    const TestFrame frame(16, 8, ChromaLayout::kPlanar);
+    const Plane& y = frame.image().y;
+    for (int row = 0; row < 8; ++row) {
+        for (int x = 0; x < 16; ++x) {
+            y.RowAt(row)[x] = static_cast<uint8_t>(x < 8 ? 10 * (x % 2) : 100);
+        }
+    }
+    MaskOptions options;
+    options.mode = MaskMode::kPixelate;
+    options.size = 8;
+    const MaskRegion region = {0, 0, 16, 8};
+    ASSERT_EQ(MaskRegions(frame.image(), &region, 1, options, nullptr), 0);
+    EXPECT_EQ(y.RowAt(3)[2], 5);
+    EXPECT_EQ(y.RowAt(7)[12], 100);
+}
+
+TEST(PrivacyMaskTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kMask);
+    ASSERT_FALSE(impls.empty());
+    StripePool pool(2);
+    for (MaskMode mode : {MaskMode::kBoxBlur, MaskMode::kGaussianBlur, MaskMode::kPixelate}) {
+        for (int size : {1, 5, 16}) {
+            MaskOptions options;
+            options.mode = mode;
+            options.size = size;
+            for (ChromaLayout layout : kLayouts) {
+                std::vector<uint8_t> expected;
+                {
+                    const ScopedKernelImpl scalar(Kernel::kMask, KernelImpl::kScalar);
+                    ASSERT_TRUE(scalar.ok());
+                    expected = Mask(layout, options, nullptr);
+                }
+                for (KernelImpl impl : impls) {
+                    const ScopedKernelImpl simd(Kernel::kMask, impl);
+                    ASSERT_TRUE(simd.ok());
+                    EXPECT_EQ(Mask(layout, options, &pool), expected)
+                            << GetKernelImplName(impl) << " mode " << static_cast<int>(mode)
+                            << " size " << size << " layout " << static_cast<int>(layout);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
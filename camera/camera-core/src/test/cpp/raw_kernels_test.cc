@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "raw_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "stripe_pool.h"
+
+namespace camerax {
+namespace {
+
+constexpr RawFormat kFormats[] = {RawFormat::kRaw10, RawFormat::kRaw12, RawFormat::kRaw16};
+
+// Widths below, at and above the 16-byte loads of the SIMD loops, with and without tails.
+constexpr int kWidths[] = {4, 8, 12, 16, 24, 100, 4000};
+
+// A RAW image of pseudo random bytes with 32 bytes of row padding.
+class TestRaw {
+public:
+    TestRaw(int width, int height, RawFormat format) {
+        image_.width = width;
+        image_.height = height;
+        image_.format = format;
+        image_.row_stride = image_.row_bytes() + 32;
+        bytes_.resize(static_cast<size_t>(image_.row_stride) * height);
+        uint32_t state = static_cast<uint32_t>(width * 31 + static_cast<int>(format));
+        for (uint8_t& byte : bytes_) {
+            state = state * 1664525U + 1013904223U;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+        if (format == RawFormat::kRaw16) {
+            // Keep the samples within a 12-bit white level.
+            for (size_t i = 1; i < bytes_.size(); i += 2) {
+                bytes_[i] &= 0x0F;
+            }
+        }
+        image_.data = bytes_.data();
+    }
+
+    const RawImage& image() const { return image_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    RawImage image_;
+};
+
+RawDevelopOptions DevelopOptions(RawFormat format, DemosaicMethod method) {
+    RawDevelopOptions options;
+    options.pattern = CfaPattern::kGrbg;
+    options.black_level[0] = 64;
+    options.black_level[1] = 60;
+    options.black_level[2] = 66;
+    options.black_level[3] = 62;
+    options.white_level = format == RawFormat::kRaw10 ? 1023 : 4095;
+    options.gains[0] = 1.9f;
+    options.gains[3] = 1.4f;
+    options.method = method;
+    return options;
+}
+
+// The outputs of all RAW kernels for one image, concatenated.
+std::vector<uint8_t> RunRawKernels(const RawImage& src, StripePool* pool) {
+    const int width = src.width;
+    const int height = src.height;
+    std::vector<uint16_t> unpacked(static_cast<size_t>(width) * height);
+    std::vector<uint16_t> linear(unpacked.size());
+    std::vector<uint8_t> binned(static_cast<size_t>(width / 2) * (height / 2) * 4);
+    std::vector<uint8_t> bilinear(static_cast<size_t>(width) * height * 4);
+    std::vector<uint8_t> edge_aware(bilinear.size());
+    const RawDevelopOptions options = DevelopOptions(src.format, DemosaicMethod::kBilinear);
+    const RawDevelopOptions edge_options = DevelopOptions(src.format, DemosaicMethod::kEdgeAware);
+    EXPECT_EQ(UnpackRaw(src, unpacked.data(), width, pool), 0);
+    EXPECT_EQ(LinearizeRaw(src, options, linear.data(), width, pool), 0);
+    EXPECT_EQ(BinRawToABGR(src, options, binned.data(), width / 2 * 4, pool), 0);
+    EXPECT_EQ(DemosaicRawToABGR(src, options, bilinear.data(), width * 4, pool), 0);
+    EXPECT_EQ(DemosaicRawToABGR(src, edge_options, edge_aware.data(), width * 4, pool), 0);
+
+    std::vector<uint8_t> out;
+    for (const std::vector<uint16_t>* samples : {&unpacked, &linear}) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(samples->data());
+        out.insert(out.end(), bytes, bytes + samples->size() * 2);
+    }
+    for (const std::vector<uint8_t>* abgr : {&binned, &bilinear, &edge_aware}) {
+        out.insert(out.end(), abgr->begin(), abgr->end());
+    }
+    return out;
+}
+
+TEST(RawKernelsTest, UnpacksMipiPackings) {
+    // Pixels 0x3FF, 0x000, 0x155 and 0x2AA: the high bytes, then the low bits of the first pixel
+    // in the lowest 2 bits.
+    const uint8_t raw10[] = {0xFF, 0x00, 0x55, 0xAA, 0b10010011};
+    // Pixels 0xABC and 0x123: the high bytes, then the first pixel's low bits in the low nibble.
+    const uint8_t raw12[] = {0xAB, 0x12, 0x3C};
+    std::vector<uint8_t> bytes(64);
+    RawImage src;
+    src.width = 4;
+    src.height = 4;
+    src.row_stride = 16;
+    src.data = bytes.data();
+    uint16_t dst[16];
+
+    src.format = RawFormat::kRaw10;
+    for (int y = 0; y < 4; ++y) {
+        std::copy(raw10, raw10 + 5, bytes.begin() + 16 * y);
+    }
+    ASSERT_EQ(UnpackRaw(src, dst, 4, nullptr), 0);
+    EXPECT_EQ(std::vector<uint16_t>(dst, dst + 4),
+              (std::vector<uint16_t>{0x3FF, 0x000, 0x155, 0x2AA}));
+
+    src.format = RawFormat::kRaw12;
+    for (int y = 0; y < 4; ++y) {
+        std::copy(raw12, raw12 + 3, bytes.begin() + 16 * y);
+        std::copy(raw12, raw12 + 3, bytes.begin() + 16 * y + 3);
+    }
+    ASSERT_EQ(UnpackRaw(src, dst, 4, nullptr), 0);
+    EXPECT_EQ(std::vector<uint16_t>(dst, dst + 4),
+              (std::vector<uint16_t>{0xABC, 0x123, 0xABC, 0x123}));
+}
+
+TEST(RawKernelsTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kRawUnpack);
+    ASSERT_FALSE(impls.empty());
+    StripePool pool(2);
+    for (RawFormat format : kFormats) {
+        for (int width : kWidths) {
+            const TestRaw raw(width, width < 100 ? 8 : 6, format);
+            std::vector<uint8_t> expected;
+            {
+                const ScopedKernelImpl scalar(Kernel::kRawUnpack, KernelImpl::kScalar);
+                ASSERT_TRUE(scalar.ok());
+                expected = RunRawKernels(raw.image(), nullptr);
+            }
+            for (KernelImpl impl : impls) {
+                const ScopedKernelImpl simd(Kernel::kRawUnpack, impl);
+                ASSERT_TRUE(simd.ok());
+                EXPECT_EQ(RunRawKernels(raw.image(), &pool), expected)
+                        << GetKernelImplName(impl) << " format " << static_cast<int>(format)
+                        << " width " << width;
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rgb_to_yuv.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+// Sizes with and without SIMD tails, odd ones with a partial last chroma block.
+constexpr int kSizes[][2] = {{64, 8}, {37, 11}, {16, 2}};
+
+// A width x height RGBA image of pseudo random bytes, rows padded by 12 bytes.
+class TestRgba {
+public:
+    TestRgba(int width, int height) : stride_(width * 4 + 12) {
+        bytes_.resize(static_cast<size_t>(stride_) * height);
+        uint32_t state = static_cast<uint32_t>(width * height);
+        for (uint8_t& byte : bytes_) {
+            state = state * 1664525U + 1013904223U;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+    }
+
+    const uint8_t* data() const { return bytes_.data(); }
+    int stride() const { return stride_; }
+
+private:
+    int stride_;
+    std::vector<uint8_t> bytes_;
+};
+
+std::vector<uint8_t> Convert(const TestRgba& src, int width, int height,
+                             const RgbToYuvOptions& options, ChromaLayout layout,
+                             StripePool* pool) {
+    const bool swap = options.rotation == 90 || options.rotation == 270;
+    const TestFrame dst(swap ? height : width, swap ? width : height, layout);
+    EXPECT_EQ(RgbToYuv420(src.data(), src.stride(), width, height, options, dst.image(), pool),
+              0);
+    return ToI420(dst.image());
+}
+
+std::vector<RgbToYuvOptions> AllOptions() {
+    std::vector<RgbToYuvOptions> all;
+    for (YuvMatrix matrix : {YuvMatrix::kBt601, YuvMatrix::kBt709}) {
+        for (bool full_range : {false, true}) {
+            for (RgbOrder order : {RgbOrder::kABGR, RgbOrder::kARGB}) {
+                for (int rotation : {0, 90, 180, 270}) {
+                    RgbToYuvOptions options;
+                    options.matrix = matrix;
+                    options.full_range = full_range;
+                    options.order = order;
+                    options.rotation = rotation;
+                    all.push_back(options);
+                }
+            }
+        }
+    }
+    return all;
+}
+
+TEST(RgbToYuvTest, LumaFollowsTheWeights) {
+    const TestRgba src(37, 11);
+    for (const RgbToYuvOptions& options : AllOptions()) {
+        if (options.rotation != 0) {
+            continue;
+        }
+        const YuvWeights weights = ComputeYuvWeights(options);
+        const std::vector<uint8_t> i420 =
+                Convert(src, 37, 11, options, ChromaLayout::kPlanar, nullptr);
+        for (int y = 0; y < 11; ++y) {
+            for (int x = 0; x < 37; ++x) {
+                const uint8_t* pixel = src.data() + y * src.stride() + 4 * x;
+                ASSERT_EQ(i420[y * 37 + x], weights.Luma(pixel[0], pixel[1], pixel[2]))
+                        << x << "," << y;
+            }
+        }
+    }
+}
+
+TEST(RgbToYuvTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kRgbToYuv);
+    ASSERT_FALSE(impls.empty());
+    StripePool pool(2);
+    for (const auto& size : kSizes) {
+        const TestRgba src(size[0], size[1]);
+        for (const RgbToYuvOptions& options : AllOptions()) {
+            for (ChromaLayout layout : kLayouts) {
+                std::vector<uint8_t> expected;
+                {
+                    const ScopedKernelImpl scalar(Kernel::kRgbToYuv, KernelImpl::kScalar);
+                    ASSERT_TRUE(scalar.ok());
+                    expected = Convert(src, size[0], size[1], options, layout, nullptr);
+                }
+                for (KernelImpl impl : impls) {
+                    const ScopedKernelImpl simd(Kernel::kRgbToYuv, impl);
+                    ASSERT_TRUE(simd.ok());
+                    EXPECT_EQ(Convert(src, size[0], size[1], options, layout, &pool), expected)
+                            << GetKernelImplName(impl) << " " << size[0] << "x" << size[1]
+                            << " matrix " << static_cast<int>(options.matrix) << " full "
+                            << options.full_range << " order " << static_cast<int>(options.order)
+                            << " rotation " << options.rotation << " layout "
+                            << static_cast<int>(layout);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax
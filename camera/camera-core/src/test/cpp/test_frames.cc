@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "test_frames.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace camerax {
+namespace {
+
+uint8_t PatternAt(int x, int y, uint32_t plane, uint32_t seed) {
+    // Small integer hash, so that neighbouring samples differ in every bit.
+    uint32_t h = static_cast<uint32_t>(x) * 0x9E3779B1u ^ static_cast<uint32_t>(y) * 0x85EBCA77u
+            ^ (plane + 1) * 0xC2B2AE3Du ^ seed * 0x27D4EB2Fu;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return static_cast<uint8_t>(h >> 24);
+}
+
+void FillPlane(const Plane& plane, int width, int height, uint32_t index, uint32_t seed) {
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = plane.RowAt(y);
+        for (int x = 0; x < width; ++x) {
+            row[x * plane.pixel_stride] = PatternAt(x, y, index, seed);
+        }
+    }
+}
+
+void CopyPlane(const Plane& plane, int width, int height, uint8_t* dst) {
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = plane.RowAt(y);
+        for (int x = 0; x < width; ++x) {
+            *dst++ = row[x * plane.pixel_stride];
+        }
+    }
+}
+
+// A gradient across the plane plus a wave along both axes, all within 40 to 232.
+void FillSmoothPlane(const Plane& plane, int width, int height, uint32_t index, uint32_t seed) {
+    double phase = (index * 7 + seed * 13) % 64 / 10.0;
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = plane.RowAt(y);
+        for (int x = 0; x < width; ++x) {
+            double gradient = 64.0 * x / width + 48.0 * y / height;
+            double wave = 40.0 * std::sin(x / 9.0 + phase) * std::cos(y / 11.0 - phase);
+            row[x * plane.pixel_stride] = static_cast<uint8_t>(std::lround(80 + gradient + wave));
+        }
+    }
+}
+
+int AlignUp(int value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+PlanarImage AllocateTestPlanes(int width, int height, ChromaLayout layout, int row_alignment,
+                               std::vector<uint8_t>* memory, ChromaSubsampling subsampling) {
+    PlanarImage shape;
+    shape.width = width;
+    shape.height = height;
+    shape.subsampling = subsampling;
+    int chroma_width = shape.chroma_width();
+    int chroma_height = shape.chroma_height();
+    int align = row_alignment > 0 ? row_alignment : 1;
+    // Semi-planar buffers share the stride between the luma and the interleaved chroma rows.
+    int min_stride_y = (layout == ChromaLayout::kSemiPlanarUV
+                        || layout == ChromaLayout::kSemiPlanarVU)
+            ? std::max(width, 2 * chroma_width) : width;
+    int stride_y = AlignUp(min_stride_y, align);
+
+    PlanarImage image;
+    switch (layout) {
+        case ChromaLayout::kSemiPlanarUV:
+        case ChromaLayout::kSemiPlanarVU: {
+            memory->assign(static_cast<size_t>(stride_y) * (height + chroma_height), 0);
+            image = WrapNV12(memory->data(), width, height, stride_y, height,
+                             layout == ChromaLayout::kSemiPlanarVU);
+            break;
+        }
+        case ChromaLayout::kFlexible: {
+            // Chroma samples padded to a pixel stride of 2 in two independent planes.
+            int stride_uv = AlignUp(2 * chroma_width, align);
+            size_t size_y = static_cast<size_t>(stride_y) * height;
+            size_t size_uv = static_cast<size_t>(stride_uv) * chroma_height;
+            memory->assign(size_y + 2 * size_uv, 0);
+            uint8_t* y = memory->data();
+            image = WrapAndroid420(y, stride_y, 1, y + size_y, stride_uv,
+                                   y + size_y + size_uv, 2, width, height);
+            break;
+        }
+        case ChromaLayout::kPlanar:
+        default: {
+            int stride_uv = AlignUp(chroma_width, align);
+            size_t size_y = static_cast<size_t>(stride_y) * height;
+            size_t size_uv = static_cast<size_t>(stride_uv) * chroma_height;
+            memory->assign(size_y + 2 * size_uv, 0);
+            uint8_t* y = memory->data();
+            image = WrapAndroid420(y, stride_y, 1, y + size_y, stride_uv,
+                                   y + size_y + size_uv, 1, width, height);
+            break;
+        }
+    }
+    image.subsampling = subsampling;
+    return image;
+}
+
+void FillTestPattern(const PlanarImage& image, uint32_t seed) {
+    FillPlane(image.y, image.width, image.height, 0, seed);
+    FillPlane(image.u, image.chroma_width(), image.chroma_height(), 1, seed);
+    FillPlane(image.v, image.chroma_width(), image.chroma_height(), 2, seed);
+}
+
+void FillSmoothTestPattern(const PlanarImage& image, uint32_t seed) {
+    FillSmoothPlane(image.y, image.width, image.height, 0, seed);
+    FillSmoothPlane(image.u, image.chroma_width(), image.chroma_height(), 1, seed);
+    FillSmoothPlane(image.v, image.chroma_width(), image.chroma_height(), 2, seed);
+}
+
+std::vector<uint8_t> ToI420(const PlanarImage& image) {
+    size_t luma_size = static_cast<size_t>(image.width) * image.height;
+    size_t chroma_size = static_cast<size_t>(image.chroma_width()) * image.chroma_height();
+    std::vector<uint8_t> i420(luma_size + 2 * chroma_size);
+    CopyPlane(image.y, image.width, image.height, i420.data());
+    CopyPlane(image.u, image.chroma_width(), image.chroma_height(), i420.data() + luma_size);
+    CopyPlane(image.v, image.chroma_width(), image.chroma_height(),
+              i420.data() + luma_size + chroma_size);
+    return i420;
+}
+
+double Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    if (a.size() != b.size() || a.empty()) {
+        return 0;
+    }
+    double squared_error = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double diff = static_cast<double>(a[i]) - b[i];
+        squared_error += diff * diff;
+    }
+    if (squared_error == 0) {
+        return 99;
+    }
+    return 10 * std::log10(255.0 * 255.0 * a.size() / squared_error);
+}
+
+}  // namespace camerax
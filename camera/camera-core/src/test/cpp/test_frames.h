@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_TEST_FRAMES_H_
+#define CAMERA_CORE_TEST_FRAMES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+
+namespace camerax {
+
+/**
+ * Allocates an Android420 image of the given chroma layout in {@code memory}, laid out the way
+ * hardware buffers commonly are: rows padded to {@code row_alignment} bytes, semi-planar chroma
+ * sharing the luma stride and flexible chroma as two planes with a pixel stride of 2. The chroma
+ * is 4:2:0 unless {@code subsampling} says otherwise.
+ */
+PlanarImage AllocateTestPlanes(int width, int height, ChromaLayout layout, int row_alignment,
+                               std::vector<uint8_t>* memory,
+                               ChromaSubsampling subsampling = ChromaSubsampling::k420);
+
+/**
+ * Fills every sample of the image, padding excluded, with a pseudo random pattern that depends
+ * only on the position and {@code seed}.
+ */
+void FillTestPattern(const PlanarImage& image, uint32_t seed = 0);
+
+/**
+ * Fills every sample of the image, padding excluded, with slowly varying gradients that depend on
+ * {@code seed}. Lossy codecs reproduce these closely, unlike {@link FillTestPattern}.
+ */
+void FillSmoothTestPattern(const PlanarImage& image, uint32_t seed = 0);
+
+/** An Android420 image in heap memory, see {@link AllocateTestPlanes}, filled on construction. */
+class TestFrame {
+public:
+    TestFrame(int width, int height, ChromaLayout layout, uint32_t seed = 0,
+              int row_alignment = 64, ChromaSubsampling subsampling = ChromaSubsampling::k420)
+            : image_(AllocateTestPlanes(width, height, layout, row_alignment, &memory_,
+                                        subsampling)) {
+        FillTestPattern(image_, seed);
+    }
+
+    TestFrame(const TestFrame&) = delete;
+    TestFrame& operator=(const TestFrame&) = delete;
+
+    const PlanarImage& image() const { return image_; }
+
+private:
+    std::vector<uint8_t> memory_;
+    PlanarImage image_;
+};
+
+/** Copies the samples of an image into tightly packed I420 memory, for comparisons. */
+std::vector<uint8_t> ToI420(const PlanarImage& image);
+
+/**
+ * Returns the peak signal to noise ratio of two equally sized sample arrays in dB, or 99 when
+ * they are equal.
+ */
+double Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_TEST_FRAMES_H_
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "test_jpeg.h"
+
+#include <csetjmp>
+
+#include "jpeg_error.h"
+
+namespace camerax {
+namespace {
+
+// Runs below the setjmp of DecodeReferenceJpeg, so that none of its locals cross it.
+void ReadScanlines(j_decompress_ptr cinfo, DecodedJpeg* decoded) {
+    jpeg_read_header(cinfo, TRUE);
+    cinfo->out_color_space = JCS_YCbCr;
+    cinfo->do_fancy_upsampling = FALSE;
+    cinfo->dct_method = JDCT_ISLOW;
+    jpeg_start_decompress(cinfo);
+    decoded->width = static_cast<int>(cinfo->output_width);
+    decoded->height = static_cast<int>(cinfo->output_height);
+    decoded->ycbcr.resize(static_cast<size_t>(decoded->width) * decoded->height * 3);
+    while (cinfo->output_scanline < cinfo->output_height) {
+        JSAMPROW row = decoded->ycbcr.data()
+                + static_cast<size_t>(cinfo->output_scanline) * decoded->width * 3;
+        jpeg_read_scanlines(cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(cinfo);
+}
+
+}  // namespace
+
+bool DecodeReferenceJpeg(const uint8_t* jpeg, size_t jpeg_size, DecodedJpeg* decoded) {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = InitJpegErrorManager(&error);
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg, static_cast<unsigned long>(jpeg_size));
+    ReadScanlines(&cinfo, decoded);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+std::vector<uint8_t> DecodedJpegToI420(const DecodedJpeg& decoded) {
+    const int chroma_width = (decoded.width + 1) / 2;
+    const int chroma_height = (decoded.height + 1) / 2;
+    const size_t luma_size = static_cast<size_t>(decoded.width) * decoded.height;
+    const size_t chroma_size = static_cast<size_t>(chroma_width) * chroma_height;
+    std::vector<uint8_t> i420(luma_size + 2 * chroma_size);
+    for (int y = 0; y < decoded.height; ++y) {
+        for (int x = 0; x < decoded.width; ++x) {
+            i420[static_cast<size_t>(y) * decoded.width + x] =
+                    decoded.ycbcr[(static_cast<size_t>(y) * decoded.width + x) * 3];
+        }
+    }
+    for (int y = 0; y < chroma_height; ++y) {
+        for (int x = 0; x < chroma_width; ++x) {
+            const uint8_t* pixel =
+                    &decoded.ycbcr[(static_cast<size_t>(2 * y) * decoded.width + 2 * x) * 3];
+            size_t i = static_cast<size_t>(y) * chroma_width + x;
+            i420[luma_size + i] = pixel[1];
+            i420[luma_size + chroma_size + i] = pixel[2];
+        }
+    }
+    return i420;
+}
+
+}  // namespace camerax
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAMERA_CORE_TEST_JPEG_H_
+#define CAMERA_CORE_TEST_JPEG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace camerax {
+
+/** A JPEG decoded at full size to interleaved 4:4:4 YCbCr, 3 bytes per pixel. */
+struct DecodedJpeg {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> ycbcr;
+};
+
+/**
+ * Decodes a JPEG with plain libjpeg, as the reference the codecs of camera-core are compared
+ * against. Chroma is upsampled by replication, so every decoded chroma sample of a 4:2:0 JPEG
+ * appears unchanged in a 2x2 block. Returns false if libjpeg fails.
+ */
+bool DecodeReferenceJpeg(const uint8_t* jpeg, size_t jpeg_size, DecodedJpeg* decoded);
+
+/**
+ * Copies the luma and the top left chroma sample of every 2x2 block of {@code decoded} into
+ * tightly packed I420 memory, see {@link ToI420}.
+ */
+std::vector<uint8_t> DecodedJpegToI420(const DecodedJpeg& decoded);
+
+}  // namespace camerax
+
+#endif  // CAMERA_CORE_TEST_JPEG_H_
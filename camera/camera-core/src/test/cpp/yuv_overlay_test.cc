@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "yuv_overlay.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "image_planes.h"
+#include "kernel_dispatch.h"
+#include "kernel_impls.h"
+#include "rgb_to_yuv.h"
+#include "test_frames.h"
+
+namespace camerax {
+namespace {
+
+constexpr ChromaLayout kLayouts[] = {ChromaLayout::kPlanar, ChromaLayout::kSemiPlanarUV,
+                                     ChromaLayout::kSemiPlanarVU, ChromaLayout::kFlexible};
+
+constexpr int kFrameWidth = 96;
+constexpr int kFrameHeight = 40;
+
+// A width x height RGBA image with transparent margins of 3 columns, an opaque middle row and
+// pseudo random alpha elsewhere. Premultiplied colors do not exceed their alpha.
+std::vector<uint8_t> OverlayPixels(int width, int height, bool premultiplied) {
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    uint32_t state = static_cast<uint32_t>(width * 7 + height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t* pixel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+            state = state * 1664525U + 1013904223U;
+            int alpha = static_cast<int>(state >> 24);
+            if (x < 3 || x >= width - 3) {
+                alpha = 0;
+            } else if (y == height / 2) {
+                alpha = 255;
+            }
+            for (int c = 0; c < 3; ++c) {
+                state = state * 1664525U + 1013904223U;
+                const int color = static_cast<int>(state >> 24);
+                pixel[c] = static_cast<uint8_t>(premultiplied ? color * alpha / 255 : color);
+            }
+            pixel[3] = static_cast<uint8_t>(alpha);
+        }
+    }
+    return rgba;
+}
+
+// Blends the overlay at every position into a fresh frame and returns the frames as I420.
+std::vector<uint8_t> Blend(const YuvOverlay& overlay, ChromaLayout layout, StripePool* pool) {
+    const int positions[][2] = {{0, 0}, {7, 3}, {-5, -3}, {70, 30}, {-40, 20}};
+    std::vector<uint8_t> out;
+    for (const auto& position : positions) {
+        const TestFrame frame(kFrameWidth, kFrameHeight, layout, 9);
+        EXPECT_EQ(overlay.BlendInto(frame.image(), position[0], position[1], pool), 0);
+        const std::vector<uint8_t> i420 = ToI420(frame.image());
+        out.insert(out.end(), i420.begin(), i420.end());
+    }
+    return out;
+}
+
+TEST(YuvOverlayTest, LeavesTransparentPixelsUntouched) {
+    std::vector<uint8_t> rgba(32 * 8 * 4, 0);
+    const YuvOverlay overlay(rgba.data(), 32 * 4, 32, 8, true, RgbToYuvOptions());
+    ASSERT_TRUE(overlay.IsValid());
+    const TestFrame frame(kFrameWidth, kFrameHeight, ChromaLayout::kSemiPlanarUV);
+    const std::vector<uint8_t> before = ToI420(frame.image());
+    ASSERT_EQ(overlay.BlendInto(frame.image(), 10, 4, nullptr), 0);
+    EXPECT_EQ(ToI420(frame.image()), before);
+}
+
+TEST(YuvOverlayTest, SimdMatchesScalar) {
+    const std::vector<KernelImpl> impls = SimdImpls(Kernel::kOverlay);
+    ASSERT_FALSE(impls.empty());
+    StripePool pool(2);
+    const int sizes[][2] = {{64, 16}, {45, 13}, {8, 4}};
+    for (const auto& size : sizes) {
+        for (bool premultiplied : {false, true}) {
+            for (int rotation : {0, 90}) {
+                const std::vector<uint8_t> rgba = OverlayPixels(size[0], size[1], premultiplied);
+                RgbToYuvOptions options;
+                options.rotation = rotation;
+                const YuvOverlay overlay(rgba.data(), size[0] * 4, size[0], size[1],
+                                         premultiplied, options);
+                ASSERT_TRUE(overlay.IsValid());
+                for (ChromaLayout layout : kLayouts) {
+                    std::vector<uint8_t> expected;
+                    {
+                        const ScopedKernelImpl scalar(Kernel::kOverlay, KernelImpl::kScalar);
+                        ASSERT_TRUE(scalar.ok());
+                        expected = Blend(overlay, layout, nullptr);
+                    }
+                    for (KernelImpl impl : impls) {
+                        const ScopedKernelImpl simd(Kernel::kOverlay, impl);
+                        ASSERT_TRUE(simd.ok());
+                        EXPECT_EQ(Blend(overlay, layout, &pool), expected)
+                                << GetKernelImplName(impl) << " " << size[0] << "x" << size[1]
+                                << " premultiplied " << premultiplied << " rotation "
+                                << rotation << " layout " << static_cast<int>(layout);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace camerax